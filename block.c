@@ -35,6 +35,7 @@
 #include "read_input.h"
 #include "operator/D_psi.h"
 #include "linalg_eo.h"
+#include "linalg/blas.h"
 #include "start.h"
 #include "gamma.h"
 #include "xchange/xchange.h"
@@ -859,6 +860,54 @@ void block_orthonormalize_free(block *parent) {
 
 
 
+/* The g_N_s basis fields of a block are stored consecutively with      */
+/* stride volume + spinpad, so they form a (12*volume) x g_N_s complex  */
+/* matrix B with leading dimension 12*(volume + spinpad). Restriction   */
+/* v = B^dagger psi and prolongation psi = B v are then single gemv     */
+/* calls which stream the block field only once instead of g_N_s times. */
+
+/* v[j] = (basis_j, psi) for all j, block local (no reduction) */
+void block_restrict(_Complex double * const v, block * const blk, spinor * const psi) {
+  int m = 12*blk->volume, n = g_N_s, lda = 12*(blk->volume + blk->spinpad), one = 1;
+  _Complex double cone = 1.0, czero = 0.0;
+
+  _FT(zgemv)("C", &m, &n, &cone, (_Complex double*) blk->basis[0], &lda,
+             (_Complex double*) psi, &one, &czero, v, &one, 1);
+  return;
+}
+
+/* psi = sum_j v[j] basis_j */
+void block_prolongate(spinor * const psi, block * const blk, _Complex double * const v) {
+  int m = 12*blk->volume, n = g_N_s, lda = 12*(blk->volume + blk->spinpad), one = 1;
+  _Complex double cone = 1.0, czero = 0.0;
+
+  _FT(zgemv)("N", &m, &n, &cone, (_Complex double*) blk->basis[0], &lda,
+             v, &one, &czero, (_Complex double*) psi, &one, 1);
+  return;
+}
+
+/* v[j + i*g_N_s] = (block_list[i].basis_j, psi[i]) for all blocks i */
+void blocks_restrict(_Complex double * const v, spinor ** const psi) {
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int i = 0; i < nb_blocks; i++) {
+    block_restrict(v + i*g_N_s, &block_list[i], psi[i]);
+  }
+  return;
+}
+
+/* psi[i] = sum_j v[j + i*g_N_s] block_list[i].basis_j for all blocks i */
+void blocks_prolongate(spinor ** const psi, _Complex double * const v) {
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int i = 0; i < nb_blocks; i++) {
+    block_prolongate(psi[i], &block_list[i], v + i*g_N_s);
+  }
+  return;
+}
+
 /* the following 2 functions are reference functions for computing little_d */
 /* but much slower than block_compute_little_D_diagonal and                 */
 /* block_compute_little_D_offdiagonal                                       */
@@ -1009,8 +1058,8 @@ void compute_little_D(const int mul_g5) {
     for(int i = 0; i < g_N_s; i++) {
       Block_D_psi(&block_list[blk], bscratch, block_list[blk].basis[i]);
       if(mul_g5) gamma5(bscratch, bscratch, bvol);
+      block_restrict(M + i * g_N_s, &block_list[blk], bscratch);
       for(int j = 0; j < g_N_s; j++) {
-        M[i * g_N_s + j]  = scalar_prod_ts(block_list[blk].basis[j], bscratch, bvol, 0);
         block_list[blk].little_dirac_operator_32[i * g_N_s + j] = (_Complex float)M[i * g_N_s + j];
         
         block_list[block_list[blk].evenodd_id].little_dirac_operator_eo[i * g_N_s + j] = M[i * g_N_s + j];
@@ -87,6 +87,11 @@ void add_eo_block_32_to_global(spinor * const globalfield,
 void block_convert_lexic_to_eo(spinor * const s, spinor * const r, spinor * const P);
 void block_convert_eo_to_lexic(spinor * const P, spinor * const s, spinor * const r);
 
+void block_restrict(_Complex double * const v, block * const blk, spinor * const psi);
+void block_prolongate(spinor * const psi, block * const blk, _Complex double * const v);
+void blocks_restrict(_Complex double * const v, spinor ** const psi);
+void blocks_prolongate(spinor ** const psi, _Complex double * const v);
+
 void block_orthonormalize(block *parent);
 void block_orthonormalize_free(block *parent);
 
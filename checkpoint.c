@@ -0,0 +1,595 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+ *
+ * Asynchronous checkpoints of the HMC state
+ *
+ * write_checkpoint copies the state into a snapshot and starts an I/O
+ * thread writing it, the main thread continues with the next trajectory.
+ * The I/O thread never calls MPI (hmc_tm initialises MPI with at most
+ * MPI_THREAD_SERIALIZED), hence every process writes its local part into
+ * its own LIME container .checkpoint.<slot>.<g_cart_id> with the records
+ *
+ *   tmlqcd-checkpoint-info   counters, geometry, checksum of the gauge
+ *                            record, integrator setup, intervals and
+ *                            orders of the rational approximations,
+ *                            ranlxd and ranlxs states (text)
+ *   tmlqcd-checkpoint-gauge  the VOLUME*4 local links in lexicographic
+ *                            order, big endian
+ *
+ * The two slots are used alternately. Once all processes are done (checked
+ * by poll_checkpoint after every trajectory) process 0 commits the slot by
+ * replacing the index file .checkpoint, such that a run which is killed
+ * while writing still finds the previous complete checkpoint.
+ *
+ * Without pthreads the checkpoints are written synchronously.
+ *
+ * The measurements of the integrator tuning (tune_integrator.c) are not
+ * part of the checkpoint, after a restart they are accumulated anew for
+ * Integrator.tune_trajectories trajectories.
+ *
+ *******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef HAVE_PTHREAD
+# include <pthread.h>
+#endif
+#include <lime.h>
+#include "global.h"
+#include "su3.h"
+#include "aligned_malloc.h"
+#include "ranlxd.h"
+#include "ranlxs.h"
+#include "derived_gauge_fields.h"
+#include "monomial/monomial.h"
+#include "monomial/adapt_rational.h"
+#include "integrator.h"
+#include "io/utils.h"
+#include "io/dml.h"
+#include "checkpoint.h"
+
+#define CP_IDLE 0
+#define CP_RUNNING 1
+#define CP_WRITTEN 2
+#define CP_FAILED 3
+
+static char const index_filename[] = ".checkpoint";
+
+typedef struct {
+  int slot, traj, nstore;
+  /* integrator setup */
+  int tune, no_timescales, no_monomials;
+  int n_int[10], timescale[max_no_monomials];
+  /* rational approximations, which may have been adapted */
+  int rat_order[max_no_monomials];
+  double stilde[2*max_no_monomials];
+  int * rlxd, * rlxs;
+  su3 * gauge;
+  DML_Checksum checksum;
+  char info[8192];
+} checkpoint_t;
+
+static checkpoint_t cp = {-1, 0, 0, 0, 0, 0, {0}, {0}, {0}, {0.}, NULL, NULL, NULL};
+/* slot of the last complete checkpoint, -1 if there is none */
+static int committed_slot = -1;
+/* a snapshot is being written (the same on all processes) */
+static int pending = 0;
+static int cp_status = CP_IDLE;
+#ifdef HAVE_PTHREAD
+static pthread_t io_thread;
+static pthread_mutex_t status_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int joinable = 0;
+#endif
+
+static void checkpoint_filename(char * const filename, const int slot) {
+  sprintf(filename, "%s.%d.%.4d", index_filename, slot, g_cart_id);
+}
+
+static int alloc_checkpoint() {
+  if(cp.gauge != NULL) return(0);
+  cp.gauge = (su3*)aligned_malloc(4*VOLUME*sizeof(su3));
+  cp.rlxd = (int*)malloc(rlxd_size()*sizeof(int));
+  cp.rlxs = (int*)malloc(rlxs_size()*sizeof(int));
+  if(cp.gauge == NULL || cp.rlxd == NULL || cp.rlxs == NULL) {
+    return(-1);
+  }
+  return(0);
+}
+
+static void append_ints(char * const message, char const * const key, const int * const v, const int n) {
+  char * p = message + strlen(message);
+  p += sprintf(p, "\n%s =", key);
+  for(int i = 0; i < n; i++) {
+    p += sprintf(p, " %d", v[i]);
+  }
+  return;
+}
+
+/* as append_ints, with 17 significant digits such that parse_doubles */
+/* reads back the same values                                         */
+static void append_doubles(char * const message, char const * const key, const double * const v, const int n) {
+  char * p = message + strlen(message);
+  p += sprintf(p, "\n%s =", key);
+  for(int i = 0; i < n; i++) {
+    p += sprintf(p, " %.16e", v[i]);
+  }
+  return;
+}
+
+/* reads the n integers following "key =" at the beginning of a line */
+static int parse_ints(char const * const message, char const * const key, int * const v, const int n) {
+  char tag[50];
+  char const * p;
+  int len;
+
+  sprintf(tag, "\n%s =", key);
+  if((p = strstr(message, tag)) == NULL) return(-1);
+  p += strlen(tag);
+  for(int i = 0; i < n; i++) {
+    if(sscanf(p, "%d%n", &v[i], &len) != 1) return(-1);
+    p += len;
+  }
+  return(0);
+}
+
+/* as parse_ints for doubles */
+static int parse_doubles(char const * const message, char const * const key, double * const v, const int n) {
+  char tag[50];
+  char const * p;
+  int len;
+
+  sprintf(tag, "\n%s =", key);
+  if((p = strstr(message, tag)) == NULL) return(-1);
+  p += strlen(tag);
+  for(int i = 0; i < n; i++) {
+    if(sscanf(p, "%lf%n", &v[i], &len) != 1) return(-1);
+    p += len;
+  }
+  return(0);
+}
+
+static void build_info() {
+  int v[4];
+
+  sprintf(cp.info, "checkpoint of hmc_tm, version %s", PACKAGE_VERSION);
+  append_ints(cp.info, "trajectory", &cp.traj, 1);
+  append_ints(cp.info, "nstore", &cp.nstore, 1);
+  v[0] = T*g_nproc_t; v[1] = LX*g_nproc_x; v[2] = LY*g_nproc_y; v[3] = LZ*g_nproc_z;
+  append_ints(cp.info, "lattice", v, 4);
+  v[0] = g_nproc_t; v[1] = g_nproc_x; v[2] = g_nproc_y; v[3] = g_nproc_z;
+  append_ints(cp.info, "processes", v, 4);
+  append_ints(cp.info, "coordinates", g_proc_coords, 4);
+  sprintf(cp.info + strlen(cp.info), "\nchecksum = %08x %08x", cp.checksum.suma, cp.checksum.sumb);
+  append_ints(cp.info, "tune", &cp.tune, 1);
+  append_ints(cp.info, "timescales", &cp.no_timescales, 1);
+  append_ints(cp.info, "steps", cp.n_int, cp.no_timescales);
+  append_ints(cp.info, "monomials", &cp.no_monomials, 1);
+  append_ints(cp.info, "timescale", cp.timescale, cp.no_monomials);
+  append_ints(cp.info, "rat_order", cp.rat_order, cp.no_monomials);
+  append_doubles(cp.info, "stilde", cp.stilde, 2*cp.no_monomials);
+  append_ints(cp.info, "ranlxd", cp.rlxd, rlxd_size());
+  append_ints(cp.info, "ranlxs", cp.rlxs, rlxs_size());
+  strcat(cp.info, "\n");
+  return;
+}
+
+static int parse_info() {
+  int v[4], w[4];
+  unsigned int suma, sumb;
+  char const * p;
+
+  if(parse_ints(cp.info, "trajectory", &cp.traj, 1) != 0 ||
+     parse_ints(cp.info, "nstore", &cp.nstore, 1) != 0 ||
+     parse_ints(cp.info, "tune", &cp.tune, 1) != 0 ||
+     parse_ints(cp.info, "timescales", &cp.no_timescales, 1) != 0 ||
+     parse_ints(cp.info, "monomials", &cp.no_monomials, 1) != 0 ||
+     cp.no_timescales < 1 || cp.no_timescales > 10 ||
+     cp.no_monomials < 0 || cp.no_monomials > max_no_monomials ||
+     parse_ints(cp.info, "steps", cp.n_int, cp.no_timescales) != 0 ||
+     parse_ints(cp.info, "timescale", cp.timescale, cp.no_monomials) != 0 ||
+     parse_ints(cp.info, "rat_order", cp.rat_order, cp.no_monomials) != 0 ||
+     parse_doubles(cp.info, "stilde", cp.stilde, 2*cp.no_monomials) != 0 ||
+     parse_ints(cp.info, "ranlxd", cp.rlxd, rlxd_size()) != 0 ||
+     parse_ints(cp.info, "ranlxs", cp.rlxs, rlxs_size()) != 0) {
+    fprintf(stderr, "Incomplete checkpoint info on process %d\n", g_proc_id);
+    return(-1);
+  }
+  if((p = strstr(cp.info, "\nchecksum =")) == NULL ||
+     sscanf(p + strlen("\nchecksum ="), "%x %x", &suma, &sumb) != 2) {
+    fprintf(stderr, "No checksum in the checkpoint of process %d\n", g_proc_id);
+    return(-1);
+  }
+  cp.checksum.suma = suma;
+  cp.checksum.sumb = sumb;
+
+  w[0] = T*g_nproc_t; w[1] = LX*g_nproc_x; w[2] = LY*g_nproc_y; w[3] = LZ*g_nproc_z;
+  if(parse_ints(cp.info, "lattice", v, 4) != 0 || memcmp(v, w, sizeof(v)) != 0) {
+    fprintf(stderr, "The checkpoint of process %d is for a different lattice\n", g_proc_id);
+    return(-1);
+  }
+  w[0] = g_nproc_t; w[1] = g_nproc_x; w[2] = g_nproc_y; w[3] = g_nproc_z;
+  if(parse_ints(cp.info, "processes", v, 4) != 0 || memcmp(v, w, sizeof(v)) != 0 ||
+     parse_ints(cp.info, "coordinates", v, 4) != 0 || memcmp(v, g_proc_coords, sizeof(v)) != 0) {
+    fprintf(stderr, "The checkpoint of process %d is for a different process grid\n", g_proc_id);
+    return(-1);
+  }
+  return(0);
+}
+
+static int write_record(LimeWriter * writer, char * const type, void * const data,
+                        n_uint64_t bytes, const int MB_flag, const int ME_flag) {
+  LimeRecordHeader * header = limeCreateHeader(MB_flag, ME_flag, type, bytes);
+  n_uint64_t written = bytes;
+  int status;
+
+  if(header == (LimeRecordHeader*)NULL) return(-1);
+  status = limeWriteRecordHeader(header, writer);
+  limeDestroyHeader(header);
+  if(status != LIME_SUCCESS) return(-1);
+  status = limeWriteRecordData(data, &written, writer);
+  if(status != LIME_SUCCESS || written != bytes) return(-1);
+  return(0);
+}
+
+/* runs in the I/O thread, must not call MPI */
+static int write_snapshot() {
+  char filename[50];
+  FILE * ofs;
+  LimeWriter * writer;
+  int ret = 0;
+
+  if(!big_endian()) {
+    byte_swap(cp.gauge, 4*VOLUME*sizeof(su3)/sizeof(double));
+  }
+  for(int ix = 0; ix < VOLUME; ix++) {
+    DML_checksum_accum(&cp.checksum, ix, (char*)(cp.gauge + 4*ix), 4*sizeof(su3));
+  }
+  build_info();
+
+  checkpoint_filename(filename, cp.slot);
+  if((ofs = fopen(filename, "w")) == (FILE*)NULL) {
+    fprintf(stderr, "Error opening checkpoint file %s for writing\n", filename);
+    return(-1);
+  }
+  if((writer = limeCreateWriter(ofs)) == (LimeWriter*)NULL) {
+    fclose(ofs);
+    return(-1);
+  }
+  ret = write_record(writer, "tmlqcd-checkpoint-info", cp.info, strlen(cp.info), 1, 0);
+  if(ret == 0) {
+    ret = write_record(writer, "tmlqcd-checkpoint-gauge", cp.gauge,
+                       (n_uint64_t)4*VOLUME*sizeof(su3), 0, 1);
+  }
+  limeDestroyWriter(writer);
+  /* the index may only point to data which is on disk */
+  if(fflush(ofs) != 0 || fsync(fileno(ofs)) != 0) ret = -1;
+  if(fclose(ofs) != 0) ret = -1;
+  if(ret != 0) {
+    fprintf(stderr, "Error writing checkpoint file %s\n", filename);
+  }
+  return(ret);
+}
+
+static int read_snapshot(const int slot) {
+  char filename[50];
+  FILE * ifs;
+  LimeReader * reader;
+  DML_Checksum checksum;
+  n_uint64_t bytes;
+  int found = 0, lstatus;
+
+  checkpoint_filename(filename, slot);
+  if((ifs = fopen(filename, "r")) == (FILE*)NULL) {
+    fprintf(stderr, "Error opening checkpoint file %s\n", filename);
+    return(-1);
+  }
+  if((reader = limeCreateReader(ifs)) == (LimeReader*)NULL) {
+    fclose(ifs);
+    return(-1);
+  }
+  while((lstatus = limeReaderNextRecord(reader)) != LIME_EOF) {
+    if(lstatus != LIME_SUCCESS) break;
+    bytes = limeReaderBytes(reader);
+    if(!strcmp("tmlqcd-checkpoint-info", limeReaderType(reader)) && bytes < sizeof(cp.info)) {
+      if(limeReaderReadData(cp.info, &bytes, reader) != LIME_SUCCESS) break;
+      cp.info[bytes] = '\0';
+      found |= 1;
+    }
+    else if(!strcmp("tmlqcd-checkpoint-gauge", limeReaderType(reader)) &&
+            bytes == (n_uint64_t)4*VOLUME*sizeof(su3)) {
+      if(limeReaderReadData(cp.gauge, &bytes, reader) != LIME_SUCCESS) break;
+      found |= 2;
+    }
+  }
+  limeDestroyReader(reader);
+  fclose(ifs);
+  if(found != 3) {
+    fprintf(stderr, "Checkpoint file %s is incomplete\n", filename);
+    return(-1);
+  }
+  if(parse_info() != 0) return(-1);
+
+  DML_checksum_init(&checksum);
+  for(int ix = 0; ix < VOLUME; ix++) {
+    DML_checksum_accum(&checksum, ix, (char*)(cp.gauge + 4*ix), 4*sizeof(su3));
+  }
+  if(checksum.suma != cp.checksum.suma || checksum.sumb != cp.checksum.sumb) {
+    fprintf(stderr, "Checksum mismatch in checkpoint file %s\n", filename);
+    return(-1);
+  }
+  if(!big_endian()) {
+    byte_swap(cp.gauge, 4*VOLUME*sizeof(su3)/sizeof(double));
+  }
+  return(0);
+}
+
+#ifdef HAVE_PTHREAD
+static void * checkpoint_thread(void * arg) {
+  const int s = (write_snapshot() == 0) ? CP_WRITTEN : CP_FAILED;
+  pthread_mutex_lock(&status_mutex);
+  cp_status = s;
+  pthread_mutex_unlock(&status_mutex);
+  return(NULL);
+}
+#endif
+
+static void commit_checkpoint() {
+  char tmp_filename[50];
+  FILE * ofs;
+
+  sprintf(tmp_filename, "%s.tmp", index_filename);
+  if((ofs = fopen(tmp_filename, "w")) == (FILE*)NULL) {
+    fprintf(stderr, "Error writing %s, checkpoint of trajectory %d not committed\n", tmp_filename, cp.traj);
+    return;
+  }
+  fprintf(ofs, "%d %d %d\n", cp.slot, cp.traj, cp.nstore);
+  fflush(ofs);
+  fsync(fileno(ofs));
+  fclose(ofs);
+  if(rename(tmp_filename, index_filename) != 0) {
+    fprintf(stderr, "Error renaming %s to %s, checkpoint of trajectory %d not committed\n",
+            tmp_filename, index_filename, cp.traj);
+    return;
+  }
+  printf("# Checkpoint for trajectory %d committed.\n", cp.traj);
+  fflush(stdout);
+  return;
+}
+
+void finish_checkpoint() {
+  int ok;
+
+  if(!pending) return;
+#ifdef HAVE_PTHREAD
+  if(joinable) {
+    pthread_join(io_thread, NULL);
+    joinable = 0;
+  }
+#endif
+  ok = (cp_status == CP_WRITTEN);
+#ifdef TM_USE_MPI
+  int mok = ok;
+  MPI_Allreduce(&mok, &ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  if(ok) {
+    committed_slot = cp.slot;
+    if(g_proc_id == 0) {
+      commit_checkpoint();
+    }
+  }
+  else if(g_proc_id == 0) {
+    fprintf(stderr, "Warning: writing the checkpoint for trajectory %d failed, the previous one is kept\n", cp.traj);
+  }
+  pending = 0;
+  cp_status = CP_IDLE;
+  return;
+}
+
+void poll_checkpoint() {
+  int done = 1;
+
+  if(!pending) return;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock(&status_mutex);
+  done = (cp_status != CP_RUNNING);
+  pthread_mutex_unlock(&status_mutex);
+#endif
+#ifdef TM_USE_MPI
+  int mdone = done;
+  MPI_Allreduce(&mdone, &done, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  if(done) {
+    finish_checkpoint();
+  }
+  return;
+}
+
+void write_checkpoint(const int nstore, const int traj) {
+  int ok;
+
+  /* the snapshot buffer is still in use by the previous checkpoint */
+  if(pending && g_proc_id == 0 && g_debug_level > 0) {
+    printf("# Waiting for the checkpoint for trajectory %d to be written\n", cp.traj);
+    fflush(stdout);
+  }
+  finish_checkpoint();
+
+  ok = (alloc_checkpoint() == 0);
+#ifdef TM_USE_MPI
+  int mok = ok;
+  MPI_Allreduce(&mok, &ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  if(!ok) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Warning: not enough memory for the checkpoint, none written\n");
+    }
+    return;
+  }
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int ix = 0; ix < VOLUME; ix++) {
+    for(int mu = 0; mu < 4; mu++) {
+      _su3_assign(cp.gauge[4*ix + mu], g_gauge_field[ix][mu]);
+    }
+  }
+  rlxd_get(cp.rlxd);
+  rlxs_get(cp.rlxs);
+  cp.tune = Integrator.tune;
+  cp.no_timescales = Integrator.no_timescales;
+  for(int i = 0; i < Integrator.no_timescales; i++) {
+    cp.n_int[i] = Integrator.n_int[i];
+  }
+  cp.no_monomials = no_monomials;
+  for(int i = 0; i < no_monomials; i++) {
+    cp.timescale[i] = monomial_list[i].timescale;
+    cp.rat_order[i] = monomial_list[i].rat.order;
+    cp.stilde[2*i] = monomial_list[i].StildeMin;
+    cp.stilde[2*i+1] = monomial_list[i].StildeMax;
+  }
+  cp.traj = traj;
+  cp.nstore = nstore;
+  cp.slot = (committed_slot == 0) ? 1 : 0;
+  /* also initialises the crc tables, which must not be done concurrently */
+  DML_checksum_init(&cp.checksum);
+  pending = 1;
+  cp_status = CP_RUNNING;
+
+#ifdef HAVE_PTHREAD
+  if(pthread_create(&io_thread, NULL, &checkpoint_thread, NULL) == 0) {
+    joinable = 1;
+    return;
+  }
+  if(g_debug_level > 0) {
+    fprintf(stderr, "Warning: could not start the I/O thread on process %d, writing the checkpoint directly\n", g_proc_id);
+  }
+#endif
+  cp_status = (write_snapshot() == 0) ? CP_WRITTEN : CP_FAILED;
+#ifndef HAVE_PTHREAD
+  finish_checkpoint();
+#endif
+  return;
+}
+
+int read_checkpoint(int * const nstore, int * const traj) {
+  int index[3] = {-1, 0, 0}, ok;
+  FILE * ifs;
+
+  if(g_proc_id == 0 && (ifs = fopen(index_filename, "r")) != (FILE*)NULL) {
+    if(fscanf(ifs, "%d %d %d", &index[0], &index[1], &index[2]) != 3 || index[0] < 0 || index[0] > 1) {
+      fprintf(stderr, "Warning: %s is corrupt and ignored\n", index_filename);
+      index[0] = -1;
+    }
+    fclose(ifs);
+  }
+#ifdef TM_USE_MPI
+  MPI_Bcast(index, 3, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+  if(index[0] < 0) {
+    if(g_proc_id == 0) {
+      printf("# No checkpoint found, continuing from the gauge configuration\n");
+    }
+    return(0);
+  }
+  /* e.g. the run was continued meanwhile without checkpoints */
+  if(index[1] < *traj) {
+    if(g_proc_id == 0) {
+      printf("# Checkpoint for trajectory %d is older than trajectory %d, ignored\n", index[1], *traj);
+    }
+    return(0);
+  }
+
+  ok = (alloc_checkpoint() == 0) && (read_snapshot(index[0]) == 0)
+    && (cp.traj == index[1]) && (cp.nstore == index[2]);
+#ifdef TM_USE_MPI
+  int mok = ok;
+  MPI_Allreduce(&mok, &ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+  if(!ok) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Warning: the checkpoint for trajectory %d could not be read, continuing from the gauge configuration\n",
+              index[1]);
+    }
+    return(0);
+  }
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int ix = 0; ix < VOLUME; ix++) {
+    for(int mu = 0; mu < 4; mu++) {
+      _su3_assign(g_gauge_field[ix][mu], cp.gauge[4*ix + mu]);
+    }
+  }
+  gauge_field_changed();
+  rlxd_reset(cp.rlxd);
+  rlxs_reset(cp.rlxs);
+  /* the integrator setup is only changed at run time by the tuning, */
+  /* without tuning the input is taken as it is                      */
+  if(Integrator.tune != 0 && cp.no_timescales == Integrator.no_timescales
+     && cp.no_monomials == no_monomials) {
+    Integrator.tune = cp.tune;
+    for(int i = 0; i < cp.no_timescales; i++) {
+      Integrator.n_int[i] = cp.n_int[i];
+    }
+    for(int i = 0; i < cp.no_monomials; i++) {
+      monomial_list[i].timescale = cp.timescale[i];
+    }
+  }
+  *traj = cp.traj;
+  *nstore = cp.nstore;
+  committed_slot = index[0];
+  if(g_proc_id == 0) {
+    printf("# Continuing from the checkpoint for trajectory %d\n", cp.traj);
+    fflush(stdout);
+  }
+  return(1);
+}
+
+void read_checkpoint_rational() {
+  if(cp.no_monomials != no_monomials) return;
+  for(int i = 0; i < no_monomials; i++) {
+    restore_rational(i, cp.stilde[2*i], cp.stilde[2*i+1], cp.rat_order[i]);
+  }
+  return;
+}
+
+void free_checkpoint() {
+  finish_checkpoint();
+  if(cp.gauge != NULL) {
+    aligned_free(cp.gauge);
+  }
+  free(cp.rlxd);
+  free(cp.rlxs);
+  cp.gauge = NULL;
+  cp.rlxd = NULL;
+  cp.rlxs = NULL;
+  return;
+}
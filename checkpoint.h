@@ -0,0 +1,53 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* checkpoints of the HMC state (WriteCheckpoints = async)             */
+/*                                                                     */
+/* the gauge field, the states of ranlxd and ranlxs, the counters and  */
+/* the integrator setup (as changed by the tuning) and the rational    */
+/* approximations (as adapted) are copied by the main thread and       */
+/* written by an I/O thread while the next trajectory runs, every      */
+/* process into its own LIME container. A checkpoint is only used      */
+/* after all processes have written it completely, such that an        */
+/* interrupted run continues from the last complete one. The           */
+/* measurements of the integrator tuning start over after a restart.   */
+/* All functions are collective.                                       */
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+/* starts writing the state at the end of trajectory traj-1, nstore and */
+/* traj are the values to continue with, as in .nstore_counter          */
+void write_checkpoint(const int nstore, const int traj);
+/* commits the checkpoint being written if all processes are done       */
+void poll_checkpoint();
+/* waits for the checkpoint being written and commits it                */
+void finish_checkpoint();
+/* restores the state from the last complete checkpoint unless it is    */
+/* older than traj, returns 1 if the state was restored and 0 otherwise */
+/* the boundaries of the gauge field still have to be exchanged         */
+int read_checkpoint(int * const nstore, int * const traj);
+/* restores the rational approximations from the checkpoint read by    */
+/* read_checkpoint, after init_monomials                                */
+void read_checkpoint_rational();
+/* waits for the checkpoint being written and frees the buffers         */
+void free_checkpoint();
+
+#endif
@@ -0,0 +1,55 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* counter based random numbers (splitmix64): every stream is labelled by */
+/* a key and a position, e.g. the global lattice site, such that the      */
+/* numbers do not depend on the process grid, the number of threads or    */
+/* the order in which the sites are visited                                */
+
+#ifndef _COUNTER_RANDOM_H
+#define _COUNTER_RANDOM_H
+
+#include <stdint.h>
+#include "global.h"
+
+static inline uint64_t cr_mix(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return(z ^ (z >> 31));
+}
+
+/* uniform in (0,1] */
+static inline double cr_random(uint64_t * const state) {
+  *state += 0x9e3779b97f4a7c15ULL;
+  return(((double)(cr_mix(*state) >> 11) + 1.) * (1./9007199254740992.));
+}
+
+/* start of the stream of position n for key */
+static inline uint64_t cr_state(const uint64_t key, const uint64_t n) {
+  return(cr_mix(key ^ cr_mix(n)));
+}
+
+/* global lexicographic index of the local site ix */
+static inline uint64_t cr_global_site(const int ix) {
+  const uint64_t LXg = LX*g_nproc_x, LYg = LY*g_nproc_y, LZg = LZ*g_nproc_z;
+  return(((g_coord[ix][0]*LXg + g_coord[ix][1])*LYg + g_coord[ix][2])*LZg + g_coord[ix][3]);
+}
+
+#endif
@@ -61,6 +61,15 @@
 #define _default_little_solver_max_iter 20
 #define _default_little_solver_low_prec 1.0e-2
 #define _default_little_solver_high_prec 1.0e-10
+#define _default_little_mg_threelevel 0
+#define _default_little_mg_Nc 8
+#define _default_little_mg_aggregate 2
+#define _default_little_mg_cycle_type 1
+#define _default_little_mg_ncycle 2
+#define _default_little_mg_niter 4
+#define _default_little_mg_nsmooth 3
+#define _default_little_mg_coarse_max_iter 20
+#define _default_little_mg_coarse_prec 1.0e-2
 
 #define _default_Msap_precon 1
 #define _default_NiterMsap 3
@@ -71,6 +80,9 @@
 #define _default_NiterMsap_dflgen 4
 #define _default_NcycleMsap_dflgen 4
 #define _default_NsmoothMsap_dflgen 2
+#define _default_NsmoothMsap_dflupdate 1
+#define _default_dfl_subspace_reuse 0
+#define _default_dfl_subspace_filename ""
 #define _default_kappa_dflgen -1.
 #define _default_mu_dflgen -20.
 #define _default_kappa_dfl -1.
@@ -82,6 +94,9 @@
 #define _default_nd_solver_flag 15 // this is CGMMSND (see solver/solver_types.h)
 #define _default_startoption 0
 #define _default_Ntherm 0
+#define _default_Nhb 1
+#define _default_Nor 4
+#define _default_Nquenched 0
 #define _default_Nmeas 1
 #define _default_Nsave 9
 #define _default_write_cp_flag 1
@@ -110,11 +125,15 @@
 #define _default_g_eps_sq_force3 -1.
 #define _default_g_eps_sq_acc3 -1.
 #define _default_g_relative_precision_flag 0
+#define _default_g_multimass_groups 0
+#define _default_g_profiling 0
 #define _default_return_check_flag 0
 #define _default_return_check_interval 100
 #define _default_g_debug_level 1
 #define _default_g_csg_N 0
 #define _default_2mn_lambda 0.1938
+#define _default_tune_trajectories 10
+#define _default_tune_acceptance 0.8
 #define _default_source_format_flag 0
 #define _default_source_time_slice 0
 #define _default_automaticTS 0
@@ -139,6 +158,7 @@
 #define _default_phmc_pure_phmc 0
 #define _default_stilde_max 3.
 #define _default_stilde_min 0.01
+#define _default_rat_margin 0.05
 #define _default_degree_of_p 48
 #define _default_propagator_splitted 1
 #define _default_source_splitted 1
@@ -153,6 +173,7 @@
 #define _default_timescale 1
 #define _default_reweighting_flag 0
 #define _default_reweighting_samples 10
+#define _default_reweighting_batch_size 0
 #define _default_source_type_flag 0
 #define _default_no_samples 1
 #define _default_online_measurement_flag 1
@@ -171,6 +192,7 @@
 #define _default_g_C1ss 0.
 #define _default_g_C1tss 0.
 #define _default_g_C1tts 0.
+#define _default_g_sf_inc_wrap_sq 0
 #define _default_bc_flag 0
 /* default poly monomial values */
 #define _default_MDPolyDegree 123
@@ -193,6 +215,12 @@
 #define _default_mixcg_innereps 1.0e-6
 #define _default_mixcg_maxinnersolverit 5000
 
+/* default low mode deflation values */
+#define _default_lowmodes_nev 0
+#define _default_lowmodes_single 0
+#define _default_lowmodes_readwrite 0
+#define _default_lowmodes_prec 1.0e-6
+
 #define _default_use_preconditioning 0
 
 #define _default_use_qudainverter 0
@@ -0,0 +1,110 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include "global.h"
+#include "su3.h"
+#include "xchange/xchange.h"
+#include "init/init_gauge_field.h"
+#include "monomial/monomial.h"
+#include "derived_gauge_fields.h"
+
+static unsigned int halo_version = GAUGE_VERSION_NONE;
+static unsigned int gauge_32_version = GAUGE_VERSION_NONE;
+
+/* sw is identified by the gauge version and parameters it was  */
+/* computed with, sw_inv and the 32 bit copies by the generation */
+/* of sw they were computed from                                 */
+static unsigned int sw_version = GAUGE_VERSION_NONE, sw_generation = 0;
+static double sw_kappa = 0., sw_c_sw = 0.;
+static unsigned int sw_inv_generation = 0, sw_inv_serial = 0;
+static int sw_inv_type = -1, sw_inv_ieo = -1;
+static double sw_inv_mu = 0.;
+static unsigned int sw_32_generation = 0, sw_32_inv_serial = 0;
+
+void update_gauge_halo() {
+  if(halo_version == g_gauge_version) return;
+#ifdef TM_USE_MPI
+  xchange_gauge(g_gauge_field);
+#endif
+  halo_version = g_gauge_version;
+  return;
+}
+
+void update_gauge_field_32() {
+  if(gauge_32_version == g_gauge_version) return;
+  /* convert after the exchange, the boundary is needed as well */
+  update_gauge_halo();
+  convert_32_gauge_field(g_gauge_field_32, g_gauge_field, VOLUMEPLUSRAND + g_dbw2rand);
+  gauge_32_version = g_gauge_version;
+  return;
+}
+
+void update_gauge_fields_for_monomial(const int id) {
+  update_gauge_halo();
+  /* pure gauge monomials never use the 32 bit field */
+  if(monomial_list[id].type != GAUGE && monomial_list[id].type != SFGAUGE) {
+    update_gauge_field_32();
+  }
+  return;
+}
+
+int sw_term_current(const su3 ** const gf, const double kappa, const double c_sw) {
+  /* only g_gauge_field is tracked */
+  return(gf == (const su3 **) g_gauge_field && sw_version == g_gauge_version && 
+         sw_kappa == kappa && sw_c_sw == c_sw);
+}
+
+void sw_term_computed(const su3 ** const gf, const double kappa, const double c_sw) {
+  sw_generation++;
+  sw_version = (gf == (const su3 **) g_gauge_field) ? g_gauge_version : GAUGE_VERSION_NONE;
+  sw_kappa = kappa;
+  sw_c_sw = c_sw;
+  return;
+}
+
+int sw_inv_current(const int type, const int ieo, const double mu) {
+  return(sw_generation > 0 && sw_inv_generation == sw_generation && 
+         sw_inv_type == type && sw_inv_ieo == ieo && sw_inv_mu == mu);
+}
+
+void sw_inv_computed(const int type, const int ieo, const double mu) {
+  sw_inv_generation = sw_generation;
+  sw_inv_type = type;
+  sw_inv_ieo = ieo;
+  sw_inv_mu = mu;
+  sw_inv_serial++;
+  return;
+}
+
+int sw_32_current() {
+  return(sw_generation > 0 && sw_32_generation == sw_generation && 
+         sw_32_inv_serial == sw_inv_serial);
+}
+
+void sw_32_computed() {
+  sw_32_generation = sw_generation;
+  sw_32_inv_serial = sw_inv_serial;
+  return;
+}
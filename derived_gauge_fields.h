@@ -0,0 +1,65 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* bookkeeping for fields derived from g_gauge_field                 */
+/*                                                                    */
+/* every change of the links bumps a version counter, the boundary,  */
+/* the 32 bit copy and the clover fields sw, sw_inv (and their 32 bit */
+/* copies) remember the version they were computed from and are only  */
+/* recomputed on first use after a change. The backward copies are    */
+/* still handled by g_update_gauge_copy(_32) in the operators, these  */
+/* flags are set by gauge_field_changed                               */
+
+#ifndef _DERIVED_GAUGE_FIELDS_H
+#define _DERIVED_GAUGE_FIELDS_H
+
+#include "global.h"
+#include "su3.h"
+
+#define SW_INV_TM 0
+#define SW_INV_ND 1
+/* version of derived fields which were never computed */
+#define GAUGE_VERSION_NONE (~0u)
+
+/* to be called whenever the links of g_gauge_field were modified */
+/* inline, such that also the io library can use it               */
+static inline void gauge_field_changed() {
+  g_gauge_version++;
+  if(g_gauge_version == GAUGE_VERSION_NONE) g_gauge_version = 0;
+  g_update_gauge_copy = 1;
+  g_update_gauge_copy_32 = 1;
+}
+
+/* exchange the boundary of g_gauge_field if it is out of date */
+void update_gauge_halo();
+/* convert g_gauge_field to g_gauge_field_32 if it is out of date */
+void update_gauge_field_32();
+/* everything monomial id might read during derivative, acc or heatbath */
+void update_gauge_fields_for_monomial(const int id);
+
+/* clover term: sw_term(gf, kappa, c_sw), sw_invert and sw_invert_nd */
+int sw_term_current(const su3 ** const gf, const double kappa, const double c_sw);
+void sw_term_computed(const su3 ** const gf, const double kappa, const double c_sw);
+int sw_inv_current(const int type, const int ieo, const double mu);
+void sw_inv_computed(const int type, const int ieo, const double mu);
+int sw_32_current();
+void sw_32_computed();
+
+#endif
@@ -72,7 +72,11 @@ EXTERN int NO_OF_BISPINORFIELDS;
 
 EXTERN int g_update_gauge_copy;
 EXTERN int g_update_gauge_copy_32;
+/* bumped on every change of g_gauge_field, see derived_gauge_fields.h */
+EXTERN unsigned int g_gauge_version;
 EXTERN int g_relative_precision_flag;
+EXTERN int g_multimass_groups;
+EXTERN int g_profiling;
 EXTERN int g_debug_level;
 EXTERN int g_disable_IO_checks;
 
@@ -196,6 +200,9 @@ EXTERN int count00,count01,count10,count11,count20,count21;
 EXTERN double g_kappa, g_c_sw, g_beta;
 EXTERN double g_mu, g_mu1, g_mu2, g_mu3;
 EXTERN double g_rgi_C0, g_rgi_C1;
+/* Schroedinger functional: boundary timeslice, boundary coefficients */
+EXTERN int g_Tbsf, g_sf_inc_wrap_sq;
+EXTERN double g_eta, g_Ct, g_Cs, g_C1ss, g_C1tss, g_C1tts;
 
 /* Parameters for non-degenrate case */
 EXTERN double g_mubar, g_epsbar;
@@ -225,6 +232,9 @@ EXTERN int NcycleMsap;
 EXTERN int NiterMsap_dflgen;
 EXTERN int NcycleMsap_dflgen;
 EXTERN int NsmoothMsap_dflgen;
+EXTERN int NsmoothMsap_dflupdate;
+EXTERN int dfl_subspace_reuse;
+EXTERN char dfl_subspace_filename[500];
 EXTERN int usePL;
 EXTERN int little_solver;
 EXTERN int little_evenodd;
@@ -232,6 +242,15 @@ EXTERN int little_gmres_m_parameter;
 EXTERN double little_solver_low_prec;
 EXTERN double little_solver_high_prec;
 EXTERN int little_solver_max_iter;
+EXTERN int little_mg_threelevel;
+EXTERN int little_mg_Nc;
+EXTERN int little_mg_aggregate;
+EXTERN int little_mg_cycle_type;
+EXTERN int little_mg_ncycle;
+EXTERN int little_mg_niter;
+EXTERN int little_mg_nsmooth;
+EXTERN int little_mg_coarse_max_iter;
+EXTERN double little_mg_coarse_prec;
 
 #ifdef TM_USE_MPI
 EXTERN MPI_Status status;
@@ -66,8 +66,12 @@
 #include "solver/solver.h"
 #include "monomial/monomial.h"
 #include "integrator.h"
+#include "tune_integrator.h"
+#include "profiler.h"
 #include "sighandler.h"
 #include "meas/measurements.h"
+#include "quenched_update.h"
+#include "checkpoint.h"
 
 extern int nstore;
 
@@ -87,7 +91,7 @@ int main(int argc,char *argv[]) {
   char nstore_filename[50];
   char tmp_filename[50];
   char *input_filename = NULL;
-  int status = 0, accept = 0;
+  int status = 0, accept = 0, restored = 0;
   int j,ix,mu, trajectory_counter=0;
   unsigned int const io_max_attempts = 5; /* Make this configurable? */
   unsigned int const io_timeout = 5; /* Make this configurable? */
@@ -149,6 +153,9 @@ int main(int argc,char *argv[]) {
 #ifdef TM_USE_OMP
   init_openmp();
 #endif
+  if(g_profiling && init_profiler() != 0) {
+    exit(-1);
+  }
 
   DUM_DERI = 4;
   DUM_SOLVER = DUM_DERI+1;
@@ -302,9 +309,14 @@ int main(int argc,char *argv[]) {
   /* Initialise random number generator */
   start_ranlux(rlxd_level, random_seed^trajectory_counter);
 
+  /* continue from the last complete checkpoint, if there is one */
+  if(startoption == 3 && write_cp_flag == 2) {
+    restored = read_checkpoint(&nstore, &trajectory_counter);
+  }
+
   /* Set up the gauge field */
   /* continue and restart */
-  if(startoption==3 || startoption == 2) {
+  if((startoption==3 || startoption == 2) && !restored) {
     if(g_proc_id == 0) {
       printf("# Trying to read gauge field from file %s in %s precision.\n",
             gauge_input_filename, (gauge_precision_read_flag == 32 ? "single" : "double"));
@@ -333,6 +345,17 @@ int main(int argc,char *argv[]) {
 #ifdef TM_USE_MPI
   xchange_gauge(g_gauge_field);
 #endif
+
+  /* thermalise hot and cold starts with the quenched Wilson action */
+  if(startoption < 2 && Nquenched > 0) {
+    if(g_proc_id == 0) {
+      printf("# Thermalising start configuration with %d quenched updates at beta = %f\n", Nquenched, g_beta);
+      fflush(stdout);
+    }
+    for(j = 0; j < Nquenched; j++) {
+      quenched_update(g_beta, Nhb, Nor, random_seed, j);
+    }
+  }
     
   /*Convert to a 32 bit gauge field, after xchange*/
   convert_32_gauge_field(g_gauge_field_32, g_gauge_field, VOLUMEPLUSRAND + g_dbw2rand);
@@ -348,6 +371,10 @@ int main(int argc,char *argv[]) {
     fprintf(stderr, "Not enough memory for monomial pseudo fermion fields! Aborting...\n");
     exit(0);
   }
+  /* rational approximations as adapted before the checkpoint */
+  if(restored) {
+    read_checkpoint_rational();
+  }
 
   init_integrator();
 
@@ -410,6 +437,8 @@ int main(int argc,char *argv[]) {
     accept = update_tm(&plaquette_energy, &rectangle_energy, datafilename, 
 		       return_check, trajectory_counter>=Ntherm, trajectory_counter);
     Rate += accept;
+    prof_report(trajectory_counter);
+    tune_integrator();
 
     /* Save gauge configuration all Nsave times */
     if((Nsave !=0) && (trajectory_counter%Nsave == 0) && (trajectory_counter!=0)) {
@@ -514,6 +543,11 @@ int main(int argc,char *argv[]) {
         fclose(countfile);
       }
     }
+    else if(return_check && accept && g_proc_id == 0) {
+      /* the configuration written by the reversibility check is not needed */
+      sprintf(tmp_filename,".conf.t%05d.tmp",trajectory_counter);
+      remove(tmp_filename);
+    }
 
     /* online measurements */
     for(imeas = 0; imeas < no_measurements; imeas++){
@@ -526,6 +560,15 @@ int main(int argc,char *argv[]) {
       }
     }
 
+    /* asynchronous checkpoints instead of writing conf.save every trajectory, */
+    /* after the measurements, which also use random numbers                   */
+    if(write_cp_flag == 2) {
+      poll_checkpoint();
+      if((cp_interval > 0 && (trajectory_counter+1)%cp_interval == 0) || (j >= (Nmeas - 1))) {
+        write_checkpoint(nstore, trajectory_counter+1);
+      }
+    }
+
     if(g_proc_id == 0) {
       verbose = 1;
     }
@@ -555,9 +598,11 @@ int main(int argc,char *argv[]) {
     fclose(parameterfile);
   }
 
+  free_checkpoint();
 #ifdef TM_USE_OMP
   free_omp_accumulators();
 #endif
+  free_profiler();
   free_gauge_tmp();
   free_gauge_field();
   free_gauge_field_32();  
@@ -38,6 +38,12 @@ extern "C"
     unsigned int LX, LY, LZ, T, nstore, nsave, no_operators;
   } tmLQCD_lat_params;
 
+  /* even/odd spinor fields: sites of one parity on this process, sites */
+  /* to allocate per field (including the halo) and reals per site      */
+  typedef struct {
+    unsigned int sites, field_sites, site_reals;
+  } tmLQCD_eo_layout;
+
   typedef struct {
     unsigned int nproc, nproc_t, nproc_x, nproc_y, nproc_z, cart_id, proc_id, time_rank, omp_num_threads;
     unsigned int proc_coords[4];
@@ -47,8 +53,32 @@ extern "C"
   int tmLQCD_read_gauge(const int nconfig);
   int tmLQCD_invert(double * const propagator, double * const source,
 		    const int op_id, const int write_prop);
+  /* inverts operator op_id on nrhs lexicographic sources, sharing the  */
+  /* operator setup and the low mode deflation space between all of them */
+  int tmLQCD_invert_batch(double ** const propagators, double ** const sources,
+                          const int nrhs, const int op_id);
+
+  /* fields in the internal even/odd layout are passed to the inverter    */
+  /* without reordering, they must be allocated with                      */
+  /* tmLQCD_alloc_eo_field(_32) because of the halo. The site ix of the   */
+  /* lexicographic order used by tmLQCD_invert is stored at index[ix] of  */
+  /* the even (parity[ix] = 0) or the odd field, with 24 reals per site   */
+  /* ordered as spin, colour, real and imaginary part                     */
+  int tmLQCD_get_eo_layout(tmLQCD_eo_layout * layout);
+  int tmLQCD_get_eo_index_map(int * const parity, int * const index);
+  double * tmLQCD_alloc_eo_field();
+  float * tmLQCD_alloc_eo_field_32();
+  void tmLQCD_free_eo_field(void * field);
+  int tmLQCD_invert_eo(double * const prop_even, double * const prop_odd,
+                       double * const source_even, double * const source_odd, const int op_id);
+  int tmLQCD_invert_eo_32(float * const prop_even, float * const prop_odd,
+                          float * const source_even, float * const source_odd, const int op_id);
   int tmLQCD_finalise();
 
+  /* every call marks the gauge field as changed, such that all fields    */
+  /* derived from it (halo, 32 bit copy, clover term, ...) are recomputed */
+  /* a caller writing to the field through gf must call this function     */
+  /* again afterwards, before the next inversion                          */
   int tmLQCD_get_gauge_field_pointer(double ** gf);
   int tmLQCD_get_mpi_params(tmLQCD_mpi_params * params);
   int tmLQCD_get_lat_params(tmLQCD_lat_params * params);
@@ -25,12 +25,15 @@
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
+#include <errno.h>
 #include "global.h"
+#include "xchange/xchange.h"
 #include "monomial/monomial.h"
 #include "update_momenta.h"
 #include "update_gauge.h"
 #include "hamiltonian_field.h"
 #include "integrator.h"
+#include "derived_gauge_fields.h"
 
 integrator Integrator;
 
@@ -39,6 +42,15 @@ static const double omf4_theta = -0.03230286765269967;
 static const double omf4_vartheta = 0.08398315262876693;
 static const double omf4_lamb = 0.6822365335719091;
 
+/* force gradient integrator, lambda = 1/6 and chi = 1/72 */
+static const double fg_lambda = 1./6.;
+static const double fg_chi = 1./72.;
+/* links and momenta needed for the shifted gauge field */
+static su3 * fg_gauge_ = NULL;
+static su3 ** fg_gauge = NULL;
+static su3adj * fg_momenta_ = NULL;
+static su3adj ** fg_momenta = NULL;
+
 /* second order minimal norm integration scheme */
 void integrate_2mn(const double tau, const int S, const int halfstep);
 /* second order minimal norm integration scheme in velocity version */
@@ -47,19 +59,19 @@ void integrate_2mnp(const double tau, const int S, const int halfstep);
 void integrate_leap_frog(const double tau, const int S, const int halfstep);
 /* fourth order OMF scheme */
 void integrate_omf4(const double tau, const int S, const int halfstep);
+/* Omelyan type force gradient scheme */
+void integrate_fg(const double tau, const int S, const int halfstep);
+static int init_fg_fields();
 /* half step function */
 void dohalfstep(const double tau, const int S);
 
 /* function to initialise the integrator, to be called once at the beginning */
 
 int init_integrator() {
-  int i, ts;
+  int i;
   Integrator.hf.gaugefield = (su3 **) NULL;
   Integrator.hf.momenta = (su3adj **) NULL;
   Integrator.hf.derivative = (su3adj **) NULL;
-  for(i = 0; i < 10; i++) {
-    Integrator.no_mnls_per_ts[i] = 0;
-  }
   if(Integrator.type[Integrator.no_timescales-1] == MN2p) {
     for(i = 0; i < Integrator.no_timescales; i++) {
       Integrator.type[i] = MN2p;
@@ -77,9 +89,27 @@ int init_integrator() {
       else if(Integrator.type[i] == OMF4) {
 	Integrator.integrate[i] = &integrate_omf4;
       }
+      else if(Integrator.type[i] == FG) {
+	Integrator.integrate[i] = &integrate_fg;
+	if(init_fg_fields() != 0) {
+	  fprintf(stderr, "Not enough memory for the force gradient integrator! Aborting...\n");
+	  exit(-1);
+	}
+      }
     }
   }
 
+  return(integrator_set_timescales());
+}
+
+/* distributes the monomials over the timescales, also used when */
+/* the tuning changes the timescale assignment                    */
+
+int integrator_set_timescales() {
+  int i, ts;
+  for(i = 0; i < 10; i++) {
+    Integrator.no_mnls_per_ts[i] = 0;
+  }
   for(i = 0; i < no_monomials; i++) {
     ts = monomial_list[i].timescale;
     if(ts < Integrator.no_timescales && ts > -1) {
@@ -244,6 +274,129 @@ void integrate_2mn(const double tau, const int S, const int halfstep) {
   }
 }
 
+static int init_fg_fields() {
+  if(fg_gauge != NULL) return(0);
+  if((void*)(fg_gauge = (su3**)calloc(VOLUME, sizeof(su3*))) == NULL ||
+     (void*)(fg_gauge_ = (su3*)calloc(4*VOLUME+1, sizeof(su3))) == NULL ||
+     (void*)(fg_momenta = (su3adj**)calloc(VOLUME, sizeof(su3adj*))) == NULL ||
+     (void*)(fg_momenta_ = (su3adj*)calloc(4*VOLUME+1, sizeof(su3adj))) == NULL) {
+    fprintf(stderr, "malloc errno : %d\n", errno);
+    errno = 0;
+    return(1);
+  }
+#if (defined SSE || defined SSE2 || defined SSE3)
+  fg_gauge[0] = (su3*)(((unsigned long int)(fg_gauge_)+ALIGN_BASE)&~ALIGN_BASE);
+  fg_momenta[0] = (su3adj*)(((unsigned long int)(fg_momenta_)+ALIGN_BASE)&~ALIGN_BASE);
+#else
+  fg_gauge[0] = fg_gauge_;
+  fg_momenta[0] = fg_momenta_;
+#endif
+  for(int i = 1; i < VOLUME; i++) {
+    fg_gauge[i] = fg_gauge[i-1]+4;
+    fg_momenta[i] = fg_momenta[i-1]+4;
+  }
+  return(0);
+}
+
+/* momentum update with the force gradient term on timescale S     */
+/* instead of computing the Hessian the force is evaluated on the  */
+/* shifted gauge field U' = exp(-2 chi eps^3/step F(U)) U and the  */
+/* momenta are updated with step * F(U'), cf. arXiv:1111.5059      */
+static void update_momenta_fg(const int S, const double step, const double eps) {
+  integrator * itgr = &Integrator;
+  hamiltonian_field_t fg_hf = itgr->hf;
+  const double fg_step = 2.*fg_chi*eps*eps*eps/step;
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int i = 0; i < VOLUME; i++) {
+    for(int mu = 0; mu < 4; mu++) {
+      _zero_su3adj(fg_momenta[i][mu]);
+      _su3_assign(fg_gauge[i][mu], itgr->hf.gaugefield[i][mu]);
+    }
+  }
+
+  /* fg_momenta = -fg_step F(U) and U -> exp(fg_momenta) U */
+  fg_hf.momenta = fg_momenta;
+  update_momenta(itgr->mnls_per_ts[S], fg_step, itgr->no_mnls_per_ts[S], &fg_hf);
+  update_gauge(1., &fg_hf);
+
+  update_momenta(itgr->mnls_per_ts[S], step, itgr->no_mnls_per_ts[S], &itgr->hf);
+
+  /* back to the unshifted links */
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int i = 0; i < VOLUME; i++) {
+    for(int mu = 0; mu < 4; mu++) {
+      _su3_assign(itgr->hf.gaugefield[i][mu], fg_gauge[i][mu]);
+    }
+  }
+  if(itgr->hf.gaugefield == g_gauge_field) {
+    gauge_field_changed();
+  }
+  else {
+#ifdef TM_USE_MPI
+    xchange_gauge(itgr->hf.gaugefield);
+#endif
+    g_update_gauge_copy = 1;
+    g_update_gauge_copy_32 = 1;
+  }
+  return;
+}
+
+/* same structure as integrate_2mn with lambda = 1/6, but the */
+/* middle momentum update includes the force gradient term    */
+void integrate_fg(const double tau, const int S, const int halfstep) {
+  int i,j=0;
+  integrator * itgr = &Integrator;
+  double eps,
+    oneminus2lambda = (1.-2.*fg_lambda);
+
+  if(S == itgr->no_timescales-1) {
+    dohalfstep(tau, S);
+  }
+  
+  eps = tau/((double)itgr->n_int[S]);
+  if(S == 0) {
+
+    for(j = 1; j < itgr->n_int[0]; j++) {
+      update_gauge(0.5*eps, &itgr->hf);
+      update_momenta_fg(0, oneminus2lambda*eps, eps);
+      update_gauge(0.5*eps, &itgr->hf);
+      update_momenta(itgr->mnls_per_ts[0], 2.*fg_lambda*eps, itgr->no_mnls_per_ts[0], &itgr->hf);
+    }
+    update_gauge(0.5*eps, &itgr->hf);
+    update_momenta_fg(0, oneminus2lambda*eps, eps);
+    update_gauge(0.5*eps, &itgr->hf);
+    if(halfstep != 1) {
+      update_momenta(itgr->mnls_per_ts[0], 2*fg_lambda*eps, itgr->no_mnls_per_ts[0], &itgr->hf);
+    }
+  }
+  else {
+    for(i = 1; i < itgr->n_int[S]; i++){
+      itgr->integrate[S-1](eps/2., S-1, 0);
+      update_momenta_fg(S, oneminus2lambda*eps, eps);
+      itgr->integrate[S-1](eps/2., S-1, 0);
+      update_momenta(itgr->mnls_per_ts[S], 2*fg_lambda*eps, itgr->no_mnls_per_ts[S], &itgr->hf);
+    }
+    itgr->integrate[S-1](eps/2., S-1, 0);
+    update_momenta_fg(S, oneminus2lambda*eps, eps);
+    if(S == itgr->no_timescales-1) {
+      itgr->integrate[S-1](eps/2., S-1, 1);
+    }
+    else itgr->integrate[S-1](eps/2., S-1, halfstep);
+    if(halfstep != 1 && S != itgr->no_timescales-1) {
+      update_momenta(itgr->mnls_per_ts[S], 2*fg_lambda*eps, itgr->no_mnls_per_ts[S], &itgr->hf);
+    }
+  }
+
+  if(S == itgr->no_timescales-1) {
+    dohalfstep(tau, S);
+  }
+}
+
 void integrate_2mnp(const double tau, const int S, const int halfstep) {
   int i;
   integrator * itgr = &Integrator;
@@ -334,6 +487,10 @@ void dohalfstep(const double tau, const int S) {
       update_momenta(itgr->mnls_per_ts[i], omf4_vartheta*eps, itgr->no_mnls_per_ts[i], &itgr->hf);
       eps /= ((double)itgr->n_int[i-1])/omf4_rho;
     }
+    else if(itgr->type[i] == FG) {
+      update_momenta(itgr->mnls_per_ts[i], fg_lambda*eps, itgr->no_mnls_per_ts[i], &itgr->hf);
+      eps /= ((double)itgr->n_int[i-1])*2;
+    }
   }
   if(itgr->type[0] == LEAPFROG) {
     update_momenta(itgr->mnls_per_ts[0], 0.5*eps, itgr->no_mnls_per_ts[0], &itgr->hf);
@@ -344,5 +501,8 @@ void dohalfstep(const double tau, const int S) {
   else if(itgr->type[0] == OMF4) {
     update_momenta(itgr->mnls_per_ts[0], omf4_vartheta*eps, itgr->no_mnls_per_ts[0], &itgr->hf);
   }
+  else if(itgr->type[0] == FG) {
+    update_momenta(itgr->mnls_per_ts[0], fg_lambda*eps, itgr->no_mnls_per_ts[0], &itgr->hf);
+  }
   return;
 }
@@ -31,6 +31,7 @@
 #define MN2 6
 #define MN2p 7
 #define OMF4 8
+#define FG 9
 
 typedef void (*integratefk)(const double, const int, const int);
 
@@ -43,6 +44,12 @@ typedef struct {
   int no_timescales;
   /* monitor forces */
   int monitor_forces;
+  /* tune timescales and steps: 0 off, 1 propose only, 2 apply */
+  int tune;
+  /* number of trajectories to collect before tuning */
+  int tune_trajectories;
+  /* acceptance rate aimed at by the tuning */
+  double tune_acceptance;
   /* steps per timescale */
   int n_int[10];
   /* trajectory length */
@@ -62,6 +69,8 @@ extern integrator Integrator;
 /* all following functions are currently defined in integrator.c */
 /* function to initialise the integrator, to be called once at the beginning */
 int init_integrator();
+/* distributes the monomials over the timescales according to monomial_list[].timescale */
+int integrator_set_timescales();
 /* function to set the gauge and momenta fields for the integration */
 void integrator_set_fields(hamiltonian_field_t * hf);
 /* and unsets again (to NULL pointer ) */
@@ -88,6 +88,9 @@
 #endif
 #include "meas/measurements.h"
 #include "source_generation.h"
+#include "derived_gauge_fields.h"
+#include "profiler.h"
+#include "solver/eigenspace.h"
 
 extern int nstore;
 int check_geometry();
@@ -101,6 +104,7 @@ int main(int argc, char *argv[])
 {
   FILE *parameterfile = NULL;
   int j, i, ix = 0, isample = 0, op_id = 0;
+  int op_group[max_no_operators], group_ids[max_no_operators], group_n = 0;
   char datafilename[206];
   char parameterfilename[206];
   char conf_filename[50];
@@ -154,6 +158,9 @@ int main(int argc, char *argv[])
 #ifdef TM_USE_OMP
   init_openmp();
 #endif
+  if(g_profiling && init_profiler() != 0) {
+    exit(-1);
+  }
 
   /* this DBW2 stuff is not needed for the inversion ! */
   if (g_dflgcr_flag == 1) {
@@ -258,6 +265,7 @@ int main(int argc, char *argv[])
   phmc_invmaxev = 1.;
 
   init_operators();
+  init_operator_groups(op_group);
 
   /* list and initialize measurements*/
   if(g_proc_id == 0) {
@@ -323,7 +331,7 @@ int main(int argc, char *argv[])
       params_smear.iterations = stout_no_iter;
 /*       if (stout_smear((su3_tuple*)(g_gauge_field[0]), &params_smear, (su3_tuple*)(g_gauge_field[0])) != 0) */
 /*         exit(1) ; */
-      g_update_gauge_copy = 1;
+      gauge_field_changed();
       plaquette_energy = measure_plaquette( (const su3**) g_gauge_field);
 
       if (g_cart_id == 0) {
@@ -331,6 +339,8 @@ int main(int argc, char *argv[])
         fflush(stdout);
       }
     }
+    /* stored low modes belong to the previous gauge field */
+    eigenspace_reset(nstore);
 
     /* if any measurements are defined in the input file, do them here */
     measurement * meas;
@@ -386,6 +396,13 @@ int main(int argc, char *argv[])
       fprintf(stdout, "#\n"); /*Indicate starting of the operator part*/
     }
     for(op_id = 0; op_id < no_operators; op_id++) {
+      /* inverted together with its group leader */
+      if(op_group[op_id] != op_id) continue;
+      group_n = 0;
+      for(i = op_id; i < no_operators; i++) {
+        if(op_group[i] == op_id) group_ids[group_n++] = i;
+      }
+
       boundary(operator_list[op_id].kappa);
       g_kappa = operator_list[op_id].kappa; 
       g_mu = operator_list[op_id].mu;
@@ -421,6 +438,10 @@ int main(int argc, char *argv[])
           /* 0-3 in case of 1 flavour  */
           /* 0-7 in case of 2 flavours */
           prepare_source(nstore, isample, ix, op_id, read_source_flag, source_location);
+          if(group_n > 1) {
+            op_invert_multimass(group_ids, group_n, index_start, 1);
+            continue;
+          }
           //randmize initial guess for eigcg if needed-----experimental
           if( (operator_list[op_id].solver == INCREIGCG) && (operator_list[op_id].solver_params.eigcg_rand_guess_opt) ){ //randomize the initial guess
               gaussian_volume_source( operator_list[op_id].prop0, operator_list[op_id].prop1,isample,ix,0); //need to check this
@@ -441,12 +462,14 @@ int main(int argc, char *argv[])
       }
 
     }
+    prof_report(nstore);
     nstore += Nsave;
   }
 
 #ifdef TM_USE_OMP
   free_omp_accumulators();
 #endif
+  free_profiler();
   free_blocks();
   free_dfl_subspace();
   free_gauge_field();
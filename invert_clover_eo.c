@@ -50,6 +50,7 @@
 #include"invert_clover_eo.h"
 #include "solver/dirac_operator_eigenvectors.h"
 #include "solver/dfl_projector.h"
+#include "solver/eigenspace.h"
 #ifdef QUDA
 #  include "quda_interface.h"
 #endif
@@ -63,6 +64,8 @@ int invert_clover_eo(spinor * const Even_new, spinor * const Odd_new,
                      su3 *** gf, matrix_mult Qsq, matrix_mult Qm,
                      const ExternalInverter inverter, const SloppyPrecision sloppy, const CompressionType compression) {
   int iter;
+  /* rescaled by the low mode deflation for relative precision */
+  double eps_sq = precision;
 
   if(even_odd_flag) {  
     if(g_proc_id == 0 && g_debug_level > 0) {
@@ -96,11 +99,15 @@ int invert_clover_eo(spinor * const Even_new, spinor * const Odd_new,
              g_mu/2./g_kappa, g_kappa, g_c_sw);
       fflush(stdout);
     }
+    if(solver_flag == CG || solver_flag == MIXEDCG || solver_flag == RGMIXEDCG) {
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, Qsq);
+    }
     if(solver_flag == CG) {
       if(g_proc_id == 0) {printf("# Using CG!\n"); fflush(stdout);}
       iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, 
-                    precision, rel_prec, 
+                    eps_sq, rel_prec, 
                     VOLUME/2, Qsq);
+      eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qm(Odd_new, Odd_new);
     }
     else if(solver_flag == INCREIGCG){
@@ -113,13 +120,15 @@ int invert_clover_eo(spinor * const Even_new, spinor * const Odd_new,
     }
     else if(solver_flag == MIXEDCG){
       iter = mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, 
-			  max_iter, precision, rel_prec, 
+			  max_iter, eps_sq, rel_prec, 
                           VOLUME/2, &Qsw_pm_psi, &Qsw_pm_psi_32);
+      eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qm(Odd_new, Odd_new);
     }
     else if(solver_flag == RGMIXEDCG){
-      iter = rg_mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, max_iter, precision, rel_prec,
+      iter = rg_mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, max_iter, eps_sq, rel_prec,
 			                     VOLUME/2, &Qsw_pm_psi, &Qsw_pm_psi_32);
+      eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qm(Odd_new, Odd_new);
     }
     else{
@@ -49,6 +49,7 @@
 #include"solver/dfl_projector.h"
 #include"invert_eo.h"
 #include "solver/dirac_operator_eigenvectors.h"
+#include "solver/eigenspace.h"
 /* FIXME temporary includes and declarations until IO and interface for invert and CGMMS are generelized */
 #include "init/init_spinor_field.h"
 #include <io/params.h>
@@ -64,6 +65,7 @@ static void cgmms_write_props(spinor ** const P, double const * const extra_mass
 #include"GPU/cudadefs.h"
 #include"temporalgauge.h"
 #include"measure_gauge_action.h"
+#include"derived_gauge_fields.h"
 
 extern int mixed_solve (spinor * const P, spinor * const Q, const int max_iter, 
                         double eps, const int rel_prec,const int N);
@@ -83,6 +85,8 @@ int invert_eo(spinor * const Even_new, spinor * const Odd_new,
               const ExternalInverter inverter, const SloppyPrecision sloppy, const CompressionType compression )  {
 
   int iter = 0;
+  /* rescaled by the low mode deflation for relative precision */
+  double eps_sq = precision;
 
 #ifdef QUDA
   if( inverter==QUDA_INVERTER ) {
@@ -194,7 +198,9 @@ int invert_eo(spinor * const Even_new, spinor * const Odd_new,
       /* Here we invert the hermitean operator squared */
       gamma5(g_spinor_field[DUM_DERI], g_spinor_field[DUM_DERI], VOLUME/2);  
       if(g_proc_id == 0) {printf("# Using PCG!\n"); fflush(stdout);}
-      iter = pcg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, precision, rel_prec, VOLUME/2, &Qtm_pm_psi);
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+      iter = pcg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, eps_sq, rel_prec, VOLUME/2, &Qtm_pm_psi);
+      if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qtm_minus_psi(Odd_new, Odd_new);
     }
     else if(solver_flag == INCREIGCG) {
@@ -210,16 +216,20 @@ int invert_eo(spinor * const Even_new, spinor * const Odd_new,
       /* Here we invert the hermitean operator squared */
       gamma5(g_spinor_field[DUM_DERI], g_spinor_field[DUM_DERI], VOLUME/2);
       if(g_proc_id == 0) {printf("# Using Mixed Precision CG!\n"); fflush(stdout);}
-      iter = mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, max_iter, precision, rel_prec, 
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+      iter = mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, max_iter, eps_sq, rel_prec, 
                           VOLUME/2, &Qtm_pm_psi, &Qtm_pm_psi_32);
+      if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qtm_minus_psi(Odd_new, Odd_new);
     }
     else if(solver_flag == RGMIXEDCG) {
       /* Here we invert the hermitean operator squared */
       gamma5(g_spinor_field[DUM_DERI], g_spinor_field[DUM_DERI], VOLUME/2);
       if(g_proc_id == 0) {printf("# Using Mixed Precision CG!\n"); fflush(stdout);}
-      iter = rg_mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, max_iter, precision, rel_prec,
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+      iter = rg_mixed_cg_her(Odd_new, g_spinor_field[DUM_DERI], solver_params, max_iter, eps_sq, rel_prec,
                              VOLUME/2, &Qtm_pm_psi, &Qtm_pm_psi_32);
+      if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qtm_minus_psi(Odd_new, Odd_new);
     }
     else if(solver_flag == CG) {
@@ -236,12 +246,16 @@ int invert_eo(spinor * const Even_new, spinor * const Odd_new,
         iter = mixed_solve_eo(Odd_new, g_spinor_field[DUM_DERI], max_iter,   precision, rel_prec, VOLUME/2);
       }
       else {
-        iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, precision, rel_prec, VOLUME/2, &Qtm_pm_psi);
+        eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+        iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, eps_sq, rel_prec, VOLUME/2, &Qtm_pm_psi);
+        if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
         Qtm_minus_psi(Odd_new, Odd_new);
       }
 #else        
-      iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, precision, rel_prec, 
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+      iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, eps_sq, rel_prec, 
                     VOLUME/2, &Qtm_pm_psi);
+      if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qtm_minus_psi(Odd_new, Odd_new);
 #endif /*HAVE_GPU*/
     }
@@ -262,18 +276,26 @@ int invert_eo(spinor * const Even_new, spinor * const Odd_new,
         fflush(stdout);}
       iter = mixed_solve_eo(Odd_new, g_spinor_field[DUM_DERI], max_iter,   precision, rel_prec, VOLUME/2);
 #else
-      iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, precision, rel_prec, VOLUME/2, &Qtm_pm_psi);
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+      iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, eps_sq, rel_prec, VOLUME/2, &Qtm_pm_psi);
+      if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qtm_minus_psi(Odd_new, Odd_new);
 #endif
     }
     
     /* In case of failure, redo with CG */
     if(iter == -1 && solver_flag !=CG) {
+      /* the solvers above modify the source in different ways  */
+      /* (deflated or not), so rebuild it from scratch          */
+      Hopping_Matrix(OE, g_spinor_field[DUM_DERI], Even_new); 
+      assign_mul_add_r(g_spinor_field[DUM_DERI], +1., Odd, VOLUME/2);
       /* Here we invert the hermitean operator squared */
-      mul_one_pm_imu(g_spinor_field[DUM_DERI], +1.); 
       gamma5(g_spinor_field[DUM_DERI], g_spinor_field[DUM_DERI], VOLUME/2);  
       if(g_proc_id == 0) {printf("# Redoing it with CG!\n"); fflush(stdout);}
-      iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, precision, rel_prec, VOLUME/2, &Qtm_pm_psi);
+      eps_sq = precision;
+      eigenspace_deflate_source(g_spinor_field[DUM_DERI], &eps_sq, rel_prec, VOLUME/2, &solver_params, &Qtm_pm_psi);
+      iter = cg_her(Odd_new, g_spinor_field[DUM_DERI], max_iter, eps_sq, rel_prec, VOLUME/2, &Qtm_pm_psi);
+      if(iter >= 0) eigenspace_add_lowmode(Odd_new, VOLUME/2);
       Qtm_minus_psi(Odd_new, Odd_new);
     }
     
@@ -296,7 +318,7 @@ int invert_eo(spinor * const Even_new, spinor * const Odd_new,
       /*apply_inv_gtrafo(g_gauge_field, g_trafo);*/
       /* copy back the saved original field located in g_tempgauge_field -> update necessary*/
       copy_gauge_field(g_gauge_field, g_tempgauge_field);
-      g_update_gauge_copy = 1;
+      gauge_field_changed();
     
     
       plaquette = measure_plaquette(g_gauge_field);
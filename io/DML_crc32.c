@@ -167,32 +167,66 @@ local uLongf crc_table[256] = {
 #endif
 
 /* =========================================================================
- * This function can be used by asm versions of crc32()
+ * Tables for slicing-by-8: crc_table_8[k-1][n] is the CRC of byte n
+ * followed by k zero bytes, such that eight bytes are processed with
+ * eight independent table lookups. Built from crc_table on first use.
  */
-#if 0 /* we don't need it -- avoid unused code warnings */
-static uLongf *get_crc_table()
+local uLongf crc_table_8[7][256];
+local volatile int crc_table_8_empty = 1;
+
+local void make_crc_table_8()
 {
+  int n, k;
+  uLong c;
 #ifdef DYNAMIC_CRC_TABLE
   if (crc_table_empty) make_crc_table();
 #endif
-  return (uLongf *)crc_table;
+  for (n = 0; n < 256; n++)
+  {
+    c = crc_table[n];
+    for (k = 0; k < 7; k++)
+    {
+      c = crc_table[c & 0xff] ^ (c >> 8);
+      crc_table_8[k][n] = c;
+    }
+  }
+  crc_table_8_empty = 0;
+}
+
+/* to be called outside of parallel regions, DML_checksum_init does */
+void DML_crc32_init()
+{
+  if (crc_table_8_empty) make_crc_table_8();
 }
-#endif
 
 /* ========================================================================= */
 #define DO1(buf) crc = crc_table[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
-#define DO2(buf)  DO1(buf); DO1(buf);
-#define DO4(buf)  DO2(buf); DO2(buf);
-#define DO8(buf)  DO4(buf); DO4(buf);
+
+/* the words are assembled byte by byte, which is independent of the
+   endianness of the host and compiles to plain loads on little endian */
+#define DO8(buf) \
+  one = crc ^ ((uLong)buf[0] | (uLong)buf[1] << 8 | (uLong)buf[2] << 16 | (uLong)buf[3] << 24); \
+  two = (uLong)buf[4] | (uLong)buf[5] << 8 | (uLong)buf[6] << 16 | (uLong)buf[7] << 24; \
+  crc = crc_table_8[6][one & 0xff] ^ crc_table_8[5][(one >> 8) & 0xff] ^ \
+        crc_table_8[4][(one >> 16) & 0xff] ^ crc_table_8[3][one >> 24] ^ \
+        crc_table_8[2][two & 0xff] ^ crc_table_8[1][(two >> 8) & 0xff] ^ \
+        crc_table_8[0][(two >> 16) & 0xff] ^ crc_table[two >> 24]; \
+  buf += 8;
 
 /* ========================================================================= */
 uint32_t DML_crc32(uint32_t crc, const unsigned char *buf, size_t len)
 {
+    uLong one, two;
     if (buf == Z_NULL) return 0L;
-#ifdef DYNAMIC_CRC_TABLE
-    if (crc_table_empty)
-      make_crc_table();
+    if (crc_table_8_empty)
+    {
+#ifdef TM_USE_OMP
+#pragma omp critical(dml_crc32_table)
 #endif
+      {
+        if (crc_table_8_empty) make_crc_table_8();
+      }
+    }
     crc = crc ^ 0xffffffffL;
     while (len >= 8)
     {
@@ -9,6 +9,9 @@
 #ifdef TM_USE_MPI
 # include <mpi.h>
 #endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "global.h"
 #include"dml.h"
 
@@ -23,6 +26,7 @@
 void DML_checksum_init(DML_Checksum *checksum){
   checksum->suma = 0;
   checksum->sumb = 0;
+  DML_crc32_init();
 }
 
 
@@ -60,6 +64,35 @@ void DML_checksum_accum(DML_Checksum *checksum, DML_SiteRank rank,
 }
 
 
+/* Accumulate checksums of the local lattice                          */
+/* the rotated crc32 sums of the sites are combined with XOR, which   */
+/* is independent of the order, such that the sites are distributed   */
+/* over the threads and the partial sums are reduced at the end       */
+void DML_checksum_accum_local(DML_Checksum *checksum, char *buf, size_t size){
+  const DML_SiteRank gx = (DML_SiteRank)LX*g_nproc_x, gy = (DML_SiteRank)LY*g_nproc_y;
+  const DML_SiteRank gz = (DML_SiteRank)LZ*g_nproc_z;
+  const int nrows = T*LZ*LY;
+  uint32_t suma = 0, sumb = 0;
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for reduction(^ : suma, sumb)
+#endif
+  for(int row = 0; row < nrows; row++) {
+    const int y = row % LY, z = (row / LY) % LZ, t = row / (LY*LZ);
+    DML_SiteRank rank = ((((DML_SiteRank)g_proc_coords[0]*T + t)*gz + g_proc_coords[3]*LZ + z)*gy
+                         + g_proc_coords[2]*LY + y)*gx + g_proc_coords[1]*LX;
+    char * current = buf + (size_t)row*LX*size;
+    for(int x = 0; x < LX; x++, rank++, current += size) {
+      const uint32_t work = DML_crc32(0, (unsigned char*)current, size);
+      const DML_SiteRank rank29 = rank % 29, rank31 = rank % 31;
+      suma ^= work<<rank29 | work>>(32-rank29);
+      sumb ^= work<<rank31 | work>>(32-rank31);
+    }
+  }
+  checksum->suma ^= suma;
+  checksum->sumb ^= sumb;
+}
+
 /* Combine checksums over all nodes */
 void DML_checksum_combine(DML_Checksum *checksum){
   DML_global_xor(&checksum->suma);
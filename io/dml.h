@@ -50,12 +50,18 @@ int DML_global_xor(uint32_t *x) ;
 void DML_checksum_accum(DML_Checksum *checksum, DML_SiteRank rank,
                         char *buf, size_t size) ;
 
+/* accumulates the checksum of all local sites at once, buf holds */
+/* the sites of this process in the order t, z, y, x (x fastest)   */
+/* with size bytes per site, as used by the lemon I/O routines     */
+void DML_checksum_accum_local(DML_Checksum *checksum, char *buf, size_t size) ;
+
 void DML_checksum_combine(DML_Checksum *checksum) ;
 
 
 void DML_checksum_peq(DML_Checksum *total, DML_Checksum *checksum) ;
 
 uint32_t DML_crc32(uint32_t crc, const unsigned char *buf, size_t len);
+void DML_crc32_init();
 
 #endif
 
@@ -19,6 +19,7 @@
  ***********************************************************************/
 
 #include "gauge.ih"
+#include "derived_gauge_fields.h"
 
 extern int gauge_precision_read_flag;
 paramsGaugeInfo GaugeInfo = { 0., 0, {0,0}, NULL, NULL};
@@ -27,7 +28,6 @@ int read_gauge_field(char * filename, su3 ** const gf) {
   int status = 0;
   char *header_type = NULL;
   READER *reader = NULL;
-
   paramsIldgFormat ildgformat_read;
   paramsIldgFormat *ildgformat_input;
   DML_Checksum checksum_read;
@@ -39,6 +39,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
   char *checksum_string = NULL;
   char *ildgformat_string = NULL;
 
+  prof_begin("read_gauge_field");
   construct_reader(&reader, filename);
   GaugeInfo.gaugeRead = 0;
   ildgformat_input = construct_paramsIldgFormat(gauge_precision_read_flag);
@@ -64,6 +65,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
         fprintf(stderr, "Unable to verify integrity of the gauge field data.\n");
 	destruct_reader(reader);
 	free(ildgformat_input);
+        prof_end("read_gauge_field", 0., 0.);
         return(-1);
       }
       gauge_binary_status = read_binary_gauge_data(reader, &checksum_calc, ildgformat_input, gf);
@@ -71,6 +73,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
         fprintf(stderr, "Gauge file reading failed at binary part, unable to proceed.\n");
 	destruct_reader(reader);
 	free(ildgformat_input);
+        prof_end("read_gauge_field", 0., 0.);
         return(-1);
       }
       gauge_read_flag = 1;
@@ -89,6 +92,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
           fprintf(stderr, "Unable to verify integrity of the gauge field data.\n");
 	  destruct_reader(reader);
 	  free(ildgformat_input);
+          prof_end("read_gauge_field", 0., 0.);
           return(-1);
         }
       }
@@ -111,6 +115,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
           fprintf(stderr, "Unable to verify integrity of the gauge field data.\n");
 	  destruct_reader(reader);
 	  free(ildgformat_input);
+          prof_end("read_gauge_field", 0., 0.);
           return(-1);
         }
       }
@@ -125,6 +130,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
       fprintf(stderr, "Unable to verify gauge field size or precision.\n");
       destruct_reader(reader);
       free(ildgformat_input);
+      prof_end("read_gauge_field", 0., 0.);
       return(-1);
     }
 
@@ -133,6 +139,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
       fprintf(stderr, "No gauge field was read, unable to proceed.\n");
       destruct_reader(reader);
       free(ildgformat_input);
+      prof_end("read_gauge_field", 0., 0.);
       return(-1);
     }
 
@@ -141,6 +148,7 @@ int read_gauge_field(char * filename, su3 ** const gf) {
       fprintf(stderr, "Unable to verify integrity of gauge field data.\n");
       destruct_reader(reader);
       free(ildgformat_input);
+      prof_end("read_gauge_field", 0., 0.);
       return(-1);
     }
 
@@ -156,12 +164,14 @@ int read_gauge_field(char * filename, su3 ** const gf) {
       fprintf(stderr, "For gauge file %s, calculated and stored values for SciDAC checksum A do not match.\n", filename);
       destruct_reader(reader);
       free(ildgformat_input);
+      prof_end("read_gauge_field", 0., 0.);
       return(-1);
     }
     if (checksum_calc.sumb != checksum_read.sumb) {
       fprintf(stderr, "For gauge file %s, calculated and stored values for SciDAC checksum B do not match.\n", filename);
       destruct_reader(reader);
       free(ildgformat_input);
+      prof_end("read_gauge_field", 0., 0.);
       return(-1);
     }
 
@@ -180,7 +190,8 @@ int read_gauge_field(char * filename, su3 ** const gf) {
   free(ildgformat_input);
   destruct_reader(reader);
 
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
 
+  prof_end("read_gauge_field", 0., (double)VOLUME*4*sizeof(su3));
   return(0);
 }
@@ -28,7 +28,6 @@ int read_binary_gauge_data(LemonReader * lemonreader, DML_Checksum * checksum, p
   int t, x, y, z, status = 0;
   int latticeSize[] = {input->lt, input->lx, input->ly, input->lz};
   int scidacMapping[] = {0, 3, 2, 1};
-  DML_SiteRank rank;
   MPI_Offset bytes;
   uint64_t fbsu3;
   char * filebuffer = NULL, * current = NULL;
@@ -91,15 +90,13 @@ int read_binary_gauge_data(LemonReader * lemonreader, DML_Checksum * checksum, p
   }
 
 
+  DML_checksum_accum_local(checksum, filebuffer, bytes);
+
   for (t = 0; t < T; t++) {
     for (z = 0; z < LZ; z++) {
       for (y = 0; y < LY; y++) {
         for (x = 0; x < LX; x++) {
-          rank = (DML_SiteRank)(g_proc_coords[1] * LX +
-                                (((g_proc_coords[0] * T + t) * g_nproc_z * LZ + g_proc_coords[3] * LZ + z) * g_nproc_y * LY
-                                 + g_proc_coords[2] * LY + y) * ((DML_SiteRank)LX * g_nproc_x) + x);
           current = filebuffer + bytes * (x + (y + (t * LZ + z) * LY) * LX);
-          DML_checksum_accum(checksum, rank, current, bytes);
           if (input->prec == 32) {
             be_to_cpu_assign_single2double(&gf[ g_ipt[t][x][y][z] ][1], current            , sizeof(su3) / 8);
             be_to_cpu_assign_single2double(&gf[ g_ipt[t][x][y][z] ][2], current +     fbsu3, sizeof(su3) / 8);
@@ -27,6 +27,7 @@ int write_gauge_field(char * filename, const int prec, paramsXlfInfo const *xlfI
   DML_Checksum     checksum;
   paramsIldgFormat *ildg;
 
+  prof_begin("write_gauge_field");
   bytes = (uint64_t)L * L * L * T_global * sizeof(su3) * prec / 16;
 
   /* all these functions, except for write_binary_gauge_data do their own error handling */
@@ -54,5 +55,6 @@ int write_gauge_field(char * filename, const int prec, paramsXlfInfo const *xlfI
 #endif /* MPI */
 
   destruct_writer(writer);
+  prof_end("write_gauge_field", 0., (double)VOLUME*4*sizeof(su3)*prec/64);
   return status;
 }
@@ -34,7 +34,6 @@ int write_binary_gauge_data(LemonWriter * lemonwriter, const int prec, DML_Check
   uint64_t bytes;
   double tick = 0, tock = 0;
   char measure[64];
-  DML_SiteRank rank;
   DML_checksum_init(checksum);
 
   bytes = (uint64_t)sizeof(su3) * (prec == 32 ? 2 : 4);
@@ -59,7 +58,6 @@ int write_binary_gauge_data(LemonWriter * lemonwriter, const int prec, DML_Check
     for(z = 0; z < LZ; z++) {
       for(y = 0; y < LY; y++) {
         for(x = 0; x < LX; x++) {
-          rank = (DML_SiteRank) ((((tG + t)*L + zG + z)*L + yG + y)*L + xG + x);
           memcpy(&tmp3[0], &g_gauge_field[ g_ipt[t][x][y][z] ][1], sizeof(su3));
           memcpy(&tmp3[1], &g_gauge_field[ g_ipt[t][x][y][z] ][2], sizeof(su3));
           memcpy(&tmp3[2], &g_gauge_field[ g_ipt[t][x][y][z] ][3], sizeof(su3));
@@ -68,12 +66,12 @@ int write_binary_gauge_data(LemonWriter * lemonwriter, const int prec, DML_Check
             be_to_cpu_assign_double2single(filebuffer + bufoffset, tmp3, 4*sizeof(su3)/8);
           else
             be_to_cpu_assign(filebuffer + bufoffset, tmp3, 4*sizeof(su3)/8);
-          DML_checksum_accum(checksum, rank, (char*) filebuffer + bufoffset, bytes);
           bufoffset += bytes;
         }
       }
     }
   }
+  DML_checksum_accum_local(checksum, filebuffer, bytes);
 
   status = lemonWriteLatticeParallelMapped(lemonwriter, filebuffer, bytes, latticeSize, scidacMapping);
 
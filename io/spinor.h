@@ -32,6 +32,8 @@ int read_binary_spinor_data_l(spinor * const s, READER * reader, DML_Checksum *
 int write_spinor(WRITER * writer, spinor ** const s, spinor ** const r, const int flavours, const int prec);
 int write_binary_spinor_data(spinor * const s, spinor * const r, WRITER * writer, DML_Checksum *checksum, int const prec);
 int write_binary_spinor_data_l(spinor * const s, WRITER * writer, DML_Checksum * checksum, const int prec);
+/* n fields with one writer, each in its own binary data record with checksum */
+int write_spinor_stream(WRITER * writer, spinor ** const s, spinor ** const r, const int n, const int prec);
 
 void write_spinor_info(WRITER * writer, const int write_prop_format_flag, paramsInverterInfo * InverterInfo, int append);
 void write_source_format(WRITER *writer, paramsSourceFormat const *format);
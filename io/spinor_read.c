@@ -36,6 +36,7 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
   /* determine the propagator type */
   prop_type = parse_propagator_type(reader);
 
+  prof_begin("read_spinor");
   switch (prop_type) {
   case 1:
     /* strictly speaking the following depends on whether we read a source or a propagator */
@@ -43,10 +44,12 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
     break;
   case 2:
   case 3:
+    prof_end("read_spinor", 0., 0.);
     return(-2);
   case 11:
   case 12:
   case 13:
+    prof_end("read_spinor", 0., 0.);
     return(-3);
   case -1:
   case 4:
@@ -74,6 +77,7 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
 
   if (status == LIME_EOF) {
     fprintf(stderr, "Unable to find requested LIME record scidac-binary-data in file %s.\nEnd of file reached before record was found.\n", filename);
+    prof_end("read_spinor", 0., 0.);
     return(-5);
   }
 
@@ -89,6 +93,7 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
     else {
       fprintf(stderr, "Length of scidac-binary-data record in %s does not match input parameters.\n", filename);
       fprintf(stderr, "Found %lu bytes.\n", bytes);
+      prof_end("read_spinor", 0., 0.);
       return(-6);
     }
   }
@@ -100,12 +105,14 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
   if(r == NULL) {
     if( (rstat = read_binary_spinor_data_l(s, reader, &checksum)) != 0) {
       fprintf(stderr, "read_binary_spinor_data_l failed with return value %d", rstat);
+      prof_end("read_spinor", 0., 0.);
       return(-7);
     }
   }
   else {
     if( (rstat = read_binary_spinor_data(s, r, reader, &checksum)) != 0) {
       fprintf(stderr, "read_binary_spinor_data failed with return value %d", rstat);
+      prof_end("read_spinor", 0., 0.);
       return(-7);
     }
   }
@@ -132,6 +139,7 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
   if (!DML_read_flag) {
     fprintf(stderr, "LIME record with name: \"scidac-checksum\", in gauge file %s either missing or malformed.\n", filename);
     fprintf(stderr, "Unable to verify integrity of gauge field data.\n");
+    prof_end("read_spinor", 0., 0.);
     return(-1);
   }
 
@@ -143,5 +151,6 @@ int read_spinor(spinor * const s, spinor * const r, char * filename, const int p
 
   destruct_reader(reader);
 
+  prof_end("read_spinor", 0., (double)VOLUME*sizeof(spinor));
   return(0);
 }
@@ -30,7 +30,6 @@ int read_binary_spinor_data(spinor * const s, spinor * const r, LemonReader * le
   spinor *p = NULL;
   char *filebuffer = NULL, *current = NULL;
   double tick = 0, tock = 0;
-  DML_SiteRank rank;
   char measure[64];
 
   bytes = lemonReaderBytes(lemonreader);
@@ -84,17 +83,13 @@ int read_binary_spinor_data(spinor * const s, spinor * const r, LemonReader * le
     return(-2);
   }
 
+  DML_checksum_accum_local(checksum, filebuffer, bytes);
+
   for (t = 0; t < T; t++) {
     for (z = 0; z < LZ; z++) {
       for (y = 0; y < LY; y++) {
         for (x = 0; x < LX; x++) {
-          rank = (DML_SiteRank)(g_proc_coords[1] * LX +
-                                (((g_proc_coords[0] * T  + t) * g_nproc_z * LZ
-                                  + g_proc_coords[3] * LZ + z) * g_nproc_y * LY
-                                 + g_proc_coords[2] * LY + y) *
-                                ((DML_SiteRank) LX * g_nproc_x) + x);
           current = filebuffer + bytes * (x + (y + (t * LZ + z) * LY) * LX);
-          DML_checksum_accum(checksum, rank, current, bytes);
 
           i = g_lexic2eosub[ g_ipt[t][x][y][z] ];
           p = ((t + x + y + z +
@@ -206,7 +201,6 @@ int read_binary_spinor_data_l(spinor * const s, LemonReader * lemonreader, DML_C
   n_uint64_t bytes;
   char *filebuffer = NULL, *current = NULL;
   double tick = 0, tock = 0;
-  DML_SiteRank rank;
   char measure[64];
 
   bytes = lemonReaderBytes(lemonreader);
@@ -260,17 +254,13 @@ int read_binary_spinor_data_l(spinor * const s, LemonReader * lemonreader, DML_C
     return(-2);
   }
 
+  DML_checksum_accum_local(checksum, filebuffer, bytes);
+
   for (t = 0; t < T; t++) {
     for (z = 0; z < LZ; z++) {
       for (y = 0; y < LY; y++) {
         for (x = 0; x < LX; x++) {
-          rank = (DML_SiteRank)(g_proc_coords[1] * LX +
-                                (((g_proc_coords[0] * T  + t) * g_nproc_z * LZ
-                                  + g_proc_coords[3] * LZ + z) * g_nproc_y * LY
-                                 + g_proc_coords[2] * LY + y) *
-                                ((DML_SiteRank) LX * g_nproc_x) + x);
           current = filebuffer + bytes * (x + (y + (t * LZ + z) * LY) * LX);
-          DML_checksum_accum(checksum, rank, current, bytes);
 
           i = g_ipt[t][x][y][z];
           if (prec == 32)
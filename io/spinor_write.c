@@ -22,26 +22,10 @@
 
 int write_spinor(WRITER * writer, spinor ** const s, spinor ** const r, const int flavours, const int prec)
 {
-  DML_Checksum checksum;
-  uint64_t bytes;
-  int i = 0, status = 0;
+  int status = 0;
 
-  bytes = (n_uint64_t)LX * g_nproc_x * LY * g_nproc_y * LZ * g_nproc_z * T * g_nproc_t * (n_uint64_t)(sizeof(spinor) * prec / 64);
-
-  if(r == NULL) {
-    for (i = 0; i < flavours; ++i) {
-      //DEBUG following line
-      write_header(writer, 1, 0, "scidac-binary-data", bytes);
-      status  = write_binary_spinor_data_l(s[i], writer, &checksum, prec);
-      write_checksum(writer, &checksum, NULL);
-    }
-  }
-  else {
-    for (i = 0; i < flavours; ++i) {
-      write_header(writer, 1, 0, "scidac-binary-data", bytes);
-      status = write_binary_spinor_data(s[i], r[i], writer, &checksum, prec);
-      write_checksum(writer, &checksum, NULL);
-    }
-  }
+  prof_begin("write_spinor");
+  status = write_spinor_stream(writer, s, r, flavours, prec);
+  prof_end("write_spinor", 0., (double)flavours*VOLUME*sizeof(spinor)*prec/64);
   return status;
 }
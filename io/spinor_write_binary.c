@@ -29,7 +29,6 @@ int write_binary_spinor_data(spinor * const s, spinor * const r,
   unsigned long bufoffset = 0;
   char *filebuffer = NULL;
   uint64_t bytes;
-  DML_SiteRank rank;
   double tick = 0, tock = 0;
   char measure[64];
   spinor *p = NULL;
@@ -55,7 +54,6 @@ int write_binary_spinor_data(spinor * const s, spinor * const r,
     for(z = 0; z < LZ; z++) {
       for(y = 0; y < LY; y++) {
         for(x = 0; x < LX; x++) {
-          rank = (DML_SiteRank) ((((tG + t)*L + zG + z)*L + yG + y)*L + xG + x);
           i = g_lexic2eosub[g_ipt[t][x][y][z]];
           if ((z  + zG + y  + yG +
                x  + xG + t + tG) % 2 == 0)
@@ -67,12 +65,12 @@ int write_binary_spinor_data(spinor * const s, spinor * const r,
             be_to_cpu_assign_double2single((float*)(filebuffer + bufoffset), (double*)(p + i), sizeof(spinor) / 8);
           else
             be_to_cpu_assign((double*)(filebuffer + bufoffset), (double*)(p + i),  sizeof(spinor) / 8);
-            DML_checksum_accum(checksum, rank, (char*) filebuffer + bufoffset, bytes);
-            bufoffset += bytes;
+          bufoffset += bytes;
         }
       }
     }
   }
+  DML_checksum_accum_local(checksum, filebuffer, bytes);
 
   if (g_debug_level > 0) {
     MPI_Barrier(g_cart_grid);
@@ -263,7 +261,6 @@ int write_binary_spinor_data_l(spinor * const s,
   unsigned long bufoffset = 0;
   char *filebuffer = NULL;
   uint64_t bytes;
-  DML_SiteRank rank;
   double tick = 0, tock = 0;
   char measure[64];
 
@@ -288,19 +285,18 @@ int write_binary_spinor_data_l(spinor * const s,
     for(z = 0; z < LZ; z++) {
       for(y = 0; y < LY; y++) {
         for(x = 0; x < LX; x++) {
-          rank = (DML_SiteRank) ((((tG + t)*L + zG + z)*L + yG + y)*L + xG + x);
           i = g_ipt[t][x][y][z];
 
           if (prec == 32)
             be_to_cpu_assign_double2single((float*)(filebuffer + bufoffset), (double*)(s + i), sizeof(spinor) / 8);
           else
             be_to_cpu_assign((double*)(filebuffer + bufoffset), (double*)(s + i),  sizeof(spinor) / 8);
-            DML_checksum_accum(checksum, rank, (char*) filebuffer + bufoffset, bytes);
-            bufoffset += bytes;
+          bufoffset += bytes;
         }
       }
     }
   }
+  DML_checksum_accum_local(checksum, filebuffer, bytes);
 
   if (g_debug_level > 0) {
     MPI_Barrier(g_cart_grid);
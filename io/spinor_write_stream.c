@@ -0,0 +1,410 @@
+/***********************************************************************
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/*******************************************************************************
+ *
+ * Streaming writer for n spinor fields, e.g. the 12 spin-colour components
+ * of a propagator, into one open writer. Every field is written into its own
+ * scidac-binary-data record followed by its checksum, such that the file is
+ * the same as with n calls of write_binary_spinor_data(_l).
+ *
+ * The sites are converted to big endian and the requested precision row
+ * by row (x = 0..LX-1 at fixed t, z, y) in parallel and the checksum is
+ * accumulated in the same pass.
+ *
+ * lemon: the local lattice of one field is written collectively. For n > 1
+ *        and more than one thread the master thread writes field k while
+ *        the other threads convert field k+1 into a second buffer.
+ * c-lime: the fields are written in chunks of one global timeslice. Every
+ *        process converts its local timeslices and sends them to process 0,
+ *        which receives them directly into place and writes the chunk of
+ *        timeslice t0 while the one of t0+1 is received. Only two
+ *        timeslices are kept on process 0 and two local ones elsewhere.
+ *
+ *******************************************************************************/
+
+#include "spinor.ih"
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+
+/* convert rows [row0, row1) of the local lattice, row = (t*LZ + z)*LY + y, */
+/* to buf + t*ldt + z*ldz + y*ldy, the checksum of the sites is xored to    */
+/* suma, sumb                                                               */
+static void pack_rows(char * const buf, const size_t ldy, const size_t ldz, const size_t ldt,
+                      spinor * const s, spinor * const r, const int prec,
+                      const int row0, const int row1, uint32_t * const suma, uint32_t * const sumb) {
+  const size_t bytes = sizeof(spinor)*prec/64;
+  const DML_SiteRank gx = (DML_SiteRank)LX*g_nproc_x, gy = (DML_SiteRank)LY*g_nproc_y;
+  const DML_SiteRank gz = (DML_SiteRank)LZ*g_nproc_z;
+  const int xG = g_proc_coords[1]*LX, yG = g_proc_coords[2]*LY;
+  const int zG = g_proc_coords[3]*LZ, tG = g_proc_coords[0]*T;
+  uint32_t a = 0, b = 0;
+
+  for(int row = row0; row < row1; row++) {
+    const int y = row % LY, z = (row / LY) % LZ, t = row / (LY*LZ);
+    char * current = buf + t*ldt + z*ldz + y*ldy;
+    DML_SiteRank rank = (((DML_SiteRank)(tG + t)*gz + zG + z)*gy + yG + y)*gx + xG;
+    spinor * p;
+    int i;
+
+    for(int x = 0; x < LX; x++, rank++, current += bytes) {
+      if(r == NULL) {
+        p = s;
+        i = g_ipt[t][x][y][z];
+      }
+      else {
+        p = ((x + xG + y + yG + z + zG + t + tG) % 2 == 0) ? s : r;
+        i = g_lexic2eosub[ g_ipt[t][x][y][z] ];
+      }
+      if(prec == 32)
+        be_to_cpu_assign_double2single((float*)current, (double*)(p + i), sizeof(spinor)/8);
+      else
+        be_to_cpu_assign((double*)current, (double*)(p + i), sizeof(spinor)/8);
+
+      const uint32_t work = DML_crc32(0, (unsigned char*)current, bytes);
+      const DML_SiteRank rank29 = rank % 29, rank31 = rank % 31;
+      a ^= work<<rank29 | work>>(32-rank29);
+      b ^= work<<rank31 | work>>(32-rank31);
+    }
+  }
+  *suma ^= a;
+  *sumb ^= b;
+}
+
+/* rows [row0, row1) with all threads */
+static void pack_rows_omp(char * const buf, const size_t ldy, const size_t ldz, const size_t ldt,
+                          spinor * const s, spinor * const r, const int prec,
+                          const int row0, const int row1, DML_Checksum * const checksum) {
+  uint32_t suma = 0, sumb = 0;
+#ifdef TM_USE_OMP
+#pragma omp parallel for reduction(^ : suma, sumb)
+#endif
+  for(int row = row0; row < row1; row++) {
+    pack_rows(buf, ldy, ldz, ldt, s, r, prec, row, row + 1, &suma, &sumb);
+  }
+  checksum->suma ^= suma;
+  checksum->sumb ^= sumb;
+}
+
+static void report_speed(const double bytes, const double time) {
+  char measure[64];
+  if(g_cart_id == 0) {
+    engineering(measure, bytes, "b");
+    fprintf(stdout, "# Time spent writing %s ", measure);
+    engineering(measure, time, "s");
+    fprintf(stdout, "was %s.\n", measure);
+    engineering(measure, bytes / time, "b/s");
+    fprintf(stdout, "# Writing speed: %s", measure);
+    engineering(measure, bytes / (g_nproc * time), "b/s");
+    fprintf(stdout, " (%s per MPI process).\n", measure);
+    fflush(stdout);
+  }
+}
+
+#ifdef HAVE_LIBLEMON
+
+/* header, data and checksum of one field, MPI only from here */
+static int write_record(WRITER * writer, char * const buf, DML_Checksum * const checksum, const int prec) {
+  int latticeSize[] = {T_global, g_nproc_x*LX, g_nproc_y*LY, g_nproc_z*LZ};
+  int scidacMapping[] = {0, 3, 2, 1};
+  const uint64_t bytes = sizeof(spinor)*prec/64;
+  int status;
+
+  write_header(writer, 1, 0, "scidac-binary-data", (n_uint64_t)VOLUME * g_nproc * bytes);
+  status = lemonWriteLatticeParallelMapped(writer, buf, bytes, latticeSize, scidacMapping);
+  if(status != LEMON_SUCCESS) {
+    fprintf(stderr, "LEMON write error occurred with status = %d, while in write_spinor_stream (spinor_write_stream.c)!\n", status);
+  }
+  lemonWriterCloseRecord(writer);
+  DML_global_xor(&checksum->suma);
+  DML_global_xor(&checksum->sumb);
+  write_checksum(writer, checksum, NULL);
+  checksum->suma = 0;
+  checksum->sumb = 0;
+  return((status == LEMON_SUCCESS) ? 0 : -2);
+}
+
+/* the master thread may write while the others convert only if MPI */
+/* allows MPI calls from the master thread within a parallel region */
+static int overlap_possible() {
+#ifdef TM_USE_OMP
+  int provided;
+  MPI_Query_thread(&provided);
+  return(omp_get_max_threads() > 1 && provided >= MPI_THREAD_FUNNELED);
+#else
+  return(0);
+#endif
+}
+
+int write_spinor_stream(WRITER * writer, spinor ** const s, spinor ** const r, const int n, const int prec) {
+  const size_t bytes = sizeof(spinor)*prec/64;
+  const size_t ldy = LX*bytes, ldz = LY*LX*bytes, ldt = LZ*LY*LX*bytes;
+  const int nrows = T*LZ*LY;
+  const int nbuf = (n > 1 && overlap_possible()) ? 2 : 1;
+  char * buf[2] = {NULL, NULL};
+  DML_Checksum checksum[2];
+  double tick = 0., tock = 0.;
+  int status = 0;
+
+  DML_checksum_init(&checksum[0]);
+  DML_checksum_init(&checksum[1]);
+  for(int b = 0; b < nbuf; b++) {
+    if((buf[b] = malloc(VOLUME * bytes)) == NULL) {
+      fprintf(stderr, "malloc errno in write_spinor_stream: %d\n", errno);
+      fflush(stderr);
+      errno = 0;
+      free(buf[0]);
+      return(1);
+    }
+  }
+  if(g_debug_level > 0) {
+    MPI_Barrier(g_cart_grid);
+    tick = MPI_Wtime();
+  }
+
+  if(nbuf == 1) {
+    for(int k = 0; k < n; k++) {
+      pack_rows_omp(buf[0], ldy, ldz, ldt, s[k], (r == NULL) ? NULL : r[k], prec, 0, nrows, &checksum[0]);
+      status |= write_record(writer, buf[0], &checksum[0], prec);
+    }
+  }
+#ifdef TM_USE_OMP
+  else {
+#pragma omp parallel
+    {
+      const int tid = omp_get_thread_num(), nt = omp_get_num_threads();
+      uint32_t suma = 0, sumb = 0;
+
+      /* the first field with all threads */
+#pragma omp for
+      for(int row = 0; row < nrows; row++) {
+        pack_rows(buf[0], ldy, ldz, ldt, s[0], (r == NULL) ? NULL : r[0], prec, row, row + 1, &suma, &sumb);
+      }
+#pragma omp atomic
+      checksum[0].suma ^= suma;
+#pragma omp atomic
+      checksum[0].sumb ^= sumb;
+#pragma omp barrier
+
+      /* the team can be smaller than omp_get_max_threads() (dynamic */
+      /* adjustment, nested regions), with a single thread there is  */
+      /* nobody to convert while writing                             */
+      if(nt == 1) {
+        for(int k = 0; k < n; k++) {
+          if(k > 0) {
+            suma = 0;
+            sumb = 0;
+            pack_rows(buf[0], ldy, ldz, ldt, s[k], (r == NULL) ? NULL : r[k], prec, 0, nrows, &suma, &sumb);
+            checksum[0].suma ^= suma;
+            checksum[0].sumb ^= sumb;
+          }
+          status |= write_record(writer, buf[0], &checksum[0], prec);
+        }
+      }
+      else {
+        for(int k = 0; k < n; k++) {
+          if(tid == 0) {
+            const int st = write_record(writer, buf[k%2], &checksum[k%2], prec);
+            status |= st;
+          }
+          else if(k + 1 < n) {
+            /* the rows of field k+1 split over threads 1..nt-1 */
+            const int row0 = (int)((long)nrows*(tid - 1)/(nt - 1));
+            const int row1 = (int)((long)nrows*tid/(nt - 1));
+            suma = 0;
+            sumb = 0;
+            pack_rows(buf[(k+1)%2], ldy, ldz, ldt, s[k+1], (r == NULL) ? NULL : r[k+1], prec,
+                      row0, row1, &suma, &sumb);
+#pragma omp atomic
+            checksum[(k+1)%2].suma ^= suma;
+#pragma omp atomic
+            checksum[(k+1)%2].sumb ^= sumb;
+          }
+#pragma omp barrier
+        }
+      }
+    }
+  }
+#endif
+
+  if(g_debug_level > 0) {
+    MPI_Barrier(g_cart_grid);
+    tock = MPI_Wtime();
+    report_speed((double)n * VOLUME * g_nproc * bytes, tock - tick);
+  }
+  free(buf[0]);
+  free(buf[1]);
+  return(status);
+}
+
+#else /* HAVE_LIBLEMON */
+
+static void write_chunk(WRITER * writer, char * const buf, n_uint64_t bytes) {
+  const int status = limeWriteRecordData((void*)buf, &bytes, writer);
+  if(status < 0) {
+    fprintf(stderr, "LIME write error occurred with status = %d, while in write_spinor_stream (spinor_write_stream.c)!\n", status);
+#ifdef TM_USE_MPI
+    MPI_Abort(MPI_COMM_WORLD, 1);
+    MPI_Finalize();
+#endif
+    exit(500);
+  }
+}
+
+int write_spinor_stream(WRITER * writer, spinor ** const s, spinor ** const r, const int n, const int prec) {
+  const size_t bytes = sizeof(spinor)*prec/64;
+  const int LXg = LX*g_nproc_x, LYg = LY*g_nproc_y, LZg = LZ*g_nproc_z;
+  /* a global timeslice in file order on process 0 */
+  const size_t chunk = (size_t)LZg*LYg*LXg*bytes;
+  const size_t ldy = (size_t)LXg*bytes, ldz = (size_t)LYg*LXg*bytes;
+  const int nslab = g_nproc_x*g_nproc_y*g_nproc_z;
+  char * buf[2] = {NULL, NULL};
+  DML_Checksum checksum;
+  double tick = 0., tock = 0.;
+#ifdef TM_USE_MPI
+  MPI_Datatype * block = NULL;
+  MPI_Request * req = NULL;
+  int * src = NULL;
+  int coords[4];
+#endif
+
+  if(g_cart_id == 0) {
+    buf[0] = malloc(chunk);
+    buf[1] = malloc(chunk);
+  }
+  else {
+    buf[0] = malloc((size_t)LZ*LY*LX*bytes);
+    buf[1] = malloc((size_t)LZ*LY*LX*bytes);
+  }
+  if(buf[0] == NULL || buf[1] == NULL) {
+    fprintf(stderr, "malloc errno in write_spinor_stream: %d\n", errno);
+    fflush(stderr);
+    errno = 0;
+    free(buf[0]);
+    free(buf[1]);
+    return(1);
+  }
+
+#ifdef TM_USE_MPI
+  req = malloc(2*nslab*sizeof(MPI_Request));
+  src = malloc(nslab*sizeof(int));
+  if(g_cart_id == 0) {
+    /* the block of process (x, y, z) in a global timeslice */
+    int sizes[3] = {LZg, LYg, LXg*(int)bytes};
+    int subsizes[3] = {LZ, LY, LX*(int)bytes};
+    int starts[3];
+    block = malloc(nslab*sizeof(MPI_Datatype));
+    for(int j = 0; j < nslab; j++) {
+      coords[1] = j % g_nproc_x;
+      coords[2] = (j / g_nproc_x) % g_nproc_y;
+      coords[3] = j / (g_nproc_x*g_nproc_y);
+      starts[0] = coords[3]*LZ;
+      starts[1] = coords[2]*LY;
+      starts[2] = coords[1]*LX*(int)bytes;
+      MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C, MPI_BYTE, &block[j]);
+      MPI_Type_commit(&block[j]);
+    }
+  }
+  MPI_Barrier(g_cart_grid);
+#endif
+  if(g_debug_level > 0) {
+    tick = gettime();
+  }
+
+  for(int k = 0; k < n; k++) {
+    spinor * const sk = s[k], * const rk = (r == NULL) ? NULL : r[k];
+    DML_checksum_init(&checksum);
+    write_header(writer, 1, 0, "scidac-binary-data", (n_uint64_t)chunk * T_global);
+
+    if(g_cart_id == 0) {
+      /* receive timeslice t0 while timeslice t0-1 is written */
+      for(int t0 = 0; t0 <= T_global; t0++) {
+        if(t0 < T_global) {
+          char * const dest = buf[t0%2];
+#ifdef TM_USE_MPI
+          coords[0] = t0 / T;
+          for(int j = 0; j < nslab; j++) {
+            coords[1] = j % g_nproc_x;
+            coords[2] = (j / g_nproc_x) % g_nproc_y;
+            coords[3] = j / (g_nproc_x*g_nproc_y);
+            MPI_Cart_rank(g_cart_grid, coords, &src[j]);
+            if(src[j] == g_cart_id) {
+              req[(t0%2)*nslab + j] = MPI_REQUEST_NULL;
+            }
+            else {
+              MPI_Irecv(dest, 1, block[j], src[j], t0, g_cart_grid, &req[(t0%2)*nslab + j]);
+            }
+          }
+#endif
+          if(g_proc_coords[0] == t0 / T) {
+            const int t = t0 - g_proc_coords[0]*T;
+            pack_rows_omp(dest + g_proc_coords[3]*LZ*ldz + g_proc_coords[2]*LY*ldy + g_proc_coords[1]*LX*bytes,
+                          ldy, ldz, 0, sk, rk, prec, t*LZ*LY, (t + 1)*LZ*LY, &checksum);
+          }
+        }
+        if(t0 > 0) {
+#ifdef TM_USE_MPI
+          MPI_Waitall(nslab, &req[((t0-1)%2)*nslab], MPI_STATUSES_IGNORE);
+#endif
+          write_chunk(writer, buf[(t0-1)%2], chunk);
+        }
+      }
+    }
+#ifdef TM_USE_MPI
+    else {
+      /* rows of a local timeslice are contiguous in the send buffer */
+      req[0] = MPI_REQUEST_NULL;
+      req[1] = MPI_REQUEST_NULL;
+      for(int t = 0; t < T; t++) {
+        MPI_Wait(&req[t%2], MPI_STATUS_IGNORE);
+        pack_rows_omp(buf[t%2], LX*bytes, LY*LX*bytes, 0, sk, rk, prec, t*LZ*LY, (t + 1)*LZ*LY, &checksum);
+        MPI_Isend(buf[t%2], LZ*LY*LX*bytes, MPI_BYTE, 0, g_proc_coords[0]*T + t, g_cart_grid, &req[t%2]);
+      }
+      MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+    }
+#endif
+    DML_global_xor(&checksum.suma);
+    DML_global_xor(&checksum.sumb);
+    write_checksum(writer, &checksum, NULL);
+  }
+
+  if(g_debug_level > 0) {
+#ifdef TM_USE_MPI
+    MPI_Barrier(g_cart_grid);
+#endif
+    tock = gettime();
+    report_speed((double)n * chunk * T_global, tock - tick);
+  }
+#ifdef TM_USE_MPI
+  if(g_cart_id == 0) {
+    for(int j = 0; j < nslab; j++) {
+      MPI_Type_free(&block[j]);
+    }
+    free(block);
+  }
+  free(req);
+  free(src);
+#endif
+  free(buf[0]);
+  free(buf[1]);
+  return(0);
+}
+
+#endif /* HAVE_LIBLEMON */
@@ -0,0 +1,746 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+*
+* Benchmark program for the kernels used in HMC and inversions
+*
+* Times the even/odd operators (tm, clover, non-degenerate doublet),
+* the clover term, the linear algebra kernels in 64 and 32 bit,
+* the halo exchanges, the force and gauge update kernels, a fixed
+* iteration CG and the gauge I/O. The compute kernels are repeated
+* for 1, 2, 4, ... up to OMPNumThreads threads.
+*
+* Results are printed and written in JSON format (default benchmark.json).
+* Flop and byte counts are nominal counts per call, the byte counts
+* are the minimal memory traffic assuming perfect caching. The local
+* volume is given by the input file, see HOWTO-benchmark for sweeping it.
+*
+*******************************************************************************/
+
+#include"lime.h"
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+# include "init/init_openmp.h"
+#endif
+#include "global.h"
+#include "git_hash.h"
+#include "getopt.h"
+#include "gettime.h"
+#include "su3.h"
+#include "su3adj.h"
+#include "ranlxd.h"
+#include "geometry_eo.h"
+#include "read_input.h"
+#include "start.h"
+#include "boundary.h"
+#include "linalg_eo.h"
+#include "operator/Hopping_Matrix.h"
+#include "operator/Hopping_Matrix_32.h"
+#include "operator/tm_operators.h"
+#include "operator/tm_operators_32.h"
+#include "operator/tm_operators_nd.h"
+#include "operator/clovertm_operators.h"
+#include "operator/clovertm_operators_32.h"
+#include "operator/clover_leaf.h"
+#include "xchange/xchange.h"
+#include "init/init.h"
+#include "test/check_geometry.h"
+#include "hamiltonian_field.h"
+#include "deriv_Sb.h"
+#include "update_gauge.h"
+#include "derived_gauge_fields.h"
+#include "solver/cg_her.h"
+#include "io/params.h"
+#include "io/gauge.h"
+#include "phmc.h"
+#include "mpi_init.h"
+
+#ifdef PARALLELT
+#  define SLICE (LX*LY*LZ/2)
+#elif defined PARALLELXT
+#  define SLICE ((LX*LY*LZ/2)+(T*LY*LZ/2))
+#elif defined PARALLELXYT
+#  define SLICE ((LX*LY*LZ/2)+(T*LY*LZ/2) + (T*LX*LZ/2))
+#elif defined PARALLELXYZT
+#  define SLICE ((LX*LY*LZ/2)+(T*LY*LZ/2) + (T*LX*LZ/2) + (T*LX*LY/2))
+#elif defined PARALLELX
+#  define SLICE ((LY*LZ*T/2))
+#elif defined PARALLELXY
+#  define SLICE ((LY*LZ*T/2) + (LX*LZ*T/2))
+#elif defined PARALLELXYZ
+#  define SLICE ((LY*LZ*T/2) + (LX*LZ*T/2) + (LX*LY*T/2))
+#else
+#  define SLICE 0
+#endif
+
+/* nominal flops per site of the even/odd operators */
+#define _HM_FLOP 1320.
+#define _TM_DIAG_FLOP 48.
+#define _SW_DIAG_FLOP 552.
+/* bytes per site read and written by one Hopping_Matrix */
+#define _HM_BYTE(s, g) (9.*(s) + 8.*(g))
+
+static void usage();
+static void process_args(int argc, char *argv[], char ** input_filename, char ** json_filename);
+
+/* minimal time in seconds a single measurement should take */
+static double bench_min_time = 1.;
+static int bench_cg_iter = 25;
+static FILE * json = NULL;
+static int json_first = 1;
+static int bench_threads = 1;
+/* accumulates results of reductions such that nothing is optimised away */
+static volatile double antioptaway = 0.;
+
+/* fields the kernels act on, set in main */
+static spinor ** s;
+static spinor32 ** s32;
+static hamiltonian_field_t hf;
+static su3 ** gf_alias;
+static double sw_shift = 0.;
+static char gauge_filename[] = "conf.benchmark";
+static paramsXlfInfo * xlfInfo = NULL;
+
+#ifdef TM_USE_MPI
+static char * halo_send, * halo_recv;
+static int halo_bytes, halo_up, halo_dn;
+#endif
+
+/* runs f n times and returns the maximal time over all processes */
+static double bench_time(void (*f)(void), const int n, double * tmin, double * tavg) {
+  double t, tmax;
+  int j;
+#ifdef TM_USE_MPI
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  t = gettime();
+  for(j = 0; j < n; j++) {
+    f();
+  }
+  t = gettime() - t;
+#ifdef TM_USE_MPI
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(&t, tmin, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(&t, tavg, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  *tavg /= (double)g_nproc;
+#else
+  tmax = t;
+  *tmin = t;
+  *tavg = t;
+#endif
+  return(tmax);
+}
+
+/* times kernel f and reports its performance                     */
+/* flops and bytes are per call and process, for n > 0 f is       */
+/* called exactly n times, otherwise n is chosen such that the    */
+/* measurement takes at least bench_min_time seconds              */
+static void bench(const char * const name, const int prec, void (*f)(void),
+                  const double flops, const double bytes, int n) {
+  double tmax, tmin, tavg, gflops, gbytes;
+
+  if(n < 1) {
+    /* calibrate, the estimate is the same on all processes */
+    n = 1;
+    f();
+    while((tmax = bench_time(f, n, &tmin, &tavg)) < 0.1*bench_min_time) {
+      n *= 2;
+    }
+    n = (int)ceil(n*bench_min_time/tmax);
+  }
+  tmax = bench_time(f, n, &tmin, &tavg);
+
+  gflops = (double)g_nproc*flops*n/tmax/1.e9;
+  gbytes = (double)g_nproc*bytes*n/tmax/1.e9;
+  if(g_proc_id == 0) {
+    printf("# %-24s %2d bit %3d threads %9d calls %12.4e usec/call %9.3f GFlop/s %9.3f GB/s\n",
+           name, prec, bench_threads, n, 1.e6*tmax/n, gflops, gbytes);
+    fflush(stdout);
+    if(json != NULL) {
+      fprintf(json, "%s\n    {\"kernel\": \"%s\", \"precision\": %d, \"threads\": %d, \"calls\": %d, ",
+              json_first ? "" : ",", name, prec, bench_threads, n);
+      fprintf(json, "\"usec_per_call\": %e, \"usec_per_call_min\": %e, \"usec_per_call_avg\": %e, ",
+              1.e6*tmax/n, 1.e6*tmin/n, 1.e6*tavg/n);
+      fprintf(json, "\"flops_per_call\": %e, \"bytes_per_call\": %e, \"gflops\": %e, \"gbytes\": %e}",
+              (double)g_nproc*flops, (double)g_nproc*bytes, gflops, gbytes);
+      fflush(json);
+    }
+    json_first = 0;
+  }
+  return;
+}
+
+/* the kernels */
+
+static void k_hopping_matrix() {
+  Hopping_Matrix(EO, s[1], s[0]);
+  Hopping_Matrix(OE, s[2], s[1]);
+}
+
+static void k_hopping_matrix_32() {
+  Hopping_Matrix_32(EO, s32[3], s32[2]);
+  Hopping_Matrix_32(OE, s32[4], s32[3]);
+}
+
+static void k_qtm_pm_psi() {
+  Qtm_pm_psi(s[1], s[0]);
+}
+
+static void k_qtm_pm_psi_32() {
+  Qtm_pm_psi_32(s32[3], s32[2]);
+}
+
+static void k_qsw_pm_psi() {
+  Qsw_pm_psi(s[1], s[0]);
+}
+
+static void k_qsw_pm_psi_32() {
+  Qsw_pm_psi_32(s32[3], s32[2]);
+}
+
+static void k_qtm_pm_ndpsi() {
+  Qtm_pm_ndpsi(s[2], s[3], s[0], s[1]);
+}
+
+static void k_qsw_pm_ndpsi() {
+  Qsw_pm_ndpsi(s[2], s[3], s[0], s[1]);
+}
+
+static void k_sw_term() {
+  /* gf_alias is not tracked by derived_gauge_fields, */
+  /* such that sw_term always recomputes              */
+  sw_term((const su3**) gf_alias, g_kappa, g_c_sw);
+}
+
+/* alternate the twisted mass such that the inverse is never current */
+static void k_sw_invert() {
+  sw_shift = 1. - sw_shift;
+  sw_invert(EE, g_mu + sw_shift);
+}
+
+static void k_sw_invert_nd() {
+  sw_shift = 1. - sw_shift;
+  sw_invert_nd(g_mubar*g_mubar - g_epsbar*g_epsbar + sw_shift);
+}
+
+static void k_deriv_Sb() {
+  deriv_Sb(EO, s[0], s[1], &hf, 1.);
+}
+
+static void k_sw_all() {
+  sw_all(&hf, g_kappa, g_c_sw);
+}
+
+static void k_update_gauge() {
+  /* small step, such that the field stays close to the original one */
+  update_gauge(1.e-6, &hf);
+}
+
+static void k_cg_her() {
+  /* eps_sq is never reached, cg_her does bench_cg_iter iterations */
+  cg_her(s[4], s[0], bench_cg_iter, 1.e-60, 0, VOLUME/2, &Qtm_pm_psi);
+}
+
+static void k_square_norm() {
+  antioptaway += square_norm(s[0], VOLUME/2, 1);
+}
+
+static void k_square_norm_32() {
+  antioptaway += square_norm_32(s32[2], VOLUME/2, 1);
+}
+
+static void k_scalar_prod_r() {
+  antioptaway += scalar_prod_r(s[0], s[1], VOLUME/2, 1);
+}
+
+static void k_scalar_prod_r_32() {
+  antioptaway += scalar_prod_r_32(s32[2], s32[3], VOLUME/2, 1);
+}
+
+static void k_scalar_prod() {
+  antioptaway += creal(scalar_prod(s[0], s[1], VOLUME/2, 1));
+}
+
+static void k_scalar_prod_32() {
+  antioptaway += creal(scalar_prod_32(s32[2], s32[3], VOLUME/2, 1));
+}
+
+static void k_assign_add_mul_r() {
+  assign_add_mul_r(s[2], s[0], 1.e-3, VOLUME/2);
+}
+
+static void k_assign_add_mul_r_32() {
+  assign_add_mul_r_32(s32[4], s32[2], 1.e-3, VOLUME/2);
+}
+
+static void k_assign_mul_add_r() {
+  assign_mul_add_r(s[2], 0.999, s[0], VOLUME/2);
+}
+
+static void k_assign_mul_add_r_32() {
+  assign_mul_add_r_32(s32[4], 0.999, s32[2], VOLUME/2);
+}
+
+static void k_assign_add_mul() {
+  assign_add_mul(s[2], s[0], 1.e-3*I, VOLUME/2);
+}
+
+static void k_assign_add_mul_32() {
+  assign_add_mul_32(s32[4], s32[2], 1.e-3*I, VOLUME/2);
+}
+
+static void k_assign_mul_add_mul_r() {
+  assign_mul_add_mul_r(s[2], s[0], 0.999, 1.e-3, VOLUME/2);
+}
+
+static void k_assign_mul_add_mul_r_32() {
+  assign_mul_add_mul_r_32(s32[4], s32[2], 0.999, 1.e-3, VOLUME/2);
+}
+
+static void k_diff() {
+  diff(s[3], s[0], s[1], VOLUME/2);
+}
+
+static void k_diff_32() {
+  diff_32(s32[5], s32[2], s32[3], VOLUME/2);
+}
+
+static void k_mul_r() {
+  mul_r(s[3], 0.999, s[0], VOLUME/2);
+}
+
+static void k_mul_r_32() {
+  mul_r_32(s32[5], 0.999, s32[2], VOLUME/2);
+}
+
+static void k_assign() {
+  assign(s[3], s[0], VOLUME/2);
+}
+
+static void k_assign_32() {
+  assign_32(s32[5], s32[2], VOLUME/2);
+}
+
+static void k_assign_to_32() {
+  assign_to_32(s32[5], s[0], VOLUME/2);
+}
+
+static void k_addto_32() {
+  addto_32(s[3], s32[2], VOLUME/2);
+}
+
+#ifdef TM_USE_MPI
+static void k_xchange_field() {
+  xchange_field(s[0], EO);
+}
+
+static void k_xchange_gauge() {
+  xchange_gauge(g_gauge_field);
+}
+
+static void k_halo() {
+  MPI_Status status;
+  MPI_Sendrecv(halo_send, halo_bytes, MPI_BYTE, halo_up, 101,
+               halo_recv, halo_bytes, MPI_BYTE, halo_dn, 101, g_cart_grid, &status);
+  MPI_Sendrecv(halo_send, halo_bytes, MPI_BYTE, halo_dn, 102,
+               halo_recv, halo_bytes, MPI_BYTE, halo_up, 102, g_cart_grid, &status);
+}
+
+/* latency (one spinor) and bandwidth (one face of half spinors) */
+/* per parallelised direction, both directions are exchanged     */
+static void bench_halo() {
+  const char dirname[4] = {'t', 'x', 'y', 'z'};
+  int nproc[4], up[4], dn[4], face[4];
+  char name[32];
+
+  nproc[0] = g_nproc_t; up[0] = g_nb_t_up; dn[0] = g_nb_t_dn; face[0] = LX*LY*LZ/2;
+  nproc[1] = g_nproc_x; up[1] = g_nb_x_up; dn[1] = g_nb_x_dn; face[1] = T*LY*LZ/2;
+  nproc[2] = g_nproc_y; up[2] = g_nb_y_up; dn[2] = g_nb_y_dn; face[2] = T*LX*LZ/2;
+  nproc[3] = g_nproc_z; up[3] = g_nb_z_up; dn[3] = g_nb_z_dn; face[3] = T*LX*LY/2;
+
+  for(int mu = 0; mu < 4; mu++) {
+    if(nproc[mu] < 2) continue;
+    halo_up = up[mu];
+    halo_dn = dn[mu];
+    if((void*)(halo_send = (char*)calloc(face[mu], sizeof(spinor))) == NULL ||
+       (void*)(halo_recv = (char*)calloc(face[mu], sizeof(spinor))) == NULL) {
+      fprintf(stderr, "Not enough memory for halo buffers! Aborting...\n");
+      exit(-1);
+    }
+    halo_bytes = sizeof(spinor);
+    sprintf(name, "halo_latency_%c", dirname[mu]);
+    bench(name, 64, &k_halo, 0., 2.*halo_bytes, 0);
+    halo_bytes = face[mu]*sizeof(spinor);
+    sprintf(name, "halo_bandwidth_%c", dirname[mu]);
+    bench(name, 64, &k_halo, 0., 2.*halo_bytes, 0);
+    free(halo_send);
+    free(halo_recv);
+  }
+  return;
+}
+#endif
+
+static void k_write_gauge() {
+  write_gauge_field(gauge_filename, 64, xlfInfo);
+}
+
+static void k_read_gauge() {
+  read_gauge_field(gauge_filename, g_gauge_field);
+}
+
+/* all kernels which depend on the number of threads */
+static void bench_kernels() {
+  const double V2 = (double)(VOLUME/2), V = (double)VOLUME;
+  const double S = sizeof(spinor), S32 = sizeof(spinor32);
+  const double G = sizeof(su3), G32 = sizeof(su3_32), A = sizeof(su3adj);
+  const double HM = _HM_BYTE(S, G), HM32 = _HM_BYTE(S32, G32);
+  const double qtm_flops = V2*(4.*_HM_FLOP + 4.*_TM_DIAG_FLOP);
+  const double qtm_bytes = V2*(4.*HM + 4.*3.*S);
+
+  update_gauge_halo();
+  update_gauge_field_32();
+
+  /* operators */
+  bench("Hopping_Matrix", 64, &k_hopping_matrix, 2.*V2*_HM_FLOP, 2.*V2*HM, 0);
+  bench("Hopping_Matrix", 32, &k_hopping_matrix_32, 2.*V2*_HM_FLOP, 2.*V2*HM32, 0);
+  bench("Qtm_pm_psi", 64, &k_qtm_pm_psi, qtm_flops, qtm_bytes, 0);
+  bench("Qtm_pm_psi", 32, &k_qtm_pm_psi_32, qtm_flops, V2*(4.*HM32 + 4.*3.*S32), 0);
+  bench("Qtm_pm_ndpsi", 64, &k_qtm_pm_ndpsi, 2.*qtm_flops, 2.*qtm_bytes, 0);
+
+  /* clover term, the inverse is left at (EE, g_mu) for Qsw_pm_psi */
+  bench("sw_term", 64, &k_sw_term, V*6.*4.*3.*198., V*(4.*G + 6.*G), 0);
+  bench("sw_invert", 64, &k_sw_invert, V2*4.*2.*3456., V2*(6.*G + 8.*G), 0);
+  sw_invert(EE, g_mu);
+  copy_32_sw_fields();
+  bench("Qsw_pm_psi", 64, &k_qsw_pm_psi,
+        V2*(4.*_HM_FLOP + 4.*_SW_DIAG_FLOP), V2*(4.*HM + 2.*(8.*G + 2.*S) + 2.*(6.*G + 3.*S)), 0);
+  bench("Qsw_pm_psi", 32, &k_qsw_pm_psi_32,
+        V2*(4.*_HM_FLOP + 4.*_SW_DIAG_FLOP), V2*(4.*HM32 + 2.*(8.*G32 + 2.*S32) + 2.*(6.*G32 + 3.*S32)), 0);
+  bench("sw_invert_nd", 64, &k_sw_invert_nd, V2*8.*2.*3456., V2*(6.*G + 16.*G), 0);
+  sw_invert_nd(g_mubar*g_mubar - g_epsbar*g_epsbar);
+  bench("Qsw_pm_ndpsi", 64, &k_qsw_pm_ndpsi,
+        V2*(8.*_HM_FLOP + 8.*_SW_DIAG_FLOP), V2*(8.*HM + 4.*(16.*G + 4.*S) + 4.*(6.*G + 3.*S)), 0);
+
+  /* forces and the gauge update */
+  bench("deriv_Sb", 64, &k_deriv_Sb, V2*8.*684., V2*(9.*S + 8.*G + 16.*A), 0);
+  bench("sw_all", 64, &k_sw_all, V*6.*24.*198., V*(4.*G + 12.*G + 8.*A), 0);
+
+  /* solver, Qtm_pm_psi plus two scalar products and three axpys per iteration */
+  bench("cg_her", 64, &k_cg_her, bench_cg_iter*(qtm_flops + V2*5.*48.),
+        bench_cg_iter*(qtm_bytes + V2*(2.*2.*S + 3.*3.*S)), 0);
+
+  /* linear algebra */
+  bench("square_norm", 64, &k_square_norm, V2*48., V2*S, 0);
+  bench("square_norm", 32, &k_square_norm_32, V2*48., V2*S32, 0);
+  bench("scalar_prod_r", 64, &k_scalar_prod_r, V2*48., V2*2.*S, 0);
+  bench("scalar_prod_r", 32, &k_scalar_prod_r_32, V2*48., V2*2.*S32, 0);
+  bench("scalar_prod", 64, &k_scalar_prod, V2*96., V2*2.*S, 0);
+  bench("scalar_prod", 32, &k_scalar_prod_32, V2*96., V2*2.*S32, 0);
+  bench("assign_add_mul_r", 64, &k_assign_add_mul_r, V2*48., V2*3.*S, 0);
+  bench("assign_add_mul_r", 32, &k_assign_add_mul_r_32, V2*48., V2*3.*S32, 0);
+  bench("assign_mul_add_r", 64, &k_assign_mul_add_r, V2*48., V2*3.*S, 0);
+  bench("assign_mul_add_r", 32, &k_assign_mul_add_r_32, V2*48., V2*3.*S32, 0);
+  bench("assign_add_mul", 64, &k_assign_add_mul, V2*96., V2*3.*S, 0);
+  bench("assign_add_mul", 32, &k_assign_add_mul_32, V2*96., V2*3.*S32, 0);
+  bench("assign_mul_add_mul_r", 64, &k_assign_mul_add_mul_r, V2*72., V2*3.*S, 0);
+  bench("assign_mul_add_mul_r", 32, &k_assign_mul_add_mul_r_32, V2*72., V2*3.*S32, 0);
+  bench("diff", 64, &k_diff, V2*24., V2*3.*S, 0);
+  bench("diff", 32, &k_diff_32, V2*24., V2*3.*S32, 0);
+  bench("mul_r", 64, &k_mul_r, V2*24., V2*2.*S, 0);
+  bench("mul_r", 32, &k_mul_r_32, V2*24., V2*2.*S32, 0);
+  bench("assign", 64, &k_assign, 0., V2*2.*S, 0);
+  bench("assign", 32, &k_assign_32, 0., V2*2.*S32, 0);
+  bench("assign_to_32", 32, &k_assign_to_32, 0., V2*(S + S32), 0);
+  bench("addto_32", 32, &k_addto_32, V2*24., V2*(3.*S32 + S32), 0);
+
+  /* modifies the gauge field, therefore last */
+  bench("update_gauge", 64, &k_update_gauge, V*4.*(800. + 198.), V*4.*(2.*G + A), 0);
+  return;
+}
+
+int main(int argc,char *argv[])
+{
+  int j, nt, max_threads = 1;
+  int status = 0;
+  char * input_filename = NULL;
+  char * json_filename = NULL;
+
+  DUM_DERI = 8;
+  DUM_SOLVER = DUM_DERI+8;
+  DUM_MATRIX = DUM_SOLVER+6;
+  NO_OF_SPINORFIELDS = DUM_MATRIX+8;
+  NO_OF_SPINORFIELDS_32 = 8;
+
+#ifdef TM_USE_MPI
+#  ifdef TM_USE_OMP
+  int mpi_thread_provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &mpi_thread_provided);
+#  else
+  MPI_Init(&argc, &argv);
+#  endif
+  MPI_Comm_rank(MPI_COMM_WORLD, &g_proc_id);
+#else
+  g_proc_id = 0;
+#endif
+
+  process_args(argc, argv, &input_filename, &json_filename);
+  if(input_filename == NULL) {
+    input_filename = "benchmark.input";
+  }
+  if(json_filename == NULL) {
+    json_filename = "benchmark.json";
+  }
+
+  g_rgi_C1 = 1.;
+
+  /* Read the input file */
+  if((status = read_input(input_filename)) != 0) {
+    fprintf(stderr, "Could not find input file: %s\nAborting...\n", input_filename);
+    exit(-1);
+  }
+
+#ifdef TM_USE_OMP
+  init_openmp();
+  max_threads = omp_num_threads;
+#endif
+
+  tmlqcd_mpi_init(argc, argv);
+
+#ifdef _GAUGE_COPY
+  j = init_gauge_field(VOLUMEPLUSRAND + g_dbw2rand, 1);
+#else
+  j = init_gauge_field(VOLUMEPLUSRAND + g_dbw2rand, 0);
+#endif
+  j += init_geometry_indices(VOLUMEPLUSRAND + g_dbw2rand);
+  j += init_spinor_field(VOLUMEPLUSRAND/2, NO_OF_SPINORFIELDS);
+  j += init_spinor_field_32(VOLUMEPLUSRAND/2, NO_OF_SPINORFIELDS_32);
+  j += init_moment_field(VOLUME, VOLUMEPLUSRAND + g_dbw2rand);
+  if(j != 0) {
+    fprintf(stderr, "Not enough memory for gauge, spinor and moment fields! Aborting...\n");
+    exit(-1);
+  }
+
+  geometry();
+  boundary(g_kappa);
+
+#ifdef _USE_HALFSPINOR
+  j = init_dirac_halfspinor();
+  j += init_dirac_halfspinor32();
+  if(j != 0) {
+    fprintf(stderr, "Not enough memory for halfspinor fields! Aborting...\n");
+    exit(-1);
+  }
+#  if (defined _PERSISTENT)
+  init_xchange_halffield();
+#  endif
+#endif
+
+  status = check_geometry();
+  if(status != 0) {
+    fprintf(stderr, "Checking of geometry failed. Unable to proceed.\nAborting....\n");
+    exit(1);
+  }
+
+  if(g_proc_id == 0) {
+    printf("# The number of processes is %d (%d x %d x %d x %d)\n", g_nproc,
+           g_nproc_t, g_nproc_x, g_nproc_y, g_nproc_z);
+    printf("# The lattice size is %d x %d x %d x %d\n",
+           (int)(T*g_nproc_t), (int)(LX*g_nproc_x), (int)(LY*g_nproc_y), (int)(g_nproc_z*LZ));
+    printf("# The local lattice size is %d x %d x %d x %d\n",
+           (int)(T), (int)(LX), (int)(LY), (int)(LZ));
+    printf("# Writing results to %s\n\n", json_filename);
+    fflush(stdout);
+  }
+
+  start_ranlux(1, 123456);
+  random_gauge_field(reproduce_randomnumber_flag, g_gauge_field);
+  gauge_field_changed();
+  update_gauge_halo();
+  update_gauge_field_32();
+
+  s = g_spinor_field;
+  /* g_spinor_field32[0] and [1] are used inside the 32 bit operators */
+  s32 = g_spinor_field32;
+  for(j = 0; j < 4; j++) {
+    random_spinor_field_eo(s[j], reproduce_randomnumber_flag, RN_GAUSS);
+    assign_to_32(s32[j+2], s[j], VOLUME/2);
+  }
+  random_spinor_field_eo(s[4], reproduce_randomnumber_flag, RN_GAUSS);
+
+  hf.gaugefield = g_gauge_field;
+  hf.momenta = moment;
+  hf.derivative = df0;
+  hf.update_gauge_copy = g_update_gauge_copy;
+  hf.traj_counter = 0;
+  random_su3adj_field(reproduce_randomnumber_flag, hf.momenta);
+
+  /* operator parameters */
+  phmc_invmaxev = 1.;
+  if((void*)(gf_alias = (su3**)calloc(VOLUMEPLUSRAND + g_dbw2rand, sizeof(su3*))) == NULL) {
+    fprintf(stderr, "Not enough memory for gauge field pointers! Aborting...\n");
+    exit(-1);
+  }
+  memcpy(gf_alias, g_gauge_field, (VOLUMEPLUSRAND + g_dbw2rand)*sizeof(su3*));
+  init_sw_fields();
+  init_swpm(VOLUME);
+  sw_term((const su3**) g_gauge_field, g_kappa, g_c_sw);
+  sw_invert(EE, g_mu);
+  /* fill swm, swp as in the clover force */
+  sw_deriv(EE, g_mu);
+  sw_spinor_eo(OO, s[0], s[1], 1.);
+
+  if(g_proc_id == 0) {
+    if((json = fopen(json_filename, "w")) == NULL) {
+      fprintf(stderr, "Could not open %s for writing, results are only printed\n", json_filename);
+    }
+    else {
+      fprintf(json, "{\n  \"program\": \"kernel_benchmark\",\n  \"version\": \"%s %s\",\n",
+              PACKAGE_STRING, git_hash);
+      fprintf(json, "  \"nproc\": %d,\n  \"proc_grid\": [%d, %d, %d, %d],\n",
+              g_nproc, g_nproc_t, g_nproc_x, g_nproc_y, g_nproc_z);
+      fprintf(json, "  \"lattice\": [%d, %d, %d, %d],\n",
+              T*g_nproc_t, LX*g_nproc_x, LY*g_nproc_y, LZ*g_nproc_z);
+      fprintf(json, "  \"local_lattice\": [%d, %d, %d, %d],\n", T, LX, LY, LZ);
+      fprintf(json, "  \"max_threads\": %d,\n", max_threads);
+#ifdef _USE_HALFSPINOR
+      fprintf(json, "  \"halfspinor\": true,\n");
+#else
+      fprintf(json, "  \"halfspinor\": false,\n");
+#endif
+#ifdef _GAUGE_COPY
+      fprintf(json, "  \"gauge_copy\": true,\n");
+#else
+      fprintf(json, "  \"gauge_copy\": false,\n");
+#endif
+      fprintf(json, "  \"min_time\": %e,\n  \"cg_iterations\": %d,\n  \"results\": [",
+              bench_min_time, bench_cg_iter);
+    }
+  }
+
+  /* thread sweep 1, 2, 4, ..., max_threads */
+  for(nt = 1; ; nt = (2*nt > max_threads && nt < max_threads) ? max_threads : 2*nt) {
+    bench_threads = nt;
+#ifdef TM_USE_OMP
+    omp_num_threads = nt;
+    omp_set_num_threads(nt);
+#endif
+    bench_kernels();
+    if(nt >= max_threads) break;
+  }
+
+  /* communication and I/O with all threads */
+  update_gauge_halo();
+#ifdef TM_USE_MPI
+  bench("xchange_field", 64, &k_xchange_field, 0., 2.*SLICE*sizeof(spinor), 0);
+  bench("xchange_gauge", 64, &k_xchange_gauge, 0., 2.*2.*SLICE*4.*sizeof(su3), 0);
+  bench_halo();
+#endif
+  xlfInfo = construct_paramsXlfInfo(0.5, 0);
+  bench("write_gauge_field", 64, &k_write_gauge, 0., (double)VOLUME*4.*18.*8., 1);
+  bench("read_gauge_field", 64, &k_read_gauge, 0., (double)VOLUME*4.*18.*8., 1);
+  free(xlfInfo);
+  if(g_proc_id == 0) {
+    remove(gauge_filename);
+  }
+
+  if(g_proc_id == 0) {
+    printf("\n# The following result is just to make sure that the calculation is not optimized away: %e\n",
+           antioptaway);
+    if(json != NULL) {
+      fprintf(json, "\n  ]\n}\n");
+      fclose(json);
+    }
+  }
+
+  free(gf_alias);
+#ifdef TM_USE_OMP
+  free_omp_accumulators();
+#endif
+  free_gauge_field();
+  free_geometry_indices();
+  free_spinor_field();
+  free_spinor_field_32();
+  free_moment_field();
+#ifdef TM_USE_MPI
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Finalize();
+#endif
+  return(0);
+}
+
+static void usage()
+{
+  fprintf(stdout, "Benchmark of the operators, linear algebra, communication and I/O kernels\n");
+  fprintf(stdout, "Version %s \n\n", PACKAGE_VERSION);
+  fprintf(stdout, "Please send bug reports to %s\n", PACKAGE_BUGREPORT);
+  fprintf(stdout, "Usage:   kernel_benchmark [options]\n");
+  fprintf(stdout, "Options: [-f input-filename] default: benchmark.input\n");
+  fprintf(stdout, "         [-o json-filename] default: benchmark.json\n");
+  fprintf(stdout, "         [-t minimal time per kernel in seconds] default: 1\n");
+  fprintf(stdout, "         [-i number of CG iterations] default: 25\n");
+  fprintf(stdout, "         [-h|-? this help]\n");
+  fprintf(stdout, "         [-V] print version information and exit\n");
+  exit(0);
+}
+
+static void process_args(int argc, char *argv[], char ** input_filename, char ** json_filename) {
+  int c;
+  while ((c = getopt(argc, argv, "h?Vf:o:t:i:")) != -1) {
+    switch (c) {
+      case 'f':
+        *input_filename = calloc(200, sizeof(char));
+        strncpy(*input_filename, optarg, 200);
+        break;
+      case 'o':
+        *json_filename = calloc(200, sizeof(char));
+        strncpy(*json_filename, optarg, 200);
+        break;
+      case 't':
+        bench_min_time = atof(optarg);
+        break;
+      case 'i':
+        bench_cg_iter = atoi(optarg);
+        break;
+      case 'V':
+        if(g_proc_id == 0) {
+          fprintf(stdout,"%s %s\n",PACKAGE_STRING,git_hash);
+        }
+        exit(0);
+        break;
+      case 'h':
+      case '?':
+      default:
+        if( g_proc_id == 0 ) {
+          usage();
+        }
+        break;
+    }
+  }
+}
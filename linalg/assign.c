@@ -51,6 +51,18 @@ void assign_32(spinor32 * const R, spinor32 * const S, const int N)
   return;
 }
 
+/* version to be called from within a parallel region */
+void assign_orphaned(spinor * const R, spinor * const S, const int N)
+{
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int ix = 0; ix < N; ix++) {
+    R[ix] = S[ix];
+  }
+  return;
+}
+
 #ifdef WITHLAPH
 void assign_su3vect(su3_vector * const R, su3_vector * const S, const int N)
 {
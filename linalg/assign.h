@@ -25,6 +25,7 @@
 /* Assign (*R) = (*S) */
 void assign(spinor * const R, spinor * const S, const int N);
 void assign_32(spinor32 * const R, spinor32 * const S, const int N);
+void assign_orphaned(spinor * const R, spinor * const S, const int N);
 void assign_su3vect(su3_vector * const R, su3_vector * const S, const int N);
 
 #endif
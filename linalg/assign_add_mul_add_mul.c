@@ -39,13 +39,7 @@
 
 
 /* S,U input, R inoutput, c1,c2 input */
-void assign_add_mul_add_mul(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N)
-{
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
-
+void assign_add_mul_add_mul_orphaned(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N) {
   spinor *r, *s, *u;
 
 #ifdef TM_USE_OMP
@@ -73,9 +67,15 @@ void assign_add_mul_add_mul(spinor * const R, spinor * const S, spinor * const U
     r->s3.c1 += c1 * s->s3.c1 + c2 * u->s3.c1;
     r->s3.c2 += c1 * s->s3.c2 + c2 * u->s3.c2;
   }
+}
 
+void assign_add_mul_add_mul(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  assign_add_mul_add_mul_orphaned(R, S, U, c1, c2, N);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
-  
 }
@@ -24,6 +24,7 @@
 
 /* (*R) = (*R) + c1*(*S) + c2*(*U) */
 void assign_add_mul_add_mul(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N);
+void assign_add_mul_add_mul_orphaned(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N);
 
 
 #endif
@@ -32,6 +32,7 @@
 #endif
 #include "su3.h"
 #include "assign_add_mul_r.h"
+#include "profiler.h"
 
 
 #if ( defined SSE2 || defined SSE3 )
@@ -345,14 +346,24 @@ void assign_add_mul_r(spinor * const R, spinor * const S, const double c, const
 
 void assign_add_mul_r(spinor * const P, spinor * const Q, const double c, const int N)
 {
+  prof_begin("assign_add_mul_r");
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
 #endif
-  register spinor *p;
-  register spinor *q;
+  assign_add_mul_r_orphaned(P, Q, c, N);
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
+  prof_end("assign_add_mul_r", 48.*N, 3.*N*sizeof(spinor));
+}
+#endif
+
+/* version to be called from within a parallel region */
+void assign_add_mul_r_orphaned(spinor * const P, spinor * const Q, const double c, const int N)
+{
+  spinor *p, *q;
 
-  /* Change due to even-odd preconditioning : VOLUME   to VOLUME/2 */   
 #ifdef TM_USE_OMP
 #pragma omp for
 #endif
@@ -376,11 +387,7 @@ void assign_add_mul_r(spinor * const P, spinor * const Q, const double c, const
     p->s3.c1 += c * q->s3.c1;
     p->s3.c2 += c * q->s3.c2;
   }
-#ifdef TM_USE_OMP
-  } /* OpenMP closing brace */
-#endif
 }
-#endif
 
 #ifdef WITHLAPH
 void assign_add_mul_r_su3vect(su3_vector * const P, su3_vector * const Q, const double c, const int N)
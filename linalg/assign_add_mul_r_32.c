@@ -107,6 +107,18 @@ void assign_add_mul_r_32(spinor32 * const R, spinor32 * const S, const float c,
 #pragma omp parallel
   {
 #endif
+  assign_add_mul_r_32_orphaned(R, S, c, N);
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
+
+}
+
+#endif
+
+/* version to be called from within a parallel region */
+void assign_add_mul_r_32_orphaned(spinor32 * const R, spinor32 * const S, const float c, const int N)
+{
   spinor32 *r,*s;
 
 #ifdef TM_USE_OMP
@@ -133,11 +145,4 @@ void assign_add_mul_r_32(spinor32 * const R, spinor32 * const S, const float c,
     r->s3.c1 += c * s->s3.c1;
     r->s3.c2 += c * s->s3.c2;
   }
-
-#ifdef TM_USE_OMP
-  } /* OpenMP closing brace */
-#endif
-
 }
-
-#endif
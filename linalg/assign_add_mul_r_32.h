@@ -5,5 +5,6 @@
 
 /*   (*P) = (*P) + c(*Q)        c is a complex constant   */
 void assign_add_mul_r_32(spinor32 * const R, spinor32 * const S, const float c, const int N);
+void assign_add_mul_r_32_orphaned(spinor32 * const R, spinor32 * const S, const float c, const int N);
 
 #endif
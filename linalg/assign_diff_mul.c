@@ -28,12 +28,7 @@
 #include "assign_diff_mul.h"
 
 /* R=R-c*S */
-void assign_diff_mul(spinor * const R, spinor * const S, const _Complex double c, const int N)
-{
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
+void assign_diff_mul_orphaned(spinor * const R, spinor * const S, const _Complex double c, const int N) {
   spinor *r, *s;
 
 #ifdef TM_USE_OMP
@@ -60,6 +55,14 @@ void assign_diff_mul(spinor * const R, spinor * const S, const _Complex double c
     r->s3.c1 -= c * s->s3.c1;
     r->s3.c2 -= c * s->s3.c2;
   }
+}
+
+void assign_diff_mul(spinor * const R, spinor * const S, const _Complex double c, const int N) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  assign_diff_mul_orphaned(R, S, c, N);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
@@ -23,5 +23,6 @@
 #include "su3.h"
 
 void assign_diff_mul(spinor * const S,spinor * const R, const _Complex double c, const int N);
+void assign_diff_mul_orphaned(spinor * const S,spinor * const R, const _Complex double c, const int N);
 
 #endif
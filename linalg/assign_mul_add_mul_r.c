@@ -34,14 +34,9 @@
 
 
 /* S input, R inoutput, c1,c2 input */
-void assign_mul_add_mul_r(spinor * const R,spinor * const S, 
+void assign_mul_add_mul_r_orphaned(spinor * const R,spinor * const S, 
 			  const double c1, const double c2,
 			  const int N) {
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
-
   spinor *r,*s;
   
 #ifdef TM_USE_OMP
@@ -67,6 +62,16 @@ void assign_mul_add_mul_r(spinor * const R,spinor * const S,
     r->s3.c1 = c1 * r->s3.c1 + c2 * s->s3.c1;
     r->s3.c2 = c1 * r->s3.c2 + c2 * s->s3.c2;
   }
+}
+
+void assign_mul_add_mul_r(spinor * const R,spinor * const S, 
+			  const double c1, const double c2,
+			  const int N) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  assign_mul_add_mul_r_orphaned(R, S, c1, c2, N);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
@@ -26,5 +26,8 @@
 void assign_mul_add_mul_r(spinor * const R,spinor * const S, 
 			  const double c1, const double c2,
 			  const int N);
+void assign_mul_add_mul_r_orphaned(spinor * const R,spinor * const S, 
+			  const double c1, const double c2,
+			  const int N);
 
 #endif
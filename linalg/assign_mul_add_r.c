@@ -27,6 +27,7 @@
 #endif
 #include "su3.h"
 #include "assign_mul_add_r.h"
+#include "profiler.h"
 
 
 #if ( defined SSE2 || defined SSE3 )
@@ -339,14 +340,26 @@ void assign_mul_add_r(spinor * const R, const double c, const spinor * const S,
 
 void assign_mul_add_r(spinor * const R, const double c, const spinor * const S, const int N)
 {
+  prof_begin("assign_mul_add_r");
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
 #endif
+  assign_mul_add_r_orphaned(R, c, S, N);
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
+  prof_end("assign_mul_add_r", 48.*N, 3.*N*sizeof(spinor));
+}
+
+#endif
+
+/* version to be called from within a parallel region */
+void assign_mul_add_r_orphaned(spinor * const R, const double c, const spinor * const S, const int N)
+{
   spinor *r;
   const spinor *s;
   
-  /* Change due to even-odd preconditioning : VOLUME   to VOLUME/2 */   
 #ifdef TM_USE_OMP
 #pragma omp for
 #endif
@@ -371,13 +384,8 @@ void assign_mul_add_r(spinor * const R, const double c, const spinor * const S,
     r->s3.c1 = c * r->s3.c1 + s->s3.c1;
     r->s3.c2 = c * r->s3.c2 + s->s3.c2;   
   }
-#ifdef TM_USE_OMP
-  } /* OpenMP closing brace */
-#endif
 }
 
-#endif
-
 #ifdef WITHLAPH
 void assign_mul_add_r_su3vect(su3_vector * const R, const double c, su3_vector * const S, const int N)
 {
@@ -84,10 +84,21 @@ void assign_mul_add_r_32(spinor32 * const R, const float c, const spinor32 * con
 #pragma omp parallel
   {
 #endif
+  assign_mul_add_r_32_orphaned(R, c, S, N);
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
+}
+
+
+#endif
+
+/* version to be called from within a parallel region */
+void assign_mul_add_r_32_orphaned(spinor32 * const R, const float c, const spinor32 * const S, const int N)
+{
   spinor32 *r;
   const spinor32 *s;
-  
-  /* Change due to even-odd preconditioning : VOLUME   to VOLUME/2 */   
+
 #ifdef TM_USE_OMP
 #pragma omp for
 #endif
@@ -112,10 +123,4 @@ void assign_mul_add_r_32(spinor32 * const R, const float c, const spinor32 * con
     r->s3.c1 = c * r->s3.c1 + s->s3.c1;
     r->s3.c2 = c * r->s3.c2 + s->s3.c2;   
   }
-#ifdef TM_USE_OMP
-  } /* OpenMP closing brace */
-#endif
 }
-
-
-#endif
@@ -4,5 +4,6 @@
 #include "su3.h"
 
 void assign_mul_add_r_32(spinor32 * const R, const float c, const spinor32 * const S, const int N);
+void assign_mul_add_r_32_orphaned(spinor32 * const R, const float c, const spinor32 * const S, const int N);
 
 #endif
\ No newline at end of file
@@ -31,6 +31,7 @@
 #endif
 #include "su3.h"
 #include "assign_mul_add_r_and_square.h"
+#include "reduce_orphaned.h"
 
 
 #if (defined BGQ && defined XLC)
@@ -217,3 +218,48 @@ double assign_mul_add_r_and_square(spinor * const R, const double c, const spino
 
 #endif
 
+/* version to be called by all threads from within a parallel region */
+double assign_mul_add_r_and_square_orphaned(spinor * const R, const double c, const spinor * const S, 
+                                            const int N, const int parallel) {
+  spinor *r;
+  const spinor *s;
+  double ALIGN ds = 0.0;
+
+#ifdef TM_USE_OMP
+#pragma omp for nowait
+#endif
+  for (int ix = 0; ix < N; ++ix) {
+    r = R + ix;
+    s = S + ix;
+    
+    r->s0.c0 = c * r->s0.c0 + s->s0.c0;
+    ds += creal(r->s0.c0)*creal(r->s0.c0) + cimag(r->s0.c0)*cimag(r->s0.c0);
+    r->s0.c1 = c * r->s0.c1 + s->s0.c1;
+    ds += creal(r->s0.c1)*creal(r->s0.c1) + cimag(r->s0.c1)*cimag(r->s0.c1);
+    r->s0.c2 = c * r->s0.c2 + s->s0.c2;    
+    ds += creal(r->s0.c2)*creal(r->s0.c2) + cimag(r->s0.c2)*cimag(r->s0.c2);
+
+    r->s1.c0 = c * r->s1.c0 + s->s1.c0;
+    ds += creal(r->s1.c0)*creal(r->s1.c0) + cimag(r->s1.c0)*cimag(r->s1.c0);
+    r->s1.c1 = c * r->s1.c1 + s->s1.c1;
+    ds += creal(r->s1.c1)*creal(r->s1.c1) + cimag(r->s1.c1)*cimag(r->s1.c1);
+    r->s1.c2 = c * r->s1.c2 + s->s1.c2;    
+    ds += creal(r->s1.c2)*creal(r->s1.c2) + cimag(r->s1.c2)*cimag(r->s1.c2);
+
+    r->s2.c0 = c * r->s2.c0 + s->s2.c0;
+    ds += creal(r->s2.c0)*creal(r->s2.c0) + cimag(r->s2.c0)*cimag(r->s2.c0);
+    r->s2.c1 = c * r->s2.c1 + s->s2.c1;
+    ds += creal(r->s2.c1)*creal(r->s2.c1) + cimag(r->s2.c1)*cimag(r->s2.c1);
+    r->s2.c2 = c * r->s2.c2 + s->s2.c2;    
+    ds += creal(r->s2.c2)*creal(r->s2.c2) + cimag(r->s2.c2)*cimag(r->s2.c2);
+
+    r->s3.c0 = c * r->s3.c0 + s->s3.c0;
+    ds += creal(r->s3.c0)*creal(r->s3.c0) + cimag(r->s3.c0)*cimag(r->s3.c0);
+    r->s3.c1 = c * r->s3.c1 + s->s3.c1;
+    ds += creal(r->s3.c1)*creal(r->s3.c1) + cimag(r->s3.c1)*cimag(r->s3.c1);
+    r->s3.c2 = c * r->s3.c2 + s->s3.c2;   
+    ds += creal(r->s3.c2)*creal(r->s3.c2) + cimag(r->s3.c2)*cimag(r->s3.c2);
+  }
+
+  return(reduce_re_orphaned(ds, parallel));
+}
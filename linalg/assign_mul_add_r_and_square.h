@@ -24,5 +24,7 @@
 
 double assign_mul_add_r_and_square(spinor * const R, const double c, const spinor * const S, 
 				   const int N, const int parallel);
+double assign_mul_add_r_and_square_orphaned(spinor * const R, const double c, const spinor * const S, 
+                                            const int N, const int parallel);
 
 #endif
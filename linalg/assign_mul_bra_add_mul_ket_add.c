@@ -41,13 +41,8 @@
 
 /* (*R) =  c2*(*R + c1*(*S)) + (*U) */
 /* R inoutput, S input, U input, c1 input, c2 input */
-void assign_mul_bra_add_mul_ket_add(spinor * const R, spinor * const S,spinor * const U,
+void assign_mul_bra_add_mul_ket_add_orphaned(spinor * const R, spinor * const S,spinor * const U,
 				    const _Complex double c1, const _Complex double c2, const int N) {
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
-
   spinor *r, *s, *u;
   
 #ifdef TM_USE_OMP
@@ -76,6 +71,15 @@ void assign_mul_bra_add_mul_ket_add(spinor * const R, spinor * const S,spinor *
     r->s3.c1 = u->s3.c1 + c2 * (r->s3.c1 + c1 * s->s3.c1);
     r->s3.c2 = u->s3.c2 + c2 * (r->s3.c2 + c1 * s->s3.c2);
   }
+}
+
+void assign_mul_bra_add_mul_ket_add(spinor * const R, spinor * const S,spinor * const U,
+				    const _Complex double c1, const _Complex double c2, const int N) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  assign_mul_bra_add_mul_ket_add_orphaned(R, S, U, c1, c2, N);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
@@ -24,5 +24,6 @@
 
 /* (*R) =  c2*(*R + c1*(*S)) + (*U) */
 void assign_mul_bra_add_mul_ket_add(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N);
+void assign_mul_bra_add_mul_ket_add_orphaned(spinor * const R, spinor * const S, spinor * const U, const _Complex double c1, const _Complex double c2, const int N);
 
 #endif
@@ -25,6 +25,7 @@
 /* Makes the difference (*Q) = (*R) - (*S) */
 void diff(spinor * const Q, const spinor * const R, const spinor * const S, const int N);
 void diff_ts(spinor * const Q, const spinor * const R, const spinor * const S, const int N);
+void diff_orphaned(spinor * const Q, const spinor * const R, const spinor * const S, const int N);
 void diff_su3vect(su3_vector * const Q, su3_vector * const R, su3_vector * const S, const int N);
 
 
@@ -0,0 +1,116 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+ *
+ * Reductions for the orphaned linear algebra kernels, which are called
+ * from within a parallel region opened by the caller (a solver, say).
+ *
+ * Every thread stores its Kahan corrected partial sum in g_omp_acc_re
+ * (g_omp_acc_cp), after a barrier the master thread sums them up in
+ * the order of the thread numbers, does the MPI_Allreduce and stores
+ * the result in a shared variable, which all threads read after a
+ * second barrier. The result is hence bitwise the same on all threads
+ * and independent of the timing of the threads.
+ *
+ * The second barrier also guarantees that no thread can overwrite its
+ * entry in g_omp_acc_re of the next reduction before the master has
+ * read it, such that reductions can follow each other directly.
+ *
+ *******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include <complex.h>
+#include "global.h"
+#include "reduce_orphaned.h"
+
+static double ALIGN res_re;
+static _Complex double ALIGN res_cp;
+
+double reduce_re_orphaned(const double s, const int parallel) {
+  double res;
+#ifdef TM_USE_OMP
+  g_omp_acc_re[omp_get_thread_num()] = s;
+#pragma omp barrier
+#pragma omp master
+  {
+    res = 0.;
+    for(int i = 0; i < omp_get_num_threads(); i++) {
+      res += g_omp_acc_re[i];
+    }
+#else
+    res = s;
+#endif
+#ifdef TM_USE_MPI
+    if(parallel) {
+      MPI_Allreduce(&res, &res_re, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+    else {
+      res_re = res;
+    }
+#else
+    res_re = res;
+#endif
+#ifdef TM_USE_OMP
+  } /* OpenMP master closing brace */
+#pragma omp barrier
+#endif
+  res = res_re;
+  return(res);
+}
+
+_Complex double reduce_cp_orphaned(const _Complex double s, const int parallel) {
+  _Complex double res;
+#ifdef TM_USE_OMP
+  g_omp_acc_cp[omp_get_thread_num()] = s;
+#pragma omp barrier
+#pragma omp master
+  {
+    res = 0.;
+    for(int i = 0; i < omp_get_num_threads(); i++) {
+      res += g_omp_acc_cp[i];
+    }
+#else
+    res = s;
+#endif
+#ifdef TM_USE_MPI
+    if(parallel) {
+      MPI_Allreduce(&res, &res_cp, 1, MPI_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
+    }
+    else {
+      res_cp = res;
+    }
+#else
+    res_cp = res;
+#endif
+#ifdef TM_USE_OMP
+  } /* OpenMP master closing brace */
+#pragma omp barrier
+#endif
+  res = res_cp;
+  return(res);
+}
@@ -0,0 +1,30 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef _REDUCE_ORPHANED_H
+#define _REDUCE_ORPHANED_H
+
+/* sum of the thread local values s over the thread team and, if parallel, */
+/* over all MPI processes; to be called by all threads of the team, every  */
+/* thread gets the same result                                             */
+double reduce_re_orphaned(const double s, const int parallel);
+_Complex double reduce_cp_orphaned(const _Complex double s, const int parallel);
+
+#endif
@@ -30,6 +30,7 @@
 #endif
 #include "su3.h"
 #include "scalar_prod.h"
+#include "reduce_orphaned.h"
 
 /*  <S,R>=S^* times R */
 #define _C_TYPE _Complex double
@@ -42,6 +43,39 @@
 #undef _PSWITCH
 #undef _PTSWITCH
 
+/* version to be called by all threads from within a parallel region */
+_Complex double scalar_prod_orphaned(const spinor * const S, const spinor * const R, const int N, const int parallel) {
+  _Complex double ALIGN ds,tr,ts,tt,ks,kc;
+  const spinor *s,*r;
+
+  ks = 0.0;
+  kc = 0.0;
+
+#ifdef TM_USE_OMP
+#pragma omp for nowait
+#endif
+  for (int ix = 0; ix < N; ix++)
+    {
+      s= S + ix;
+      r= R + ix;
+    
+      ds = r->s0.c0 * conj(s->s0.c0) + r->s0.c1 * conj(s->s0.c1) + r->s0.c2 * conj(s->s0.c2) +
+        r->s1.c0 * conj(s->s1.c0) + r->s1.c1 * conj(s->s1.c1) + r->s1.c2 * conj(s->s1.c2) +
+        r->s2.c0 * conj(s->s2.c0) + r->s2.c1 * conj(s->s2.c1) + r->s2.c2 * conj(s->s2.c2) + 
+        r->s3.c0 * conj(s->s3.c0) + r->s3.c1 * conj(s->s3.c1) + r->s3.c2 * conj(s->s3.c2);
+
+      /* Kahan Summation */
+      tr=ds+kc;
+      ts=tr+ks;
+      tt=ts-ks;
+      ks=ts;
+      kc=tr-tt;
+    }
+  kc=ks+kc;
+
+  return(reduce_cp_orphaned(kc, parallel));
+}
+
 #define _C_TYPE _Complex float
 #define _PSWITCH(s) s ## _32
 #define _PTSWITCH(s) s ## 32
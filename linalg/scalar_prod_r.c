@@ -35,6 +35,8 @@
 #endif
 #include "su3.h"
 #include "scalar_prod_r.h"
+#include "reduce_orphaned.h"
+#include "profiler.h"
 
 /*  R input, S input */
 
@@ -139,6 +141,7 @@ double scalar_prod_r(const spinor * const S, const spinor * const R, const int N
   double ALIGN mres;
 #endif
 
+  prof_begin("scalar_prod_r");
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
@@ -189,16 +192,52 @@ double scalar_prod_r(const spinor * const S, const spinor * const R, const int N
 #if defined TM_USE_MPI
   if(parallel)
   {
+    prof_begin("MPI_Allreduce");
     MPI_Allreduce(&res, &mres, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    prof_end("MPI_Allreduce", 0., 0.);
+    prof_end("scalar_prod_r", 48.*N, 2.*N*sizeof(spinor));
     return mres;
   }
 #endif
+  prof_end("scalar_prod_r", 48.*N, 2.*N*sizeof(spinor));
   return res;
 }
 
 
 #endif
 
+/* version to be called by all threads from within a parallel region */
+double scalar_prod_r_orphaned(const spinor * const S, const spinor * const R, const int N, const int parallel)
+{
+  double ALIGN ks,kc,ds,tr,ts,tt;
+  const spinor *s,*r;
+
+  ks = 0.0;
+  kc = 0.0;
+
+#ifdef TM_USE_OMP
+#pragma omp for nowait
+#endif
+  for (int ix = 0; ix < N; ++ix) {
+    s = S + ix;
+    r = R + ix;
+    
+    ds = creal(r->s0.c0 * conj(s->s0.c0)) + creal(r->s0.c1 * conj(s->s0.c1)) + creal(r->s0.c2 * conj(s->s0.c2)) +
+      creal(r->s1.c0 * conj(s->s1.c0)) + creal(r->s1.c1 * conj(s->s1.c1)) + creal(r->s1.c2 * conj(s->s1.c2)) +
+      creal(r->s2.c0 * conj(s->s2.c0)) + creal(r->s2.c1 * conj(s->s2.c1)) + creal(r->s2.c2 * conj(s->s2.c2)) +
+      creal(r->s3.c0 * conj(s->s3.c0)) + creal(r->s3.c1 * conj(s->s3.c1)) + creal(r->s3.c2 * conj(s->s3.c2));
+
+    tr = ds + kc;
+    ts = tr + ks;
+    tt = ts-ks;
+    ks = ts;
+    kc = tr-tt;
+  }
+  kc=ks+kc;
+
+  return(reduce_re_orphaned(kc, parallel));
+}
+
 #ifdef WITHLAPH
 double scalar_prod_r_su3vect(su3_vector * const S,su3_vector * const R, const int N, const int parallel)
 {
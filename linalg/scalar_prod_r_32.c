@@ -10,6 +10,7 @@
 #endif
 #include "su3.h"
 #include "scalar_prod_r_32.h"
+#include "reduce_orphaned.h"
 
 /*  R input, S input */
 
@@ -166,3 +167,35 @@ float scalar_prod_r_32(const spinor32 * const S, const spinor32 * const R, const
 }
 
 #endif
+
+/* version to be called by all threads from within a parallel region */
+float scalar_prod_r_32_orphaned(const spinor32 * const S, const spinor32 * const R, const int N, const int parallel)
+{
+  float ALIGN32 ks,kc,ds,tr,ts,tt;
+  const spinor32 *s,*r;
+
+  ks = 0.0;
+  kc = 0.0;
+
+#ifdef TM_USE_OMP
+#pragma omp for nowait
+#endif
+  for (int ix = 0; ix < N; ++ix) {
+    s = S + ix;
+    r = R + ix;
+    
+    ds = creal(r->s0.c0 * conj(s->s0.c0)) + creal(r->s0.c1 * conj(s->s0.c1)) + creal(r->s0.c2 * conj(s->s0.c2)) +
+      creal(r->s1.c0 * conj(s->s1.c0)) + creal(r->s1.c1 * conj(s->s1.c1)) + creal(r->s1.c2 * conj(s->s1.c2)) +
+      creal(r->s2.c0 * conj(s->s2.c0)) + creal(r->s2.c1 * conj(s->s2.c1)) + creal(r->s2.c2 * conj(s->s2.c2)) +
+      creal(r->s3.c0 * conj(s->s3.c0)) + creal(r->s3.c1 * conj(s->s3.c1)) + creal(r->s3.c2 * conj(s->s3.c2));
+
+    tr = ds + kc;
+    ts = tr + ks;
+    tt = ts-ks;
+    ks = ts;
+    kc = tr-tt;
+  }
+  kc=ks+kc;
+
+  return(reduce_re_orphaned(kc, parallel));
+}
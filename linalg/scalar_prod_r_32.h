@@ -5,5 +5,6 @@
 
 /* Returns the real part of the scalar product (*R,*S) */
 float scalar_prod_r_32(const spinor32 * const S, const spinor32 * const R, const int N, const int parallel);
+float scalar_prod_r_32_orphaned(const spinor32 * const S, const spinor32 * const R, const int N, const int parallel);
 
 #endif
\ No newline at end of file
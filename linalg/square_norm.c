@@ -42,6 +42,8 @@
 # include "sse.h"
 #endif
 #include "square_norm.h"
+#include "reduce_orphaned.h"
+#include "profiler.h"
 
 #if ((defined BGL) && (defined XLC))
 
@@ -257,6 +259,7 @@ double square_norm(const spinor * const P, const int N, const int parallel)
   double ALIGN mres;
 #endif
 
+  prof_begin("square_norm");
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
@@ -311,16 +314,59 @@ double square_norm(const spinor * const P, const int N, const int parallel)
 
 #  ifdef TM_USE_MPI
   if(parallel) {
+    prof_begin("MPI_Allreduce");
     MPI_Allreduce(&res, &mres, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    prof_end("MPI_Allreduce", 0., 0.);
+    prof_end("square_norm", 48.*N, (double)N*sizeof(spinor));
     return mres;
   }
 #endif
 
+  prof_end("square_norm", 48.*N, (double)N*sizeof(spinor));
   return res;
 }
 
 #endif
 
+/* version to be called by all threads from within a parallel region */
+double square_norm_orphaned(const spinor * const P, const int N, const int parallel)
+{
+  double ALIGN ks,kc,ds,tr,ts,tt;
+  const spinor *s;
+
+  ks = 0.0;
+  kc = 0.0;
+
+#ifdef TM_USE_OMP
+#pragma omp for nowait
+#endif
+  for (int ix  =  0; ix < N; ix++) {
+    s = P + ix;
+    
+    ds = conj(s->s0.c0) * s->s0.c0 +
+         conj(s->s0.c1) * s->s0.c1 +
+         conj(s->s0.c2) * s->s0.c2 +
+         conj(s->s1.c0) * s->s1.c0 +
+         conj(s->s1.c1) * s->s1.c1 +
+         conj(s->s1.c2) * s->s1.c2 +
+         conj(s->s2.c0) * s->s2.c0 +
+         conj(s->s2.c1) * s->s2.c1 +
+         conj(s->s2.c2) * s->s2.c2 +
+         conj(s->s3.c0) * s->s3.c0 +
+         conj(s->s3.c1) * s->s3.c1 +
+         conj(s->s3.c2) * s->s3.c2;
+
+    tr = ds + kc;
+    ts = tr + ks;
+    tt = ts-ks;
+    ks = ts;
+    kc = tr-tt;
+  }
+  kc=ks+kc;
+
+  return(reduce_re_orphaned(kc, parallel));
+}
+
 // threadsafe version
 
 double square_norm_ts(const spinor * const P, const int N, const int parallel)
@@ -14,6 +14,7 @@
 #include <complex.h>
 #include "su3.h"
 #include "square_norm_32.h"
+#include "reduce_orphaned.h"
 
 #if (defined BGQ && defined XLC)
 
@@ -163,6 +164,45 @@ float square_norm_32(const spinor32 * const P, const int N, const int parallel)
 
 #endif
 
+/* version to be called by all threads from within a parallel region */
+float square_norm_32_orphaned(const spinor32 * const P, const int N, const int parallel)
+{
+  float ALIGN32 ks,kc,ds,tr,ts,tt;
+  const spinor32 *s;
+
+  ks = 0.0;
+  kc = 0.0;
+
+#ifdef TM_USE_OMP
+#pragma omp for nowait
+#endif
+  for (int ix  =  0; ix < N; ix++) {
+    s = P + ix;
+    
+    ds = conj(s->s0.c0) * s->s0.c0 +
+         conj(s->s0.c1) * s->s0.c1 +
+         conj(s->s0.c2) * s->s0.c2 +
+         conj(s->s1.c0) * s->s1.c0 +
+         conj(s->s1.c1) * s->s1.c1 +
+         conj(s->s1.c2) * s->s1.c2 +
+         conj(s->s2.c0) * s->s2.c0 +
+         conj(s->s2.c1) * s->s2.c1 +
+         conj(s->s2.c2) * s->s2.c2 +
+         conj(s->s3.c0) * s->s3.c0 +
+         conj(s->s3.c1) * s->s3.c1 +
+         conj(s->s3.c2) * s->s3.c2;
+
+    tr = ds + kc;
+    ts = tr + ks;
+    tt = ts-ks;
+    ks = ts;
+    kc = tr-tt;
+  }
+  kc=ks+kc;
+
+  return(reduce_re_orphaned(kc, parallel));
+}
+
 // threadsafe version
 
 float square_norm_ts_32(const spinor32 * const P, const int N, const int parallel)
@@ -8,4 +8,5 @@
 
 float square_norm_32(const spinor32 * const P, const int N, const int parallel);
 float square_norm_ts_32(const spinor32 * const P, const int N, const int parallel);
+float square_norm_32_orphaned(const spinor32 * const P, const int N, const int parallel);
 #endif
@@ -67,4 +67,6 @@
 
 #include "linalg/convert_eo_to_lexic.h"
 
+#include "linalg/reduce_orphaned.h"
+
 #endif
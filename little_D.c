@@ -81,7 +81,7 @@ void unit_little_D(_Complex double *v, _Complex double *w) {
 
 /** ANOTHER TESTING FUNCTION */
 void invert_little_D_spinor(spinor *r, spinor *s){
-  int i, j;
+  int i;
   spinor **psi;
   _Complex double *v, *w;
   psi = calloc(nb_blocks, sizeof(spinor));
@@ -93,25 +93,14 @@ void invert_little_D_spinor(spinor *r, spinor *s){
   }
   split_global_field_GEN(psi, s, nb_blocks); // ADAPT THIS
      
-  for (j = 0; j < g_N_s; ++j) {/*loop over block.basis */
-    for(i=0;i<nb_blocks;i++) {
-      v[j + i*g_N_s] = scalar_prod(block_list[i].basis[j], psi[i], VOLUME/nb_blocks, 0);
-    }
-  }
+  blocks_restrict(v, psi);
 
   i = gcr4complex(w, v, 10, 100, little_solver_high_prec, 1, nb_blocks * g_N_s, 1, nb_blocks * 9 * g_N_s, 0, &little_D);
   if(g_proc_id == 0 && g_debug_level > 0) {
     printf("lgcr: %d iterations in invert_little_D_spinor\n", i);
   }
   
-  for(i = 0; i < nb_blocks; i++) {
-    mul(psi[i], w[i*g_N_s], block_list[i].basis[0], VOLUME/nb_blocks);
-  }
-  for(j = 1; j < g_N_s; ++j) {
-    for(i = 0; i < nb_blocks; i++) {
-      assign_add_mul(psi[i], block_list[i].basis[j], w[j+i*g_N_s], VOLUME/nb_blocks);
-    }
-  }
+  blocks_prolongate(psi, w);
   reconstruct_global_field_GEN(r, psi, nb_blocks); // ADAPT THIS
       
   free(v);
@@ -140,11 +129,11 @@ void invert_little_D_eo_spinor(spinor *r, spinor *s){
   }
   split_global_field_GEN(psi, s, nb_blocks); // ADAPT THIS 
   
+  blocks_restrict(v, psi);
   for (j = 0; j < g_N_s; ++j) {/*loop over block.basis */
     i_e=0;
     i_o=0;
     for(i=0;i<nb_blocks;i++) {
-      v[j + i*g_N_s] = scalar_prod(block_list[i].basis[j], psi[i], VOLUME/nb_blocks, 0);
       if (block_list[i].evenodd==0) {
 	v_eo[j+i_e*g_N_s] = v[j+i*g_N_s];
 	i_e++;
@@ -185,14 +174,7 @@ void invert_little_D_eo_spinor(spinor *r, spinor *s){
     printf("lgcr: %d iterations in invert_little_D_eo_spinor\n", iter);
   }
   
-  for(i = 0; i < nb_blocks; i++) {
-    mul(psi[i], w[i*g_N_s], block_list[i].basis[0], VOLUME/nb_blocks);
-  }
-  for(j = 1; j < g_N_s; ++j) {
-    for(i = 0; i < nb_blocks; i++) {
-      assign_add_mul(psi[i], block_list[i].basis[j], w[j+i*g_N_s], VOLUME/nb_blocks);
-    }
-  }
+  blocks_prolongate(psi, w);
   reconstruct_global_field_GEN(r, psi, nb_blocks); // ADAPT THIS
 
   free(v);
@@ -211,7 +193,7 @@ void project2(spinor * const out, spinor * const in);
 
 /** ANOTHER TESTING FUNCTION */
 void apply_little_D_spinor(spinor *r, spinor *s){
-  int i,j, k;
+  int i;
   spinor **psi;
   _Complex double *v, *w;
 
@@ -224,20 +206,11 @@ void apply_little_D_spinor(spinor *r, spinor *s){
   }
   split_global_field_GEN(psi, s, nb_blocks);  
 
-  for (j = 0; j < g_N_s; ++j) {
-    for(i = 0; i < nb_blocks; i++) v[j + i*g_N_s] = scalar_prod(block_list[i].basis[j], psi[i], VOLUME/nb_blocks, 0);
-  }
+  blocks_restrict(v, psi);
 
   little_D(w, v);
 
-  for(i = 0; i < nb_blocks; i++) {
-    mul(psi[i], w[i*g_N_s], block_list[i].basis[0], VOLUME/nb_blocks);
-  }
-  for(j = 1; j < g_N_s; ++j) {
-    for(i = 0; i < nb_blocks; i++){
-      assign_add_mul(psi[i], block_list[i].basis[j], w[i*g_N_s + j], VOLUME/nb_blocks);
-    }
-  }
+  blocks_prolongate(psi, w);
   reconstruct_global_field_GEN(r, psi, nb_blocks);
   
   free(v);
@@ -0,0 +1,270 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+ *
+ * Meson contractions of two propagators for all 16x16 gamma structures
+ * and a list of momenta.
+ *
+ * In the chiral basis used in tmLQCD every gamma structure has exactly one
+ * non-zero entry per row, G[a][p(a)] = c(a), so the gamma structures are
+ * stored as permutation p and phases c. For every site the spin matrix
+ *   M[a1][a2][b1][b2] = sum_{colour} S1[a1][b1] conj(S2[a2][b2])
+ * is computed once, all channels then only need 16 products each.
+ *
+ * The site loop runs once over the local volume, threaded, with the phases
+ * exp(-ipx) taken from a table computed beforehand. Every thread accumulates
+ * in its own buffer, the buffers are summed in the order of the threads and
+ * all timeslices, momenta and channels are reduced in one MPI_Reduce.
+ *
+ *******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include "global.h"
+#include "su3.h"
+#include "contractions.h"
+
+const char * meson_gamma_name[NO_MESON_GAMMA] = {"1", "g5", "g0", "g1", "g2", "g3",
+                                                 "g0g5", "g1g5", "g2g5", "g3g5",
+                                                 "g0g1", "g0g2", "g0g3", "g1g2", "g1g3", "g2g3"};
+
+typedef struct {
+  int p[4];
+  _Complex double c[4];
+} gamma_perm;
+
+/* 1, gamma_0..gamma_3 and gamma_5 as in su3spinor.h */
+static const gamma_perm gamma_basis[6] = {
+  {{0, 1, 2, 3}, {1., 1., 1., 1.}},
+  {{2, 3, 0, 1}, {1., 1., 1., 1.}},
+  {{3, 2, 1, 0}, {I, I, -I, -I}},
+  {{3, 2, 1, 0}, {1., -1., -1., 1.}},
+  {{2, 3, 0, 1}, {I, -I, -I, I}},
+  {{0, 1, 2, 3}, {1., 1., -1., -1.}}
+};
+
+static gamma_perm gamma_table[NO_MESON_GAMMA];
+static int gamma_init = 0;
+
+/* r = a*b */
+static void gamma_mult(gamma_perm * const r, const gamma_perm * const a, const gamma_perm * const b) {
+  for(int al = 0; al < 4; al++) {
+    r->p[al] = b->p[a->p[al]];
+    r->c[al] = a->c[al] * b->c[a->p[al]];
+  }
+  return;
+}
+
+static void init_gamma_table() {
+  /* factors from gamma_basis in the order of meson_gamma_name */
+  const int f[NO_MESON_GAMMA][2] = {{0, 0}, {5, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0},
+                                    {1, 5}, {2, 5}, {3, 5}, {4, 5},
+                                    {1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}};
+  for(int i = 0; i < NO_MESON_GAMMA; i++) {
+    gamma_mult(&gamma_table[i], &gamma_basis[f[i][0]], &gamma_basis[f[i][1]]);
+  }
+  gamma_init = 1;
+  return;
+}
+
+int momentum_list(int (** const mom)[3], const int max_p2) {
+  int n = 1, pm = (int)sqrt((double)max_p2);
+
+  *mom = malloc((2*pm+1)*(2*pm+1)*(2*pm+1)*sizeof(**mom));
+  (*mom)[0][0] = (*mom)[0][1] = (*mom)[0][2] = 0;
+  for(int px = -pm; px <= pm; px++) {
+    for(int py = -pm; py <= pm; py++) {
+      for(int pz = -pm; pz <= pm; pz++) {
+        int p2 = px*px + py*py + pz*pz;
+        if(p2 > 0 && p2 <= max_p2) {
+          (*mom)[n][0] = px;
+          (*mom)[n][1] = py;
+          (*mom)[n][2] = pz;
+          n++;
+        }
+      }
+    }
+  }
+  return(n);
+}
+
+int meson_contractions(_Complex double * const C, spinor ** const S1, spinor ** const S2,
+                       const int nsc, int (* const mom)[3], const int no_mom) {
+  const int VS = LX*LY*LZ;
+  const int nsrc = (nsc == 1) ? 1 : NO_MESON_GAMMA;
+  const int nc = NO_MESON_GAMMA*nsrc;
+  const int nloc = T*no_mom*nc;
+  const double g5[4] = {1., 1., -1., -1.};
+  _Complex double wsnk[NO_MESON_GAMMA][4], wsrc[NO_MESON_GAMMA][4];
+  _Complex double * ph, * buf, * sbuf;
+  int nthreads = 1;
+
+  if(nsc != 1 && nsc != 12) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "meson_contractions: propagators with %d spinors not supported\n", nsc);
+    }
+    return(-1);
+  }
+  if(!gamma_init) {
+    init_gamma_table();
+  }
+  /* the g5 of g5 S2^+ g5 go into the weights of the gamma structures */
+  for(int i = 0; i < NO_MESON_GAMMA; i++) {
+    for(int al = 0; al < 4; al++) {
+      wsnk[i][al] = gamma_table[i].c[al] * g5[al];
+      wsrc[i][al] = gamma_table[i].c[al] * g5[gamma_table[i].p[al]];
+    }
+  }
+
+  /* phases exp(-ipx) for all local spatial sites */
+  ph = (_Complex double*)malloc(no_mom*VS*sizeof(_Complex double));
+  for(int p = 0; p < no_mom; p++) {
+    for(int x = 0; x < LX; x++) {
+      for(int y = 0; y < LY; y++) {
+        for(int z = 0; z < LZ; z++) {
+          double arg = 2.*M_PI*((double)(mom[p][0]*(g_proc_coords[1]*LX + x))/(g_nproc_x*LX) +
+                                (double)(mom[p][1]*(g_proc_coords[2]*LY + y))/(g_nproc_y*LY) +
+                                (double)(mom[p][2]*(g_proc_coords[3]*LZ + z))/(g_nproc_z*LZ));
+          ph[p*VS + (x*LY + y)*LZ + z] = cos(arg) - I*sin(arg);
+        }
+      }
+    }
+  }
+
+#ifdef TM_USE_OMP
+  nthreads = omp_num_threads;
+#endif
+  buf = (_Complex double*)calloc(nthreads*nloc, sizeof(_Complex double));
+  /* local timeslices at their global position, zero elsewhere */
+  sbuf = (_Complex double*)calloc(g_nproc_t*nloc, sizeof(_Complex double));
+
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+  int thread = omp_get_thread_num();
+#else
+  int thread = 0;
+#endif
+  _Complex double * const acc = buf + thread*nloc;
+  _Complex double M[256], Cs[NO_MESON_GAMMA*NO_MESON_GAMMA];
+  const _Complex double * v1[12], * v2[12];
+
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int i = 0; i < VOLUME; i++) {
+    const int t = i/VS, is = i%VS;
+    const int ix = g_ipt[t][is/(LY*LZ)][(is/LZ)%LY][is%LZ];
+    for(int k = 0; k < nsc; k++) {
+      v1[k] = (const _Complex double*)(S1[k] + ix);
+      v2[k] = (const _Complex double*)(S2[k] + ix);
+    }
+    if(nsc == 12) {
+      for(int a1 = 0; a1 < 4; a1++) {
+        for(int a2 = 0; a2 < 4; a2++) {
+          for(int b1 = 0; b1 < 4; b1++) {
+            for(int b2 = 0; b2 < 4; b2++) {
+              _Complex double s = 0.;
+              for(int b = 0; b < 3; b++) {
+                for(int a = 0; a < 3; a++) {
+                  s += v1[3*b1+b][3*a1+a] * conj(v2[3*b2+b][3*a2+a]);
+                }
+              }
+              M[((a1*4 + a2)*4 + b1)*4 + b2] = s;
+            }
+          }
+        }
+      }
+      for(int snk = 0; snk < NO_MESON_GAMMA; snk++) {
+        const int * const ps = gamma_table[snk].p;
+        for(int src = 0; src < NO_MESON_GAMMA; src++) {
+          const int * const pr = gamma_table[src].p;
+          _Complex double s = 0.;
+          for(int al = 0; al < 4; al++) {
+            _Complex double sb = 0.;
+            for(int be = 0; be < 4; be++) {
+              sb += wsrc[src][be] * M[((ps[al]*4 + al)*4 + be)*4 + pr[be]];
+            }
+            s += wsnk[snk][al] * sb;
+          }
+          Cs[snk*NO_MESON_GAMMA + src] = s;
+        }
+      }
+    }
+    else {
+      for(int a1 = 0; a1 < 4; a1++) {
+        for(int a2 = 0; a2 < 4; a2++) {
+          M[a1*4 + a2] = v1[0][3*a1] * conj(v2[0][3*a2]) + v1[0][3*a1+1] * conj(v2[0][3*a2+1]) +
+            v1[0][3*a1+2] * conj(v2[0][3*a2+2]);
+        }
+      }
+      for(int snk = 0; snk < NO_MESON_GAMMA; snk++) {
+        const int * const ps = gamma_table[snk].p;
+        Cs[snk] = wsnk[snk][0] * M[ps[0]*4] + wsnk[snk][1] * M[ps[1]*4 + 1] +
+          wsnk[snk][2] * M[ps[2]*4 + 2] + wsnk[snk][3] * M[ps[3]*4 + 3];
+      }
+    }
+    for(int p = 0; p < no_mom; p++) {
+      const _Complex double phase = ph[p*VS + is];
+      _Complex double * const dst = acc + (t*no_mom + p)*nc;
+      for(int c = 0; c < nc; c++) {
+        dst[c] += phase * Cs[c];
+      }
+    }
+  }
+
+  /* sum of the thread buffers, always in the same order */
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int j = 0; j < nloc; j++) {
+    _Complex double s = 0.;
+    for(int th = 0; th < nthreads; th++) {
+      s += buf[th*nloc + j];
+    }
+    sbuf[g_proc_coords[0]*nloc + j] = s;
+  }
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
+
+#ifdef TM_USE_MPI
+  MPI_Reduce(sbuf, C, 2*g_nproc_t*nloc, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+  memcpy(C, sbuf, nloc*sizeof(_Complex double));
+#endif
+
+  free(sbuf);
+  free(buf);
+  free(ph);
+  return(0);
+}
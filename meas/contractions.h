@@ -0,0 +1,46 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef _CONTRACTIONS_H
+#define _CONTRACTIONS_H
+
+#include "su3.h"
+
+/* number of gamma structures: 1, g5, g0..g3, g0g5..g3g5, g0g1, g0g2, g0g3, g1g2, g1g3, g2g3 */
+#define NO_MESON_GAMMA 16
+
+extern const char * meson_gamma_name[NO_MESON_GAMMA];
+
+/* list of all momenta (in units of 2pi/L) with p^2 <= max_p2, p = 0 first */
+int momentum_list(int (** const mom)[3], const int max_p2);
+
+/* meson two-point functions                                               */
+/*   C(t, p, snk, src) = sum_x exp(-ipx) Tr[G_snk S1(x) G_src g5 S2(x)^+ g5] */
+/* for all NO_MESON_GAMMA^2 gamma structures and all no_mom momenta, where  */
+/* S1, S2 are lexicographic propagators of nsc = 12 spinors (source spin   */
+/* and colour index 3*is+ic). For nsc = 1 (one-end trick) the source gamma */
+/* structure is the one of the source and there is only one src index.     */
+/* C[((t*no_mom + p)*NO_MESON_GAMMA + snk)*nsrc + src], t the global time, */
+/* nsrc = NO_MESON_GAMMA for nsc = 12 and 1 for nsc = 1; the result is     */
+/* only available on g_proc_id == 0                                         */
+int meson_contractions(_Complex double * const C, spinor ** const S1, spinor ** const S2,
+                       const int nsc, int (* const mom)[3], const int no_mom);
+
+#endif
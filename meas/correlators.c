@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
+#include <complex.h>
 #include "global.h"
 #include "start.h"
 #include "ranlxs.h"
@@ -36,6 +37,7 @@
 #include "geometry_eo.h"
 #include "linalg/convert_eo_to_lexic.h"
 #include "measurements.h"
+#include "contractions.h"
 #include "correlators.h"
 #include "gettime.h"
 
@@ -54,21 +56,17 @@
  ******************************************************/
 
 void correlators_measurement(const int traj, const int id, const int ieo) {
-  int i, j, t, tt, t0;
+  int t, tt, t0;
   double *Cpp = NULL, *Cpa = NULL, *Cp4 = NULL;
-  double res = 0., respa = 0., resp4 = 0.;
+  _Complex double * C = NULL;
+  int zero_mom[1][3] = {{0, 0, 0}};
+  double norm;
   double atime, etime;
   float tmp;
   operator * optr;
-#ifdef TM_USE_MPI
-  double mpi_res = 0., mpi_respa = 0., mpi_resp4 = 0.;
-  // send buffer for MPI_Gather
-  double *sCpp = NULL, *sCpa = NULL, *sCp4 = NULL;
-#endif
   FILE *ofs;
   char *filename;
   char buf[100];
-  spinor phi;
   filename=buf;
   sprintf(filename,"%s%.6d", "onlinemeas." ,traj);
 
@@ -108,20 +106,10 @@ void correlators_measurement(const int traj, const int id, const int ieo) {
   }
   atime = gettime();
 
-#ifdef TM_USE_MPI
-  sCpp = (double*) calloc(T, sizeof(double));
-  sCpa = (double*) calloc(T, sizeof(double));
-  sCp4 = (double*) calloc(T, sizeof(double));
-  if(g_mpi_time_rank == 0) {
-    Cpp = (double*) calloc(g_nproc_t*T, sizeof(double));
-    Cpa = (double*) calloc(g_nproc_t*T, sizeof(double));
-    Cp4 = (double*) calloc(g_nproc_t*T, sizeof(double));
-  }
-#else
-  Cpp = (double*) calloc(T, sizeof(double));
-  Cpa = (double*) calloc(T, sizeof(double));
-  Cp4 = (double*) calloc(T, sizeof(double));
-#endif
+  Cpp = (double*) calloc(g_nproc_t*T, sizeof(double));
+  Cpa = (double*) calloc(g_nproc_t*T, sizeof(double));
+  Cp4 = (double*) calloc(g_nproc_t*T, sizeof(double));
+  C = (_Complex double*) calloc(g_nproc_t*T*NO_MESON_GAMMA, sizeof(_Complex double));
   source_generation_pion_only(g_spinor_field[0], g_spinor_field[1], 
 			      t0, 0, traj);
   optr->sr0 = g_spinor_field[0];
@@ -136,48 +124,19 @@ void correlators_measurement(const int traj, const int id, const int ieo) {
   /* here we use implicitly DUM_MATRIX and DUM_MATRIX+1 */
   convert_eo_to_lexic(g_spinor_field[DUM_MATRIX], g_spinor_field[2], g_spinor_field[3]);
   
-  /* now we sum only over local space for every t */
-  for(t = 0; t < T; t++) {
-    j = g_ipt[t][0][0][0];
-    res = 0.;
-    respa = 0.;
-    resp4 = 0.;
-    for(i = j; i < j+LX*LY*LZ; i++) {
-      res += _spinor_prod_re(g_spinor_field[DUM_MATRIX][i], g_spinor_field[DUM_MATRIX][i]);
-      _gamma0(phi, g_spinor_field[DUM_MATRIX][i]);
-      respa += _spinor_prod_re(g_spinor_field[DUM_MATRIX][i], phi);
-      _gamma5(phi, phi);
-      resp4 += _spinor_prod_im(g_spinor_field[DUM_MATRIX][i], phi);
-    }
-
-#if defined TM_USE_MPI
-    MPI_Reduce(&res, &mpi_res, 1, MPI_DOUBLE, MPI_SUM, 0, g_mpi_time_slices);
-    res = mpi_res;
-    MPI_Reduce(&respa, &mpi_respa, 1, MPI_DOUBLE, MPI_SUM, 0, g_mpi_time_slices);
-    respa = mpi_respa;
-    MPI_Reduce(&resp4, &mpi_resp4, 1, MPI_DOUBLE, MPI_SUM, 0, g_mpi_time_slices);
-    resp4 = mpi_resp4;
-    sCpp[t] = +res/(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
-    sCpa[t] = -respa/(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
-    sCp4[t] = +resp4/(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
-#else
-    Cpp[t] = +res/(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
-    Cpa[t] = -respa/(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
-    Cp4[t] = +resp4/(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
-#endif
+  /* all sink gamma structures in one sweep and one reduction, with    */
+  /* C(G) = sum_x phi^+ g5 G phi, hence PP = C(g5), PA = C(g0g5) and   */
+  /* P4 from C(g0); the result is available on g_proc_id == 0 only     */
+  meson_contractions(C, &g_spinor_field[DUM_MATRIX], &g_spinor_field[DUM_MATRIX], 1, zero_mom, 1);
+  norm = 1./(g_nproc_x*LX)/(g_nproc_y*LY)/(g_nproc_z*LZ)/2./optr->kappa/optr->kappa;
+  for(t = 0; t < g_nproc_t*T; t++) {
+    Cpp[t] = +creal(C[t*NO_MESON_GAMMA + 1])*norm;
+    Cpa[t] = +creal(C[t*NO_MESON_GAMMA + 6])*norm;
+    Cp4[t] = -cimag(C[t*NO_MESON_GAMMA + 2])*norm;
   }
 
-#ifdef TM_USE_MPI
-  /* some gymnastics needed in case of parallelisation */
-  if(g_mpi_time_rank == 0) {
-    MPI_Gather(sCpp, T, MPI_DOUBLE, Cpp, T, MPI_DOUBLE, 0, g_mpi_SV_slices);
-    MPI_Gather(sCpa, T, MPI_DOUBLE, Cpa, T, MPI_DOUBLE, 0, g_mpi_SV_slices);
-    MPI_Gather(sCp4, T, MPI_DOUBLE, Cp4, T, MPI_DOUBLE, 0, g_mpi_SV_slices);
-  }
-#endif
-
   /* and write everything into a file */
-  if(g_mpi_time_rank == 0 && g_proc_coords[0] == 0) {
+  if(g_proc_id == 0) {
     ofs = fopen(filename, "w");
     fprintf( ofs, "1  1  0  %e  %e\n", Cpp[t0], 0.);
     for(t = 1; t < g_nproc_t*T/2; t++) {
@@ -210,14 +169,8 @@ void correlators_measurement(const int traj, const int id, const int ieo) {
     fprintf( ofs, "6  1  %d  %e  %e\n", t, Cp4[tt], 0.);
     fclose(ofs);
   }
-#ifdef TM_USE_MPI
-  if(g_mpi_time_rank == 0) {
-    free(Cpp); free(Cpa); free(Cp4);
-  }
-  free(sCpp); free(sCpa); free(sCp4);
-#else
   free(Cpp); free(Cpa); free(Cp4);
-#endif
+  free(C);
   etime = gettime();
   
   if(g_proc_id == 0 && g_debug_level > 0) {
@@ -120,7 +120,8 @@ void step_gradient_flow(su3 ** x0, su3 ** x1, su3 ** x2, su3 ** z, const unsigne
 
 void gradient_flow_measurement(const int traj, const int id, const int ieo) {
 
-  double E[3],t[3], P[3];
+  double E[3],t[3], P[3], Q[3];
+  gauge_obs_t obs;
   double W=0, eps=0.01, tsqE=0;
   double t1, t2;
 
@@ -140,7 +141,7 @@ void gradient_flow_measurement(const int traj, const int id, const int ieo) {
       fatal_error(error_message,"gradient_flow_measurement");
     }
 
-    fprintf(outfile, "traj t P Eplaq Esym tsqEplaq tsqEsym Wsym\n");
+    fprintf(outfile, "traj t P Eplaq Esym tsqEplaq tsqEsym Wsym Qsym\n");
   }
 
   aligned_su3_field_t vt = aligned_su3_field_alloc(VOLUMEPLUSRAND+g_dbw2rand);
@@ -153,13 +154,16 @@ void gradient_flow_measurement(const int traj, const int id, const int ieo) {
 #endif
   memcpy(vt.field[0],g_gauge_field[0],sizeof(su3)*4*(VOLUMEPLUSRAND+g_dbw2rand));
 
-  t[0] = E[0] = P[0] = 0.0;
-  t[1] = E[1] = P[1] = 0.0;
-  t[2] = E[2] = P[2] = 0.0;
+  t[0] = E[0] = P[0] = Q[0] = 0.0;
+  t[1] = E[1] = P[1] = Q[1] = 0.0;
+  t[2] = E[2] = P[2] = Q[2] = 0.0;
 
   t1 = gettime();
-  measure_energy_density(vt.field,&E[2]);
-  P[2] = measure_plaquette(vt.field)/(6.0*VOLUME*g_nproc);
+  // plaquette, energy density and topological charge in a single sweep
+  measure_gauge_observables((const su3 ** const)vt.field, GAUGE_OBS_CLOVER, &obs, NULL);
+  E[2] = obs.E;
+  P[2] = obs.plaq/(6.0*VOLUME*g_nproc);
+  Q[2] = obs.Q;
   t2 = gettime();
   if(g_proc_id==0 && g_debug_level > 2) {
     printf("time for energy density measurement: %lf\n",t2-t1);
@@ -169,11 +173,14 @@ void gradient_flow_measurement(const int traj, const int id, const int ieo) {
     t[0] = t[2];
     E[0] = E[2];
     P[0] = P[2];
+    Q[0] = Q[2];
     for(int step = 1; step < 3; ++step) {
       t[step] = t[step-1]+eps;
       step_gradient_flow(vt.field,x1.field,x2.field,z.field,0,eps);
-      measure_energy_density(vt.field,&E[step]);
-      P[step] = measure_plaquette(vt.field)/(6.0*VOLUME*g_nproc);
+      measure_gauge_observables((const su3 ** const)vt.field, GAUGE_OBS_CLOVER, &obs, NULL);
+      E[step] = obs.E;
+      P[step] = obs.plaq/(6.0*VOLUME*g_nproc);
+      Q[step] = obs.Q;
     }
     W = t[1]*t[1]*( 2*E[1] + t[1]*((E[2]-E[0])/(2*eps)) ) ;
     tsqE = t[1]*t[1]*E[1];
@@ -185,11 +192,11 @@ void gradient_flow_measurement(const int traj, const int id, const int ieo) {
         W);
     }
     if(g_proc_id==0){
-      fprintf(outfile,"%06d %f %2.12lf %2.12lf %2.12lf %2.12lf %2.12lf %2.12lf \n",
+      fprintf(outfile,"%06d %f %2.12lf %2.12lf %2.12lf %2.12lf %2.12lf %2.12lf %2.12lf \n",
                       traj,t[1],P[1],
                       36*(1-P[1]),E[1],
                       t[1]*t[1]*36*(1-P[1]),tsqE,
-                      W);
+                      W,Q[1]);
       fflush(outfile);
     }
 
@@ -35,6 +35,7 @@
 #include "polyakov_loop.h"
 #include "oriented_plaquettes.h"
 #include "gradient_flow.h"
+#include "mesons.h"
 #include "measurements.h"
 
 measurement measurement_list[max_no_measurements];
@@ -78,6 +79,11 @@ int init_measurements(){
     if(measurement_list[i].type == GRADIENT_FLOW) {
       measurement_list[i].measurefunc = &gradient_flow_measurement;
     }
+
+    if(measurement_list[i].type == MESONS) {
+      measurement_list[i].measurefunc = &mesons_measurement;
+      measurement_list[i].max_source_slice = g_nproc_t*T;
+    }
     
     measurement_list[i].id = i;
  }
@@ -30,7 +30,8 @@ enum MEAS_TYPE {
   PIONNORM, 
   POLYAKOV, 
   ORIENTED_PLAQUETTES,
-  GRADIENT_FLOW 
+  GRADIENT_FLOW,
+  MESONS
   };
 
 typedef struct {
@@ -44,6 +45,9 @@ typedef struct {
   int max_iter;
   /* for polyakov loop */
   int direction;
+  int resolved;
+  /* for meson contractions: maximal p^2 in units of (2pi/L)^2 */
+  int max_momentum;
   
   /* how it's usually called */
   char name[100];
@@ -0,0 +1,153 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <complex.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#include "global.h"
+#include "start.h"
+#include "ranlxs.h"
+#include "operator.h"
+#include "linalg/convert_eo_to_lexic.h"
+#include "measurements.h"
+#include "contractions.h"
+#include "mesons.h"
+#include "gettime.h"
+
+/******************************************************
+ *
+ * This routine computes the charged meson two-point
+ * functions for all 16x16 gamma structures and all
+ * momenta with p^2 <= MaxMomentum (in units of 2pi/L)
+ * from the twelve point source propagators at
+ * (t0, 0, 0, 0), t0 chosen randomly
+ *
+ * the output file mesons.traj contains lines
+ *   G_snk G_src px py pz t Re(C) Im(C)
+ * with t relative to t0
+ *
+ ******************************************************/
+
+void mesons_measurement(const int traj, const int id, const int ieo) {
+  const int Tg = g_nproc_t*T;
+  int t0, no_mom, (*mom)[3] = NULL;
+  _Complex double * C = NULL;
+  spinor ** S = NULL, * S_ = NULL;
+  double atime, etime;
+  float tmp;
+  operator * optr;
+  FILE *ofs;
+  char filename[100];
+  sprintf(filename,"%s%.6d", "mesons." ,traj);
+
+  init_operators();
+  if(no_operators < 1) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Warning! no operators defined in input file, cannot perform meson measurement!\n");
+    }
+    return;
+  }
+  optr = &operator_list[0];
+  optr->DownProp = 0;
+  if(optr->type != TMWILSON && optr->type != WILSON && optr->type != CLOVER) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Warning! meson measurement currently only implemented for TMWILSON, WILSON and CLOVER\n");
+    }
+    return;
+  }
+
+  /* generate random timeslice */
+  if(ranlxs_init == 0) {
+    rlxs_init(1, 123456);
+  }
+  ranlxs(&tmp, 1);
+  t0 = (int)(measurement_list[id].max_source_slice*tmp);
+#ifdef TM_USE_MPI
+  MPI_Bcast(&t0, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+  if(g_debug_level > 1 && g_proc_id == 0) {
+    printf("# point source at (%d, 0, 0, 0) for meson measurement\n", t0);
+  }
+  atime = gettime();
+
+  /* the twelve propagators in lexicographic order */
+  S = (spinor**) malloc(12*sizeof(spinor*));
+  S_ = (spinor*) calloc(12*VOLUME+1, sizeof(spinor));
+  for(int isc = 0; isc < 12; isc++) {
+#if (defined SSE || defined SSE2 || defined SSE3)
+    S[isc] = (spinor*)(((unsigned long int)(S_)+ALIGN_BASE)&~ALIGN_BASE) + isc*VOLUME;
+#else
+    S[isc] = S_ + isc*VOLUME;
+#endif
+  }
+  /* with the iteration limit of the measurement */
+  const int maxiter = optr->maxiter;
+  optr->maxiter = measurement_list[id].max_iter;
+  for(int isc = 0; isc < 12; isc++) {
+    source_spinor_field_point_from_file(g_spinor_field[0], g_spinor_field[1], isc/3, isc%3,
+                                        t0*(g_nproc_x*LX)*(g_nproc_y*LY)*(g_nproc_z*LZ));
+    optr->sr0 = g_spinor_field[0];
+    optr->sr1 = g_spinor_field[1];
+    optr->prop0 = g_spinor_field[2];
+    optr->prop1 = g_spinor_field[3];
+    optr->inverter(0, 0, 0);
+    convert_eo_to_lexic(S[isc], g_spinor_field[2], g_spinor_field[3]);
+  }
+  optr->maxiter = maxiter;
+
+  no_mom = momentum_list(&mom, measurement_list[id].max_momentum);
+  C = (_Complex double*) calloc(Tg*no_mom*NO_MESON_GAMMA*NO_MESON_GAMMA, sizeof(_Complex double));
+  /* for the charged mesons S_d = g5 S_u^+ g5, so S2 = S1 */
+  meson_contractions(C, S, S, 12, mom, no_mom);
+
+  if(g_proc_id == 0) {
+    ofs = fopen(filename, "w");
+    for(int snk = 0; snk < NO_MESON_GAMMA; snk++) {
+      for(int src = 0; src < NO_MESON_GAMMA; src++) {
+        for(int p = 0; p < no_mom; p++) {
+          for(int t = 0; t < Tg; t++) {
+            const _Complex double c = 
+              C[((((t0+t)%Tg)*no_mom + p)*NO_MESON_GAMMA + snk)*NO_MESON_GAMMA + src];
+            fprintf(ofs, "%s %s %d %d %d %d %e %e\n", meson_gamma_name[snk], meson_gamma_name[src],
+                    mom[p][0], mom[p][1], mom[p][2], t, creal(c), cimag(c));
+          }
+        }
+      }
+    }
+    fclose(ofs);
+  }
+  free(C);
+  free(mom);
+  free(S_);
+  free(S);
+  etime = gettime();
+
+  if(g_proc_id == 0 && g_debug_level > 0) {
+    printf("MESONS: measurement done int t/s = %1.4e\n", etime - atime);
+  }
+  return;
+}
@@ -1,5 +1,6 @@
 /***********************************************************************
- * Copyright (C) 2002,2003,2004,2005,2006,2007,2008 Carsten Urbach
+ *
+ * Copyright (C) 2016
  *
  * This file is part of tmLQCD.
  *
@@ -7,17 +8,19 @@
  * it under the terms of the GNU General Public License as published by
  * the Free Software Foundation, either version 3 of the License, or
  * (at your option) any later version.
- * 
+ *
  * tmLQCD is distributed in the hope that it will be useful,
  * but WITHOUT ANY WARRANTY; without even the implied warranty of
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU General Public License for more details.
- * 
+ *
  * You should have received a copy of the GNU General Public License
  * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
  ***********************************************************************/
-#ifndef _OVERRELAXATION_H
-#define _OVERRELAXATION_H
- 
-extern void overrel_sweep();
+
+#ifndef _MESONS_H
+#define _MESONS_H
+
+void mesons_measurement(const int traj, const int id, const int ieo);
+
 #endif
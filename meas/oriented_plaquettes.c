@@ -31,57 +31,17 @@
 
 #include "global.h"
 #include "su3.h"
-#include "geometry_eo.h"
+#include "measure_gauge_action.h"
 #include "oriented_plaquettes.h"
 #include "fatal_error.h"
 #include "measurements.h"
 
 void measure_oriented_plaquettes(const su3 ** const gf, double *plaq) {
-#ifdef TM_USE_MPI
-  double ALIGN mplaq[6];
-#endif
-
-  int ix,ix1,ix2,mu1,mu2,plane;
-  su3 ALIGN pr1,pr2; 
-  const su3 *v,*w;
-  double ALIGN pl; 
-  double ALIGN ks[6] = {0.0,0.0,0.0,0.0,0.0,0.0};
-  double ALIGN kc[6] = {0.0,0.0,0.0,0.0,0.0,0.0};
-  double ALIGN tr[6],ts[6],tt[6];
-
-  for (ix=0;ix<VOLUME;ix++){
-    plane = 0;
-    for (mu1=0;mu1<3;mu1++){ 
-      ix1=g_iup[ix][mu1];
-      for (mu2=mu1+1;mu2<4;mu2++){ 
-        ix2=g_iup[ix][mu2];
-        v=&gf[ix][mu1];
-        w=&gf[ix1][mu2];
-        _su3_times_su3(pr1,*v,*w);
-        v=&gf[ix][mu2];
-        w=&gf[ix2][mu1];
-        _su3_times_su3(pr2,*v,*w);
-        _trace_su3_times_su3d(pl,pr1,pr2);
-        tr[plane]=pl+kc[plane];
-        ts[plane]=tr[plane]+ks[plane];
-        tt[plane]=ts[plane]-ks[plane];
-        ks[plane]=ts[plane];
-        kc[plane]=tr[plane]-tt[plane];
-        ++plane;
-      }
-    }
+  gauge_obs_t obs;
+  measure_gauge_observables(gf, GAUGE_OBS_PLAQ, &obs, NULL);
+  for(int j = 0; j < 6; j++) {
+    plaq[j] = obs.plaq_plane[j];
   }
-
-  for(int j = 0; j < 6; ++j) {
-    kc[j]=(kc[j]+ks[j])/3.0;
-    plaq[j] = kc[j]/(g_nproc*VOLUME);
-  }
-
-#ifdef TM_USE_MPI
-  MPI_Allreduce(plaq, mplaq, 6, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  for(int j = 0; j < 6; j++)
-    plaq[j] = mplaq[j];
-#endif
   return;
 }
 
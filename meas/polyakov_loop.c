@@ -26,6 +26,10 @@
  * Polyakov loop in time direction added by Marcus Petschlies
  *       2008
  *
+ * All four directions with one engine: the local line segments are
+ * multiplied in parallel with OpenMP, the segments of the ranks along
+ * the line are combined in a binary tree of log2(g_nproc_mu) steps
+ *
  ***********************************************************************/
 
 #ifdef HAVE_CONFIG_H
@@ -38,6 +42,9 @@
 #ifdef TM_USE_MPI
 # include <mpi.h>
 #endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "global.h"
 #include <complex.h>
 #include "sse.h"
@@ -48,250 +55,199 @@
 #include "polyakov_loop.h"
 #include "gettime.h"
 
-void polyakov_loop(_Complex double * pl_, const int mu) {
+/* local and global extent of the lattice in direction mu */
+static int local_extent(const int mu) {
+  const int L[4] = {T, LX, LY, LZ};
+  return(L[mu]);
+}
 
-  static int i0, i1, i2, i3, L0, L1, L2, L3, ixyzt, ixyzt_up;
-  static double vol;
-  static su3 tmp, tmp2; 
-  su3 *v = NULL , *w = NULL;
-  static _Complex double pl; 
-  /* For the Kahan summation:*/
-#ifdef TM_USE_MPI
-  static _Complex double pls; 
-#endif
-  static _Complex double ks = 0.0, kc = 0.0, tr, ts, tt;
-  
-  /* For the moment only the Polyakov loop in y- and z-direction 
-     are implemented, since they are not affected by parallelisation: */
-  if(mu == 0 || mu == 1 || mu > 3) {
-    fprintf(stderr, "Wrong parameter for Polyakov loop calculation in polyakov_loop.c:\n");
-    fprintf(stderr, "Only direction %d and %d are allowed.\n",2,3);
-    fprintf(stderr, "Actual value is %d! Aborting...\n",mu);
-#ifdef TM_USE_MPI
-    MPI_Abort(MPI_COMM_WORLD, 10);
-    MPI_Finalize();
-#endif
-    exit(0);
-  }
-  
-  
-  L0=T;
-  L1=LX;
-  if(mu==2) {
-    L2=LZ;
-    L3=LY;
-  }
-  else {
-    L2=LY;
-    L3=LZ;
+static int global_extent(const int mu) {
+  const int L[4] = {g_nproc_t*T, g_nproc_x*LX, g_nproc_y*LY, g_nproc_z*LZ};
+  return(L[mu]);
+}
+
+/* the three directions orthogonal to mu in increasing order */
+static void transverse_directions(const int mu, int * const d) {
+  for(int nu = 0, k = 0; nu < 4; nu++) {
+    if(nu != mu) d[k++] = nu;
   }
-  /* loop over the spatial sites: */
-  for (i0=0; i0 < L0; i0++) {
-    for (i1=0; i1 < L1; i1++) {
-      for (i2=0; i2 < L2; i2++) {
-	/* at each spatial site multiply the links in 
-	   temporal direction: */
-	i3 = 0;
-	/* get the site index: */
-	if(mu==2) {
-	  ixyzt = g_ipt[i0][i1][i3][i2];
-	}
-	else {
-	  ixyzt = g_ipt[i0][i1][i2][i3];
-	}
-	/* and its neigbour in direction mu: */
-	ixyzt_up = g_iup[ixyzt][mu];
-	
-	/* Get the links and multiply them: ixyzt --> ixyzt_up --> */
-	v = &g_gauge_field[ixyzt][mu];
-	w = &g_gauge_field[ixyzt_up][mu];
-	_su3_times_su3(tmp, *v, *w);
-	
-	/* now start the loop over indices in mu-direction: */
-	for (i3=1; i3 < L3-2; i3++) {
-	  /* store the current result in v:*/
-	  _su3_assign(tmp2,tmp);
-	  /* get the next site index: */
-	  ixyzt_up = g_iup[ixyzt_up][mu];
-	  /* and the corresponding link matrix: */
-	  w = &g_gauge_field[ixyzt_up][mu];
-	  /* and multiply them: */
-	  _su3_times_su3(tmp, tmp2, *w);
-	}
-	
-	/* for the last link we directly take the _Complex double trace: */
-	ixyzt_up = g_iup[ixyzt_up][mu];
-	w = &g_gauge_field[ixyzt_up][mu];
-	_trace_su3_times_su3(pl,tmp,*w);
-	
-	/* printf("i0=%d, i1=%d, i2=%d, pl=(%e,%e)\n",i0,i1,i2,creal(pl),cimag(pl));*/
-	
-	/* Kahan summation for real and imaginary part: */
-	tr = pl + kc;
-	ts = tr + ks;
-	tt = ts - ks;
-	ks = ts;
-	kc = tr - tt;
-      }
+  return;
+}
+
+/* P[i] = product of the local links in direction mu along the line through */
+/* the transverse site i = (x[d0]*L[d1] + x[d1])*L[d2] + x[d2], x[mu] = 0     */
+static void local_lines(su3 * const P, const int mu) {
+  int d[3];
+  const int Lmu = local_extent(mu);
+  transverse_directions(mu, d);
+  const int L1 = local_extent(d[1]), L2 = local_extent(d[2]);
+  const int VOL3 = VOLUME/Lmu;
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int i = 0; i < VOL3; i++) {
+    int x[4];
+    su3 ALIGN tmp, tmp2;
+    su3 *u, *v, *w;
+    x[mu] = 0;
+    x[d[0]] = i/(L1*L2);
+    x[d[1]] = (i/L2)%L1;
+    x[d[2]] = i%L2;
+    u = &tmp;
+    v = &tmp2;
+    _su3_assign(*u, g_gauge_field[g_ipt[x[0]][x[1]][x[2]][x[3]]][mu]);
+    for(x[mu] = 1; x[mu] < Lmu; x[mu]++) {
+      /* swap u and v via w */
+      w = u; u = v; v = w;
+      w = &g_gauge_field[g_ipt[x[0]][x[1]][x[2]][x[3]]][mu];
+      _su3_times_su3(*u, *v, *w);
     }
+    _su3_assign(P[i], *u);
   }
-  /* Finish Kahan summation: */
-  /* (Division by 3 is for normalising the colour trace.) */
-  pl = (kc + ks) / 3.0;
-  /*  printf("Polyakov loop before normalisation, pl.re=%e, pl.im=%e\n",creal(pl),cimag(pl));*/
-  
-  
-  /* Collect the results and return:*/
-#ifdef TM_USE_MPI
-  MPI_Allreduce(&pl, &pls, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  pl=pls;
-#endif
-  
-  /* Normalise, i.e. divide by the number of loops: */
-  vol = (double) L0*L1*L2*g_nproc_t*g_nproc_x;
-  /*    printf("L0*L1*L2=%d, vol=%e\n",L0*L1*L2,vol);  */
-  pl /= vol;
-  /*    printf("Polyakov loop after normalisation, pl.re=%e, pl.im=%e\n",creal(pl),cimag(pl)) */; 
-  /*   return pl; */
-  *pl_ = pl;
+  return;
 }
 
-
-/* here comes the one in time direction */
-
-int polyakov_loop_0(const int nstore, _Complex double *pl) {
-
-  int i0, i1, i2, i3, ixyz, ixyzt, ixyzt_up, VOL3, VOLUME3;
-  int L0, L1, L2, L3;
-  double retime, ratime;
-  _Complex double pl_tmp, tr, ts, tt, kc, ks;
-  su3 *tmp_loc = NULL, tmp, tmp2;
-  su3 *v = NULL, *w = NULL;
-  
-  FILE *ofs = NULL;
-  
 #ifdef TM_USE_MPI
-  int iproc;
+/* one dimensional communicators along the four directions, the rank */
+/* in line_comm[mu] is the coordinate g_proc_coords[mu]              */
+static MPI_Comm line_comm[4];
+static int line_comm_init = 0;
+
+static void init_line_comm() {
+  for(int mu = 0; mu < 4; mu++) {
+    int remain[4] = {0, 0, 0, 0};
+    remain[mu] = 1;
+    MPI_Cart_sub(g_cart_grid, remain, &line_comm[mu]);
+  }
+  line_comm_init = 1;
+  return;
+}
+
+/* ordered product of the segments P of all ranks along mu in a binary */
+/* tree: after the step with distance s the rank r holds the product of */
+/* the segments r, ..., r+2s-1; the full lines end up on rank 0         */
+static void line_reduce(su3 * const P, const int n, const int mu) {
+  int rank, size;
   MPI_Status status;
-  su3 *tmp_nnb = NULL;
+  su3 * buf;
+
+  MPI_Comm_rank(line_comm[mu], &rank);
+  MPI_Comm_size(line_comm[mu], &size);
+  if(size == 1) return;
+  buf = (su3*)malloc(n*sizeof(su3));
+  for(int s = 1; s < size; s *= 2) {
+    if(rank % (2*s) == s) {
+      MPI_Send(P, n, mpi_su3, rank - s, 101, line_comm[mu]);
+      break;
+    }
+    if(rank % (2*s) == 0 && rank + s < size) {
+      MPI_Recv(buf, n, mpi_su3, rank + s, 101, line_comm[mu], &status);
+#ifdef TM_USE_OMP
+#pragma omp parallel for
 #endif
-  
-  L0 = LX; /* enable transparent comparison with existing Polyakov routines */
-  L1 = LY; /* in spatial directions                                         */
-  L2 = LZ;
-  L3 = T;
-  
-  /**************
-   * local part *
-   **************/
-    ratime = gettime();
-
-  VOL3 = L0*L1*L2;
-  tmp_loc = (su3 *)calloc(VOL3, sizeof(su3));
-  
-  for(i0 = 0; i0 < LX; i0++) {
-    for(i1 = 0; i1 < LY; i1++) {
-      for(i2 = 0; i2 < LZ; i2++) {
-	ixyz = (i2 * L1 + i1) * L0 + i0;
-	i3 = 0;
-	ixyzt    = g_ipt[i3][i0][i1][i2];
-	ixyzt_up = g_iup[ixyzt][0];
-	v = &g_gauge_field[ixyzt][0];
-	w = &g_gauge_field[ixyzt_up][0];
-	_su3_times_su3(tmp, *v, *w);
-	
-	for(i3 = 1; i3 < L3-1; i3++) {
-	  _su3_assign(tmp2,tmp);
-	  ixyzt_up = g_iup[ixyzt_up][0];
-	  w = &g_gauge_field[ixyzt_up][0];
-	  _su3_times_su3(tmp, tmp2, *w);
-	}
-	_su3_assign(tmp_loc[ixyz],tmp);
+      for(int i = 0; i < n; i++) {
+        su3 ALIGN tmp;
+        _su3_times_su3(tmp, P[i], buf[i]);
+        _su3_assign(P[i], tmp);
       }
     }
   }
-  retime = gettime();
-  if(g_debug_level>0) {
-    fprintf(stdout, "[polyakov_loop_0 | %3d] time for calculating local part = %e seconds\n", g_cart_id, retime-ratime);
+  free(buf);
+  return;
+}
+#endif
+
+int polyakov_loop_lines(su3 * const P, const int mu) {
+  local_lines(P, mu);
+#ifdef TM_USE_MPI
+  if(!line_comm_init) {
+    init_line_comm();
   }
-  
-  /********************************************************************************/
-    
+  line_reduce(P, VOLUME/local_extent(mu), mu);
+#endif
+  return(g_proc_coords[mu] == 0);
+}
+
+_Complex double polyakov_loop_average(const int mu, _Complex double * const pl_site) {
+  const int VOL3 = VOLUME/local_extent(mu);
+  const int have_lines = (g_proc_coords[mu] == 0);
+  static _Complex double pl;
+  su3 * P = (su3*)malloc(VOL3*sizeof(su3));
 #ifdef TM_USE_MPI
-  /***************
-   * global part *
-   ***************/
+  _Complex double ALIGN mpl;
+#endif
 
-  ratime = MPI_Wtime();
+  polyakov_loop_lines(P, mu);
 
-  /* (1) collect contributions from different time slices to nodes with t-coord. 0 */
-  tmp_nnb = (su3*)calloc(VOL3, sizeof(su3)); /* contains the next-neighbour-part*/
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+  int thread_num = omp_get_thread_num();
+#endif
+  _Complex double ALIGN tr, ts, tt, kc, ks;
 
-  /* note: in the following loop t is taken as the time coordinate of nodes */
-  for(iproc = g_nproc_t-1; iproc > 0; iproc--) {
-    if(g_proc_coords[0] == iproc) /* node is in the {t=iproc}-hyperplane */ {
-      MPI_Send(tmp_loc, VOL3, mpi_su3, g_nb_t_dn, 100+g_cart_id, g_cart_grid);
-      /* send tmp_loc from {t=iproc}-hyperplane to {t=iproc-1}-hyperplane */
-    }
-    if(g_proc_coords[0] == iproc-1) {
-      /* so the node is right below the sending one in time(= 0)-direction */
-      MPI_Recv(tmp_nnb, VOL3, mpi_su3, g_nb_t_up, 100+g_nb_t_up, g_cart_grid, &status); 
-      /* receive tmp_loc from the tmp_loc from the
-	 {t=my_own_t_index+1}-hyperplane */
-      for(ixyz=0; ixyz<VOL3; ixyz++) {
-	/* multiply all matrices in tmp_nbb to my own in tmp_loc from the right */
-	v = tmp_loc+ixyz; 
-	w = tmp_nnb+ixyz; 
-	_su3_assign(tmp2, *v);
-	_su3_times_su3(*v, tmp2, *w);
-      }
-    }
-    /* if iproc==0 then the node with g_proc_coords[0]=0 will finally contain
-       the product of all contributions from all {t=const.}-planes */
-  }
- 
-  retime = MPI_Wtime();
-  if(g_proc_id==0 && g_debug_level>0) {
-    fprintf(stdout, "[polyakov_loop_0 | %3d] time for calculating global part = %e seconds\n", g_cart_id, retime-ratime);
-  }
- 
-  /* (2) nodes with time coordinate 0 sum traces over local spatial points */
+  kc = 0.0; ks = 0.0;
+  if(have_lines) {
+#ifdef TM_USE_OMP
+#pragma omp for
 #endif
-  pl_tmp = 0.0;
-  if(g_proc_coords[0] == 0) {
-    
-    kc = 0.0; ks = 0.0;
-    for(ixyz = 0; ixyz < VOL3; ixyz++) /* Kahan-summation of traces */
-    {
-      pl_tmp = tmp_loc[ixyz].c00 + tmp_loc[ixyz].c11 + tmp_loc[ixyz].c22;
+    for(int i = 0; i < VOL3; i++) {
+      /* (Division by 3 is for normalising the colour trace.) */
+      _Complex double pl_tmp = (P[i].c00 + P[i].c11 + P[i].c22) / 3.;
+      if(pl_site != NULL) pl_site[i] = pl_tmp;
+      /* Kahan summation */
       tr = pl_tmp + kc;
       ts = tr + ks;
       tt = ts - ks;
       ks = ts;
       kc = tr - tt;
     }
-    pl_tmp = ks + kc;
   }
-  
-#ifdef TM_USE_MPI
-  /* (3) sum over all contributions from all nodes (also nodes with pl_tmp=0;
-     apparently the easiest way) */
-  MPI_Reduce(&pl_tmp, pl, 1, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, g_cart_grid);
-  /*   MPI_Reduce(&(creal(pl_tmp)), &(pl->re), 1, MPI_DOUBLE, MPI_SUM, 0, g_cart_grid);  */
-  /*   MPI_Reduce(&(cimag(pl_tmp)), &(pl->im), 1, MPI_DOUBLE, MPI_SUM, 0, g_cart_grid);  */
+#ifdef TM_USE_OMP
+  g_omp_acc_cp[thread_num] = kc + ks;
+  } /* OpenMP parallel closing brace */
+
+  pl = 0.0;
+  for(int i = 0; i < omp_num_threads; ++i) {
+    pl += g_omp_acc_cp[i];
+  }
 #else
-  *pl = pl_tmp;
+  pl = kc + ks;
 #endif
-  
-  /* normalization */
-  VOLUME3 = VOL3;
 
-  if(g_proc_id == 0)
-  {
-    VOLUME3 = VOLUME3 * g_nproc_x*g_nproc_y*g_nproc_z;
-    *pl /= 3 * VOLUME3;
+#ifdef TM_USE_MPI
+  MPI_Allreduce(&pl, &mpl, 1, MPI_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
+  pl = mpl;
+#endif
+  /* Normalise, i.e. divide by the number of loops: */
+  pl /= (double)VOLUME*g_nproc/global_extent(mu);
+  free(P);
+  return(pl);
+}
+
+void polyakov_loop(_Complex double * pl_, const int mu) {
+  if(mu < 0 || mu > 3) {
+    fprintf(stderr, "Wrong parameter for Polyakov loop calculation in polyakov_loop.c:\n");
+    fprintf(stderr, "Actual value is %d! Aborting...\n",mu);
+#ifdef TM_USE_MPI
+    MPI_Abort(MPI_COMM_WORLD, 10);
+    MPI_Finalize();
+#endif
+    exit(0);
   }
-  
+  *pl_ = polyakov_loop_average(mu, NULL);
+  return;
+}
+
+
+/* here comes the one in time direction */
+
+int polyakov_loop_0(const int nstore, _Complex double *pl) {
+  FILE *ofs = NULL;
+
+  *pl = polyakov_loop_average(0, NULL);
+
   /* write result to file */
   if (g_proc_id == 0) {
     if (nstore == 0) {
@@ -303,239 +259,89 @@ int polyakov_loop_0(const int nstore, _Complex double *pl) {
     fprintf(ofs, "%25.16e\t%25.16e\n", creal(*pl), cimag(*pl)); 
     fclose(ofs);
   }
-#ifdef TM_USE_MPI
-  free(tmp_nnb);
-#endif
-  free(tmp_loc);
   return(0);
 }
 
-
-/*********************************************************************************/
-
-/* here comes the version using reduction operations for time- (dir==0) or
-   z- (dir==3) direction
-   the reduction operation is defined in mpi_init.h
-*/
-void polyakov_loop_measurement(const int nstore, const int id, const int ieo) {
-  polyakov_loop_dir(nstore, measurement_list[id].direction);
-}
-
-
-int polyakov_loop_dir(
-		      const int nstore /* in  */,
-		      const int dir    /* in  */) {
-
-  int ixyz, ixyzt, ixyzt_up, VOL3, VOLUME3, ix, iy, iz, it;
-  _Complex double pl_tmp, tr, ts, tt, kc, ks, pl;
-  su3 *tmp_loc, tmp, tmp2;
-  su3 *u, *v, *w;
-  double ratime, retime;
+/* the traces of the Polyakov loops at all transverse sites, written */
+/* by g_proc_id 0 with the global transverse coordinates             */
+static int write_resolved(const int nstore, const int dir, _Complex double * const pl_site) {
+  int d[3], G[3], L[3], VOLG;
+  _Complex double * plg;
   char filename[50];
-
   FILE *ofs;
-
 #ifdef TM_USE_MPI
-  int rank_slice, rank_ray;
-  MPI_Comm slice, ray;
-  su3 *tmp_ray;
+  _Complex double * mplg = NULL;
 #endif
 
-  if(dir!=0 && dir!=3 && g_proc_id==0) {
-    fprintf(stderr, "Wrong direction; must be 0 (t) or 3 (z)\n");
-    return(-1);
+  transverse_directions(dir, d);
+  for(int k = 0; k < 3; k++) {
+    G[k] = global_extent(d[k]);
+    L[k] = local_extent(d[k]);
   }
-
-  pl = 0.0;
-
-  /********************************************************************************/
-
-  /**************
-   * local part *
-   **************/
-  ratime = gettime();
-
-  if(dir==0) {
-    VOL3 = LX*LY*LZ;
-    tmp_loc = (su3 *)calloc(VOL3, sizeof(su3));
-    if((void*)tmp_loc == NULL) {
-      fprintf(stderr, "[%2d] Could not allocate memory for tmp_loc\n", g_proc_id);
-      return(-1);
-    }
-
-    for(ix=0; ix<LX; ix++) {
-      for(iy=0; iy<LY; iy++) {
-	for(iz=0; iz<LZ; iz++) {
-	  /* ixyz = ix*LY*LZ + iy*LZ + iz */
-	  ixyz = (ix * LY + iy) * LZ + iz;
-	  it = 0;
-	  ixyzt    = g_ipt[it][ix][iy][iz];
-	  ixyzt_up = g_iup[ixyzt][0];
-	  v = &g_gauge_field[ixyzt][0];
-	  w = &g_gauge_field[ixyzt_up][0];
-	  u = &tmp;
-	  _su3_times_su3(*u, *v, *w);
-	  v = &tmp2;
-	  for(it=1; it<T-2; it++) {
-	    /* swap u and v via w */
-	    w = u; u = v; v = w;
-	    ixyzt_up = g_iup[ixyzt_up][0];
-	    w = &g_gauge_field[ixyzt_up][0];
-	    _su3_times_su3(*u, *v, *w);
-	  }
-	  /* last multiplication for it=T-1 */
-	  ixyzt_up = g_iup[ixyzt_up][0];
-	  w = &g_gauge_field[ixyzt_up][0];
-	  _su3_times_su3(tmp_loc[ixyz],*u, *w);
-	}
-      }
+  VOLG = G[0]*G[1]*G[2];
+  plg = (_Complex double*)calloc(VOLG, sizeof(_Complex double));
+  if(g_proc_coords[dir] == 0) {
+    for(int i = 0; i < L[0]*L[1]*L[2]; i++) {
+      int x0 = g_proc_coords[d[0]]*L[0] + i/(L[1]*L[2]);
+      int x1 = g_proc_coords[d[1]]*L[1] + (i/L[2])%L[1];
+      int x2 = g_proc_coords[d[2]]*L[2] + i%L[2];
+      plg[(x0*G[1] + x1)*G[2] + x2] = pl_site[i];
     }
   }
-  else { /* z-direction <=> dir==3 */
-    VOL3 = T*LX*LY;
-    tmp_loc = (su3 *)calloc(VOL3, sizeof(su3));
-    if((void*)tmp_loc == NULL) {
-      /* Abort */
-    }
-
-    for(it=0; it<T;  it++) {
-      for(ix=0; ix<LX; ix++) {
-	for(iy=0; iy<LY; iy++) {
-	  /* ixyz = it*LX*LY + ix*LY + iy */
-	  ixyz = (it * LX + ix) * LY + iy;
-	  iz = 0;
-	  ixyzt    = g_ipt[it][ix][iy][iz];
-	  ixyzt_up = g_iup[ixyzt][3];
-	  v = &g_gauge_field[ixyzt][3];
-	  w = &g_gauge_field[ixyzt_up][3];
-	  u = &tmp;
-	  _su3_times_su3(*u, *v, *w);
-	  v = &tmp2;
-	  for(iz=1; iz<LZ-2; iz++) {
-	    /* swap u and v via w */
-	    w = u; u = v; v = w;
-	    ixyzt_up = g_iup[ixyzt_up][3];
-	    w = &g_gauge_field[ixyzt_up][3];
-	    _su3_times_su3(*u, *v, *w);
-	  }
-	  ixyzt_up = g_iup[ixyzt_up][3];
-	  w = &g_gauge_field[ixyzt_up][3];
-	  _su3_times_su3(tmp_loc[ixyz], *u, *w);
-	}
-      }
-    }
-
-  }
-  retime = gettime();
-  if(g_debug_level > 0 && g_proc_id == 0) {
-    fprintf(stdout, "# [pl02 dir%1d proc%.2d] time for calculating local part"\
-	    " = %e seconds\n", dir, g_cart_id, retime-ratime);
-  }
-
-  /********************************************************************************/
-
 #ifdef TM_USE_MPI
-  /***************
-   * global part *
-   ***************/
-  /* choose the slice and ray communicators according to direction */
-  if(dir==0) {
-    slice      = g_mpi_time_slices;
-    ray        = g_mpi_SV_slices;
-    rank_slice = g_mpi_time_rank;
-    rank_ray   = g_mpi_SV_rank;
+  if(g_proc_id == 0) {
+    mplg = (_Complex double*)calloc(VOLG, sizeof(_Complex double));
   }
-  else {
-    slice      = g_mpi_z_slices;
-    ray        = g_mpi_ST_slices;
-    rank_slice = g_mpi_z_rank;
-    rank_ray   = g_mpi_ST_rank;
+  MPI_Reduce(plg, mplg, VOLG, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, MPI_COMM_WORLD);
+  if(g_proc_id == 0) {
+    free(plg);
+    plg = mplg;
   }
- 
-  ratime = MPI_Wtime();
-
-  /* (1) collect contributions from different time/z slices to nodes with rank=0 
-     in spatial volume/space-time slices */
-#  ifndef PARALLELXYZT
-  if(dir==0) {
-#  endif
-    tmp_ray = (su3*)calloc(VOL3, sizeof(su3)); /* */
-    if((void*)tmp_ray== NULL) {
-      fprintf(stderr, "[%2d] Could not allocate memory for tmp_ray\n", g_proc_id);
+#endif
+
+  if(g_proc_id == 0) {
+    sprintf(filename, "polyakovloop_dir%1d.%.6d", dir, nstore);
+    ofs = fopen(filename, "w");
+    if((void*)ofs == NULL) {
+      fprintf(stderr, "Could not open file %s for writing\n", filename);
+      free(plg);
       return(-1);
     }
-
-    MPI_Reduce(tmp_loc, tmp_ray, VOL3, mpi_su3, mpi_reduce_su3_ray, 0, ray);
-#  ifndef PARALLELXYZT
-  }
-#  endif
-
-
-  retime = MPI_Wtime();
-  if(g_proc_id==0 && g_debug_level>0) {
-    fprintf(stdout, "# [pl02 dir%1d proc%.2d] time for calculating global part"\
-	    " = %e seconds\n", dir, g_cart_id, retime-ratime);
+    for(int i = 0; i < VOLG; i++) {
+      fprintf(ofs, "%3d %3d %3d\t%25.16e\t%25.16e\n", i/(G[1]*G[2]), (i/G[2])%G[1], i%G[2],
+              creal(plg[i]), cimag(plg[i]));
+    }
+    fclose(ofs);
   }
+  free(plg);
+  return(0);
+}
 
-  if(rank_ray == 0) {
-
-#endif
-    pl_tmp = 0.0;
-    kc = 0.0;
-    ks = 0.0;
-
-#ifdef TM_USE_MPI
-#  ifdef PARALLELXYZT
-    u = tmp_ray;
-#  else
-    if(dir==0) { u = tmp_ray; }
-    else       { u = tmp_loc; }
-#  endif
-#else
-    u = tmp_loc;
-#endif
+static int polyakov_loop_write(const int nstore, const int dir, const int resolved) {
+  _Complex double pl, * pl_site = NULL;
+  double ratime, retime;
+  char filename[50];
+  FILE *ofs;
 
-    for(ixyz=0; ixyz<VOL3; ixyz++) /* Kahan-summation of traces */
-    {
-      pl_tmp = u[ixyz].c00 + u[ixyz].c11 + u[ixyz].c22;
-      tr = pl_tmp + kc;
-      ts = tr + ks;
-      tt = ts - ks;
-      ks = ts;
-      kc = tr - tt;
+  if(dir < 0 || dir > 3) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Wrong direction %d for the Polyakov loop; must be 0, 1, 2 or 3\n", dir);
     }
-    pl_tmp = ks + kc;
+    return(-1);
+  }
 
-#ifdef TM_USE_MPI
-    MPI_Reduce(&pl_tmp, &pl, 1, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, slice);
+  ratime = gettime();
+  if(resolved) {
+    pl_site = (_Complex double*)malloc(VOLUME/local_extent(dir)*sizeof(_Complex double));
   }
-#  ifndef PARALLELXYZT
-  if(dir==0) {
-#  endif
-    free(tmp_ray);
-#  ifndef PARALLELXYZT
+  pl = polyakov_loop_average(dir, pl_site);
+  retime = gettime();
+  if(g_debug_level > 0 && g_proc_id == 0) {
+    fprintf(stdout, "# [pl02 dir%1d proc%.2d] time for calculating the Polyakov loop"\
+	    " = %e seconds\n", dir, g_cart_id, retime-ratime);
   }
-#  endif
-    
-#else
-  pl = pl_tmp;
-#endif
-
-  /* normalization pl |-> pl / ( 3 * 3-dim. volume)*/
-  VOLUME3 = VOL3;
-   
-#ifdef TM_USE_MPI
-  if(rank_slice==0 && rank_ray==0) { /* this process has the sum 
-					of the Polyakov loop values */
-    if(dir==0) { 
-      VOLUME3 = VOLUME3 * g_nproc_x*g_nproc_y*g_nproc_z;
-    }
-    else {
-      VOLUME3 = VOLUME3 * g_nproc_t*g_nproc_x*g_nproc_y;
-    }
-#endif
-    pl /= 3. * VOLUME3;
 
+  if(g_proc_id == 0) {
     /* write result to file */
     sprintf(filename, "polyakovloop_dir%1d", dir);
     if (nstore == 0) {
@@ -546,13 +352,28 @@ int polyakov_loop_dir(
     }
     if((void*)ofs == NULL) {
       fprintf(stderr, "Could not open file %s for writing\n", filename);
+      free(pl_site);
       return(-1);
     }
     fprintf(ofs, "%4d\t%2d\t%25.16e\t%25.16e\n", nstore, dir, creal(pl), cimag(pl));
     fclose(ofs);
-#if defined TM_USE_MPI
   }
-#endif
-  free(tmp_loc);
+  if(resolved) {
+    write_resolved(nstore, dir, pl_site);
+    free(pl_site);
+  }
   return(0);
 }
+
+/*********************************************************************************/
+
+void polyakov_loop_measurement(const int nstore, const int id, const int ieo) {
+  polyakov_loop_write(nstore, measurement_list[id].direction, measurement_list[id].resolved);
+}
+
+
+int polyakov_loop_dir(
+		      const int nstore /* in  */,
+		      const int dir    /* in  */) {
+  return(polyakov_loop_write(nstore, dir, 0));
+}
@@ -19,8 +19,16 @@
 #ifndef _POLYAKOV_LOOP_H
 #define _POLYAKOV_LOOP_H
 
+#include "su3.h"
 #include "measurements.h"
 
+/* products of all links in direction mu (0..3) along the lines through */
+/* the transverse sites; on return P holds the full loops on the ranks    */
+/* with g_proc_coords[mu] == 0, for which the return value is 1          */
+int polyakov_loop_lines(su3 * const P, const int mu);
+/* average of the traced Polyakov loops in direction mu on all ranks, if */
+/* pl_site != NULL the local traces on the ranks holding the loops       */
+_Complex double polyakov_loop_average(const int mu, _Complex double * const pl_site);
 void polyakov_loop(_Complex double * pl_, const int mu);
 int polyakov_loop_0(const int nstore, _Complex double* pl);
 int polyakov_loop_dir(const int nstore, const int dir);
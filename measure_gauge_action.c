@@ -24,6 +24,10 @@
  *
  *   double measure_gauge_action(void)
  *     Returns the value of the action
+ *
+ *   void measure_gauge_observables(gf, flags, obs, tslice)
+ *     plaquette, clover energy density and topological charge
+ *     in one sweep over the gauge field
  ************************************************************************/
 
 #ifdef HAVE_CONFIG_H
@@ -41,68 +45,188 @@
 #include "geometry_eo.h"
 #include "global.h"
 #include <io/params.h>
+#include "matrix_utils.h"
 #include "measure_gauge_action.h"
 
-double measure_plaquette(const su3 ** const gf) {
-  static double res;
+static inline void kahan_acc(double * const ks, double * const kc, const double ac) {
+  double tr, ts, tt;
+  tr = ac + *kc;
+  ts = tr + *ks;
+  tt = ts - *ks;
+  *ks = ts;
+  *kc = tr - tt;
+}
+
+/* number of scalar results: plaquette, six oriented plaquettes, E and Q */
+#define NO_GAUGE_OBS 9
+
+void measure_gauge_observables(const su3 ** const gf, const int flags, gauge_obs_t * const obs, 
+                               double * const tslice) {
+  const int clover = (flags & GAUGE_OBS_CLOVER);
+  const int nts = (tslice != NULL) ? 3*T : 0;
+  const int nres = NO_GAUGE_OBS + nts;
+  const int ngres = NO_GAUGE_OBS + ((tslice != NULL) ? 3*g_nproc_t*T : 0);
+  int nthreads = 1;
+  double * thread_res, * res;
 #ifdef TM_USE_MPI
-  double ALIGN mres;
+  double * mres;
+#endif
+
+#ifdef TM_USE_OMP
+  nthreads = omp_num_threads;
 #endif
+  thread_res = (double*)calloc(nthreads*nres, sizeof(double));
+  res = (double*)calloc(ngres, sizeof(double));
 
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
   int thread_num = omp_get_thread_num();
+#else
+  int thread_num = 0;
 #endif
 
-  int ix1,ix2;
-  su3 ALIGN pr1,pr2; 
-  const su3 * restrict v,* restrict w;
-  double ALIGN ac, ks, kc, tr, ts, tt;
+  su3 ALIGN pr1, pr2, v1, v2;
+  su3 ALIGN leaf[6];
+  double ALIGN ac, e, q, ks[NO_GAUGE_OBS], kc[NO_GAUGE_OBS];
+  double * const tres = thread_res + thread_num*nres;
+  const su3 *w1, *w2, *w3, *w4;
 
-  kc=0.0; ks=0.0;
+  for(int j = 0; j < NO_GAUGE_OBS; j++) {
+    ks[j] = 0.; kc[j] = 0.;
+  }
 #ifdef TM_USE_OMP
 #pragma omp for
 #endif
-  for (int ix = 0; ix < VOLUME; ix++){
-    for (int mu1 = 0; mu1 < 3; mu1++){ 
-      ix1 = g_iup[ix][mu1];
-      for (int mu2 = mu1+1; mu2 < 4; mu2++){ 
-	ix2 = g_iup[ix][mu2];
-	v=&gf[ix][mu1];
-	w=&gf[ix1][mu2];
-	_su3_times_su3(pr1, *v, *w);
-	v=&gf[ix][mu2];
-	w=&gf[ix2][mu1];
-	_su3_times_su3(pr2, *v, *w);
-	_trace_su3_times_su3d(ac, pr1, pr2);
-	tr=ac+kc;
-	ts=tr+ks;
-	tt=ts-ks;
-	ks=ts;
-	kc=tr-tt;
+  for (int x = 0; x < VOLUME; x++){
+    const int t = g_coord[x][0] - g_proc_coords[0]*T;
+    int plane = 0;
+    for (int k = 0; k < 3; k++){ 
+      for (int l = k+1; l < 4; l++){ 
+        const int xpk = g_iup[x][k];
+        const int xpl = g_iup[x][l];
+        /* the plaquette, which is also the first clover leaf */
+        _su3_times_su3(pr1, gf[x][k], gf[xpk][l]);
+        _su3_times_su3(pr2, gf[x][l], gf[xpl][k]);
+        _trace_su3_times_su3d(ac, pr1, pr2);
+        kahan_acc(&ks[0], &kc[0], ac);
+        kahan_acc(&ks[1+plane], &kc[1+plane], ac);
+        if(nts) tres[NO_GAUGE_OBS + 3*t] += ac;
+
+        if(clover) {
+          /*  the clover-leave
+              l  __   __
+                |  | |  |
+                |__| |__|
+                __   __
+                |  | |  |
+                |__| |__| k  */
+          const int xmk = g_idn[x][k];
+          const int xml = g_idn[x][l];
+          const int xpkml = g_idn[xpk][l];
+          const int xplmk = g_idn[xpl][k];
+          const int xmkml = g_idn[xml][k];
+          _su3_times_su3d(leaf[plane], pr1, pr2);
+          w1 = &gf[x][l];
+          w2 = &gf[xplmk][k];
+          w3 = &gf[xmk][l];
+          w4 = &gf[xmk][k];
+          _su3_times_su3d(v1, *w1, *w2);
+          _su3d_times_su3(v2, *w3, *w4);
+          _su3_times_su3_acc(leaf[plane], v1, v2);
+          w1 = &gf[xmk][k];
+          w2 = &gf[xmkml][l];
+          w3 = &gf[xmkml][k];
+          w4 = &gf[xml][l];
+          _su3_times_su3(v1, *w2, *w1);
+          _su3_times_su3(v2, *w3, *w4);
+          _su3d_times_su3_acc(leaf[plane], v1, v2);
+          w1 = &gf[xml][l];
+          w2 = &gf[xml][k];
+          w3 = &gf[xpkml][l];
+          w4 = &gf[x][k];
+          _su3d_times_su3(v1, *w1, *w2);
+          _su3_times_su3d(v2, *w3, *w4);
+          _su3_times_su3_acc(leaf[plane], v1, v2);
+          project_traceless_antiherm(&leaf[plane]);
+        }
+        plane++;
+      }
+    }
+    if(clover) {
+      e = 0.;
+      for(int j = 0; j < 6; j++) {
+        _trace_su3_times_su3(ac, leaf[j], leaf[j]);
+        e += ac;
+      }
+      /* epsilon_{mu nu rho sigma} F_{mu nu} F_{rho sigma} with the planes */
+      /* ordered 01, 02, 03, 12, 13, 23                                    */
+      _trace_su3_times_su3(ac, leaf[0], leaf[5]);
+      q = ac;
+      _trace_su3_times_su3(ac, leaf[1], leaf[4]);
+      q -= ac;
+      _trace_su3_times_su3(ac, leaf[2], leaf[3]);
+      q += ac;
+      kahan_acc(&ks[7], &kc[7], e);
+      kahan_acc(&ks[8], &kc[8], q);
+      if(nts) {
+        tres[NO_GAUGE_OBS + 3*t + 1] += e;
+        tres[NO_GAUGE_OBS + 3*t + 2] += q;
       }
     }
   }
-  kc=(kc+ks)/3.0;
-#ifdef TM_USE_OMP
-  g_omp_acc_re[thread_num] = kc;
-#else
-  res = kc;
-#endif
-
+  for(int j = 0; j < 7; j++) {
+    tres[j] = (kc[j] + ks[j])/3.0;
+  }
+  tres[7] = kc[7] + ks[7];
+  tres[8] = kc[8] + ks[8];
 #ifdef TM_USE_OMP
   } /* OpenMP parallel closing brace */
-
-  res = 0.0;
-  for(int i=0; i < omp_num_threads; ++i)
-    res += g_omp_acc_re[i];
 #endif
+
+  /* sum over the threads in a fixed order, the local timeslices */
+  /* at their global position                                    */
+  for(int i = 0; i < nthreads; i++) {
+    for(int j = 0; j < NO_GAUGE_OBS; j++) {
+      res[j] += thread_res[i*nres + j];
+    }
+    for(int j = 0; j < nts; j++) {
+      res[NO_GAUGE_OBS + 3*g_proc_coords[0]*T + j] += thread_res[i*nres + NO_GAUGE_OBS + j];
+    }
+  }
 #ifdef TM_USE_MPI
-  MPI_Allreduce(&res, &mres, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  mres = (double*)malloc(ngres*sizeof(double));
+  MPI_Allreduce(res, mres, ngres, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  free(res);
   res = mres;
 #endif
-  return res;
+
+  obs->plaq = res[0];
+  for(int j = 0; j < 6; j++) {
+    obs->plaq_plane[j] = res[1+j]/(g_nproc*VOLUME);
+  }
+  /* normalisation as in measure_energy_density, and the topological */
+  /* charge density q = -1/(32 pi^2) eps tr(F F) with F = leaf/4      */
+  obs->E = -res[7]/(16.0 * VOLUME * g_nproc);
+  obs->Q = -res[8]/(64.0 * M_PI * M_PI);
+  if(tslice != NULL) {
+    const double VS = (double)VOLUME*g_nproc/(g_nproc_t*T);
+    for(int t = 0; t < g_nproc_t*T; t++) {
+      tslice[3*t] = res[NO_GAUGE_OBS + 3*t]/(3.0 * 6.0 * VS);
+      tslice[3*t + 1] = -res[NO_GAUGE_OBS + 3*t + 1]/(16.0 * VS);
+      tslice[3*t + 2] = -res[NO_GAUGE_OBS + 3*t + 2]/(64.0 * M_PI * M_PI);
+    }
+  }
+  free(res);
+  free(thread_res);
+  return;
+}
+
+double measure_plaquette(const su3 ** const gf) {
+  gauge_obs_t obs;
+  measure_gauge_observables(gf, GAUGE_OBS_PLAQ, &obs, NULL);
+  GaugeInfo.plaquetteEnergy = obs.plaq;
+  return obs.plaq;
 }
 
 double measure_gauge_action(const su3 ** const gf, const double lambda) {
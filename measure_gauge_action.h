@@ -22,6 +22,24 @@
 
 #include "su3.h"
 
+/* flags for measure_gauge_observables */
+#define GAUGE_OBS_PLAQ   1
+#define GAUGE_OBS_CLOVER 2
+
+typedef struct {
+  /* sum of Re tr of all plaquettes over 3, as measure_plaquette */
+  double plaq;
+  /* average plaquette in the planes 01, 02, 03, 12, 13, 23 */
+  double plaq_plane[6];
+  /* clover energy density and topological charge (GAUGE_OBS_CLOVER) */
+  double E;
+  double Q;
+} gauge_obs_t;
+
+/* gauge observables in one sweep; if tslice != NULL, it must hold     */
+/* 3*g_nproc_t*T values and gets plaquette, E and Q for every timeslice */
+void measure_gauge_observables(const su3 ** const gf, const int flags, gauge_obs_t * const obs,
+                               double * const tslice);
 double measure_plaquette(const su3 ** const gf);
 double measure_gauge_action(const su3 ** const gf, const double lambda);
 
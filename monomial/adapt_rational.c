@@ -0,0 +1,286 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "global.h"
+#include "su3.h"
+#include "aligned_malloc.h"
+#include "read_input.h"
+#include "boundary.h"
+#include "gettime.h"
+#include "operator/Hopping_Matrix.h"
+#include "operator/tm_operators_nd.h"
+#include "operator/clovertm_operators.h"
+#include "operator/clover_leaf.h"
+#include "solver/solver.h"
+#include "solver/jdher.h"
+#include "solver/eigenvalues_bi.h"
+#include "monomial/monomial.h"
+#include "hamiltonian_field.h"
+#include "rational/rational.h"
+#include "adapt_rational.h"
+
+static int is_nd(const monomial * const mnl) {
+  return(mnl->type == NDRAT || mnl->type == NDCLOVERRAT ||
+         mnl->type == NDRATCOR || mnl->type == NDCLOVERRATCOR);
+}
+
+static int is_clover(const monomial * const mnl) {
+  return(mnl->type == CLOVERRAT || mnl->type == NDCLOVERRAT ||
+         mnl->type == CLOVERRATCOR || mnl->type == NDCLOVERRATCOR);
+}
+
+static int partner_type(const int type) {
+  switch(type) {
+  case RAT: return(RATCOR);
+  case CLOVERRAT: return(CLOVERRATCOR);
+  case NDRAT: return(NDRATCOR);
+  case NDCLOVERRAT: return(NDCLOVERRATCOR);
+  default: return(-1);
+  }
+}
+
+/* the correction monomial belonging to rational monomial mnl has the same */
+/* operator and, at least initially, the same rational approximation       */
+static int is_partner(const monomial * const mnl, const monomial * const cor) {
+  return(cor->type == partner_type(mnl->type) && cor->kappa == mnl->kappa &&
+         cor->c_sw == mnl->c_sw && cor->mubar == mnl->mubar && cor->epsbar == mnl->epsbar &&
+         cor->StildeMin == mnl->StildeMin && cor->StildeMax == mnl->StildeMax &&
+         cor->rat.order == mnl->rat.order);
+}
+
+#ifdef HAVE_LAPACK
+/* one extremal eigenvalue of the even/odd operator f */
+static double extremal_ev(matrix_mult f, const int maxmin) {
+  const int N = VOLUME/2, N2 = VOLUMEPLUSRAND/2;
+  const int maximal = (maxmin == JD_MAXIMAL);
+  spinor * ev = (spinor*)aligned_malloc(N2*sizeof(spinor));
+  double lambda = 0., prec = (eigenvalue_precision < 1.e-14) ? 1.e-14 : eigenvalue_precision;
+  int converged = 0, it = 0;
+
+  jdher(N*sizeof(spinor)/sizeof(_Complex double), N2*sizeof(spinor)/sizeof(_Complex double),
+        maximal ? 50. : 0., prec, 1, 15, 8, 1000, 1, 0, 0, NULL, CG, maximal ? 50 : 200,
+        maximal ? 5.e-2 : 1.e-3, maximal ? 1.5 : 1.7, g_debug_level,
+        &converged, (_Complex double*) ev, &lambda, &it, maxmin, 1, f);
+  aligned_free(ev);
+  return(lambda);
+}
+#endif
+
+/* smallest and largest eigenvalue of the squared operator of mnl,     */
+/* for the ND monomials in units of the normalised operator as used by */
+/* the rational approximation                                          */
+static int measure_ev(monomial * const mnl, hamiltonian_field_t * const hf,
+                      double * const lmin, double * const lmax) {
+  int n = 1;
+  if(is_nd(mnl)) {
+    nd_set_global_parameter(mnl);
+    if(is_clover(mnl)) {
+      init_sw_fields();
+      sw_term((const su3**)hf->gaugefield, mnl->kappa, mnl->c_sw);
+      sw_invert_nd(mnl->mubar*mnl->mubar - mnl->epsbar*mnl->epsbar);
+      *lmin = eigenvalues_bi(&n, 1000, eigenvalue_precision, JD_MINIMAL, &Qsw_pm_ndbipsi);
+      n = 1;
+      *lmax = eigenvalues_bi(&n, 1000, eigenvalue_precision, JD_MAXIMAL, &Qsw_pm_ndbipsi);
+    }
+    else {
+      *lmin = eigenvalues_bi(&n, 1000, eigenvalue_precision, JD_MINIMAL, &Qtm_pm_ndbipsi);
+      n = 1;
+      *lmax = eigenvalues_bi(&n, 1000, eigenvalue_precision, JD_MAXIMAL, &Qtm_pm_ndbipsi);
+    }
+    return(0);
+  }
+#ifdef HAVE_LAPACK
+  const double save_mu3 = g_mu3, save_c_sw = g_c_sw;
+  g_mu = 0.;
+  g_mu3 = 0.;
+  boundary(mnl->kappa);
+  if(is_clover(mnl)) {
+    g_c_sw = mnl->c_sw;
+    init_sw_fields();
+    sw_term((const su3**)hf->gaugefield, mnl->kappa, mnl->c_sw);
+    sw_invert(EE, 0.);
+  }
+  *lmin = extremal_ev(mnl->Qsq, JD_MINIMAL);
+  *lmax = extremal_ev(mnl->Qsq, JD_MAXIMAL);
+  g_mu = g_mu1;
+  g_mu3 = save_mu3;
+  g_c_sw = save_c_sw;
+  boundary(g_kappa);
+  return(0);
+#else
+  return(-1);
+#endif
+}
+
+/* set the interval [smin, smax] (units of the squared operator) and */
+/* the approximation of mnl as fitted for its owner                  */
+static void set_rational(monomial * const mnl, const double smin, const double smax,
+                         const rational_t * const rat) {
+  const unsigned int scale = !is_nd(mnl);
+  mnl->StildeMin = smin;
+  mnl->StildeMax = smax;
+  mnl->EVMin = smin/smax;
+  mnl->EVMax = 1.;
+  mnl->EVMaxInv = 1./sqrt(smax);
+  mnl->rat.range[0] = smin;
+  mnl->rat.range[1] = smax;
+  if(rat == NULL) {
+    fit_rational(&mnl->rat, mnl->rat_delta, mnl->rat_max_order, scale);
+  }
+  else {
+    free_rational(&mnl->rat);
+    mnl->rat.order = rat->order;
+    mnl->rat.crange[0] = 0;
+    mnl->rat.crange[1] = rat->order-1;
+    init_rational(&mnl->rat, scale);
+  }
+  return;
+}
+
+/* owner[j] is the adaptive rational monomial the correction */
+/* monomial j belongs to, -1 otherwise                         */
+static int * owner = NULL;
+
+static void init_owner() {
+  owner = (int*)malloc(no_monomials*sizeof(int));
+  for(int j = 0; j < no_monomials; j++) {
+    owner[j] = -1;
+  }
+  for(int id = 0; id < no_monomials; id++) {
+    monomial * mnl = &monomial_list[id];
+    if(partner_type(mnl->type) < 0 || mnl->rat_delta <= 0.) continue;
+    if(mnl->rec_ev == 0 || mnl->rat.crange[0] != 0 || mnl->rat.crange[1] != mnl->rat.order-1) {
+      if(g_proc_id == 0) {
+        fprintf(stderr, "Warning: adaptive rational approximation for monomial %s needs ComputeEVFreq > 0 and all coefficients, switched off\n", 
+                mnl->name);
+      }
+      mnl->rat_delta = 0.;
+      continue;
+    }
+    for(int j = 0; j < no_monomials; j++) {
+      if(owner[j] < 0 && is_partner(mnl, &monomial_list[j])) {
+        owner[j] = id;
+        /* the eigenvalues are measured by the owner */
+        monomial_list[j].rec_ev = 0;
+        if(g_proc_id == 0 && g_debug_level > 0) {
+          printf("# %s: rational approximation adapted together with %s\n", monomial_list[j].name, mnl->name);
+        }
+      }
+    }
+  }
+  return;
+}
+
+void adapt_rational(hamiltonian_field_t * const hf, const int acctest) {
+  double lmin, lmax, smin, smax, wmin, wmax, atime, etime;
+  char filename[50];
+  FILE * ofs;
+
+  if(owner == NULL) {
+    init_owner();
+  }
+  for(int id = 0; id < no_monomials; id++) {
+    monomial * mnl = &monomial_list[id];
+    if(partner_type(mnl->type) < 0 || mnl->rat_delta <= 0. ||
+       hf->traj_counter%mnl->rec_ev != 0) continue;
+
+    atime = gettime();
+    if(measure_ev(mnl, hf, &lmin, &lmax) != 0) {
+      if(g_proc_id == 0) {
+        fprintf(stderr, "Warning: adaptive rational approximation for monomial %s needs LAPACK, switched off\n", mnl->name);
+      }
+      mnl->rat_delta = 0.;
+      continue;
+    }
+    /* for ND in units of the squared operator */
+    if(is_nd(mnl)) {
+      lmin *= mnl->StildeMax;
+      lmax *= mnl->StildeMax;
+    }
+    if(g_proc_id == 0 && (lmin < mnl->StildeMin || lmax > mnl->StildeMax)) {
+      fprintf(stderr, "\nWarning: spectrum [%e, %e] of monomial %s outside of the interval [%e, %e] of the trajectory before!\n\n",
+              lmin, lmax, mnl->name, mnl->StildeMin, mnl->StildeMax);
+    }
+    /* refit only if the spectrum left the interval or the interval is wider */
+    /* than needed by more than another margin, to avoid refits every time   */
+    /* after thermalisation the approximation is frozen (detailed balance)   */
+    smin = lmin/(1. + mnl->rat_margin);
+    smax = lmax*(1. + mnl->rat_margin);
+    wmin = smin/(1. + mnl->rat_margin);
+    wmax = smax*(1. + mnl->rat_margin);
+    if(!acctest && (lmin < mnl->StildeMin || lmax > mnl->StildeMax ||
+                    mnl->StildeMin < wmin || mnl->StildeMax > wmax)) {
+      set_rational(mnl, smin, smax, NULL);
+      for(int j = 0; j < no_monomials; j++) {
+        if(owner[j] == id) {
+          set_rational(&monomial_list[j], smin, smax, &mnl->rat);
+        }
+      }
+      if(g_proc_id == 0 && g_debug_level > 0) {
+        printf("# %s: rational approximation refitted to order %d on [%e, %e] with delta = %e\n",
+               mnl->name, mnl->rat.order, mnl->StildeMin, mnl->StildeMax, mnl->rat.delta);
+      }
+    }
+    etime = gettime();
+    if(g_proc_id == 0) {
+      sprintf(filename,"monomial-%.2d.data", id);
+      ofs = fopen(filename, "a");
+      fprintf(ofs, "%.8d %1.5e %1.5e %1.5e %1.5e %d %1.5e\n", hf->traj_counter, lmin, lmax,
+              mnl->StildeMin, mnl->StildeMax, mnl->rat.order, mnl->rat.delta);
+      fclose(ofs);
+      if(g_debug_level > 1) {
+        printf("# %s: time/s for adapting the rational approximation %e\n", mnl->name, etime-atime);
+      }
+    }
+  }
+  return;
+}
+
+void restore_rational(const int id, const double smin, const double smax, const int order) {
+  monomial * mnl = &monomial_list[id];
+  rational_t rat;
+
+  if(owner == NULL) {
+    init_owner();
+  }
+  if((partner_type(mnl->type) < 0 || mnl->rat_delta <= 0.) && owner[id] < 0) return;
+  if(mnl->StildeMin == smin && mnl->StildeMax == smax && mnl->rat.order == order) return;
+  /* the chi fields are allocated for the order of the input */
+  if(smin <= 0. || smax <= smin || order < 1 || order > mnl->rat_max_order) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Warning: invalid rational approximation for monomial %s in the checkpoint, the input is used\n",
+              mnl->name);
+    }
+    return;
+  }
+  rat.order = order;
+  set_rational(mnl, smin, smax, &rat);
+  if(g_proc_id == 0 && g_debug_level > 0) {
+    printf("# %s: rational approximation of order %d on [%e, %e] restored\n",
+           mnl->name, mnl->rat.order, mnl->StildeMin, mnl->StildeMax);
+  }
+  return;
+}
@@ -0,0 +1,46 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* adaptive rational approximations for the (ND)(CLOVER)RAT monomials  */
+/*                                                                      */
+/* for monomials with rat_delta > 0 the extremal eigenvalues are        */
+/* measured every rec_ev trajectories before the heatbath. If they left */
+/* the interval of the approximation, or the interval is wider than     */
+/* needed, the interval is set to the measured one widened by           */
+/* rat_margin and the smallest order <= rat_max_order with max.         */
+/* deviation <= rat_delta is chosen. The matching correction monomial   */
+/* gets the same approximation.                                         */
+/* As the refit depends on the configuration, it would violate detailed */
+/* balance. It is hence only done during thermalisation (acctest = 0),  */
+/* afterwards the approximation is frozen and the eigenvalues are only  */
+/* monitored. Measurements, interval, order and delta are appended to   */
+/* monomial-XX.data                                                     */
+
+#ifndef _ADAPT_RATIONAL_H
+#define _ADAPT_RATIONAL_H
+
+#include "hamiltonian_field.h"
+
+void adapt_rational(hamiltonian_field_t * const hf, const int acctest);
+/* re-initialises the approximation of monomial id, if it is adapted, */
+/* on [smin, smax] with the given order, e.g. from a checkpoint       */
+void restore_rational(const int id, const double smin, const double smax, const int order);
+
+#endif
@@ -41,6 +41,8 @@
 #include "hamiltonian_field.h"
 #include "monitor_forces.h"
 #include "gettime.h"
+#include "derived_gauge_fields.h"
+#include "tune_integrator.h"
 
 void monitor_forces(hamiltonian_field_t * const hf) {
 
@@ -55,6 +57,7 @@ void monitor_forces(hamiltonian_field_t * const hf) {
 	}
       }
       
+      update_gauge_fields_for_monomial(id);
       monomial_list[ id ].derivativefunction(id, hf);
       
 #ifdef TM_USE_MPI
@@ -95,6 +98,7 @@ void monitor_forces(hamiltonian_field_t * const hf) {
       MPI_Reduce(&max, &sum2, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
       max = sum2;
 #endif
+      tune_integrator_force(id, sum/((double)(VOLUME*g_nproc))/4.);
       if(g_proc_id == 0) {
 	printf("# squared force for monomial %s on timescale %d: aver: %1.2e max: %1.2e\n", 
 	       monomial_list[ id ].name,
@@ -135,6 +135,8 @@ int add_monomial(const int type) {
   monomial_list[no_monomials].rat.range[1] = _default_stilde_max;
   monomial_list[no_monomials].rat.crange[0] = 0;
   monomial_list[no_monomials].rat.crange[1] = 11;
+  monomial_list[no_monomials].rat_delta = 0.;
+  monomial_list[no_monomials].rat_margin = _default_rat_margin;
 
   monomial_list[no_monomials].initialised = 1;
   if(monomial_list[no_monomials].type == NDDETRATIO || monomial_list[no_monomials].type == CLOVERDETRATIORW) {
@@ -109,6 +109,10 @@ typedef struct {
   double * MDPolyCoefs, * PtildeCoefs;
   /* rational approximation */
   rational_t rat;
+  /* adaptive rational approximation: target delta, maximal order and */
+  /* relative margin of the interval around the measured eigenvalues  */
+  double rat_delta, rat_margin;
+  int rat_max_order;
   /* chronological solver fields */
   spinor ** csg_field;
   spinor ** csg_field2;
@@ -143,6 +147,7 @@ typedef struct {
 #include "monomial/ratcor_monomial.h"
 #include "monomial/moment_energy.h"
 #include "monomial/monitor_forces.h"
+#include "monomial/adapt_rational.h"
 
 /* list of all monomials */
 extern monomial monomial_list[max_no_monomials];
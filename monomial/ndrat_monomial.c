@@ -205,7 +205,8 @@ void ndrat_heatbath(const int id, hamiltonian_field_t * const hf) {
     copy_32_sw_fields();
   }
   // we measure before the trajectory!
-  if((mnl->rec_ev != 0) && (hf->traj_counter%mnl->rec_ev == 0)) {
+  // (adaptive approximations are measured in adapt_rational)
+  if((mnl->rec_ev != 0) && (mnl->rat_delta <= 0.) && (hf->traj_counter%mnl->rec_ev == 0)) {
     if(mnl->type != NDCLOVERRAT) phmc_compute_ev(hf->traj_counter-1, id, &Qtm_pm_ndbipsi);
     else phmc_compute_ev(hf->traj_counter-1, id, &Qsw_pm_ndbipsi);
   }
@@ -326,6 +327,9 @@ double ndrat_acc(const int id, hamiltonian_field_t * const hf) {
 int init_ndrat_monomial(const int id) {
   monomial * mnl = &monomial_list[id];  
 
+  // the order of the input is the maximal one, the chi fields are allocated for it
+  mnl->rat_max_order = mnl->rat.order;
+
   mnl->EVMin = mnl->StildeMin / mnl->StildeMax;
   mnl->EVMax = 1.;
   mnl->EVMaxInv = 1./(sqrt(mnl->StildeMax));
@@ -24,6 +24,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "global.h"
 #include "su3.h"
 #include "su3adj.h"
@@ -39,14 +42,10 @@
 #include "monomial/monomial.h"
 #include "sf_gauge_monomial.h"
 #include "hamiltonian_field.h"
-#include "sf_utils.h"
+#include "sf/sf_utils.h"
 
 void sf_gauge_derivative(const int id, hamiltonian_field_t * const hf) {
 
-  int i, mu;
-  static su3 v, w;
-  su3 *z;
-  su3adj *xm;
   monomial * mnl = &monomial_list[id];
   double factor = -1. * g_beta/3.0;
 
@@ -55,6 +54,19 @@ void sf_gauge_derivative(const int id, hamiltonian_field_t * const hf) {
     factor = -mnl->c0 * g_beta/3.0;
   }
 
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+
+  su3 ALIGN v, w;
+  int i, mu;
+  su3 *z;
+  su3adj *xm;
+
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
   for(i = 0; i < VOLUME; i++) { 
     for(mu=0;mu<4;mu++) {
       z=&hf->gaugefield[i][mu];
@@ -70,6 +82,10 @@ void sf_gauge_derivative(const int id, hamiltonian_field_t * const hf) {
       }
     }
   }
+
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
   return;
 }
 
@@ -79,10 +95,10 @@ void sf_gauge_heatbath( const int id, hamiltonian_field_t * const hf)
 
   if( mnl->use_rectangles ){ mnl->c0 = 1. - 8.*mnl->c1; }
 
-  mnl->energy0 = g_beta * ( mnl->c0 * measure_gauge_action(hf->gaugefield) );
+  mnl->energy0 = g_beta * ( mnl->c0 * measure_gauge_action( (const su3**) hf->gaugefield, mnl->glambda) );
 
   if(mnl->use_rectangles) {
-    mnl->energy0 += g_beta*(mnl->c1 * measure_rectangles(hf->gaugefield));
+    mnl->energy0 += g_beta*(mnl->c1 * measure_rectangles( (const su3**) hf->gaugefield));
   }
   if(g_proc_id == 0 && g_debug_level > 3) {
     printf("called gauge_heatbath for id %d %d\n", id, mnl->even_odd_flag);
@@ -92,6 +108,7 @@ void sf_gauge_heatbath( const int id, hamiltonian_field_t * const hf)
 double sf_gauge_acc( const int id, hamiltonian_field_t * const hf)
 {
   monomial* mnl = &(monomial_list[id]);
+  double sq_parts[5];
   double sq_plaq = 0;
   double sq_bulk_plaq = 0;
   double sq_boundary_space_space_plaq = 0;
@@ -100,15 +117,17 @@ double sf_gauge_acc( const int id, hamiltonian_field_t * const hf)
 
   double rect_plaq = 0;
 
-  sq_plaq = calc_sq_plaq();
-  sq_bulk_plaq = calc_bulk_sq_plaq();
-  sq_boundary_space_space_plaq = calc_boundary_space_space_sq_plaq();
-  sq_boundary_space_time_plaq = calc_boundary_space_time_sq_plaq();
-  sq_wrapped_plaq = calc_wrapped_sq_plaq();
+  /* all square contributions from one sweep over the lattice */
+  calc_sq_plaq_parts(sq_parts);
+  sq_plaq = sq_parts[0];
+  sq_bulk_plaq = sq_parts[1];
+  sq_boundary_space_space_plaq = sq_parts[2];
+  sq_boundary_space_time_plaq = sq_parts[3];
+  sq_wrapped_plaq = sq_parts[4];
 
   rect_plaq = calc_rect_plaq();
 
-  #if 1
+  if( ( g_proc_id == 0 ) && ( g_debug_level > 3 ) )
   {
     fprintf( stderr, "sq_plaq = %e\n", sq_plaq );
     fprintf( stderr, "beta * c0 * sq_plaq = %e\n", g_beta * mnl->c0 * sq_plaq );
@@ -128,7 +147,6 @@ double sf_gauge_acc( const int id, hamiltonian_field_t * const hf)
 
     fprintf( stderr, "my energy =    %e\n", g_beta * ( mnl->c0 * sq_plaq + mnl->c1 * rect_plaq ) );
   }
-  #endif
 
   /*mnl->energy1 = g_beta*( mnl->c0 * measure_gauge_action() );*/
 
@@ -136,21 +154,18 @@ double sf_gauge_acc( const int id, hamiltonian_field_t * const hf)
   mnl->energy1  = g_beta * mnl->c0 * sq_bulk_plaq;
 
   /* The space-time boundary contribution must be weighted differently. */
-  fprintf( stderr, "mnl->ct = %e\n", mnl->ct );
-  mnl->energy1 += g_beta * mnl->c0 * mnl->ct * sq_boundary_space_time_plaq;  
+  mnl->energy1 += g_beta * mnl->c0 * g_Ct * sq_boundary_space_time_plaq;  
 
   /* The space-space boundary contribution must be weighted differently. */
-  fprintf( stderr, "mnl->cs = %e\n", mnl->cs );
-  mnl->energy1 += g_beta * mnl->c0 * mnl->cs * sq_boundary_space_space_plaq;  
+  mnl->energy1 += g_beta * mnl->c0 * g_Cs * sq_boundary_space_space_plaq;  
 
   /* Include the missing plaquettes if requested. */
   if( g_sf_inc_wrap_sq == 1 ){ mnl->energy1 += g_beta * mnl->c0 * sq_wrapped_plaq; }
 
   if( mnl->use_rectangles )
   {
-    mnl->energy1 += g_beta*( mnl->c1 * measure_rectangles(hf->gaugefield) );
+    mnl->energy1 += g_beta*( mnl->c1 * measure_rectangles( (const su3**) hf->gaugefield) );
   }
-  fprintf( stderr, "mnl->energy1 = %e\n", mnl->energy1 );
 
   if( ( g_proc_id == 0 ) & ( g_debug_level > 3 ) )
   {
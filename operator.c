@@ -60,6 +60,9 @@
 #include "operator/clover_leaf.h"
 #include "operator.h"
 #include "gettime.h"
+#include "gamma.h"
+#include "init/init_spinor_field.h"
+#include "linalg/convert_eo_to_lexic.h"
 #ifdef QUDA
 #  include "quda_interface.h"
 #endif
@@ -116,6 +119,10 @@ int add_operator(const int type) {
   optr->applyMeeInv = &dummy_Mee;
   optr->applyQ = &dummy_M;
   (optr->solver_params).mcg_delta = _default_mixcg_innereps;
+  (optr->solver_params).lowmodes_nev = _default_lowmodes_nev;
+  (optr->solver_params).lowmodes_single = _default_lowmodes_single;
+  (optr->solver_params).lowmodes_readwrite = _default_lowmodes_readwrite;
+  (optr->solver_params).lowmodes_prec = _default_lowmodes_prec;
   optr->applyQp = &dummy_D;
   optr->applyQm = &dummy_D;
   optr->applyMp = &dummy_D;
@@ -526,6 +533,188 @@ void op_invert(const int op_id, const int index_start, const int write_prop) {
 }
 
 
+/* two operators can be inverted with one multi-shift CG if */
+/* Q^+Q^- differs only by a shift mu^2, i.e. they use the    */
+/* same kappa and c_sw, no even/odd preconditioning and the  */
+/* plain CG. The source must not depend on the operator.     */
+static int op_multimass_eligible(operator * const optr) {
+  if(optr->type != TMWILSON && optr->type != WILSON) return(0);
+  if(optr->solver != CG || optr->even_odd_flag || optr->DownProp) return(0);
+  if(optr->no_extra_masses != 0 || optr->external_inverter != NO_EXT_INV) return(0);
+  return(1);
+}
+
+int init_operator_groups(int * const group) {
+  int merged = 0;
+  operator * optr, * lptr;
+
+  for(int i = 0; i < no_operators; i++) {
+    group[i] = i;
+  }
+  if(!g_multimass_groups || use_preconditioning) return(0);
+#ifdef HAVE_GPU
+  if(usegpu_flag) return(0);
+#endif
+  if(SourceInfo.type != SRC_TYPE_POINT && SourceInfo.type != SRC_TYPE_TS && 
+     SourceInfo.type != SRC_TYPE_VOL) return(0);
+  /* the operators of a group are written index by index, which */
+  /* changes the record order of unsplitted propagator files     */
+  if(SourceInfo.type != SRC_TYPE_VOL && !PropInfo.splitted &&
+     index_end - index_start > 1) return(0);
+
+  for(int i = 0; i < no_operators; i++) {
+    optr = &operator_list[i];
+    if(group[i] != i || !op_multimass_eligible(optr)) continue;
+    for(int j = i+1; j < no_operators; j++) {
+      lptr = &operator_list[j];
+      if(group[j] != j || !op_multimass_eligible(lptr)) continue;
+      if(lptr->kappa == optr->kappa && lptr->c_sw == optr->c_sw &&
+         lptr->rel_prec == optr->rel_prec) {
+        group[j] = i;
+        merged++;
+      }
+    }
+  }
+  if(g_proc_id == 0 && merged > 0) {
+    for(int i = 0; i < no_operators; i++) {
+      if(group[i] != i) {
+        printf("# operator %d is inverted together with operator %d using multi mass CG\n", i, group[i]);
+      }
+    }
+  }
+  return(merged);
+}
+
+/* inverts the operators op_ids[0..nops-1] of one group on the   */
+/* source prepared for op_ids[0] with a single call to cg_mms_tm */
+/* every mass is then refined with CG starting from its shifted  */
+/* solution to the precision of its own operator and written out */
+/* exactly as op_invert would have done it                       */
+/* the solutions are computed in private fields, an operator     */
+/* with propagator fields of its own gets a copy, the source and */
+/* propagator fields of the operators are only lent to           */
+/* write_prop and restored afterwards                            */
+void op_invert_multimass(const int * const op_ids, const int nops, 
+                         const int index_start, const int write_prop) {
+  operator * lptr = &operator_list[op_ids[0]];
+  operator * optr;
+  double atime = 0., etime = 0., nrm1 = 0., nrm2 = 0., mms_reached_prec = 0.;
+  double * shifts = (double*)calloc(nops, sizeof(double));
+  int * order = (int*)calloc(nops, sizeof(int));
+  int iter = 0, iter_mms = 0, m, k, tmp;
+  spinor * P_memory, * S_memory;
+  spinor ** P, ** S;
+  spinor * save[4];
+  solver_pm_t solver_pm;
+
+  g_kappa = lptr->kappa;
+  boundary(g_kappa);
+  g_c_sw = lptr->c_sw;
+
+  /* cg_mms_tm needs the shifts ordered by ascending |mu| */
+  for(k = 0; k < nops; k++) {
+    order[k] = k;
+  }
+  for(k = 1; k < nops; k++) {
+    for(m = k; m > 0 && fabs(operator_list[op_ids[order[m-1]]].mu) > fabs(operator_list[op_ids[order[m]]].mu); m--) {
+      tmp = order[m]; order[m] = order[m-1]; order[m-1] = tmp;
+    }
+  }
+
+  solver_pm.shifts = shifts;
+  solver_pm.no_shifts = nops;
+  solver_pm.rel_prec = lptr->rel_prec;
+  solver_pm.max_iter = 0;
+  solver_pm.squared_solver_prec = lptr->eps_sq;
+  solver_pm.sdim = VOLUME;
+  solver_pm.M_psi = &Q_pm_psi;
+  solver_pm.type = CGMMS;
+  for(k = 0; k < nops; k++) {
+    optr = &operator_list[op_ids[order[k]]];
+    shifts[k] = optr->mu;
+    if(optr->maxiter > solver_pm.max_iter) solver_pm.max_iter = optr->maxiter;
+    if(optr->eps_sq < solver_pm.squared_solver_prec) solver_pm.squared_solver_prec = optr->eps_sq;
+  }
+
+  /* the refinement applies Q_pm_psi to the solutions, so we need the boundary */
+  allocate_spinor_field_array(&P, &P_memory, VOLUMEPLUSRAND, nops);
+  /* even and odd part of the solution of one operator */
+  allocate_spinor_field_array(&S, &S_memory, VOLUMEPLUSRAND/2, 2);
+
+  atime = gettime();
+  convert_eo_to_lexic(g_spinor_field[DUM_DERI], lptr->sr0, lptr->sr1);
+  gamma5(g_spinor_field[DUM_DERI+1], g_spinor_field[DUM_DERI], VOLUME);
+  g_mu = 0.;
+  iter_mms = cg_mms_tm(P, g_spinor_field[DUM_DERI+1], &solver_pm, &mms_reached_prec);
+  etime = gettime();
+  if(g_cart_id == 0 && g_debug_level > 0) {
+    printf("# Multi mass CG for %d operators: iter: %d eps_sq: %1.4e %1.4e s\n", 
+           nops, iter_mms, mms_reached_prec, etime - atime);
+  }
+
+  /* refine and write in the order of the operator list */
+  for(k = 0; k < nops; k++) {
+    for(m = 0; order[m] != k; m++);
+    optr = &operator_list[op_ids[k]];
+    optr->iterations = 0;
+    optr->reached_prec = -1.;
+
+    atime = gettime();
+    g_mu = optr->mu;
+    if (g_cart_id == 0) {
+      printf("#\n# 2 kappa mu = %e, kappa = %e, c_sw = %e\n", g_mu, g_kappa, g_c_sw);
+    }
+    iter = cg_her(P[m], g_spinor_field[DUM_DERI+1], optr->maxiter, optr->eps_sq, 
+                  optr->rel_prec, VOLUME, &Q_pm_psi);
+    optr->iterations = (iter_mms < 0 || iter < 0) ? -1 : iter_mms + iter;
+    Q_minus_psi(g_spinor_field[DUM_DERI+2], P[m]);
+    convert_lexic_to_eo(S[0], S[1], g_spinor_field[DUM_DERI+2]);
+
+    /* check result */
+    M_full(g_spinor_field[DUM_DERI+3], g_spinor_field[DUM_DERI+4], S[0], S[1]);
+    diff(g_spinor_field[DUM_DERI+3], g_spinor_field[DUM_DERI+3], lptr->sr0, VOLUME / 2);
+    diff(g_spinor_field[DUM_DERI+4], g_spinor_field[DUM_DERI+4], lptr->sr1, VOLUME / 2);
+    nrm1 = square_norm(g_spinor_field[DUM_DERI+3], VOLUME / 2, 1);
+    nrm2 = square_norm(g_spinor_field[DUM_DERI+4], VOLUME / 2, 1);
+    optr->reached_prec = nrm1 + nrm2;
+
+    /* convert to standard normalisation  */
+    /* we have to mult. by 2*kappa        */
+    if (optr->kappa != 0.) {
+      mul_r(S[0], (2*optr->kappa), S[0], VOLUME / 2);
+      mul_r(S[1], (2*optr->kappa), S[1], VOLUME / 2);
+    }
+    if(optr->prop0 != NULL && optr->prop1 != NULL) {
+      assign(optr->prop0, S[0], VOLUME / 2);
+      assign(optr->prop1, S[1], VOLUME / 2);
+    }
+    if(write_prop) {
+      save[0] = optr->sr0; save[1] = optr->sr1; save[2] = optr->prop0; save[3] = optr->prop1;
+      optr->sr0 = lptr->sr0;
+      optr->sr1 = lptr->sr1;
+      optr->prop0 = S[0];
+      optr->prop1 = S[1];
+      optr->write_prop(op_ids[k], index_start, 0);
+      optr->sr0 = save[0]; optr->sr1 = save[1]; optr->prop0 = save[2]; optr->prop1 = save[3];
+    }
+    etime = gettime();
+
+    if (g_cart_id == 0 && g_debug_level > 0) {
+      fprintf(stdout, "# Inversion done in %d iterations, squared residue = %e!\n",
+              optr->iterations, optr->reached_prec);
+      fprintf(stdout, "# Refinement done in %1.2e sec. \n", etime - atime);
+    }
+  }
+
+  free_spinor_field_array(&S_memory);
+  free(S);
+  free_spinor_field_array(&P_memory);
+  free(P);
+  free(order);
+  free(shifts);
+  return;
+}
+
 void op_write_prop(const int op_id, const int index_start, const int append_) {
   operator * optr = &operator_list[op_id];
   char filename[100];
@@ -595,9 +784,14 @@ void op_write_prop(const int op_id, const int index_start, const int append_) {
   free(propagatorFormat);
 
   if(optr->no_flavours == 2) {
-    status = write_spinor(writer, &operator_list[op_id].prop2, &operator_list[op_id].prop3, 1, optr->prop_precision);
+    /* both flavours in one stream */
+    spinor * s[2] = {operator_list[op_id].prop2, operator_list[op_id].prop0};
+    spinor * r[2] = {operator_list[op_id].prop3, operator_list[op_id].prop1};
+    status = write_spinor(writer, s, r, 2, optr->prop_precision);
+  }
+  else {
+    status = write_spinor(writer, &operator_list[op_id].prop0, &operator_list[op_id].prop1, 1, optr->prop_precision);
   }
-  status = write_spinor(writer, &operator_list[op_id].prop0, &operator_list[op_id].prop1, 1, optr->prop_precision);
   // check status for errors!?
   destruct_writer(writer);
   return;
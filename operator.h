@@ -140,5 +140,9 @@ extern int no_operators;
 
 int add_operator(const int type);
 int init_operators();
+/* group[i] is the operator with which operator i is inverted by multi mass CG */
+int init_operator_groups(int * const group);
+void op_invert_multimass(const int * const op_ids, const int nops, 
+                         const int index_start, const int write_prop);
 
 #endif
@@ -66,6 +66,11 @@
 #  include"DirectPut.h"
 #endif
 #include "operator/Hopping_Matrix.h"
+#include "profiler.h"
+
+/* 1320 flops per site, 8 links and 9 spinors loaded or stored per site */
+#define _HM_FLOPS (1320.*VOLUME/2)
+#define _HM_BYTES ((double)VOLUME/2*(8*sizeof(su3) + 9*sizeof(spinor)))
 
 #if defined _USE_HALFSPINOR
 #  include "operator/halfspinor_hopping.h"
@@ -83,25 +88,31 @@
 
 #  endif
 
-void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k) {
-
+void Hopping_Matrix_orphaned(const int ieo, spinor * const l, spinor * const k) {
 #ifdef _GAUGE_COPY
   if(g_update_gauge_copy) {
-    update_backward_gauge(g_gauge_field);
+    update_backward_gauge_orphaned(g_gauge_field);
   }
 #endif
 
 #ifdef TM_USE_OMP
-#pragma omp parallel
-  {
   su3 * restrict u0 ALIGN;
 #endif
 
 #  include "operator/halfspinor_body.c"
+}
 
-#  ifdef TM_USE_OMP
+void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k) {
+  prof_begin("Hopping_Matrix");
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  Hopping_Matrix_orphaned(ieo, l, k);
+#ifdef TM_USE_OMP
   } /* OpenMP closing brace */
-#  endif
+#endif
+  prof_end("Hopping_Matrix", _HM_FLOPS, _HM_BYTES);
   return;
 }
 
@@ -111,6 +122,19 @@ void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k) {
 #    include "sse.h"
 #    include "operator/hopping_sse_dbl.c"
 
+/* the SSE version with time split has no orphaned implementation, */
+/* the master thread applies the full operator                     */
+void Hopping_Matrix_orphaned(const int ieo, spinor * const l, spinor * const k) {
+#    ifdef TM_USE_OMP
+#      pragma omp barrier
+#      pragma omp master
+#    endif
+  Hopping_Matrix(ieo, l, k);
+#    ifdef TM_USE_OMP
+#      pragma omp barrier
+#    endif
+}
+
 #  else
 #    include "operator/hopping.h"
 #    if ((defined SSE2)||(defined SSE3))
@@ -128,10 +152,33 @@ void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k) {
 #      include"xlc_prefetch.h"
 
 #    endif
+void Hopping_Matrix_orphaned(const int ieo, spinor * const l, spinor * const k) {
+#    ifdef XLC
+#      pragma disjoint(*l, *k)
+#    endif
+#    ifdef _GAUGE_COPY
+  if(g_update_gauge_copy) {
+    update_backward_gauge_orphaned(g_gauge_field);
+  }
+#    endif
+
+#    if (defined TM_USE_MPI && !(defined _NO_COMM))
+#      ifdef TM_USE_OMP
+#        pragma omp single
+#      endif
+  {
+    xchange_field(k, ieo);
+  }
+#    endif
+
+#    include "operator/hopping_body_dbl.c"
+}
+
 void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k) {
 #    ifdef XLC
 #      pragma disjoint(*l, *k)
 #    endif
+  prof_begin("Hopping_Matrix");
 #    ifdef _GAUGE_COPY
   if(g_update_gauge_copy) {
     update_backward_gauge(g_gauge_field);
@@ -152,6 +199,7 @@ void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k) {
 #    ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #    endif
+  prof_end("Hopping_Matrix", _HM_FLOPS, _HM_BYTES);
   return;
 }
 #  endif
@@ -27,5 +27,6 @@
 
 #  include "su3.h"
 
+void Hopping_Matrix_orphaned(const int ieo, spinor * const l, spinor * const k);
 void Hopping_Matrix(const int ieo, spinor * const l, spinor * const k);
 #endif
@@ -84,6 +84,7 @@
 #  include"DirectPut.h"
 #endif
 #include "operator/Hopping_Matrix_32.h"
+#include "profiler.h"
 
 #if defined _USE_HALFSPINOR
 #  include "operator/halfspinor_hopping_32.h"
@@ -117,6 +118,7 @@ void Hopping_Matrix_32_orphaned(const int ieo, spinor32 * const l, spinor32 * co
 
 
 void Hopping_Matrix_32(const int ieo, spinor32 * const l, spinor32 * const k) {
+  prof_begin("Hopping_Matrix_32");
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
@@ -125,6 +127,8 @@ void Hopping_Matrix_32(const int ieo, spinor32 * const l, spinor32 * const k) {
 #ifdef TM_USE_OMP
   }
 #endif
+  /* 1320 flops per site, 8 links and 9 spinors loaded or stored per site */
+  prof_end("Hopping_Matrix_32", 1320.*VOLUME/2, (double)VOLUME/2*(8*sizeof(su3_32) + 9*sizeof(spinor32)));
   return;
 }
 
@@ -52,6 +52,7 @@
 #include "operator/clovertm_operators.h"
 #include "operator/clover_leaf.h"
 #include "operator/clover_inline.h"
+#include "derived_gauge_fields.h"
 
 /*
   !--------------------------------------------------------------!
@@ -165,6 +166,7 @@ void six_invert(int* ifail ,_Complex double a[6][6])
 // - is stored in sw_inv[VOLUME/2-(VOLUME-1)]
 
 void sw_invert(const int ieo, const double mu) {
+  if(sw_inv_current(SW_INV_TM, ieo, mu)) return;
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
@@ -253,6 +255,7 @@ void sw_invert(const int ieo, const double mu) {
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
+  sw_inv_computed(SW_INV_TM, ieo, mu);
   return;
 }
 
@@ -270,6 +273,7 @@ void sw_invert(const int ieo, const double mu) {
 // must be done elsewhere because of flavour structure
 
 void sw_invert_nd(const double mshift) {
+  if(sw_inv_current(SW_INV_ND, 0, mshift)) return;
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
@@ -315,5 +319,6 @@ void sw_invert_nd(const double mshift) {
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
+  sw_inv_computed(SW_INV_ND, 0, mshift);
   return;
 }
@@ -51,6 +51,7 @@
 #include "su3adj.h"
 #include "operator/clovertm_operators.h"
 #include "operator/clover_leaf.h"
+#include "derived_gauge_fields.h"
 
 // the clover term is written as
 //
@@ -86,6 +87,10 @@
 // suppressing space-time indices
 
 void sw_term(const su3 ** const gf, const double kappa, const double c_sw) {
+  /* nothing to do if neither the links nor the parameters changed */
+  if(sw_term_current(gf, kappa, c_sw)) return;
+  if(gf == (const su3 **) g_gauge_field) update_gauge_halo();
+
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
@@ -200,5 +205,6 @@ void sw_term(const su3 ** const gf, const double kappa, const double c_sw) {
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
+  sw_term_computed(gf, kappa, c_sw);
   return;
 }
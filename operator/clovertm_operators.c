@@ -55,6 +55,7 @@
 
 #include "operator/clovertm_operators.h"
 #include "operator/D_psi.h"
+#include "derived_gauge_fields.h"
 
 su3 *** sw;
 su3 *** sw_inv;
@@ -1263,6 +1264,8 @@ void init_sw_fields() {
 void copy_32_sw_fields(){
   
   int V = VOLUME;
+
+  if(sw_32_current()) return;
   
   for(int i = 0; i < V; i++) {
       for(int j = 0; j < 3; j++) {
@@ -1299,6 +1302,7 @@ void copy_32_sw_fields(){
 	}
       }
     }
+  sw_32_computed();
 }
 
 
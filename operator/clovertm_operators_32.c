@@ -62,11 +62,7 @@
 #include "operator/clovertm_operators_32.h"
 
 
-void Qsw_pm_psi_32(spinor32 * const l, spinor32 * const k) {
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
+void Qsw_pm_psi_32_orphaned(spinor32 * const l, spinor32 * const k) {
   /* \hat Q_{-} */
   Hopping_Matrix_32_orphaned(EO, g_spinor_field32[1], k);
   clover_inv_32_orphaned(g_spinor_field32[1], -1, g_mu);
@@ -77,6 +73,14 @@ void Qsw_pm_psi_32(spinor32 * const l, spinor32 * const k) {
   clover_inv_32_orphaned(l, +1, g_mu); 
   Hopping_Matrix_32_orphaned(OE, g_spinor_field32[1], l);
   clover_gamma5_32_orphaned(OO, l, g_spinor_field32[0], g_spinor_field32[1], +(g_mu + g_mu3));
+}
+
+void Qsw_pm_psi_32(spinor32 * const l, spinor32 * const k) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  Qsw_pm_psi_32_orphaned(l, k);
 #ifdef TM_USE_OMP
   } /* OpenMP parallel closing brace */
 #endif
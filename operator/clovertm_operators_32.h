@@ -33,6 +33,7 @@ extern su3 ** swm, ** swp;
 
 void clover_inv_32_orphaned(spinor32 * const l, const int tau3sign, const double mu);
 void clover_inv_32(spinor32 * const l, const int tau3sign, const double mu);
+void Qsw_pm_psi_32_orphaned(spinor32 * const l, spinor32 * const k);
 void Qsw_pm_psi_32(spinor32 * const l, spinor32 * const k);
 void clover_gamma5_32_orphaned(const int ieo, 
 		   spinor32 * const l, const spinor32 * const k, const spinor32 * const j,
@@ -79,6 +79,8 @@ void mul_one_pm_imu(spinor * const l, const double _sign);
  ******************************************/
 void mul_one_pm_imu_sub_mul_gamma5(spinor * const l, spinor * const k, 
 				   spinor * const j, const double _sign);
+void mul_one_pm_imu_sub_mul_gamma5_orphaned(spinor * const l, spinor * const k, 
+                                            spinor * const j, const double _sign);
 void mul_one_sub_mul_gamma5(spinor * const l, spinor * const k, 
 			    spinor * const j);
 
@@ -258,6 +260,15 @@ void Mtm_plus_sym_psi(spinor * const l, spinor * const k){
   diff(l, k, g_spinor_field[DUM_MATRIX], VOLUME/2);
 }
 
+/* to be called by all threads from within a parallel region */
+void Mtm_plus_sym_psi_orphaned(spinor * const l, spinor * const k){
+  Hopping_Matrix_orphaned(EO, g_spinor_field[DUM_MATRIX+1], k);
+  mul_one_pm_imu_inv_orphaned(g_spinor_field[DUM_MATRIX+1], +1., VOLUME/2);
+  Hopping_Matrix_orphaned(OE, g_spinor_field[DUM_MATRIX], g_spinor_field[DUM_MATRIX+1]);
+  mul_one_pm_imu_inv_orphaned(g_spinor_field[DUM_MATRIX], +1., VOLUME/2);
+  diff_orphaned(l, k, g_spinor_field[DUM_MATRIX], VOLUME/2);
+}
+
 void Mtm_plus_sym_psi_nocom(spinor * const l, spinor * const k){
   Hopping_Matrix_nocom(EO, g_spinor_field[DUM_MATRIX+1], k);
   mul_one_pm_imu_inv(g_spinor_field[DUM_MATRIX+1], +1., VOLUME/2);
@@ -338,6 +349,20 @@ void Qtm_pm_psi(spinor * const l, spinor * const k){
   tm_sub_H_eo_gamma5(l, g_spinor_field[DUM_MATRIX], g_spinor_field[DUM_MATRIX+1], OE, +1);
 }
 
+/* to be called by all threads from within a parallel region */
+void Qtm_pm_psi_orphaned(spinor * const l, spinor * const k){
+  /* Q_{-} */
+  Hopping_Matrix_orphaned(EO, g_spinor_field[DUM_MATRIX+1], k);
+  mul_one_pm_imu_inv_orphaned(g_spinor_field[DUM_MATRIX+1], -1., VOLUME/2);
+  Hopping_Matrix_orphaned(OE, g_spinor_field[DUM_MATRIX], g_spinor_field[DUM_MATRIX+1]);
+  mul_one_pm_imu_sub_mul_gamma5_orphaned(g_spinor_field[DUM_MATRIX], k, g_spinor_field[DUM_MATRIX], -1.);
+  /* Q_{+} */
+  Hopping_Matrix_orphaned(EO, l, g_spinor_field[DUM_MATRIX]);
+  mul_one_pm_imu_inv_orphaned(l, +1., VOLUME/2);
+  Hopping_Matrix_orphaned(OE, g_spinor_field[DUM_MATRIX+1], l);
+  mul_one_pm_imu_sub_mul_gamma5_orphaned(l, g_spinor_field[DUM_MATRIX], g_spinor_field[DUM_MATRIX+1], +1.);
+}
+
 void Qtm_pm_sym_psi(spinor * const l, spinor * const k){
   /* Q_{-} */
   Hopping_Matrix(EO, g_spinor_field[DUM_MATRIX+1], k);
@@ -578,6 +603,37 @@ void tm_sub_H_eo_gamma5(spinor* const l, spinor * const p, spinor * const k,
 #undef _PTSWITCH
 
 
+void mul_one_pm_imu_inv_orphaned(spinor * const l, const double _sign, const int N){
+  _Complex double z,w;
+  double sign=-1.; 
+  spinor *r;
+  su3_vector ALIGN phi1;
+  double nrm = 1./(1.+g_mu*g_mu);
+
+  if(_sign < 0.){
+    sign = 1.; 
+  }
+
+  z = nrm + (sign * nrm * g_mu) * I;
+  w = conj(z);
+  /************ loop over all lattice sites ************/
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int ix = 0; ix < N; ix++){
+    r=l + ix;
+    /* Multiply the spinorfield with the inverse of 1+imu\gamma_5 */
+    _complex_times_vector(phi1, z, r->s0);
+    _vector_assign(r->s0, phi1);
+    _complex_times_vector(phi1, z, r->s1);
+    _vector_assign(r->s1, phi1);
+    _complex_times_vector(phi1, w, r->s2);
+    _vector_assign(r->s2, phi1);
+    _complex_times_vector(phi1, w, r->s3);
+    _vector_assign(r->s3, phi1);
+  }
+}
+
 void Mee_inv_psi(spinor * const l, spinor * const k, const double mu){
 #ifdef TM_USE_OMP
 #pragma omp parallel
@@ -804,12 +860,8 @@ void mul_one_sub_mul_gamma5(spinor * const l, spinor * const k,
 }
 
 
-void mul_one_pm_imu_sub_mul_gamma5(spinor * const l, spinor * const k, 
-				   spinor * const j, const double _sign){
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
+void mul_one_pm_imu_sub_mul_gamma5_orphaned(spinor * const l, spinor * const k, 
+                                            spinor * const j, const double _sign){
   _Complex double z,w;
   int ix;
   double sign=1.;
@@ -845,7 +897,15 @@ void mul_one_pm_imu_sub_mul_gamma5(spinor * const l, spinor * const k,
     _vector_sub(t->s2, s->s2, phi3);
     _vector_sub(t->s3, s->s3, phi4);
   }
+}
 
+void mul_one_pm_imu_sub_mul_gamma5(spinor * const l, spinor * const k, 
+				   spinor * const j, const double _sign){
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  mul_one_pm_imu_sub_mul_gamma5_orphaned(l, k, j, _sign);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
@@ -39,8 +39,10 @@ void Mtm_plus_psi_nocom(spinor * const l, spinor * const k);
 void Mtm_minus_psi(spinor * const l, spinor * const k);
 void Qtm_pm_psi(spinor * const l, spinor * const k);
 void Qtm_pm_psi_nocom(spinor * const l, spinor * const k);
+void Qtm_pm_psi_orphaned(spinor * const l, spinor * const k);
 void H_eo_tm_inv_psi(spinor * const l, spinor * const k, const int ieo, const double sign);
 void mul_one_pm_imu_inv(spinor * const l, const double _sign, const int N);
+void mul_one_pm_imu_inv_orphaned(spinor * const l, const double _sign, const int N);
 void mul_one_pm_imu_inv_32(spinor32 * const l, const double _sign, const int N);
 void assign_mul_one_pm_imu_inv(spinor * const l, spinor * const k, const double _sign, const int N);
 void assign_mul_one_pm_imu_inv_32(spinor32 * const l, spinor32 * const k, const double _sign, const int N);
@@ -58,6 +60,7 @@ void Qtm_plus_sym_psi(spinor * const l, spinor * const k);
 void Qtm_plus_sym_psi_nocom(spinor * const l, spinor * const k);
 void Qtm_minus_sym_psi(spinor * const l, spinor * const k);
 void Mtm_plus_sym_psi(spinor * const l, spinor * const k);
+void Mtm_plus_sym_psi_orphaned(spinor * const l, spinor * const k);
 void Mtm_plus_sym_dagg_psi(spinor * const l, spinor * const k);
 void Mtm_minus_sym_psi(spinor * const l, spinor * const k);
 void Mtm_plus_sym_psi_nocom(spinor * const l, spinor * const k);
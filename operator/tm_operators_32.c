@@ -91,12 +91,8 @@ void mul_one_pm_imu_sub_mul_gamma5_32_orphaned(spinor32 * const l, spinor32 * co
   }
 }
 
-void Qtm_pm_psi_32(spinor32 * const l, spinor32 * const k){
+void Qtm_pm_psi_32_orphaned(spinor32 * const l, spinor32 * const k){
   /* Q_{-} */
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif  
   Hopping_Matrix_32_orphaned(EO, g_spinor_field32[1], k);
   mul_one_pm_imu_inv_32_orphaned(g_spinor_field32[1], -1., VOLUME/2);
   Hopping_Matrix_32_orphaned(OE, g_spinor_field32[0], g_spinor_field32[1]);
@@ -106,6 +102,14 @@ void Qtm_pm_psi_32(spinor32 * const l, spinor32 * const k){
   mul_one_pm_imu_inv_32_orphaned(l, +1., VOLUME/2);
   Hopping_Matrix_32_orphaned(OE, g_spinor_field32[1], l);
   mul_one_pm_imu_sub_mul_gamma5_32_orphaned(l, g_spinor_field32[0], g_spinor_field32[1], +1.);
+}
+
+void Qtm_pm_psi_32(spinor32 * const l, spinor32 * const k){
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif  
+  Qtm_pm_psi_32_orphaned(l, k);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif  
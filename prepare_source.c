@@ -147,8 +147,8 @@ void prepare_source(const int nstore, const int isample, const int ix, const int
       // If a pion timeslice source has already been inverted for the current sample and gauge configuration,
       // we would like to re-use the same timeslice, which we ensure with the loop below. The reason for doing 
       // this is that we cannot guarantee that the call to ranlxs below is reproducible.
-      // Note: source_generation_pion_only reinitialises the RNG with a systematically chosen seed and thus does
-      // not suffer from this problem when called below.
+      // Note: source_generation_pion_only uses site-indexed random numbers keyed by sample, nstore and t
+      // and thus does not suffer from this problem when called below.
       if(SourceInfo.automaticTS) {
         int found = 0;
         if(g_proc_id == 0 && !PropInfo.splitted) {
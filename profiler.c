@@ -0,0 +1,353 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include "global.h"
+#include "gettime.h"
+#include "profiler.h"
+
+#define PROF_MAX_NAMES 128
+#define PROF_MAX_NODES 256
+#define PROF_MAX_DEPTH 32
+#define PROF_NAME 64
+#define PROF_PATH 256
+
+typedef struct {
+  char path[PROF_PATH];
+  double time, calls, flops, bytes;
+} prof_record_t;
+
+/* region names, identified by the pointer passed first */
+static const char * prof_name_ptr[PROF_MAX_NAMES];
+static char prof_name_str[PROF_MAX_NAMES][PROF_NAME];
+static int prof_nnames = 0;
+
+/* the tree: name, parent, first child and next sibling of every node */
+static int prof_node_name[PROF_MAX_NODES], prof_node_parent[PROF_MAX_NODES];
+static int prof_node_child[PROF_MAX_NODES], prof_node_sibling[PROF_MAX_NODES];
+static int prof_root = -1;
+static int prof_nnodes = 0;
+
+/* per thread stacks and accumulators */
+static int prof_nthreads = 0;
+static int * prof_depth = NULL;
+static int * prof_stack = NULL;
+static double * prof_t0 = NULL;
+static double * prof_time = NULL, * prof_calls = NULL, * prof_flops = NULL, * prof_bytes = NULL;
+static int prof_warned = 0;
+
+int init_profiler() {
+  if(prof_nthreads > 0) return(0);
+#ifdef TM_USE_OMP
+  prof_nthreads = omp_num_threads > 0 ? omp_num_threads : 1;
+#else
+  prof_nthreads = 1;
+#endif
+  prof_depth = (int*)calloc(prof_nthreads, sizeof(int));
+  prof_stack = (int*)calloc(prof_nthreads*PROF_MAX_DEPTH, sizeof(int));
+  prof_t0 = (double*)calloc(prof_nthreads*PROF_MAX_DEPTH, sizeof(double));
+  prof_time = (double*)calloc(4*prof_nthreads*PROF_MAX_NODES, sizeof(double));
+  if(prof_depth == NULL || prof_stack == NULL || prof_t0 == NULL || prof_time == NULL) {
+    fprintf(stderr, "Could not allocate memory for the profiler\n");
+    free_profiler();
+    return(-1);
+  }
+  prof_calls = prof_time + prof_nthreads*PROF_MAX_NODES;
+  prof_flops = prof_calls + prof_nthreads*PROF_MAX_NODES;
+  prof_bytes = prof_flops + prof_nthreads*PROF_MAX_NODES;
+  return(0);
+}
+
+void free_profiler() {
+  free(prof_depth);
+  free(prof_stack);
+  free(prof_t0);
+  free(prof_time);
+  prof_depth = NULL;
+  prof_stack = NULL;
+  prof_t0 = NULL;
+  prof_time = prof_calls = prof_flops = prof_bytes = NULL;
+  prof_nthreads = 0;
+  return;
+}
+
+static int prof_thread() {
+#ifdef TM_USE_OMP
+  int t = omp_get_thread_num();
+  return(t < prof_nthreads ? t : 0);
+#else
+  return(0);
+#endif
+}
+
+/* returns the index of name, registering it if necessary */
+static int prof_name(const char * const name) {
+  int i, n;
+  for(i = 0; i < prof_nnames; i++) {
+    if(prof_name_ptr[i] == name) return(i);
+  }
+  n = -1;
+#ifdef TM_USE_OMP
+#pragma omp critical(prof_registry)
+#endif
+  {
+    for(i = 0; i < prof_nnames && n < 0; i++) {
+      if(strncmp(prof_name_str[i], name, PROF_NAME-1) == 0) n = i;
+    }
+    if(n < 0 && prof_nnames < PROF_MAX_NAMES) {
+      n = prof_nnames;
+      strncpy(prof_name_str[n], name, PROF_NAME-1);
+      prof_name_str[n][PROF_NAME-1] = '\0';
+      prof_name_ptr[n] = name;
+#ifdef TM_USE_OMP
+#pragma omp flush
+#endif
+      prof_nnames++;
+    }
+  }
+  return(n);
+}
+
+/* returns the child of parent (-1 for the top level) with the given name */
+static int prof_node(const int parent, const int name) {
+  int i, first = (parent < 0) ? prof_root : prof_node_child[parent];
+  for(i = first; i > -1; i = prof_node_sibling[i]) {
+    if(prof_node_name[i] == name) return(i);
+  }
+  i = -1;
+#ifdef TM_USE_OMP
+#pragma omp critical(prof_registry)
+#endif
+  {
+    first = (parent < 0) ? prof_root : prof_node_child[parent];
+    for(i = first; i > -1 && prof_node_name[i] != name; i = prof_node_sibling[i]);
+    if(i < 0 && prof_nnodes < PROF_MAX_NODES) {
+      i = prof_nnodes;
+      prof_node_name[i] = name;
+      prof_node_parent[i] = parent;
+      prof_node_child[i] = -1;
+      prof_node_sibling[i] = first;
+      prof_nnodes++;
+#ifdef TM_USE_OMP
+#pragma omp flush
+#endif
+      if(parent < 0) prof_root = i;
+      else prof_node_child[parent] = i;
+    }
+  }
+  return(i);
+}
+
+void prof_begin(const char * const name) {
+  int t, d, parent, node = -1, n;
+  if(!g_profiling || prof_nthreads == 0) return;
+
+  t = prof_thread();
+  d = prof_depth[t];
+  if(d >= PROF_MAX_DEPTH) {
+    prof_depth[t] = d+1;
+    return;
+  }
+  if(d > 0) {
+    parent = prof_stack[t*PROF_MAX_DEPTH + d-1];
+  }
+  else {
+    parent = -1;
+#ifdef TM_USE_OMP
+    if(t != 0 && omp_in_parallel() && prof_depth[0] > 0) {
+      parent = prof_stack[prof_depth[0]-1];
+    }
+#endif
+  }
+  /* regions below an unregistered one are not registered either */
+  if(d == 0 || parent > -1) {
+    n = prof_name(name);
+    if(n > -1) node = prof_node(parent, n);
+  }
+  prof_stack[t*PROF_MAX_DEPTH + d] = node;
+  prof_t0[t*PROF_MAX_DEPTH + d] = gettime();
+  prof_depth[t] = d+1;
+  return;
+}
+
+void prof_end(const char * const name, const double flops, const double bytes) {
+  int t, d, node;
+  double t1;
+  if(!g_profiling || prof_nthreads == 0) return;
+
+  t1 = gettime();
+  t = prof_thread();
+  d = prof_depth[t]-1;
+  if(d < 0) return;
+  prof_depth[t] = d;
+  if(d >= PROF_MAX_DEPTH) return;
+  node = prof_stack[t*PROF_MAX_DEPTH + d];
+  if(node < 0) return;
+  if(!prof_warned && strncmp(prof_name_str[prof_node_name[node]], name, PROF_NAME-1) != 0) {
+    fprintf(stderr, "Warning: profiling region %s closed while %s is open\n", 
+            name, prof_name_str[prof_node_name[node]]);
+    prof_warned = 1;
+  }
+  prof_time[t*PROF_MAX_NODES + node] += t1 - prof_t0[t*PROF_MAX_DEPTH + d];
+  prof_calls[t*PROF_MAX_NODES + node] += 1.;
+  prof_flops[t*PROF_MAX_NODES + node] += flops;
+  prof_bytes[t*PROF_MAX_NODES + node] += bytes;
+  return;
+}
+
+static void prof_path(char * const path, const int node) {
+  if(prof_node_parent[node] > -1) {
+    prof_path(path, prof_node_parent[node]);
+    strncat(path, "/", PROF_PATH - strlen(path) - 1);
+  }
+  strncat(path, prof_name_str[prof_node_name[node]], PROF_PATH - strlen(path) - 1);
+  return;
+}
+
+/* depth first ordering of the tree, children in order of creation */
+static int prof_order(int * const order, int n, const int first) {
+  int i, k = 0, list[PROF_MAX_NODES];
+  for(i = first; i > -1; i = prof_node_sibling[i]) list[k++] = i;
+  while(k > 0) {
+    k--;
+    order[n++] = list[k];
+    n = prof_order(order, n, prof_node_child[list[k]]);
+  }
+  return(n);
+}
+
+void prof_report(const int traj) {
+  int i, j, k, n, nrec = 0, nall, nm = 0, order[PROF_MAX_NODES];
+  prof_record_t * rec, * all = NULL, * merged = NULL;
+  double * tmin = NULL, * tmax = NULL, * nranks = NULL;
+  FILE * ofs;
+
+  if(!g_profiling || prof_nthreads == 0) return;
+
+  n = prof_order(order, 0, prof_root);
+  rec = (prof_record_t*)calloc(n > 0 ? n : 1, sizeof(prof_record_t));
+  for(k = 0; k < n; k++) {
+    i = order[k];
+    rec[nrec].path[0] = '\0';
+    prof_path(rec[nrec].path, i);
+    for(j = 0; j < prof_nthreads; j++) {
+      if(prof_time[j*PROF_MAX_NODES + i] > rec[nrec].time) rec[nrec].time = prof_time[j*PROF_MAX_NODES + i];
+      rec[nrec].calls += prof_calls[j*PROF_MAX_NODES + i];
+      rec[nrec].flops += prof_flops[j*PROF_MAX_NODES + i];
+      rec[nrec].bytes += prof_bytes[j*PROF_MAX_NODES + i];
+    }
+    if(rec[nrec].calls > 0.) nrec++;
+  }
+  memset(prof_time, 0, 4*prof_nthreads*PROF_MAX_NODES*sizeof(double));
+
+#ifdef TM_USE_MPI
+  {
+    int * counts = NULL, * displs = NULL, size = nrec*sizeof(prof_record_t);
+    if(g_proc_id == 0) {
+      counts = (int*)malloc(g_nproc*sizeof(int));
+      displs = (int*)malloc(g_nproc*sizeof(int));
+    }
+    MPI_Gather(&size, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if(g_proc_id == 0) {
+      displs[0] = 0;
+      for(i = 1; i < g_nproc; i++) displs[i] = displs[i-1] + counts[i-1];
+      nall = (displs[g_nproc-1] + counts[g_nproc-1])/sizeof(prof_record_t);
+      all = (prof_record_t*)malloc((nall > 0 ? nall : 1)*sizeof(prof_record_t));
+    }
+    MPI_Gatherv(rec, size, MPI_BYTE, all, counts, displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+    free(counts);
+    free(displs);
+  }
+#else
+  all = rec;
+  nall = nrec;
+#endif
+
+  if(g_proc_id == 0) {
+    /* merge by path, regions missing on some ranks are averaged over the others */
+    merged = (prof_record_t*)calloc(nall > 0 ? nall : 1, sizeof(prof_record_t));
+    tmin = (double*)calloc(3*(nall > 0 ? nall : 1), sizeof(double));
+    tmax = tmin + nall;
+    nranks = tmax + nall;
+    for(i = 0; i < nall; i++) {
+      for(j = 0; j < nm && strcmp(merged[j].path, all[i].path) != 0; j++);
+      if(j == nm) {
+        merged[nm] = all[i];
+        tmin[nm] = tmax[nm] = all[i].time;
+        nranks[nm] = 1.;
+        nm++;
+      }
+      else {
+        merged[j].time += all[i].time;
+        merged[j].calls += all[i].calls;
+        merged[j].flops += all[i].flops;
+        merged[j].bytes += all[i].bytes;
+        if(all[i].time < tmin[j]) tmin[j] = all[i].time;
+        if(all[i].time > tmax[j]) tmax[j] = all[i].time;
+        nranks[j] += 1.;
+      }
+    }
+
+    printf("# Profile of trajectory %d (time min/avg/max over ranks)\n", traj);
+    for(j = 0; j < nm; j++) {
+      const char * c = merged[j].path;
+      int depth = 0;
+      for(k = 0; c[k] != '\0'; k++) if(c[k] == '/') depth++;
+      if(depth > 15) depth = 15;
+      printf("# PROF %*s%-*s calls %8.0f time %.3e %.3e %.3e s",
+             2*depth, "", 40-2*depth, strrchr(c, '/') != NULL ? strrchr(c, '/')+1 : c,
+             merged[j].calls, tmin[j], merged[j].time/nranks[j], tmax[j]);
+      if(merged[j].flops > 0.) printf(" %.1f Mflop/s", merged[j].flops/nranks[j]/tmax[j]*1.e-6);
+      if(merged[j].bytes > 0.) printf(" %.1f MB/s", merged[j].bytes/nranks[j]/tmax[j]*1.e-6);
+      printf("\n");
+    }
+    fflush(stdout);
+
+    ofs = fopen("profile.data", "a");
+    if(ofs == NULL) {
+      fprintf(stderr, "Could not open profile.data for writing\n");
+    }
+    else {
+      for(j = 0; j < nm; j++) {
+        fprintf(ofs, "%d %s %.0f %.0f %e %e %e %e %e\n", traj, merged[j].path, nranks[j],
+                merged[j].calls, tmin[j], merged[j].time/nranks[j], tmax[j], merged[j].flops, merged[j].bytes);
+      }
+      fclose(ofs);
+    }
+    free(merged);
+    free(tmin);
+  }
+#ifdef TM_USE_MPI
+  free(all);
+#endif
+  free(rec);
+  return;
+}
@@ -0,0 +1,47 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* lightweight registry of nested timing regions                      */
+/*                                                                    */
+/* prof_begin(name) and prof_end(name, flops, bytes) bracket a region */
+/* and must be called pairwise by the same thread. Regions are kept   */
+/* as a tree, a region started inside another one becomes its child. */
+/* A thread inside an OpenMP parallel region without an open region   */
+/* of its own attaches to the region open on the master thread.       */
+/* Times, calls and the optional flop and byte counts are accumulated */
+/* per thread; prof_report gathers them per rank (maximal time over   */
+/* threads, summed counts) and prints min/avg/max over the ranks,     */
+/* appending one line per region to profile.data. It is collective   */
+/* and resets the counters.                                           */
+/*                                                                    */
+/* All calls return immediately unless g_profiling is set.            */
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+int init_profiler();
+void free_profiler();
+
+void prof_begin(const char * const name);
+void prof_end(const char * const name, const double flops, const double bytes);
+
+void prof_report(const int traj);
+
+#endif
@@ -0,0 +1,350 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Quenched update with heatbath and overrelaxation for the
+ * Wilson plaquette action
+ *
+ * one update consists of HeatbathSweeps heatbath sweeps followed by
+ * OverrelaxationSweeps overrelaxation sweeps, Measurements updates
+ * are performed and the gauge field is stored every Nsave updates
+ *
+ *******************************************************************************/
+#include "lime.h"
+#if HAVE_CONFIG_H
+#include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <signal.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include "global.h"
+#include "git_hash.h"
+#include <io/params.h>
+#include <io/gauge.h>
+#include "getopt.h"
+#include "ranlxd.h"
+#include "geometry_eo.h"
+#include "start.h"
+#include "measure_gauge_action.h"
+#ifdef TM_USE_MPI
+# include "xchange/xchange.h"
+#endif
+#include "read_input.h"
+#include "mpi_init.h"
+#include "sighandler.h"
+#include "init/init.h"
+#include "test/check_geometry.h"
+#include "gettime.h"
+#include "quenched_update.h"
+
+extern int nstore;
+
+int const rlxdsize = 105;
+
+static void usage();
+static void process_args(int argc, char *argv[], char ** input_filename, char ** filename);
+static void set_default_filenames(char ** input_filename, char ** filename);
+
+int main(int argc,char *argv[]) {
+
+  FILE *parameterfile=NULL, *countfile=NULL, *datafile=NULL;
+  char *filename = NULL;
+  char datafilename[206];
+  char parameterfilename[206];
+  char gauge_filename[50];
+  char nstore_filename[50];
+  char tmp_filename[50];
+  char *input_filename = NULL;
+  int status = 0;
+  int j, update_counter=0;
+  double plaquette_energy = 0., atime, etime;
+  paramsXlfInfo *xlfInfo;
+
+#if (defined SSE || defined SSE2 || SSE3)
+  signal(SIGILL,&catch_ill_inst);
+#endif
+
+  strcpy(gauge_filename,"conf.save");
+  strcpy(nstore_filename,".nstore_counter");
+
+  verbose = 1;
+  g_use_clover_flag = 0;
+
+#ifdef TM_USE_MPI
+
+#  ifdef TM_USE_OMP
+  int mpi_thread_provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &mpi_thread_provided);
+#  else
+  MPI_Init(&argc, &argv);
+#  endif
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &g_proc_id);
+#else
+  g_proc_id = 0;
+#endif
+
+  process_args(argc,argv,&input_filename,&filename);
+  set_default_filenames(&input_filename,&filename);
+
+  /* Read the input file */
+  if( (status = read_input(input_filename)) != 0) {
+    fprintf(stderr, "Could not find input file: %s\nAborting...\n", input_filename);
+    exit(-1);
+  }
+
+  if(g_rgi_C1 > 0. || g_rgi_C1 < 0.) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Only the Wilson plaquette gauge action is supported, RectangleCoefficient must be 0\nAborting...\n");
+    }
+    exit(-1);
+  }
+
+#ifdef TM_USE_OMP
+  init_openmp();
+#endif
+
+  tmlqcd_mpi_init(argc, argv);
+
+  if(nstore == -1) {
+    countfile = fopen(nstore_filename, "r");
+    if(countfile != NULL) {
+      j = fscanf(countfile, "%d %d %s\n", &nstore, &update_counter, gauge_input_filename);
+      if(j < 1) nstore = 0;
+      if(j < 2) update_counter = 0;
+      fclose(countfile);
+    }
+    else {
+      nstore = 0;
+      update_counter = 0;
+    }
+  }
+
+#ifdef _GAUGE_COPY
+  status = init_gauge_field(VOLUMEPLUSRAND, 1);
+  status += init_gauge_field_32(VOLUMEPLUSRAND, 1);
+#else
+  status = init_gauge_field(VOLUMEPLUSRAND, 0);
+  status += init_gauge_field_32(VOLUMEPLUSRAND, 0);
+#endif
+  if (status != 0) {
+    fprintf(stderr, "Not enough memory for gauge_fields! Aborting...\n");
+    exit(0);
+  }
+  j = init_geometry_indices(VOLUMEPLUSRAND);
+  if (j != 0) {
+    fprintf(stderr, "Not enough memory for geometry_indices! Aborting...\n");
+    exit(0);
+  }
+
+  /*construct the filenames for the observables and the parameters*/
+  strncpy(datafilename,filename,200);
+  strcat(datafilename,".data");
+  strncpy(parameterfilename,filename,200);
+  strcat(parameterfilename,".para");
+
+  if(g_proc_id == 0){
+    parameterfile = fopen(parameterfilename, "a");
+    write_first_messages(parameterfile, "quenched", git_hash);
+  }
+
+  /* define the geometry */
+  geometry();
+
+  status = check_geometry();
+  if (status != 0) {
+    fprintf(stderr, "Checking of geometry failed. Unable to proceed.\nAborting....\n");
+    exit(1);
+  }
+
+  /* the random numbers of the updates are generated from random_seed */
+  /* and the update counter, ranlux is used for the hot start only    */
+  start_ranlux(rlxd_level, random_seed^update_counter);
+
+  /* Set up the gauge field */
+  /* continue and restart */
+  if(startoption==3 || startoption == 2) {
+    if(g_proc_id == 0) {
+      printf("# Trying to read gauge field from file %s in %s precision.\n",
+            gauge_input_filename, (gauge_precision_read_flag == 32 ? "single" : "double"));
+      fflush(stdout);
+    }
+    if( (status = read_gauge_field(gauge_input_filename,g_gauge_field)) != 0) {
+      fprintf(stderr, "Error %d while reading gauge field from %s\nAborting...\n", status, gauge_input_filename);
+      exit(-2);
+    }
+
+    if (g_proc_id == 0){
+      printf("# Finished reading gauge field.\n");
+      fflush(stdout);
+    }
+  }
+  else if (startoption == 1) {
+    /* hot */
+    random_gauge_field(reproduce_randomnumber_flag, g_gauge_field);
+  }
+  else if(startoption == 0) {
+    /* cold */
+    unit_g_gauge_field();
+  }
+
+#ifdef TM_USE_MPI
+  xchange_gauge(g_gauge_field);
+#endif
+
+  plaquette_energy = measure_plaquette( (const su3**) g_gauge_field);
+  if(g_proc_id == 0) {
+    fprintf(parameterfile, "# beta = %f, heatbath sweeps = %d, overrelaxation sweeps = %d\n", g_beta, Nhb, Nor);
+    fprintf(parameterfile,"# Computed plaquette value: %14.12f.\n", plaquette_energy/(6.*VOLUME*g_nproc));
+    printf("# Computed plaquette value: %14.12f.\n", plaquette_energy/(6.*VOLUME*g_nproc));
+    fclose(parameterfile);
+  }
+
+  /* Loop for measurements */
+  for(j = 0; j < Nmeas; j++) {
+    atime = gettime();
+    quenched_update(g_beta, Nhb, Nor, random_seed, update_counter);
+    etime = gettime();
+
+    plaquette_energy = measure_plaquette( (const su3**) g_gauge_field);
+    if(g_proc_id == 0) {
+      printf("# Update %d: plaquette %14.12f, time %e s\n", update_counter,
+             plaquette_energy/(6.*VOLUME*g_nproc), etime-atime);
+      datafile = fopen(datafilename, "a");
+      fprintf(datafile, "%08d %14.12f %e\n", update_counter,
+              plaquette_energy/(6.*VOLUME*g_nproc), etime-atime);
+      fclose(datafile);
+    }
+
+    /* Save gauge configuration all Nsave times */
+    if((Nsave !=0) && (update_counter%Nsave == 0) && (update_counter!=0)) {
+      sprintf(gauge_filename,"conf.%.4d", nstore);
+      nstore ++;
+    }
+    else {
+      sprintf(gauge_filename,"conf.save");
+    }
+    if(((Nsave !=0) && (update_counter%Nsave == 0) && (update_counter!=0)) || (write_cp_flag == 1) || (j >= (Nmeas - 1))) {
+      sprintf(tmp_filename,".conf.t%05d.tmp",update_counter);
+      if (g_proc_id == 0)
+        fprintf(stdout, "# Writing gauge field to %s.\n", tmp_filename);
+
+      xlfInfo = construct_paramsXlfInfo(plaquette_energy/(6.*VOLUME*g_nproc), update_counter);
+      status = write_gauge_field( tmp_filename, gauge_precision_write_flag, xlfInfo);
+      free(xlfInfo);
+      if (status) {
+        fprintf(stderr, "Error %d while writing gauge field to %s\nAborting...\n", status, tmp_filename);
+        exit(-2);
+      }
+#ifdef TM_USE_MPI
+      MPI_Barrier(MPI_COMM_WORLD);
+#endif
+      if(g_proc_id == 0) {
+        fprintf(stdout, "# Renaming %s to %s.\n", tmp_filename, gauge_filename);
+        if (rename(tmp_filename, gauge_filename) != 0) {
+          fprintf(stderr, "Error while trying to rename temporary file %s to %s. Unable to proceed.\n", tmp_filename, gauge_filename);
+          exit(-2);
+        }
+        countfile = fopen(nstore_filename, "w");
+        fprintf(countfile, "%d %d %s\n", nstore, update_counter+1, gauge_filename);
+        fclose(countfile);
+      }
+    }
+    update_counter++;
+  } /* end of loop over updates */
+
+#ifdef TM_USE_OMP
+  free_omp_accumulators();
+#endif
+  free_gauge_field();
+  free_gauge_field_32();
+  free_geometry_indices();
+  free(input_filename);
+  free(filename);
+#ifdef TM_USE_MPI
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Finalize();
+#endif
+  return(0);
+}
+
+static void usage(){
+  fprintf(stdout, "Quenched heatbath and overrelaxation update\n");
+  fprintf(stdout, "Version %s \n\n", PACKAGE_VERSION);
+  fprintf(stdout, "Please send bug reports to %s\n", PACKAGE_BUGREPORT);
+  fprintf(stdout, "Usage:   quenched [options]\n");
+  fprintf(stdout, "Options: [-f input-filename]  default: quenched.input\n");
+  fprintf(stdout, "         [-o output-filename] default: output\n");
+  fprintf(stdout, "         [-v] more verbosity\n");
+  fprintf(stdout, "         [-V] print version information and exit\n");
+  fprintf(stdout, "         [-h|-? this help]\n");
+  exit(0);
+}
+
+static void process_args(int argc, char *argv[], char ** input_filename, char ** filename) {
+  int c;
+  while ((c = getopt(argc, argv, "h?vVf:o:")) != -1) {
+    switch (c) {
+      case 'f':
+        *input_filename = calloc(200, sizeof(char));
+        strncpy(*input_filename, optarg, 200);
+        break;
+      case 'o':
+        *filename = calloc(200, sizeof(char));
+        strncpy(*filename, optarg, 200);
+        break;
+      case 'v':
+        verbose = 1;
+        break;
+      case 'V':
+        if(g_proc_id == 0) {
+          fprintf(stdout,"%s %s\n",PACKAGE_STRING,git_hash);
+        }
+        exit(0);
+        break;
+      case 'h':
+      case '?':
+      default:
+        if( g_proc_id == 0 ) {
+          usage();
+        }
+        break;
+    }
+  }
+}
+
+static void set_default_filenames(char ** input_filename, char ** filename) {
+  if( *input_filename == NULL ) {
+    *input_filename = calloc(15, sizeof(char));
+    strcpy(*input_filename,"quenched.input");
+  }
+
+  if( *filename == NULL ) {
+    *filename = calloc(7, sizeof(char));
+    strcpy(*filename,"output");
+  }
+}
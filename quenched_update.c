@@ -0,0 +1,262 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+ *
+ * Heatbath and overrelaxation for the Wilson plaquette action
+ *
+ *   S_G = -beta/3 sum_P Re Tr U_P
+ *
+ * For a link U with staple sum v the relevant part of the action is
+ * -beta/3 Re Tr(U v^dagger). U is updated by left multiplication with
+ * elements of the three Cabibbo-Marinari SU(2) subgroups. With w = U v^dagger
+ * and g = g0 + i g.sigma (embedded as in flip_subgroup) Re Tr(g w) = g.r,
+ * r given by eqs. (A.14-A.17) of P. Weisz' notes "A Cabibbo-Marinari SU(3)...".
+ *
+ * heatbath: g = x * r^, x distributed according to
+ *           sqrt(1-x0^2) exp(beta/3 |r| x0) dx0 dOmega
+ *           x0 is generated with the method of Kennedy and Pendleton
+ *           for beta/3 |r| > 2 and the one of Creutz otherwise
+ * overrelaxation: the microcanonical reflection of the old code by
+ *           M. Hasenbusch, S. Sint and S. Capitani
+ *
+ *******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include "global.h"
+#include "su3.h"
+#include "expo.h"
+#include "get_staples.h"
+#include "xchange/xchange.h"
+#include "derived_gauge_fields.h"
+#include "quenched_update.h"
+#include "counter_random.h"
+
+/* x0 with density sqrt(1-x0^2) exp(a x0) on [-1,1] */
+static double qu_x0(const double a, uint64_t * const state) {
+  double x0, r, l2, c;
+
+  if(a < 1.e-10) {
+    /* Haar measure */
+    do {
+      x0 = 2.*cr_random(state) - 1.;
+      r = cr_random(state);
+    } while(r*r > 1. - x0*x0);
+  }
+  else if(a <= 2.) {
+    /* Creutz: exp(a x0) and accept with sqrt(1-x0^2) */
+    const double e = exp(-2.*a);
+    do {
+      x0 = 1. + log(e + (1. - e)*cr_random(state))/a;
+      r = cr_random(state);
+    } while(r*r > 1. - x0*x0);
+  }
+  else {
+    /* Kennedy-Pendleton: x0 = 1 - 2 lambda^2 */
+    do {
+      c = cos(2.*M_PI*cr_random(state));
+      l2 = -(log(cr_random(state)) + c*c*log(cr_random(state)))/(2.*a);
+      r = cr_random(state);
+    } while(r*r > 1. - l2);
+    x0 = 1. - 2.*l2;
+  }
+  return(x0);
+}
+
+/* the 2x2 matrix g0 + i g.sigma in the convention of flip_subgroup */
+#define _qu_su2(m, g)                            \
+  (m)[0][0] = (g)[0] + (g)[3] * I;               \
+  (m)[0][1] = (g)[2] + (g)[1] * I;               \
+  (m)[1][0] = -(g)[2] + (g)[1] * I;              \
+  (m)[1][1] = (g)[0] - (g)[3] * I;
+
+/* r of eqs. (A.14-A.17) for subgroup i of w */
+static inline void qu_project(double * const r, const su3 * const w, const int i) {
+  if(i == 1) {
+    r[0] =  creal(w->c00) + creal(w->c11);
+    r[3] = -cimag(w->c00) + cimag(w->c11);
+    r[1] = -cimag(w->c01) - cimag(w->c10);
+    r[2] = -creal(w->c01) + creal(w->c10);
+  }
+  else if(i == 2) {
+    r[0] =  creal(w->c00) + creal(w->c22);
+    r[3] = -cimag(w->c00) + cimag(w->c22);
+    r[1] = -cimag(w->c02) - cimag(w->c20);
+    r[2] = -creal(w->c02) + creal(w->c20);
+  }
+  else {
+    r[0] =  creal(w->c11) + creal(w->c22);
+    r[3] = -cimag(w->c11) + cimag(w->c22);
+    r[1] = -cimag(w->c12) - cimag(w->c21);
+    r[2] = -creal(w->c12) + creal(w->c21);
+  }
+}
+
+/* *z = m * (*z), m embedded in subgroup i */
+static inline void qu_mul_subgroup(su3 * const z, _Complex double m[2][2], const int i) {
+  su3 ALIGN a, w;
+  _su3_one(a);
+  if(i == 1) {
+    a.c00 = m[0][0]; a.c01 = m[0][1];
+    a.c10 = m[1][0]; a.c11 = m[1][1];
+  }
+  else if(i == 2) {
+    a.c00 = m[0][0]; a.c02 = m[0][1];
+    a.c20 = m[1][0]; a.c22 = m[1][1];
+  }
+  else {
+    a.c11 = m[0][0]; a.c12 = m[0][1];
+    a.c21 = m[1][0]; a.c22 = m[1][1];
+  }
+  _su3_times_su3(w, a, *z);
+  _su3_assign(*z, w);
+}
+
+static void heatbath_link(su3 * const z, const su3 * const v, const double beta, uint64_t * const state) {
+  su3 ALIGN w;
+  double r[4], x[4], k, rho, ct, st, phi;
+  _Complex double mx[2][2], mr[2][2], m[2][2];
+
+  for(int i = 1; i < 4; i++) {
+    _su3_times_su3d(w, *z, *v);
+    qu_project(r, &w, i);
+    k = sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2] + r[3]*r[3]);
+
+    x[0] = qu_x0(beta*k/3., state);
+    rho = sqrt(1. - x[0]*x[0]);
+    ct = 2.*cr_random(state) - 1.;
+    st = sqrt(1. - ct*ct);
+    phi = 2.*M_PI*cr_random(state);
+    x[1] = rho*st*cos(phi);
+    x[2] = rho*st*sin(phi);
+    x[3] = rho*ct;
+
+    if(k < 1.e-15) {
+      /* no preferred direction, g = x */
+      r[0] = 1.; r[1] = 0.; r[2] = 0.; r[3] = 0.;
+    }
+    else {
+      /* r^ = r/|r|, g = x r^ then Re Tr(g w) = |r| x0 */
+      r[0] /= k; r[1] /= k; r[2] /= k; r[3] /= k;
+    }
+    _qu_su2(mx, x);
+    _qu_su2(mr, r);
+    m[0][0] = mx[0][0]*mr[0][0] + mx[0][1]*mr[1][0];
+    m[0][1] = mx[0][0]*mr[0][1] + mx[0][1]*mr[1][1];
+    m[1][0] = mx[1][0]*mr[0][0] + mx[1][1]*mr[1][0];
+    m[1][1] = mx[1][0]*mr[0][1] + mx[1][1]*mr[1][1];
+    qu_mul_subgroup(z, m, i);
+  }
+  restoresu3_in_place(z);
+}
+
+static void overrel_link(su3 * const z, const su3 * const v) {
+  su3 ALIGN w;
+  double r[4], aux;
+  _Complex double m[2][2];
+
+  for(int i = 1; i < 4; i++) {
+    _su3_times_su3d(w, *z, *v);
+    qu_project(r, &w, i);
+    aux = r[0]*r[0] + r[1]*r[1] + r[2]*r[2] + r[3]*r[3];
+    if(aux < 1.e-30) continue;
+    aux = 2.*r[0]/aux;
+    r[1] *= aux;
+    r[2] *= aux;
+    r[3] *= aux;
+    r[0] = aux*r[0] - 1.;
+    _qu_su2(m, r);
+    qu_mul_subgroup(z, m, i);
+  }
+}
+
+static void qu_xchange() {
+#ifdef TM_USE_MPI
+  xchange_gauge(g_gauge_field);
+#endif
+  return;
+}
+
+void heatbath_sweep(const double beta, const unsigned int seed, const unsigned int sweep) {
+  const uint64_t key = cr_mix(cr_mix((uint64_t)seed + 0x9e3779b97f4a7c15ULL) ^ sweep);
+
+  qu_xchange();
+  for(int mu = 0; mu < 4; mu++) {
+    for(int ieo = 0; ieo < 2; ieo++) {
+      const int ioff = (ieo == 0) ? 0 : (VOLUME+RAND)/2;
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+      for(int icx = ioff; icx < VOLUME/2 + ioff; icx++) {
+        const int ix = g_eo2lexic[icx];
+        su3 ALIGN v;
+        uint64_t state = cr_state(key, cr_global_site(ix)*4 + mu);
+        get_staples(&v, ix, mu, (const su3**) g_gauge_field);
+        heatbath_link(&g_gauge_field[ix][mu], &v, beta, &state);
+      }
+      qu_xchange();
+    }
+  }
+  gauge_field_changed();
+  return;
+}
+
+void overrel_sweep() {
+  qu_xchange();
+  for(int mu = 0; mu < 4; mu++) {
+    for(int ieo = 0; ieo < 2; ieo++) {
+      const int ioff = (ieo == 0) ? 0 : (VOLUME+RAND)/2;
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+      for(int icx = ioff; icx < VOLUME/2 + ioff; icx++) {
+        const int ix = g_eo2lexic[icx];
+        su3 ALIGN v;
+        get_staples(&v, ix, mu, (const su3**) g_gauge_field);
+        overrel_link(&g_gauge_field[ix][mu], &v);
+      }
+      qu_xchange();
+    }
+  }
+  gauge_field_changed();
+  return;
+}
+
+void quenched_update(const double beta, const int nhb, const int nor,
+                     const unsigned int seed, const unsigned int update) {
+  for(int i = 0; i < nhb; i++) {
+    heatbath_sweep(beta, seed, update*nhb + i);
+  }
+  for(int i = 0; i < nor; i++) {
+    overrel_sweep();
+  }
+  return;
+}
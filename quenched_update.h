@@ -0,0 +1,44 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* quenched update of g_gauge_field for the Wilson plaquette action   */
+/*                                                                    */
+/* Cabibbo-Marinari heatbath (Kennedy-Pendleton, Creutz for small     */
+/* couplings) and overrelaxation in the three SU(2) subgroups. The    */
+/* links of one direction and one parity are independent and are      */
+/* updated in parallel over sites and MPI processes, the boundaries    */
+/* are exchanged after each of the eight checkerboard steps.           */
+/*                                                                    */
+/* the random numbers of a link depend only on seed, the sweep number */
+/* and the global position of the link, such that the result does not */
+/* depend on the number of threads or the MPI decomposition and a run */
+/* is continued with the sweep counter only                           */
+
+#ifndef _QUENCHED_UPDATE_H
+#define _QUENCHED_UPDATE_H
+
+void heatbath_sweep(const double beta, const unsigned int seed, const unsigned int sweep);
+void overrel_sweep();
+/* nhb heatbath sweeps followed by nor overrelaxation sweeps, */
+/* update counts the calls and selects the random numbers     */
+void quenched_update(const double beta, const int nhb, const int nor,
+                     const unsigned int seed, const unsigned int update);
+
+#endif
@@ -24,6 +24,7 @@ extern "C"
 
   void ranlxs(float r[],int n);
   void rlxs_init(int level,int seed);
+  int rlxs_size(void);
   void rlxs_get(int state[]);
   void rlxs_reset(int state[]);
   void fabhaan_vect();
@@ -98,6 +98,45 @@ int init_rational(rational_t * rat, const unsigned int scale) {
 }
 
 
+// re-init the rational approximation with the smallest order n <= max_order
+// reaching max deviation delta in the range rat->range[0,1]
+// (with a warning max_order if delta cannot be reached)
+// all coefficients are used (crange = [0:n-1])
+// returns the return value of init_rational
+
+int fit_rational(rational_t * rat, const double delta, const int max_order, const unsigned int scale) {
+  double * ars = malloc(2*max_order*sizeof(double));
+  double A, d = 1.;
+  double a = rat->range[0], b = rat->range[1];
+  int order;
+
+  if(max_order < 1 || b <= a || a <= 0) {
+    fprintf(stderr, "parameters to fit_rational out of range\n");
+    fprintf(stderr, "max_order = %d, a = %e, b = %e\n", max_order, a, b);
+    free(ars);
+    return(-1);
+  }
+  for(order = 1; order <= max_order; order++) {
+    zolotarev(order, a/b, &A, ars, &d);
+    if(d <= delta) break;
+  }
+  free(ars);
+  if(order > max_order) {
+    order = max_order;
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Warning: delta = %e not reached on [%e, %e] with order %d, using delta = %e\n",
+              delta, a, b, max_order, d);
+    }
+  }
+  if(rat->mu != NULL) {
+    free_rational(rat);
+  }
+  rat->order = order;
+  rat->crange[0] = 0;
+  rat->crange[1] = order-1;
+  return(init_rational(rat, scale));
+}
+
 int free_rational(rational_t * rat) {
   free(rat->mu);
   free(rat->nu);
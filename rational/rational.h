@@ -32,6 +32,7 @@ typedef struct {
 } rational_t;
 
 int init_rational(rational_t * rat, const unsigned int scale);
+int fit_rational(rational_t * rat, const double delta, const int max_order, const unsigned int scale);
 int free_rational(rational_t * rat);
 
 #endif
@@ -45,6 +45,7 @@ extern "C"
   extern int verbose;
   extern int startoption;
   extern int Ntherm;
+  extern int Nhb, Nor, Nquenched;
   extern int Nmeas;
   extern int Nsave;
   extern int gmres_m_parameter, gmresdr_nr_ev;
@@ -90,6 +91,7 @@ extern "C"
   extern int online_measurement_freq;
   extern int reweighting_flag;
   extern int reweighting_samples; 
+  extern int reweighting_batch_size;
   extern int no_samples;
   extern int compute_modenumber;
   extern int compute_topsus;
@@ -27,15 +27,279 @@
 #include "global.h"
 #include "linalg_eo.h"
 #include "start.h"
+#include "gettime.h"
 #include "fatal_error.h"
+#include "read_input.h"
+#include "boundary.h"
 #include "monomial/monomial.h"
 #include "hamiltonian_field.h"
+#include "operator/Hopping_Matrix.h"
 #include "operator/clovertm_operators.h"
 #include "operator/clover_leaf.h"
+#include "solver/solver.h"
+#include "solver/solver_field.h"
+#include "solver/monomial_solve.h"
+#include "solver/lu_solve.h"
 #include "reweighting_factor.h"
+#include "derived_gauge_fields.h"
 
-void reweighting_factor(const int N, const int nstore) {
+/* the trlog parts depend only on the gauge field and the parameters */
+/* of a monomial, they are kept for the current gauge field           */
+typedef struct {
+  unsigned int version;
+  double kappa, kappa2, mu, mu2, mubar, mubar2, epsbar, epsbar2, c_sw;
+  double trlog;
+} trlog_cache_t;
+
+static trlog_cache_t * trlog_cache = NULL;
+static int trlog_cache_size = 0;
+
+static double get_trlog(const int j, hamiltonian_field_t * const hf) {
+  monomial * mnl = &monomial_list[j];
+  trlog_cache_t * c;
+  double c_sw = mnl->c_sw;
+  if(c_sw < 0.) c_sw = 0.;
+
+  if(trlog_cache_size < no_monomials) {
+    trlog_cache = (trlog_cache_t*)realloc(trlog_cache, no_monomials*sizeof(trlog_cache_t));
+    for(int i = trlog_cache_size; i < no_monomials; i++) {
+      trlog_cache[i].version = GAUGE_VERSION_NONE;
+    }
+    trlog_cache_size = no_monomials;
+  }
+  c = &trlog_cache[j];
+  if(c->version == g_gauge_version && c->kappa == mnl->kappa && c->kappa2 == mnl->kappa2 &&
+     c->mu == mnl->mu && c->mu2 == mnl->mu2 && c->mubar == mnl->mubar && c->mubar2 == mnl->mubar2 &&
+     c->epsbar == mnl->epsbar && c->epsbar2 == mnl->epsbar2 && c->c_sw == c_sw) {
+    return(c->trlog);
+  }
+
+  init_sw_fields();
+  sw_term( (const su3**) hf->gaugefield, mnl->kappa, c_sw); 
+  if(mnl->type != NDDETRATIO) {
+    c->trlog = -sw_trace(0, mnl->mu);
+  }
+  else {
+    c->trlog = -sw_trace_nd(0, mnl->mubar, mnl->epsbar);
+  }
+  
+  sw_term( (const su3**) hf->gaugefield, mnl->kappa2, c_sw);
+  if(mnl->type != NDDETRATIO) {
+    c->trlog -= -sw_trace(0, mnl->mu2);
+  }
+  else {
+    c->trlog -= -sw_trace_nd(0, mnl->mubar2, mnl->epsbar2);
+  }
+  c->version = g_gauge_version;
+  c->kappa = mnl->kappa;
+  c->kappa2 = mnl->kappa2;
+  c->mu = mnl->mu;
+  c->mu2 = mnl->mu2;
+  c->mubar = mnl->mubar;
+  c->mubar2 = mnl->mubar2;
+  c->epsbar = mnl->epsbar;
+  c->epsbar2 = mnl->epsbar2;
+  c->c_sw = c_sw;
+  return(c->trlog);
+}
+
+/* degenerate even/odd ratios are computed for all samples at once */
+static int is_batched(const monomial * const mnl) {
+  return(mnl->even_odd_flag && (mnl->type == DETRATIO || mnl->type == CLOVERDETRATIO ||
+                                mnl->type == CLOVERDETRATIORW));
+}
+
+/* operator parameters of the numerator (ieo = 0) and denominator (ieo = 1) */
+/* as used in the corresponding acc functions                               */
+static void set_parameters(const monomial * const mnl, const int ieo, 
+                           hamiltonian_field_t * const hf) {
+  double kappa = mnl->kappa, mu = mnl->mu;
+  g_mu3 = 0.;
+  if(mnl->type == CLOVERDETRATIO) {
+    g_mu3 = (ieo == 0) ? mnl->rho2 : mnl->rho;
+  }
+  else if(ieo == 0) {
+    kappa = mnl->kappa2;
+    mu = mnl->mu2;
+  }
+  g_mu = mu;
+  boundary(kappa);
+  if(mnl->type != DETRATIO) {
+    sw_term( (const su3**) hf->gaugefield, kappa, mnl->c_sw);
+    sw_invert(EE, mu);
+  }
+  return;
+}
+
+/* the solutions of the previous samples span (mostly) the low modes of */
+/* Qsq, they are kept orthonormal together with G = V^dagger Qsq V and  */
+/* the projected solution is used as starting point for the next sample */
+typedef struct {
+  int n, nmax;
+  spinor ** v;
+  _Complex double * G, * LU, * y;
+} lowmode_space_t;
+
+static void lowmode_guess(spinor * const x, spinor * const b, lowmode_space_t * const lm, const int N) {
+  if(lm->n == 0) {
+    zero_spinor_field(x, N);
+    return;
+  }
+  for(int i = 0; i < lm->n; i++) {
+    lm->y[i] = scalar_prod(lm->v[i], b, N, 1);
+    for(int k = 0; k < lm->n; k++) {
+      lm->LU[i*lm->nmax + k] = lm->G[i*lm->nmax + k];
+    }
+  }
+  LUSolve(lm->n, lm->LU, lm->nmax, lm->y);
+  mul(x, lm->y[0], lm->v[0], N);
+  for(int i = 1; i < lm->n; i++) {
+    assign_add_mul(x, lm->v[i], lm->y[i], N);
+  }
+  return;
+}
+
+static void lowmode_add(spinor * const x, spinor * const tmp, lowmode_space_t * const lm, 
+                        const int N, matrix_mult f) {
+  _Complex double s;
+  double norm;
+  int n = lm->n;
+  if(n == lm->nmax) return;
+
+  assign(lm->v[n], x, N);
+  /* Gram-Schmidt twice for stability */
+  for(int iter = 0; iter < 2; iter++) {
+    for(int i = 0; i < n; i++) {
+      s = scalar_prod(lm->v[i], lm->v[n], N, 1);
+      assign_diff_mul(lm->v[n], lm->v[i], s, N);
+    }
+  }
+  norm = sqrt(square_norm(lm->v[n], N, 1));
+  if(norm < 1.e-12 * sqrt(square_norm(x, N, 1))) return;
+  mul_r(lm->v[n], 1./norm, lm->v[n], N);
+  f(tmp, lm->v[n]);
+  for(int i = 0; i <= n; i++) {
+    lm->G[i*lm->nmax + n] = scalar_prod(lm->v[i], tmp, N, 1);
+    lm->G[n*lm->nmax + i] = conj(lm->G[i*lm->nmax + n]);
+  }
+  lm->n++;
+  return;
+}
+
+static void batched_samples(const int j, const int N, double * const data, 
+                            hamiltonian_field_t * const hf) {
+  monomial * mnl = &monomial_list[j];
+  const int n = VOLUME/2;
+  const int nb = (reweighting_batch_size > 0 && reweighting_batch_size < N) ? reweighting_batch_size : N;
+  int save_sloppy = g_sloppy_precision_flag;
+  spinor ** rhs = NULL, ** work = NULL, ** vlow = NULL;
+  double * energy0 = (double*)malloc(nb*sizeof(double));
+  double atime, etime, eps_sq;
+  lowmode_space_t lm;
+
+  init_solver_field(&rhs, VOLUMEPLUSRAND/2, nb);
+  init_solver_field(&work, VOLUMEPLUSRAND/2, 3);
+  init_solver_field(&vlow, VOLUMEPLUSRAND/2, nb);
+  lm.n = 0;
+  lm.nmax = nb;
+  lm.v = vlow;
+  lm.G = (_Complex double*)malloc(nb*nb*sizeof(_Complex double));
+  lm.LU = (_Complex double*)malloc(nb*nb*sizeof(_Complex double));
+  lm.y = (_Complex double*)malloc(nb*sizeof(_Complex double));
+
+  update_gauge_fields_for_monomial(j);
+  if(mnl->type != DETRATIO) {
+    init_sw_fields();
+  }
+
+  for(int i0 = 0; i0 < N; i0 += nb) {
+    const int m = (N - i0 < nb) ? N - i0 : nb;
+    atime = gettime();
+
+    /* numerator applied to all samples of the batch */
+    set_parameters(mnl, 0, hf);
+    for(int s = 0; s < m; s++) {
+      random_spinor_field_eo(mnl->pf, mnl->rngrepro, RN_GAUSS);
+      energy0[s] = square_norm(mnl->pf, n, 1);
+      mnl->Qp(rhs[s], mnl->pf);
+    }
+
+    /* and the denominator solved for all of them, the error of the */
+    /* guess from the low mode space is solved for with zero guess  */
+    set_parameters(mnl, 1, hf);
+    g_sloppy_precision_flag = 0;
+    for(int s = 0; s < m; s++) {
+      eps_sq = mnl->accprec;
+      if(g_relative_precision_flag) {
+        eps_sq *= square_norm(rhs[s], n, 1);
+      }
+      lowmode_guess(work[0], rhs[s], &lm, n);
+      mnl->Qsq(work[1], work[0]);
+      diff(work[1], rhs[s], work[1], n);
+      zero_spinor_field(work[2], n);
+      mnl->iter0 += solve_degenerate(work[2], work[1], mnl->solver_params, mnl->maxiter, eps_sq,
+                                     0, n, mnl->Qsq, mnl->solver);
+      add(work[0], work[0], work[2], n);
+      lowmode_add(work[0], work[1], &lm, n, mnl->Qsq);
+      mnl->Qm(work[0], work[0]);
+      mnl->energy0 = energy0[s];
+      mnl->energy1 = square_norm(work[0], n, 1);
+      data[(i0 + s)*no_monomials + j] = mnl->energy1 - mnl->energy0;
+      if(g_proc_id == 0 && g_debug_level > 0) {
+        printf("# monomial[%d] %s, stochastic part: w_%d=%e exp(w_%d)=%e\n", j, mnl->name, j, 
+               data[(i0 + s)*no_monomials + j], j, exp(data[(i0 + s)*no_monomials + j]));
+      }
+    }
+    g_sloppy_precision_flag = save_sloppy;
+    etime = gettime();
+    if(g_proc_id == 0 && g_debug_level > 1) {
+      printf("# Time for %d samples of monomial %s: %e s, %d low modes\n", m, mnl->name, etime-atime, lm.n);
+    }
+  }
+
+  g_mu = g_mu1;
+  g_mu3 = 0.;
+  boundary(g_kappa);
+  finalize_solver(rhs, nb);
+  finalize_solver(work, 3);
+  finalize_solver(vlow, nb);
+  free(lm.G);
+  free(lm.LU);
+  free(lm.y);
+  free(energy0);
+  return;
+}
+
+static double single_sample(const int j, hamiltonian_field_t * const hf) {
+  monomial * mnl = &monomial_list[j];
   int n = VOLUME;
+
+  if(mnl->even_odd_flag) {
+    random_spinor_field_eo(mnl->pf, mnl->rngrepro, RN_GAUSS);
+    mnl->energy0 = square_norm(mnl->pf, n/2, 1);
+  }
+  else {
+    random_spinor_field_lexic(mnl->pf, mnl->rngrepro, RN_GAUSS);
+    mnl->energy0 = square_norm(mnl->pf, n, 1);
+  }
+  if(mnl->type == NDDETRATIO) {
+    if(mnl->even_odd_flag) {
+      random_spinor_field_eo(mnl->pf2, mnl->rngrepro, RN_GAUSS);
+      mnl->energy0 += square_norm(mnl->pf2, n/2, 1);
+    }
+    else {
+      random_spinor_field_lexic(mnl->pf2, mnl->rngrepro, RN_GAUSS);
+      mnl->energy0 += square_norm(mnl->pf2, n, 1);
+    }
+  }
+  if(g_proc_id == 0 && g_debug_level > 1) {
+    printf("# monomial[%d] %s, energy0 = %e\n", j, mnl->name, mnl->energy0);
+  }
+  update_gauge_fields_for_monomial(j);
+  return(mnl->accfunction(j, hf));
+}
+
+void reweighting_factor(const int N, const int nstore) {
   monomial * mnl;
   FILE * ofs;
   hamiltonian_field_t hf;
@@ -53,25 +317,7 @@ void reweighting_factor(const int N, const int nstore) {
   for(int j = 0; j < no_monomials; j++) {
     mnl = &monomial_list[j];
     if(mnl->even_odd_flag) {
-      init_sw_fields();
-      double c_sw = mnl->c_sw;
-      if(c_sw < 0.) c_sw = 0.;
-
-      sw_term( (const su3**) hf.gaugefield, mnl->kappa, c_sw); 
-      if(mnl->type != NDDETRATIO) {
-        trlog[j] = -sw_trace(0, mnl->mu);
-      }
-      else {
-        trlog[j] = -sw_trace_nd(0, mnl->mubar, mnl->epsbar);
-      }
-        
-      sw_term( (const su3**) hf.gaugefield, mnl->kappa2, c_sw);
-      if(mnl->type != NDDETRATIO) {
-        trlog[j] -= -sw_trace(0, mnl->mu2);
-      }
-      else {
-        trlog[j] -= -sw_trace_nd(0, mnl->mubar2, mnl->epsbar2);
-      }
+      trlog[j] = get_trlog(j, &hf);
     }
     else {
       trlog[j] = 0.;
@@ -81,45 +327,24 @@ void reweighting_factor(const int N, const int nstore) {
     }
   }
 
-  for(int i = 0; i < N; i++) {
+  // the samples are generated monomial by monomial, such that the 
+  // operators are set up once per monomial and batch
+  for(int j = 0; j < no_monomials; j++) {
+    mnl = &monomial_list[j];
+    if(mnl->type == GAUGE) continue;
     if(g_proc_id == 0 && g_debug_level > 0) {
-      printf("# computing reweighting factors for sample %d\n", i);
-    }
-    for(int j = 0; j < no_monomials; j++) {
-      mnl = &monomial_list[j];
-      if(mnl->type != GAUGE) {
-	if(mnl->even_odd_flag) {
-	  random_spinor_field_eo(mnl->pf, mnl->rngrepro, RN_GAUSS);
-          mnl->energy0 = square_norm(mnl->pf, n/2, 1);
-	}
-	else {
-          random_spinor_field_lexic(mnl->pf, mnl->rngrepro, RN_GAUSS);
-          mnl->energy0 = square_norm(mnl->pf, n, 1);
-        }
-	if(g_proc_id == 0 && g_debug_level > 1) {
-	  printf("# monomial[%d] %s, energy0 = %e\n", j, mnl->name, mnl->energy0);
-	}
-	if(mnl->type == NDDETRATIO) {
-	  if(mnl->even_odd_flag) {
-	    random_spinor_field_eo(mnl->pf2, mnl->rngrepro, RN_GAUSS);
-            mnl->energy0 += square_norm(mnl->pf, n/2, 1);
-	  }
-	  else {
-            random_spinor_field_lexic(mnl->pf, mnl->rngrepro, RN_GAUSS);
-            mnl->energy0 += square_norm(mnl->pf2, n, 1);
-          }
-	}
-      }
+      printf("# computing reweighting factors for monomial %d\n", j);
     }
-
-    for(int j = 0; j < no_monomials; j++) {
-      mnl = &monomial_list[j];
-      if(mnl->type != GAUGE) {
-	double y = mnl->accfunction(j, &hf);
-	data[i*no_monomials + j] = y;
-	if(g_proc_id == 0 && g_debug_level > 0) {
-	  printf("# monomial[%d] %s, stochastic part: w_%d=%e exp(w_%d)=%e\n", j, mnl->name, j, j, y, exp(y));
-	}
+    if(is_batched(mnl)) {
+      batched_samples(j, N, data, &hf);
+    }
+    else {
+      for(int i = 0; i < N; i++) {
+        double y = single_sample(j, &hf);
+        data[i*no_monomials + j] = y;
+        if(g_proc_id == 0 && g_debug_level > 0) {
+          printf("# monomial[%d] %s, stochastic part: w_%d=%e exp(w_%d)=%e\n", j, mnl->name, j, y, j, exp(y));
+        }
       }
     }
   }
@@ -12,15 +12,20 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "sse.h"
 #include "su3.h"
 #include "su3adj.h"
 #include "global.h"
 #include "geometry_eo.h"
+#include "sf_utils.h"
 #include "sf_calc_action.h"
 
-int Index(const int x0, const int x1, const int x2, const int x3);
-
 /**************************************************************************************************/
 
 /* the next function imposes Dirichlet b.c.
@@ -30,9 +35,12 @@ void dirichlet_boundary_conditions(int t) {
   
   int ix;
   
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
   for (ix=0;ix<VOLUME;ix++){
  
-    if (g_t[ix] == t) {
+    if (g_coord[ix][0] == t) {
 
       _su3_zero(g_gauge_field[ix][0]);
 
@@ -47,9 +55,12 @@ void dirichlet_boundary_conditions_spatial_links_to_one(int t) {
   
   int ix;
   
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
   for (ix=0;ix<VOLUME;ix++){
  
-    if (g_t[ix] == 0 || g_t[ix] == t) {
+    if (g_coord[ix][0] == 0 || g_coord[ix][0] == t) {
 
       _su3_one(g_gauge_field[ix][1]);
       _su3_one(g_gauge_field[ix][2]);
@@ -65,6 +76,9 @@ void set_all_links_to_one() {
   
   int ix;
   
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
   for (ix=0;ix<VOLUME;ix++){
  
       _su3_one(g_gauge_field[ix][0]);
@@ -80,9 +94,12 @@ void set_all_links_to_one_with_dirichlet(int t) {
   
   int ix;
   
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
   for (ix=0;ix<VOLUME;ix++){
     
-    if (g_t[ix] == t) {
+    if (g_coord[ix][0] == t) {
       
       _su3_zero(g_gauge_field[ix][0]);
       _su3_one(g_gauge_field[ix][1]);
@@ -169,9 +186,12 @@ void sf_boundary_conditions_spatially_constant_abelian_field(int t, double eta)
   phi2_T /= (double)LX; 
   phi3_T /= (double)LX; 
 
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
   for (ix=0;ix<VOLUME;ix++){
     
-    if (g_t[ix] == 0) {
+    if (g_coord[ix][0] == 0) {
       
       _su3_spatially_constant_abelian_field(g_gauge_field[ix][1], phi1_0, phi2_0, phi3_0);
       _su3_spatially_constant_abelian_field(g_gauge_field[ix][2], phi1_0, phi2_0, phi3_0);
@@ -180,7 +200,7 @@ void sf_boundary_conditions_spatially_constant_abelian_field(int t, double eta)
     } 
 
     
-    if (g_t[ix] == t) {
+    if (g_coord[ix][0] == t) {
   
       _su3_spatially_constant_abelian_field(g_gauge_field[ix][1], phi1_T, phi2_T, phi3_T);
       _su3_spatially_constant_abelian_field(g_gauge_field[ix][2], phi1_T, phi2_T, phi3_T);
@@ -197,106 +217,54 @@ void sf_boundary_conditions_spatially_constant_abelian_field(int t, double eta)
 
 /*** MEASUREMENTS ***/
 
-/* it calculates the plaquette (see notes for notation) for PBC */
-double measure_plaquette() {
-
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
+/* all measurements below are weighted sums over the per-timeslice        */
+/* plaquette and rectangle sums of sf_plaquette_slices and                */
+/* sf_rectangle_slices (sf_utils.c), which are threaded and summed over   */
+/* all processes; the weights are tables with one entry per global        */
+/* timeslice x0 of the corner of the loop, ss for space-space and st for  */
+/* space-time plaquettes, tss (tts) for rectangles with one (two) steps   */
+/* in time direction                                                      */
+
+/* weight table with one entry per global timeslice, all set to w */
+static double * weight_table(const double w) {
+  const int nt = g_nproc_t*T;
+  double * tab = (double*)malloc(nt*sizeof(double));
+  for(int x0 = 0; x0 < nt; x0++) {
+    tab[x0] = w;
+  }
+  return(tab);
+}
 
-  for (ix=0;ix<VOLUME;ix++){
-    
-    for (mu1=0;mu1<3;mu1++){
-      
-      ix1=g_iup[ix][mu1];
-      
-      for (mu2=mu1+1;mu2<4;mu2++){ 
-	
-	ix2=g_iup[ix][mu2];
-	
-	v=&g_gauge_field[ix][mu1];
-	w=&g_gauge_field[ix1][mu2];
-	
-	_su3_times_su3(pr1,*v,*w);
-	
-	
-	v=&g_gauge_field[ix][mu2];
-	w=&g_gauge_field[ix2][mu1];
-	
-	_su3_times_su3(pr2,*v,*w);
-	
-	
-	_trace_su3_times_su3d(ac,pr1,pr2);
-	
-	sum += ac;
-	
-      }
-    }
-    
+/* weight of the timeslice x0 if it lies on the lattice */
+static void set_weight(double * const tab, const int x0, const double w) {
+  if(x0 >= 0 && x0 < g_nproc_t*T) {
+    tab[x0] = w;
   }
-  
-  ga = sum*2.0;
+}
 
-  return ga;
-  
+static double weighted_plaquette(double * wss, double * wst) {
+  double ga = sf_weighted_plaquette(wss, wst);
+  free(wss);
+  free(wst);
+  return(ga*2.0);
 }
 
+/* it calculates the plaquette (see notes for notation) for PBC */
+double sf_measure_plaquette() {
 
-/* it calculates the rectangle (see notes for notation) for PBC */
-double measure_rectangle() {
+  return(weighted_plaquette(weight_table(1.), weight_table(1.)));
+  
+}
 
-  int ix,ix1,ix2,mu1,mu2;
-  int ix12,ix22;                           /* My changes */
-  static su3 pr_r1,pr_r2,pr_r11,pr_r22;    /* My changes */
-  static double ga,ac; 
-  su3 *v_r1,*w_r1,*z_r1;                   /* My changes */
-  su3 *v_r2,*w_r2,*z_r2;                   /* My changes */
-  double sum = 0;                          /* My changes */
 
+/* it calculates the rectangle (see notes for notation) for PBC */
+double sf_measure_rectangle() {
 
-  for (ix=0;ix<VOLUME;ix++){
-    
-    for (mu1=0;mu1<4;mu1++){
-      
-      ix1 = g_iup[ix][mu1];
-      
-      for (mu2=0;mu2<4;mu2++){
-	if( mu1 != mu2 ){
-	  
-	  ix2  = g_iup[ix][mu2];
-	  ix12 = g_iup[ix1][mu2];
-	  ix22 = g_iup[ix2][mu2];
-	  
-	  
-	  v_r1 = &g_gauge_field[ix][mu1];
-	  w_r1 = &g_gauge_field[ix1][mu2];
-	  z_r1 = &g_gauge_field[ix12][mu2];
-	  
-	  _su3_times_su3(pr_r1,*v_r1,*w_r1);
-	  _su3_times_su3(pr_r11,pr_r1,*z_r1);
-	  
-	  
-	  v_r2 = &g_gauge_field[ix][mu2];
-	  w_r2 = &g_gauge_field[ix2][mu2];
-	  z_r2 = &g_gauge_field[ix22][mu1];
-	  
-	  _su3_times_su3(pr_r2,*v_r2,*w_r2);
-	  _su3_times_su3(pr_r22,pr_r2,*z_r2);
-	  
-	  
-	  _trace_su3_times_su3d(ac,pr_r11,pr_r22);
-	  
-	  sum += ac;
-	}
-      }
-    }
-  }
-  
-  ga = sum*2.0;
+  double * w = weight_table(1.);
+  double ga = sf_weighted_rectangle(w, w, w);
+  free(w);
 
-  return ga;
+  return(ga*2.0);
 
 }
 
@@ -306,71 +274,13 @@ double measure_rectangle() {
 /* "hard-coded": boundaries and bulk defined in the same function */
 double measure_plaquette_sf_weights(int t) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
+  double * wss = weight_table(1.), * wst = weight_table(1.);
 
-  for (ix=0;ix<VOLUME;ix++){
-    
-    for (mu1=0;mu1<3;mu1++){
-      
-      ix1=g_iup[ix][mu1];
-      
-      for (mu2=mu1+1;mu2<4;mu2++){ 
-	
-	ix2=g_iup[ix][mu2];
-	
-	v=&g_gauge_field[ix][mu1];
-	w=&g_gauge_field[ix1][mu2];
-	
-	_su3_times_su3(pr1,*v,*w);
-	
-	
-	v=&g_gauge_field[ix][mu2];
-	w=&g_gauge_field[ix2][mu1];
-	
-	_su3_times_su3(pr2,*v,*w);
-	
-	
-	_trace_su3_times_su3d(ac,pr1,pr2);
-
-	if (g_t[ix] == 0) {
-	  
-	  if (mu1 != 0 && mu2 != 0) {
-	    
-	    ac *= 0.5;
-	    
-	  }
-	  
-	} 
-	
-	
-	if (g_t[ix] == t) {
-	  
-	  if (mu1 != 0 && mu2 != 0) {
-	    
-	    ac *= 0.5;
-	    
-	  }	  
-	  if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	    
-	    ac = 0.;
-	    
-	  }	  
-	} 
-	
-	sum += ac;
-	
-      }
-    }
-    
-  }
-  
-  ga = sum*2.0;
+  set_weight(wss, 0, 0.5);
+  set_weight(wss, t, 0.5);
+  set_weight(wst, t, 0.);
 
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
@@ -379,89 +289,15 @@ double measure_plaquette_sf_weights(int t) {
 /* "hard-coded": boundaries and bulk defined in the same function */
 double measure_plaquette_sf_weights_improvement(int t, double cs, double ct) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
-
-
-  for (ix=0;ix<VOLUME;ix++){
-    
-    for (mu1=0;mu1<3;mu1++){
-      
-      ix1=g_iup[ix][mu1];
-      
-      for (mu2=mu1+1;mu2<4;mu2++){ 
-	
-	ix2=g_iup[ix][mu2];
-	
-	v=&g_gauge_field[ix][mu1];
-	w=&g_gauge_field[ix1][mu2];
-	
-	_su3_times_su3(pr1,*v,*w);
-	
-	
-	v=&g_gauge_field[ix][mu2];
-	w=&g_gauge_field[ix2][mu1];
-	
-	_su3_times_su3(pr2,*v,*w);
-	
-	
-	_trace_su3_times_su3d(ac,pr1,pr2);
-
-	if (g_t[ix] == 0) {
-	  
-	  if (mu1 != 0 && mu2 != 0) {
-
-	    ac *= cs;
-
-	  }
-
-	  if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-
-	    ac *= ct;
-
-	  }
-	
-	} 
-	
-	
-	if (g_t[ix] == t) {
-
-	  if (mu1 != 0 && mu2 != 0) {
-	    
-	    ac *= cs;
-	    
-	  }
-	  if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	    
-	  ac = 0.;
-	    
-	  }
+  double * wss = weight_table(1.), * wst = weight_table(1.);
 
-	}
+  set_weight(wss, 0, cs);
+  set_weight(wst, 0, ct);
+  set_weight(wst, t-1, ct);
+  set_weight(wss, t, cs);
+  set_weight(wst, t, 0.);
 
-	if (g_t[ix] == (t-1)) {
-	  
-	  if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	    
-	    ac *= ct;
-	    
-	  }	  
-	  
-	} 
-	
-	sum += ac;
-	
-      }
-    }
-    
-  }
-  
-  ga = sum*2.0;
-
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
@@ -474,192 +310,37 @@ the plaquette for SF b.c. withOUT the improvement coefficients */
 /* (1) bulk: */
 double measure_plaquette_sf_weights_bulk(int t) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
-
-  int x0, x1, x2, x3;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
-  for (x0 = 1 ; x0 < t ; x0++) {
-    
-    for (x1 = 0 ; x1 < LX ; x1++) {
-      
-      for (x2 = 0 ; x2 < LY ; x2++) {
-	
-	for (x3 = 0 ; x3 < LZ ; x3++) {
-	  
-	  ix = Index(x0, x1, x2, x3);
-	  
-	  for (mu1=0;mu1<3;mu1++) {
-	    
-	    ix1=g_iup[ix][mu1];
-	    
-	    for (mu2=mu1+1;mu2<4;mu2++) { 
-	      
-	      ix2=g_iup[ix][mu2];
-	      
-	      v=&g_gauge_field[ix][mu1];
-	      w=&g_gauge_field[ix1][mu2];
-	      
-	      _su3_times_su3(pr1,*v,*w);
-	      
-	      
-	      v=&g_gauge_field[ix][mu2];
-	      w=&g_gauge_field[ix2][mu1];
-	      
-	      _su3_times_su3(pr2,*v,*w);
-	      
-	      
-	      _trace_su3_times_su3d(ac,pr1,pr2);
-	      
-	      sum += ac;
-	      
-	    }
-	  }	      
-	  
-	}
-      }
-    }
+  for(int x0 = 1; x0 < t; x0++) {
+    set_weight(wss, x0, 1.);
+    set_weight(wst, x0, 1.);
   }
-  
-  ga = sum*2.0;
-  
-  return ga;
+
+  return(weighted_plaquette(wss, wst));
   
 }
 
 /* (2) boundary at 0 */
 double measure_plaquette_sf_weights_boundary_0 () {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
-  int x0, x1, x2, x3;
+  set_weight(wss, 0, 0.5);
+  set_weight(wst, 0, 1.);
 
-  x0 = 0;
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=0;mu1<3;mu1++) {
-	  
-	  ix1=g_iup[ix][mu1];
-	  
-	  for (mu2=mu1+1;mu2<4;mu2++) { 
-	    
-	    ix2=g_iup[ix][mu2];
-	    
-	    v=&g_gauge_field[ix][mu1];
-	    w=&g_gauge_field[ix1][mu2];
-	    
-	    _su3_times_su3(pr1,*v,*w);
-	    
-	    
-	    v=&g_gauge_field[ix][mu2];
-	    w=&g_gauge_field[ix2][mu1];
-	    
-	    _su3_times_su3(pr2,*v,*w);
-	    
-	    
-	    _trace_su3_times_su3d(ac,pr1,pr2);
-	    
-	    if (mu1 != 0 && mu2 != 0) {
-	      
-	      ac *= 0.5;
-	      
-	    }
-	    
-	    sum += ac;
-	    
-	  }
-	}	      	
-	
-      }
-    }
-  }
-
-  ga = sum*2.0;
-  
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
 /* (3) boundary at t */
 double measure_plaquette_sf_weights_boundary_t (int t) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
-  int x0, x1, x2, x3;
+  set_weight(wss, t, 0.5);
 
-  x0 = t;
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=0;mu1<3;mu1++) {
-	  
-	  ix1=g_iup[ix][mu1];
-	  
-	  for (mu2=mu1+1;mu2<4;mu2++) { 
-	    
-	    ix2=g_iup[ix][mu2];
-	    
-	    v=&g_gauge_field[ix][mu1];
-	    w=&g_gauge_field[ix1][mu2];
-	    
-	    _su3_times_su3(pr1,*v,*w);
-	    
-	    
-	    v=&g_gauge_field[ix][mu2];
-	    w=&g_gauge_field[ix2][mu1];
-	    
-	    _su3_times_su3(pr2,*v,*w);
-	    
-	    
-	    _trace_su3_times_su3d(ac,pr1,pr2);
-	    
-	    if (mu1 != 0 && mu2 != 0) {
-	      
-	      ac *= 0.5;
-	      
-	    }
-	    if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	      
-	      ac = 0.;
-	      
-	    }
-	    
-	    sum += ac;
-	    
-	  }
-	}	      	
-	
-      }
-    }
-  }
-  
-  ga = sum*2.0;
-  
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
@@ -675,276 +356,54 @@ the plaquette for SF b.c. WITH the improvement coefficients (alpha collab.) */
 /* (1) bulk: */
 double measure_plaquette_sf_weights_improved_bulk(int t) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
-
-  int x0, x1, x2, x3;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
-  for (x0 = 1 ; x0 < (t-1) ; x0++) {
-    
-    for (x1 = 0 ; x1 < LX ; x1++) {
-      
-      for (x2 = 0 ; x2 < LY ; x2++) {
-	
-	for (x3 = 0 ; x3 < LZ ; x3++) {
-	  
-	  ix = Index(x0, x1, x2, x3);
-	  
-	  for (mu1=0;mu1<3;mu1++) {
-	    
-	    ix1=g_iup[ix][mu1];
-	    
-	    for (mu2=mu1+1;mu2<4;mu2++) { 
-	      
-	      ix2=g_iup[ix][mu2];
-	      
-	      v=&g_gauge_field[ix][mu1];
-	      w=&g_gauge_field[ix1][mu2];
-	      
-	      _su3_times_su3(pr1,*v,*w);
-	      
-	      
-	      v=&g_gauge_field[ix][mu2];
-	      w=&g_gauge_field[ix2][mu1];
-	      
-	      _su3_times_su3(pr2,*v,*w);
-	      
-	      
-	      _trace_su3_times_su3d(ac,pr1,pr2);
-	      
-	      sum += ac;
-	      
-	    }
-	  }	      
-	  
-	}
-      }
-    }
+  for(int x0 = 1; x0 < t-1; x0++) {
+    set_weight(wss, x0, 1.);
+    set_weight(wst, x0, 1.);
   }
-  
-  ga = sum*2.0;
-  
-  return ga;
+
+  return(weighted_plaquette(wss, wst));
   
 }
 
 /* (2) boundary at 0 */
 double measure_plaquette_sf_weights_improved_boundary_0 (double cs, double ct) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
-
-  int x0, x1, x2, x3;
-
-  x0 = 0;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
+  set_weight(wss, 0, cs);
+  set_weight(wst, 0, ct);
 
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-
-
-	for (mu1=0;mu1<3;mu1++){
-	  
-	  ix1=g_iup[ix][mu1];
-	  
-	  for (mu2=mu1+1;mu2<4;mu2++){ 
-	    
-	    ix2=g_iup[ix][mu2];
-	    
-	    v=&g_gauge_field[ix][mu1];
-	    w=&g_gauge_field[ix1][mu2];
-	    
-	    _su3_times_su3(pr1,*v,*w);
-	    
-	    
-	    v=&g_gauge_field[ix][mu2];
-	    w=&g_gauge_field[ix2][mu1];
-	    
-	    _su3_times_su3(pr2,*v,*w);
-	    
-	
-	    _trace_su3_times_su3d(ac,pr1,pr2);
-	    
-	    
-	    if (mu1 != 0 && mu2 != 0) {
-	      
-	      ac *= cs;
-	      
-	    }
-	    
-	    if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	      
-	      ac *= ct;
-	      
-	    }
-	    
-	    sum += ac;
-	    
-	  }
-	}
-	
-      }
-    }
-  }
+  return(weighted_plaquette(wss, wst));
   
-  ga = sum*2.0;
-
-  return ga;  
-
 }
 
 /*(3) boundary at t */
 double measure_plaquette_sf_weights_improved_boundary_t (int t, double cs) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
-  int x0, x1, x2, x3;
+  set_weight(wss, t, cs);
 
-  x0 = t;
-  
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	
-	for (mu1=0;mu1<3;mu1++){
-	  
-	  ix1=g_iup[ix][mu1];
-	  
-	  for (mu2=mu1+1;mu2<4;mu2++){ 
-	    
-	    ix2=g_iup[ix][mu2];
-	    
-	    v=&g_gauge_field[ix][mu1];
-	    w=&g_gauge_field[ix1][mu2];
-	    
-	    _su3_times_su3(pr1,*v,*w);
-	    
-	    
-	    v=&g_gauge_field[ix][mu2];
-	    w=&g_gauge_field[ix2][mu1];
-	    
-	    _su3_times_su3(pr2,*v,*w);
-	    
-	    
-	    _trace_su3_times_su3d(ac,pr1,pr2);
-	    
-	    
-	    if (mu1 != 0 && mu2 != 0) {
-	      
-	      ac *= cs;
-	      
-	    }
-	    if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	      
-	      ac = 0.;
-	      
-	    }
-	    
-	    sum += ac;
-	    
-	  }
-	}
-	
-      }
-    }
-  }
-  
-  ga = sum*2.0;
-
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
 /* (4) boundary at t-1 */
 double measure_plaquette_sf_weights_improved_boundary_t_minus_1 (int t, double ct) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
+  double * wss = weight_table(0.), * wst = weight_table(0.);
 
-  int x0, x1, x2, x3;
-
-  x0 = t-1;
-  
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	
-	for (mu1=0;mu1<3;mu1++){
-	  
-	  ix1=g_iup[ix][mu1];
-	  
-	  for (mu2=mu1+1;mu2<4;mu2++){ 
-	    
-	    ix2=g_iup[ix][mu2];
-	    
-	    v=&g_gauge_field[ix][mu1];
-	    w=&g_gauge_field[ix1][mu2];
-	    
-	    _su3_times_su3(pr1,*v,*w);
-	    
-	    
-	    v=&g_gauge_field[ix][mu2];
-	    w=&g_gauge_field[ix2][mu1];
-	    
-	    _su3_times_su3(pr2,*v,*w);
-	    
-	    
-	    _trace_su3_times_su3d(ac,pr1,pr2);
-	    
-	    
-	    if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	      
-	      ac *= ct;
-	      
-	    }
-	    
-	    sum += ac;
-	    
-	  }
-	}
-	
-      }
-    }
-  }
-  
-  ga = sum*2.0;
+  set_weight(wss, t-1, 1.);
+  set_weight(wst, t-1, ct);
 
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
-/*---------------------------------------------------------------------------------------------------------------*/
 
+/*---------------------------------------------------------------------------------------------------------------*/
 
 /* the next functions are used to calculate the Iwasaki action
    it is done "hard-coded"
@@ -954,186 +413,43 @@ double measure_plaquette_sf_weights_improved_boundary_t_minus_1 (int t, double c
 /* plaquette for Iwasaki */
 double measure_plaquette_sf_iwasaki(int t, double cs, double ct, double c0) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  su3 *v,*w;
-  static double ga,ac; 
-  double sum = 0;
-
+  double * wss = weight_table(c0), * wst = weight_table(c0);
 
-  for (ix=0;ix<VOLUME;ix++){
-    
-    for (mu1=0;mu1<3;mu1++){
-      
-      ix1=g_iup[ix][mu1];
-      
-      for (mu2=mu1+1;mu2<4;mu2++){ 
-	
-	ix2=g_iup[ix][mu2];
-	
-	v=&g_gauge_field[ix][mu1];
-	w=&g_gauge_field[ix1][mu2];
-	
-	_su3_times_su3(pr1,*v,*w);
-	
-	
-	v=&g_gauge_field[ix][mu2];
-	w=&g_gauge_field[ix2][mu1];
-	
-	_su3_times_su3(pr2,*v,*w);
-	
-	
-	_trace_su3_times_su3d(ac,pr1,pr2);
-
-	if (g_t[ix] == 0) {
-	  
-	  if (mu1 != 0 && mu2 != 0) {
-
-	    ac *= cs;
-
-	  }
-
-	  if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-
-	    ac *= ct;
-
-	  }
-	
-	} 
-	else if (g_t[ix] == t) {
-	  
-	  if (mu1 != 0 && mu2 != 0) {
-	    ac *= cs;
-	  }
-	  if ((mu1 == 0 || mu2 == 0) && mu1 != mu2) {
-	    ac = 0.;
-	  }
-	}
-	else if ((g_t[ix] == (t-1)) && ((mu1 == 0 || mu2 == 0) && mu1 != mu2)) {
-
-	    ac *= ct;
-	    
-	}
-
-	else {
-
-	  ac *= c0;
-
-	}
-	
-	sum += ac;
-	
-      }
-    }
-    
-  }
-  
-  ga = sum*2.0;
+  set_weight(wst, t-1, ct);
+  set_weight(wss, t, cs);
+  set_weight(wst, t, 0.);
+  set_weight(wss, 0, cs);
+  set_weight(wst, 0, ct);
 
-  return ga;
+  return(weighted_plaquette(wss, wst));
   
 }
 
 /* rectangle for Iwasaki */
 double measure_rectangle_sf_iwasaki(int t, double c1, double c1_ss, double c1_tss, double c1_tts) {
 
-  int ix,ix1,ix2,mu1,mu2;
-  int ix12,ix22;                           /* My changes */
-  static su3 pr_r1,pr_r2,pr_r11,pr_r22;    /* My changes */
-  static double ga,ac; 
-  su3 *v_r1,*w_r1,*z_r1;                   /* My changes */
-  su3 *v_r2,*w_r2,*z_r2;                   /* My changes */
-  double sum = 0;                          /* My changes */
-
-
-  for (ix=0;ix<VOLUME;ix++){
-    
-    for (mu1=0;mu1<4;mu1++){
-      
-      ix1 = g_iup[ix][mu1];
-      
-      for (mu2=0;mu2<4;mu2++){
-	if( mu1 != mu2 ){
-	  
-	  ix2  = g_iup[ix][mu2];
-	  ix12 = g_iup[ix1][mu2];
-	  ix22 = g_iup[ix2][mu2];
-	  
-	  
-	  v_r1 = &g_gauge_field[ix][mu1];
-	  w_r1 = &g_gauge_field[ix1][mu2];
-	  z_r1 = &g_gauge_field[ix12][mu2];
-	  
-	  _su3_times_su3(pr_r1,*v_r1,*w_r1);
-	  _su3_times_su3(pr_r11,pr_r1,*z_r1);
-	  
-	  
-	  v_r2 = &g_gauge_field[ix][mu2];
-	  w_r2 = &g_gauge_field[ix2][mu2];
-	  z_r2 = &g_gauge_field[ix22][mu1];
-	  
-	  _su3_times_su3(pr_r2,*v_r2,*w_r2);
-	  _su3_times_su3(pr_r22,pr_r2,*z_r2);
-	  
-	  
-	  _trace_su3_times_su3d(ac,pr_r11,pr_r22);
-
-
-	  if ((g_t[ix] == 0 || g_t[ix] == t) && (mu1 != 0 && mu2 != 0)) {
-
-	    ac *= c1_ss;
-	  
-	  }
-
-	  else if (g_t[ix] == 0 && mu1 == 0) {/* 1 movement in t <=> 2 links on a (time) boundary */
-
-	    ac *= c1_tss;
-	  
-	  }
-
-	  else if (g_t[ix] == 0 && mu2 == 0) {/* 2 movement in t <=> 1 links on a (time) boundary */
-
-	    ac *= c1_tts;
-	  
-	  }
-
-	  else if (g_t[ix] == (t-1) && mu1 == 0) {/* 1 movement in t <=> 2 links on a (time) boundary */
-
-	    ac *= c1_tss;
-	  
-	  }
-	  else if (g_t[ix] == (t-1) && mu2 == 0) {/* 2 movement in t <=> 1 links on a (time) boundary */
-
-	    ac = 0.;
-	  
-	  }
-
-	  else if (g_t[ix] == (t-2) && mu2 == 0) {/* 2 movement in t <=> 1 links on a (time) boundary */
-
-	    ac *= c1_tts;
-	  
-	  }
-	  else if (g_t[ix] == t && (mu1 == 0 || mu2 == 0)) {/* out of the lattice on the right side */
-
-	    ac = 0.;
-	  
-	  }
-
-	  else {
-
-	    ac *= c1;
-
-	  }
-	  
-	  sum += ac;
-	}
-      }
-    }
-  }
-  
-  ga = sum*2.0;
-
-  return ga;
+  double * wss = weight_table(c1), * wtss = weight_table(c1), * wtts = weight_table(c1);
+  double ga;
+
+  /* 2 movements in t <=> 1 link on a (time) boundary */
+  set_weight(wtts, t-2, c1_tts);
+  /* 1 movement in t <=> 2 links on a (time) boundary */
+  set_weight(wtss, t-1, c1_tss);
+  set_weight(wtts, t-1, 0.);
+  /* out of the lattice on the right side */
+  set_weight(wss, t, c1_ss);
+  set_weight(wtss, t, 0.);
+  set_weight(wtts, t, 0.);
+  set_weight(wss, 0, c1_ss);
+  set_weight(wtss, 0, c1_tss);
+  set_weight(wtts, 0, c1_tts);
+
+  ga = sf_weighted_rectangle(wss, wtss, wtts);
+  free(wss);
+  free(wtss);
+  free(wtts);
+
+  return(ga*2.0);
 
 }
 
@@ -1151,7 +467,7 @@ double measure_wilson_action(double beta) {
   double plaquette;
   double wilson;
 
-  plaquette = measure_plaquette();
+  plaquette = sf_measure_plaquette();
 
   wilson = - (beta/(2.*3.)) * plaquette;
   /* wilson = beta * (6.*VOLUME*g_nproc - plaquette); */
@@ -1166,9 +482,9 @@ double measure_iwasaki_action(double beta, double c0, double c1) {
   double rectangle;
   double iwasaki;
 
-  plaquette = measure_plaquette();
+  plaquette = sf_measure_plaquette();
 
-  rectangle = measure_rectangle();
+  rectangle = sf_measure_rectangle();
 
   iwasaki = - (beta/(2.*3.)) * ( c0*plaquette + c1*rectangle );
 
@@ -1337,11 +653,14 @@ void induced_continuum_background(su3 **b, int t, double eta) {
   phi3_T /= (double)t; 
 
   
+#ifdef TM_USE_OMP
+#pragma omp parallel for private(p1,p2,p3)
+#endif
   for (ix=0;ix<VOLUME;ix++){
 
-    p1 = g_t[ix]*phi1_T + ((double)t - g_t[ix])*phi1_0;
-    p2 = g_t[ix]*phi2_T + ((double)t - g_t[ix])*phi2_0;
-    p3 = g_t[ix]*phi3_T + ((double)t - g_t[ix])*phi3_0;
+    p1 = g_coord[ix][0]*phi1_T + ((double)t - g_coord[ix][0])*phi1_0;
+    p2 = g_coord[ix][0]*phi2_T + ((double)t - g_coord[ix][0])*phi2_0;
+    p3 = g_coord[ix][0]*phi3_T + ((double)t - g_coord[ix][0])*phi3_0;
 
     _su3_zero(b[ix][0]);
     _su3_spatially_constant_abelian_field_continuum(b[ix][1], p1, p2, p3);
@@ -1399,14 +718,17 @@ void induced_lattice_background(su3 **v, int t, double eta) {
 
 
 
+#ifdef TM_USE_OMP
+#pragma omp parallel for private(p1,p2,p3)
+#endif
   for (ix=0;ix<VOLUME;ix++){
 
-    p1 = g_t[ix]*phi1_T + ((double)t - g_t[ix])*phi1_0;
-    p2 = g_t[ix]*phi2_T + ((double)t - g_t[ix])*phi2_0;
-    p3 = g_t[ix]*phi3_T + ((double)t - g_t[ix])*phi3_0;
+    p1 = g_coord[ix][0]*phi1_T + ((double)t - g_coord[ix][0])*phi1_0;
+    p2 = g_coord[ix][0]*phi2_T + ((double)t - g_coord[ix][0])*phi2_0;
+    p3 = g_coord[ix][0]*phi3_T + ((double)t - g_coord[ix][0])*phi3_0;
 
 
-    if(g_t[ix] == t) {
+    if(g_coord[ix][0] == t) {
       
       _su3_zero(v[ix][0]);
       
@@ -1650,354 +972,171 @@ double partial_lattice_lo_effective_iwasaki_action_sf_k(int t, double beta, doub
 /* it has been taken from Rainer's notes in Schladming (eq.73) (we've checked and gotten the same formula) */
 /* WARNING: this function is only valid if we are considering U!=V */
 double partial_plaquette_sf_respect_to_eta(int t, double ct) {
-    
-  int ix,ix1,ix2,mu1,mu2;  
-  static su3 pr1,pr2; 
+
+  double ga = 0.;
+#ifdef TM_USE_MPI
+  double ALIGN mga;
+#endif
+
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+  int thread_num = omp_get_thread_num();
+#endif
+  int ix1,ix2,mu1,x0;
+  const int mu2 = 0;
+  su3 ALIGN pr1,pr2,pr11,i_lambda8; 
   su3 *v,*w;
-  static double ga,ac;
+  double ALIGN ac, sum = 0.;
 
-  int x0, x1, x2, x3; 
-  double sum_0 = 0, sum_tminus1 = 0;  
-  double ga_0, ga_tminus1, ga_int;
-  static su3 pr11;  
-  static su3 i_lambda8;
-  
-  /*printf("%ld\n", (((unsigned long int)(&pr11))%16) );
-    printf("%ld\n", (((unsigned long int)(&i_lambda8))%16) );*/
-  
   _su3_i_times_lambda_8(i_lambda8);
-  
-  mu2 = 0;
-  
-  /* loop to calculate E_{k}^{8}(\vec{x}) */
-  x0 = 0;
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=1;mu1<4;mu1++) {
-	  
-	  ix1=g_iup[ix][mu1];
-	  ix2=g_iup[ix][mu2];
-	  
-	  v=&g_gauge_field[ix][mu1];
-	  w=&g_gauge_field[ix1][mu2];
 
-	  _su3_times_su3(pr11,*v,*w);
-	  
-	  _su3_times_su3(pr1,i_lambda8, pr11);
-	  
-	  v=&g_gauge_field[ix][mu2];
-	  w=&g_gauge_field[ix2][mu1];
-	  
-	  _su3_times_su3(pr2,*v,*w);
-	  
-	    _trace_su3_times_su3d(ac,pr1,pr2);
-	    
-	    sum_0 += ac;
-	    
-	    
-	}
-	
-      }
-    }
-  }
-  
-  ga_0 = sum_0;
+  /* E_{k}^{8}(\vec{x}) from x0 = 0 and (E_{k}^{8})^{prime}(\vec{x}) from x0 = t-1 */
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for (int ix = 0; ix < VOLUME; ix++) {
+    x0 = g_coord[ix][0];
+    if (x0 != 0 && x0 != t-1) continue;
 
-  /* loop to calculate (E_{k}^{8})^{prime}(\vec{x}) */
-  x0 = t-1;
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=1;mu1<4;mu1++) {
+    for (mu1=1;mu1<4;mu1++) {
 	  
-	  ix1=g_iup[ix][mu1];
-	  ix2=g_iup[ix][mu2];
+      ix1=g_iup[ix][mu1];
+      ix2=g_iup[ix][mu2];
 	  
-	  v=&g_gauge_field[ix][mu1];
-	  w=&g_gauge_field[ix1][mu2];
-
-	  _su3_times_su3(pr11,*v,*w);
-	  _su3_times_su3(pr1,pr11,i_lambda8);
+      v=&g_gauge_field[ix][mu1];
+      w=&g_gauge_field[ix1][mu2];
 	  
-	  v=&g_gauge_field[ix][mu2];
-	  w=&g_gauge_field[ix2][mu1];
+      _su3_times_su3(pr11,*v,*w);
+      if (x0 == 0) {
+        _su3_times_su3(pr1,i_lambda8, pr11);
+      }
+      else {
+        _su3_times_su3(pr1,pr11,i_lambda8);
+      }
 	  
-	  _su3_times_su3(pr2,*v,*w);
+      v=&g_gauge_field[ix][mu2];
+      w=&g_gauge_field[ix2][mu1];
 	  
-	  _trace_su3_times_su3d(ac,pr1,pr2);
+      _su3_times_su3(pr2,*v,*w);
 	  
-	  sum_tminus1 += ac;
+      _trace_su3_times_su3d(ac,pr1,pr2);
 	  
-	}
-	
-      }
+      sum += ac;
     }
   }
-  
-  ga_tminus1 = sum_tminus1;
-  
-  ga_int = ct*(ga_0 + ga_tminus1);
-  
-  ga = ga_int;
-  
-  return ga;
+
+#ifdef TM_USE_OMP
+  g_omp_acc_re[thread_num] = sum;
+  } /* OpenMP parallel closing brace */
+
+  for(int i = 0; i < omp_num_threads; i++) {
+    ga += g_omp_acc_re[i];
+  }
+#else
+  ga = sum;
+#endif
+#ifdef TM_USE_MPI
+  MPI_Allreduce(&ga, &mga, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  ga = mga;
+#endif
+
+  return(ct*ga);
   
 }
 
 /*------------------------------------------------------------------------------------------------------------*/
 
-
 /* it gives the expression of the "derivative" of the "RECTANGLE" with SF b.c.
    with respect to the background field parameter "eta" */
 /* it has been derived similarly as has been done for the plquette in the previous case */
 double partial_rectangle_sf_respect_to_eta(int t, double c1_tss, double c1_tts) {
-  
-  int ix,ix1,ix2,mu1,mu2;
-  static su3 pr1,pr2; 
-  static double ga,ac;
-  
-  int x0, x1, x2, x3;
-  int ix12,ix11,ix22; 
-  static su3 i_lambda8;
-  su3 *v_r1,*w_r1,*z_r1;
-  su3 *v_r2,*w_r2,*z_r2;
-  static su3 pr_r1,pr_r2,pr_r11;
-  double sum_0_tss=0, sum_0_tts=0, sum_tminus1_tss=0, sum_tminus2_tts=0;  
-  double ga_0_tss, ga_0_tts,  ga_tminus1_tss, ga_tminus2_tts;
-  
-  
-  _su3_i_times_lambda_8(i_lambda8);
-  
-  mu2 = 0;
 
-  
- /* loops to calculate E_{k}^{8}(\vec{x}): "R_tss" and "R_tts" at 0 */ 
-  x0 = 0;
-  
-  
-  /* first contribution to E_{k}^{8}(\vec{x}): R_tss */
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=1;mu1<4;mu1++) {
-	  
-	  ix1=g_iup[ix][mu1];
-	  ix2=g_iup[ix][mu2];
-	  ix12=g_iup[ix1][mu2];
-	  ix11=g_iup[ix1][mu1];	
-	  ix22=g_iup[ix2][mu2];	
-	  
-	  
-	  v_r1 = &g_gauge_field[ix][mu1];
-	  w_r1 = &g_gauge_field[ix1][mu1];
-	  z_r1 = &g_gauge_field[ix11][mu2];
-	  
-	  _su3_times_su3(pr_r1,*v_r1,*w_r1);
-	  _su3_times_su3(pr_r11,pr_r1,*z_r1);
-	  _su3_times_su3(pr1,i_lambda8,pr_r11);	    
-	  
-	  
-	  v_r2 = &g_gauge_field[ix][mu2];
-	  w_r2 = &g_gauge_field[ix2][mu1];
-	  z_r2 = &g_gauge_field[ix12][mu1];
-	  
-	  _su3_times_su3(pr_r2,*v_r2,*w_r2);
-	  _su3_times_su3(pr2,pr_r2,*z_r2);
-	  
-	  
-	  _trace_su3_times_su3d(ac,pr1,pr2);
-	  
-	  
-	  sum_0_tss += ac;
-	  
-	}
-	
-      }
-    }
-  }
-  
-  ga_0_tss = sum_0_tss;
-  
-  
-  /* second contribution to E_{k}^{8}(\vec{x}): R_tts */
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=1;mu1<4;mu1++) {
-	  
-	  ix1=g_iup[ix][mu1];
-	  ix2=g_iup[ix][mu2];
-	  ix12=g_iup[ix1][mu2];
-	  ix11=g_iup[ix1][mu1];	
-	  ix22=g_iup[ix2][mu2];	
-	  
-	  
-	  v_r1 = &g_gauge_field[ix][mu1];
-	  w_r1 = &g_gauge_field[ix1][mu2];
-	  z_r1 = &g_gauge_field[ix12][mu2];
-	  
-	  _su3_times_su3(pr_r1,*v_r1,*w_r1);
-	  _su3_times_su3(pr_r11,pr_r1,*z_r1);
-	  _su3_times_su3(pr1,i_lambda8,pr_r11);	    
-	  
-	  
-	  v_r2 = &g_gauge_field[ix][mu2];
-	  w_r2 = &g_gauge_field[ix2][mu2];
-	  z_r2 = &g_gauge_field[ix22][mu1];
-	  
-	  _su3_times_su3(pr_r2,*v_r2,*w_r2);
-	  _su3_times_su3(pr2,pr_r2,*z_r2);
-	  
-	  
-	  _trace_su3_times_su3d(ac,pr1,pr2);
-	  
-	  
-	  sum_0_tts += ac;
-	  
-	}
-	
-      }
-    }
-  }
-  
-  ga_0_tts = sum_0_tts;
+  double ga = 0.;
+#ifdef TM_USE_MPI
+  double ALIGN mga;
+#endif
 
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+  int thread_num = omp_get_thread_num();
+#endif
+  int ix1,ix2,ix11,ix12,ix22,mu1,x0;
+  const int mu2 = 0;
+  su3 ALIGN pr1,pr2,pr_r1,pr_r2,pr_r11,i_lambda8;
+  double ALIGN ac, sum = 0.;
 
+  _su3_i_times_lambda_8(i_lambda8);
 
-    /* loop to calculate (E_{k}^{8})^{prime}(\vec{x}): "R_tss" and "R_tts" at t */
+  /* E_{k}^{8}(\vec{x}): "R_tss" and "R_tts" at 0,               */
+  /* (E_{k}^{8})^{prime}(\vec{x}): "R_tss" at t-1 and "R_tts" at t-2 */
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for (int ix = 0; ix < VOLUME; ix++) {
+    x0 = g_coord[ix][0];
+    if (x0 != 0 && x0 != t-1 && x0 != t-2) continue;
 
-    /* first contribution to (E_{k}^{8})^{prime}(\vec{x}): R_tss */
-  x0 = t-1;
-  
-  for (x1 = 0 ; x1 < LX ; x1++) {
-    
-    for (x2 = 0 ; x2 < LY ; x2++) {
-      
-      for (x3 = 0 ; x3 < LZ ; x3++) {
-	
-	ix = Index(x0, x1, x2, x3);
-	
-	for (mu1=1;mu1<4;mu1++) {
-	  
-	  ix1=g_iup[ix][mu1];
-	  ix2=g_iup[ix][mu2];
-	  ix12=g_iup[ix1][mu2];
-	  ix11=g_iup[ix1][mu1];	
-	  ix22=g_iup[ix2][mu2];	
-	  
-	  
-	  v_r1 = &g_gauge_field[ix][mu1];
-	  w_r1 = &g_gauge_field[ix1][mu1];
-	  z_r1 = &g_gauge_field[ix11][mu2];
+    for (mu1=1;mu1<4;mu1++) {
 	  
-	  _su3_times_su3(pr_r1,*v_r1,*w_r1);
-	  _su3_times_su3(pr_r11,pr_r1,*z_r1);
-	  _su3_times_su3(pr1,pr_r11,i_lambda8);	    
-	  
-	  
-	  v_r2 = &g_gauge_field[ix][mu2];
-	  w_r2 = &g_gauge_field[ix2][mu1];
-	  z_r2 = &g_gauge_field[ix12][mu1];
-	  
-	  _su3_times_su3(pr_r2,*v_r2,*w_r2);
-	  _su3_times_su3(pr2,pr_r2,*z_r2);
-	  
-	  
-	  _trace_su3_times_su3d(ac,pr1,pr2);
-	  
-	  
-	  sum_tminus1_tss += ac;
-	  
-	}
-	
+      ix1=g_iup[ix][mu1];
+      ix2=g_iup[ix][mu2];
+      ix12=g_iup[ix1][mu2];
+      ix11=g_iup[ix1][mu1];	
+      ix22=g_iup[ix2][mu2];	
+
+      if (x0 == 0 || x0 == t-1) {
+        /* R_tss */
+        _su3_times_su3(pr_r1,g_gauge_field[ix][mu1],g_gauge_field[ix1][mu1]);
+        _su3_times_su3(pr_r11,pr_r1,g_gauge_field[ix11][mu2]);
+        if (x0 == 0) {
+          _su3_times_su3(pr1,i_lambda8,pr_r11);	    
+        }
+        else {
+          _su3_times_su3(pr1,pr_r11,i_lambda8);	    
+        }
+        _su3_times_su3(pr_r2,g_gauge_field[ix][mu2],g_gauge_field[ix2][mu1]);
+        _su3_times_su3(pr2,pr_r2,g_gauge_field[ix12][mu1]);
+        _trace_su3_times_su3d(ac,pr1,pr2);
+        sum += 2.*c1_tss*ac;
       }
-    }
-  }
-  
-  ga_tminus1_tss = sum_tminus1_tss;
-  
-
-    /* second contribution to (E_{k}^{8})^{prime}(\vec{x}): R_tts */
-    x0 = t-2;
 
-    for (x1 = 0 ; x1 < LX ; x1++) {
-      
-      for (x2 = 0 ; x2 < LY ; x2++) {
-	
-	for (x3 = 0 ; x3 < LZ ; x3++) {
-	  
-	  ix = Index(x0, x1, x2, x3);
-	  
-	  for (mu1=1;mu1<4;mu1++) {
-	    
-	  ix1=g_iup[ix][mu1];
-	  ix2=g_iup[ix][mu2];
-	  ix12=g_iup[ix1][mu2];
-	  ix11=g_iup[ix1][mu1];	
-	  ix22=g_iup[ix2][mu2];	
-	  
-	  
-	  v_r1 = &g_gauge_field[ix][mu1];
-	  w_r1 = &g_gauge_field[ix1][mu2];
-	  z_r1 = &g_gauge_field[ix12][mu2];
-	  
-	  _su3_times_su3(pr_r1,*v_r1,*w_r1);
-	  _su3_times_su3(pr_r11,pr_r1,*z_r1);
-	  _su3_times_su3(pr1,pr_r11,i_lambda8);
-	  
-	  v_r2 = &g_gauge_field[ix][mu2];
-	  w_r2 = &g_gauge_field[ix2][mu2];
-	  z_r2 = &g_gauge_field[ix22][mu1];
-	  
-	  _su3_times_su3(pr_r2,*v_r2,*w_r2);
-	  _su3_times_su3(pr2,pr_r2,*z_r2);
-	  
-	  
-	  _trace_su3_times_su3d(ac,pr1,pr2);
-	  
-	  
-	  sum_tminus2_tts += ac;
-
-	    
-	    }
-	  
-	}
+      if (x0 == 0 || x0 == t-2) {
+        /* R_tts */
+        _su3_times_su3(pr_r1,g_gauge_field[ix][mu1],g_gauge_field[ix1][mu2]);
+        _su3_times_su3(pr_r11,pr_r1,g_gauge_field[ix12][mu2]);
+        if (x0 == 0) {
+          _su3_times_su3(pr1,i_lambda8,pr_r11);	    
+        }
+        else {
+          _su3_times_su3(pr1,pr_r11,i_lambda8);	    
+        }
+        _su3_times_su3(pr_r2,g_gauge_field[ix][mu2],g_gauge_field[ix2][mu2]);
+        _su3_times_su3(pr2,pr_r2,g_gauge_field[ix22][mu1]);
+        _trace_su3_times_su3d(ac,pr1,pr2);
+        sum += c1_tts*ac;
       }
     }
+  }
 
-    ga_tminus2_tts = sum_tminus2_tts;
+#ifdef TM_USE_OMP
+  g_omp_acc_re[thread_num] = sum;
+  } /* OpenMP parallel closing brace */
 
-    ga = 2.*c1_tss*(ga_0_tss + ga_tminus1_tss) + c1_tts*(ga_0_tts + ga_tminus2_tts);
+  for(int i = 0; i < omp_num_threads; i++) {
+    ga += g_omp_acc_re[i];
+  }
+#else
+  ga = sum;
+#endif
+#ifdef TM_USE_MPI
+  MPI_Allreduce(&ga, &mga, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  ga = mga;
+#endif
 
+  return(ga);  
 
-  return ga;  
-  
-  
 }
 
 /*------------------------------------------------------------------------------------------------------------*/
@@ -17,8 +17,8 @@ void sf_boundary_conditions_spatially_constant_abelian_field(int t, double eta);
 
 /*** MEASUREMENTS ***/
 
-double measure_plaquette();
-double measure_rectangle();
+double sf_measure_plaquette();
+double sf_measure_rectangle();
 
 double measure_plaquette_sf_weights(int t);
 double measure_plaquette_sf_weights_improvement(int t, double cs, double ct);
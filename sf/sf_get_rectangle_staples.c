@@ -31,7 +31,7 @@
 
 /* this function is valid ONLY IF Nt => 6 */
 void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
-  static su3 tmp1, tmp2;
+  su3 ALIGN tmp1, tmp2;
   int y, z, nu;
   su3 * a, * b, * c, * d, * e;
 #ifdef _KOJAK_INST
@@ -43,7 +43,7 @@ void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
   _su3_zero((*v));
   for(nu = 0; nu < 4; nu++) {
     if(mu != nu) {
-      if (g_t[x] > 2 && g_t[x] < (g_Tbsf-2)) {
+      if (g_coord[x][0] > 2 && g_coord[x][0] < (g_Tbsf-2)) {
         /* first contr. starting from x 
           * a b c e^+ d^+
           *   c
@@ -192,7 +192,7 @@ void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
         _real_times_su3(tmp1,g_rgi_C1,tmp1); /* that is the new thing specific of SF */
         _su3_times_su3_acc((*v), tmp2, tmp1);
       }
-      else if (g_t[x] == 2) {
+      else if (g_coord[x][0] == 2) {
         if (mu == 0 || (mu != 0 && nu != 0)){
           
           /* first contr. starting from x 
@@ -505,7 +505,7 @@ void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
           _su3_times_su3_acc((*v), tmp2, tmp1);
         }	
       }
-      else if (g_t[x] == (g_Tbsf-2)) {
+      else if (g_coord[x][0] == (g_Tbsf-2)) {
         if (mu == 0){
           /* first contr. starting from x 
             * a b c e^+ d^+
@@ -959,7 +959,7 @@ void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
           _su3_times_su3_acc((*v), tmp2, tmp1);
         }
       }
-      else if (g_t[x] == 1) {
+      else if (g_coord[x][0] == 1) {
         if (mu == 0) {
           /* first contr. starting from x 
             * a b c e^+ d^+
@@ -1385,7 +1385,7 @@ void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
           _su3_times_su3_acc((*v), tmp2, tmp1);
         }
       }
-      else if (g_t[x] == (g_Tbsf-1)) {
+      else if (g_coord[x][0] == (g_Tbsf-1)) {
         if (mu == 0) {
           /* first contr. starting from x 
             * a b c e^+ d^+
@@ -1761,7 +1761,7 @@ void sf_get_rectangle_staples(su3 * const v, const int x, const int mu) {
           _su3_times_su3_acc((*v), tmp2, tmp1);
         }
       }
-      else if (g_t[x] == 0) {
+      else if (g_coord[x][0] == 0) {
         /* first contr. starting from x 
           * a b c e^+ d^+
           *   c
@@ -36,7 +36,7 @@
 su3 sf_get_staples(int x, int mu, su3 ** in_gauge_field) {
   
   int k, iy, flag1, flag2;
-  static su3 v, st, cst;
+  su3 ALIGN v, st, cst;
   su3 *w1, *w2, *w3;
 #ifdef _KOJAK_INST
 #pragma pomp inst begin(staples)
@@ -46,16 +46,16 @@ su3 sf_get_staples(int x, int mu, su3 ** in_gauge_field) {
   _su3_zero(v);
   for (k = 0; k < 4; k++) {
     if (k != mu) {
-      if (g_t[x] > 1 && g_t[x] < (g_Tbsf - 1)) {
+      if (g_coord[x][0] > 1 && g_coord[x][0] < (g_Tbsf - 1)) {
         flag1 = 0;
         flag2 = 0;
-      } else if (g_t[x] == 0 && mu == 0) {
+      } else if (g_coord[x][0] == 0 && mu == 0) {
         flag1 = 1;  
         flag2 = 1;
-      } else if (g_t[x] == 1 && mu == 0) {
+      } else if (g_coord[x][0] == 1 && mu == 0) {
         flag1 = 0;
         flag2 = 0;
-      } else if (g_t[x] == 1 && mu != 0) {
+      } else if (g_coord[x][0] == 1 && mu != 0) {
         if (k != 0) {
           flag1 = 0;
           flag2 = 0;
@@ -63,10 +63,10 @@ su3 sf_get_staples(int x, int mu, su3 ** in_gauge_field) {
           flag1 = 0;  
           flag2 = 1;
         }
-      } else if (g_t[x] == (g_Tbsf - 1) && mu == 0) {
+      } else if (g_coord[x][0] == (g_Tbsf - 1) && mu == 0) {
         flag1 = 1;  
         flag2 = 1;
-      } else if (g_t[x] == (g_Tbsf - 1) && mu != 0) {
+      } else if (g_coord[x][0] == (g_Tbsf - 1) && mu != 0) {
         if (k != 0) {
           flag1 = 0;
           flag2 = 0;
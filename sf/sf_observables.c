@@ -28,6 +28,7 @@ void sf_observables() {
   double wilson_action_sepbound;
   double iwasaki_action;
   double factor;
+  double k_factor, partial_eff, partial_action;
 
   /* sf b.c. abelian field and standard sf weight factors included (only plaquette here) */
   plaquette_energy = measure_plaquette_sf_weights(g_Tbsf);
@@ -68,22 +69,25 @@ void sf_observables() {
 
   if(g_rgi_C1 > 0. || g_rgi_C1 < 0.) {
 
+    /* the derivatives of the action are global sums, to be computed on all processes */
+    k_factor = partial_lattice_lo_effective_iwasaki_action_sf_k(g_Tbsf, g_beta, g_rgi_C0, g_rgi_C1, g_eta);
+    partial_action = partial_iwasaki_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct, g_rgi_C0,
+							      g_rgi_C1, g_C1ss, g_C1tss, g_C1tts);
+
     /* print the value of the leading order effective action \Gamma[V] and its derivative \Gamma'[V] (plaquette case) */
     /* note that the derivative is precisely the constant factor in the definition of the coupling constant */
     if(g_proc_id==0){
       printf("\n"); fflush(stdout);
       printf("Constant factor K: \n");
-      printf("K = %e\n", partial_lattice_lo_effective_iwasaki_action_sf_k(g_Tbsf, g_beta, g_rgi_C0, g_rgi_C1, g_eta)); fflush(stdout);
+      printf("K = %e\n", k_factor); fflush(stdout);
     }
 
     /* print the value of the "\partial(S)/\partial(eta)" which will have to be averaged later on to obtain the coupling constant */ 
     if(g_proc_id==0){
       printf("\n"); fflush(stdout);
       printf("'Definition' of the coupling constant, partial(S)/partial(eta)\n"); fflush(stdout);
-      printf("S'[V,U] = %e\n", partial_iwasaki_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct, g_rgi_C0,
-						g_rgi_C1, g_C1ss, g_C1tss, g_C1tts)); fflush(stdout);
-      printf("S'[V,U]/K = %e\n",partial_iwasaki_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct, g_rgi_C0,
-									 g_rgi_C1, g_C1ss, g_C1tss, g_C1tts)/partial_lattice_lo_effective_iwasaki_action_sf_k(g_Tbsf, g_beta, g_rgi_C0, g_rgi_C1, g_eta)); fflush(stdout);
+      printf("S'[V,U] = %e\n", partial_action); fflush(stdout);
+      printf("S'[V,U]/K = %e\n", partial_action/k_factor); fflush(stdout);
       printf("\n"); fflush(stdout);
     }
     
@@ -92,6 +96,9 @@ void sf_observables() {
   else {
     
     factor = 1./(1. - (1. - g_Ct)*(2./((double)g_Tbsf)));
+    partial_eff = partial_lattice_lo_effective_plaquette_action_sf(g_Tbsf, g_beta, g_Ct, g_eta);
+    k_factor = partial_lattice_lo_effective_plaquette_action_sf_k(g_Tbsf, g_beta, g_Ct, g_eta);
+    partial_action = partial_wilson_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct);
     
     /* print the value of the leading order effective action \Gamma[V] and its derivative \Gamma'[V] (plaquette case) */
     /* note that the derivative is precisely the constant factor in the definition of the coupling constant */
@@ -99,19 +106,19 @@ void sf_observables() {
       printf("\n"); fflush(stdout);
       printf("Effective action and its derivative with respect to eta, at leading order: \n");
       printf("Gamma[V] = %e\n", lattice_lo_effective_plaquette_action_sf(g_Tbsf, g_beta, g_Ct, g_eta)); fflush(stdout);
-      printf("Gamma'[V] = %e\n", partial_lattice_lo_effective_plaquette_action_sf(g_Tbsf, g_beta, g_Ct, g_eta)); fflush(stdout);
-      printf("factor*Gamma'[V] = %e\n", factor*partial_lattice_lo_effective_plaquette_action_sf(g_Tbsf, g_beta, g_Ct, g_eta)); fflush(stdout);
-      printf("K_plaquette = %e\n", partial_lattice_lo_effective_plaquette_action_sf_k(g_Tbsf, g_beta, g_Ct, g_eta)); fflush(stdout);
+      printf("Gamma'[V] = %e\n", partial_eff); fflush(stdout);
+      printf("factor*Gamma'[V] = %e\n", factor*partial_eff); fflush(stdout);
+      printf("K_plaquette = %e\n", k_factor); fflush(stdout);
     }
     
     /* print the value of the "\partial(S)/\partial(eta)" which will have to be averaged later on to obtain the coupling constant */ 
     if(g_proc_id==0){
       printf("\n"); fflush(stdout);
       printf("'Definition' of the coupling constant, partial(S)/partial(eta)\n"); fflush(stdout);
-      printf("S'[V,U] = %e\n",partial_wilson_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct)); fflush(stdout);
-      printf("S'[V,U]/Gamma'[V] = %e\n",partial_wilson_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct)/partial_lattice_lo_effective_plaquette_action_sf(g_Tbsf, g_beta, g_Ct, g_eta)); fflush(stdout);
-      printf("S'[V,U]/(factor*Gamma'[V]) = %e\n",partial_wilson_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct)/(factor*partial_lattice_lo_effective_plaquette_action_sf(g_Tbsf, g_beta, g_Ct, g_eta))); fflush(stdout);
-      printf("S'[V,U]/K_plaquette = %e\n",partial_wilson_action_sf_respect_to_eta(g_Tbsf, g_beta, g_Cs, g_Ct)/partial_lattice_lo_effective_plaquette_action_sf_k(g_Tbsf, g_beta, g_Ct, g_eta)); fflush(stdout);
+      printf("S'[V,U] = %e\n", partial_action); fflush(stdout);
+      printf("S'[V,U]/Gamma'[V] = %e\n", partial_action/partial_eff); fflush(stdout);
+      printf("S'[V,U]/(factor*Gamma'[V]) = %e\n", partial_action/(factor*partial_eff)); fflush(stdout);
+      printf("S'[V,U]/K_plaquette = %e\n", partial_action/k_factor); fflush(stdout);
       printf("\n"); fflush(stdout);
     }
   }
@@ -7,275 +7,283 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "global.h"
-
-double calc_sq_plaq( void )
-{
-  int x;
-  int x_p_mu;
-  int x_p_nu;
-  int mu;
-  int nu;
-  su3* u_mu_x;
-  su3* u_nu_x_p_mu;
-  su3* u_mu_x_p_nu;
-  su3* u_nu_x;
-  su3 tmp1;
-  su3 tmp2;
-  double tr;
-  double sum = 0;
-
-  for( x=0; x<VOLUME; x++ )
-  for( mu=0; mu<4;  mu++ )
-  for( nu=0; nu<mu; nu++ )
-  {
-    x_p_mu = g_iup[ x ][ mu ];
-    x_p_nu = g_iup[ x ][ nu ];
-
-    u_mu_x      = &g_gauge_field[ x      ][ mu ];
-    u_nu_x_p_mu = &g_gauge_field[ x_p_mu ][ nu ];
-    u_mu_x_p_nu = &g_gauge_field[ x_p_nu ][ mu ];
-    u_nu_x      = &g_gauge_field[ x      ][ nu ];
-
-    _su3_times_su3( tmp1, *u_nu_x, *u_mu_x_p_nu );
-    _su3_times_su3( tmp2, *u_mu_x, *u_nu_x_p_mu );
-    _trace_su3_times_su3d( tr, tmp1, tmp2 );
-
-    sum += tr;
+#include "su3.h"
+#include "sf_utils.h"
+
+/* sums the thread local tables of length n in the order of the thread */
+/* numbers into res and over all MPI processes                         */
+static void reduce_slices(double * const thread_res, double * const res, const int n, const int nthreads) {
+#ifdef TM_USE_MPI
+  double * mres = (double*)malloc(n*sizeof(double));
+#endif
+  for(int j = 0; j < n; j++) {
+    res[j] = 0.;
   }
-
-  sum /= ((double)3);
-
-  return sum;
+  for(int i = 0; i < nthreads; i++) {
+    for(int j = 0; j < n; j++) {
+      res[j] += thread_res[i*n + j];
+    }
+  }
+#ifdef TM_USE_MPI
+  MPI_Allreduce(res, mres, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  for(int j = 0; j < n; j++) {
+    res[j] = mres[j];
+  }
+  free(mres);
+#endif
+  return;
 }
 
-double calc_bulk_sq_plaq( void )
-{
-  int x;
-  int x_p_mu;
-  int x_p_nu;
-  int mu;
-  int nu;
-  su3* u_mu_x;
-  su3* u_nu_x_p_mu;
-  su3* u_mu_x_p_nu;
-  su3* u_nu_x;
-  su3 tmp1;
-  su3 tmp2;
-  double tr;
-  double sum = 0;
+void sf_plaquette_slices(su3 ** const gf, double * const ss, double * const st) {
+  const int nt = g_nproc_t*T;
+  int nthreads = 1;
+  double * thread_res, * res;
 
-  /* None of the forward plaquettes for t=T-1 contribute. */
-  /* None of the forward plaquettes for t=0 contribute. */
-  /* Also the space-time square for t=T-2 does not contribute. */
+#ifdef TM_USE_OMP
+  nthreads = omp_num_threads;
+#endif
+  thread_res = (double*)calloc(nthreads*2*nt, sizeof(double));
+  res = (double*)malloc(2*nt*sizeof(double));
 
-  for( x=0; x<VOLUME; x++ )
-  for( mu=0; mu<4;  mu++ )
-  for( nu=0; nu<mu; nu++ )
-  if( ( g_t[ x ] != (T-1) ) &
-      ( ( g_t[ x ] != (T-2) ) || ( ( mu != 3 ) && ( nu != 3 ) ) ) &
-      ( g_t[ x ] != 0 ) )
+#ifdef TM_USE_OMP
+#pragma omp parallel
   {
-    x_p_mu = g_iup[ x ][ mu ];
-    x_p_nu = g_iup[ x ][ nu ];
-
-    u_mu_x      = &g_gauge_field[ x      ][ mu ];
-    u_nu_x_p_mu = &g_gauge_field[ x_p_mu ][ nu ];
-    u_mu_x_p_nu = &g_gauge_field[ x_p_nu ][ mu ];
-    u_nu_x      = &g_gauge_field[ x      ][ nu ];
-
-    _su3_times_su3( tmp1, *u_nu_x, *u_mu_x_p_nu );
-    _su3_times_su3( tmp2, *u_mu_x, *u_nu_x_p_mu );
-    _trace_su3_times_su3d( tr, tmp1, tmp2 );
+  int thread_num = omp_get_thread_num();
+#else
+  int thread_num = 0;
+#endif
+  su3 ALIGN tmp1, tmp2;
+  double ALIGN tr;
+  double * const tss = thread_res + thread_num*2*nt;
+  double * const tst = tss + nt;
 
-    sum += tr;
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int x = 0; x < VOLUME; x++) {
+    const int t = g_coord[x][0];
+    for(int mu = 0; mu < 3; mu++) {
+      const int x_p_mu = g_iup[x][mu];
+      for(int nu = mu+1; nu < 4; nu++) {
+        const int x_p_nu = g_iup[x][nu];
+        _su3_times_su3(tmp1, gf[x][mu], gf[x_p_mu][nu]);
+        _su3_times_su3(tmp2, gf[x][nu], gf[x_p_nu][mu]);
+        _trace_su3_times_su3d(tr, tmp1, tmp2);
+        if(mu == 0) {
+          tst[t] += tr;
+        }
+        else {
+          tss[t] += tr;
+        }
+      }
+    }
   }
+#ifdef TM_USE_OMP
+  } /* OpenMP parallel closing brace */
+#endif
 
-  sum /= ((double)3);
-
-  return sum;
+  reduce_slices(thread_res, res, 2*nt, nthreads);
+  for(int t = 0; t < nt; t++) {
+    ss[t] = res[t];
+    st[t] = res[nt + t];
+  }
+  free(res);
+  free(thread_res);
+  return;
 }
 
-double calc_boundary_space_space_sq_plaq( void )
-{
-  int x;
-  int x_p_mu;
-  int x_p_nu;
-  int mu;
-  int nu;
-  su3* u_mu_x;
-  su3* u_nu_x_p_mu;
-  su3* u_mu_x_p_nu;
-  su3* u_nu_x;
-  su3 tmp1;
-  su3 tmp2;
-  double tr;
-  double sum = 0;
+void sf_rectangle_slices(su3 ** const gf, double * const ss, double * const tss, double * const tts) {
+  const int nt = g_nproc_t*T;
+  int nthreads = 1;
+  double * thread_res, * res;
 
-  /* We need the space-space plaquettes for t=T-1 and t=0. */
+#ifdef TM_USE_OMP
+  nthreads = omp_num_threads;
+#endif
+  thread_res = (double*)calloc(nthreads*3*nt, sizeof(double));
+  res = (double*)malloc(3*nt*sizeof(double));
 
-  for( x=0; x<VOLUME; x++ )
-  for( mu=0; mu<4;  mu++ )
-  for( nu=0; nu<mu; nu++ )
-  if( ( ( g_t[ x ] == (T-1) ) & ( mu != 3 ) & ( nu != 3 ) ) ||
-      ( ( g_t[ x ] ==     0 ) & ( mu != 3 ) & ( nu != 3 ) ) )
+#ifdef TM_USE_OMP
+#pragma omp parallel
   {
-    x_p_mu = g_iup[ x ][ mu ];
-    x_p_nu = g_iup[ x ][ nu ];
-
-    u_mu_x      = &g_gauge_field[ x      ][ mu ];
-    u_nu_x_p_mu = &g_gauge_field[ x_p_mu ][ nu ];
-    u_mu_x_p_nu = &g_gauge_field[ x_p_nu ][ mu ];
-    u_nu_x      = &g_gauge_field[ x      ][ nu ];
-
-    _su3_times_su3( tmp1, *u_nu_x, *u_mu_x_p_nu );
-    _su3_times_su3( tmp2, *u_mu_x, *u_nu_x_p_mu );
-    _trace_su3_times_su3d( tr, tmp1, tmp2 );
-
-    sum += tr;
+  int thread_num = omp_get_thread_num();
+#else
+  int thread_num = 0;
+#endif
+  su3 ALIGN tmp1, tmp2, tmp11, tmp22;
+  double ALIGN tr;
+  double * const rss = thread_res + thread_num*3*nt;
+  double * const rtss = rss + nt;
+  double * const rtts = rss + 2*nt;
+
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int x = 0; x < VOLUME; x++) {
+    const int t = g_coord[x][0];
+    /* one step in direction mu, two in direction nu */
+    for(int mu = 0; mu < 4; mu++) {
+      const int x_p_mu = g_iup[x][mu];
+      for(int nu = 0; nu < 4; nu++) {
+        if(mu == nu) continue;
+        const int x_p_nu = g_iup[x][nu];
+        const int x_p_mu_p_nu = g_iup[x_p_mu][nu];
+        const int x_p_2nu = g_iup[x_p_nu][nu];
+        _su3_times_su3(tmp1, gf[x][mu], gf[x_p_mu][nu]);
+        _su3_times_su3(tmp11, tmp1, gf[x_p_mu_p_nu][nu]);
+        _su3_times_su3(tmp2, gf[x][nu], gf[x_p_nu][nu]);
+        _su3_times_su3(tmp22, tmp2, gf[x_p_2nu][mu]);
+        _trace_su3_times_su3d(tr, tmp11, tmp22);
+        if(mu == 0) {
+          rtss[t] += tr;
+        }
+        else if(nu == 0) {
+          rtts[t] += tr;
+        }
+        else {
+          rss[t] += tr;
+        }
+      }
+    }
   }
+#ifdef TM_USE_OMP
+  } /* OpenMP parallel closing brace */
+#endif
 
-  sum /= ((double)3);
-
-  return sum;
+  reduce_slices(thread_res, res, 3*nt, nthreads);
+  for(int t = 0; t < nt; t++) {
+    ss[t] = res[t];
+    tss[t] = res[nt + t];
+    tts[t] = res[2*nt + t];
+  }
+  free(res);
+  free(thread_res);
+  return;
 }
 
-double calc_boundary_space_time_sq_plaq( void )
-{
-  int x;
-  int x_p_mu;
-  int x_p_nu;
-  int mu;
-  int nu;
-  su3* u_mu_x;
-  su3* u_nu_x_p_mu;
-  su3* u_mu_x_p_nu;
-  su3* u_nu_x;
-  su3 tmp1;
-  su3 tmp2;
-  double tr;
-  double sum = 0;
-
-  /* The space-time square for t=T-2 contributes. */
-  /* The space-time square for t=0 contributes. */
+double sf_weighted_plaquette(const double * const wss, const double * const wst) {
+  const int nt = g_nproc_t*T;
+  double * ss = (double*)malloc(2*nt*sizeof(double));
+  double * st = ss + nt;
+  double sum = 0.;
 
-  for( x=0; x<VOLUME; x++ )
-  for( mu=0; mu<4;  mu++ )
-  for( nu=0; nu<mu; nu++ )
-  if( ( ( g_t[ x ] == (T-2) ) & ( ( mu == 3 ) || ( nu == 3 ) ) ) ||
-      ( ( g_t[ x ] ==     0 ) & ( ( mu == 3 ) || ( nu == 3 ) ) ) )
-  {
-    x_p_mu = g_iup[ x ][ mu ];
-    x_p_nu = g_iup[ x ][ nu ];
-
-    u_mu_x      = &g_gauge_field[ x      ][ mu ];
-    u_nu_x_p_mu = &g_gauge_field[ x_p_mu ][ nu ];
-    u_mu_x_p_nu = &g_gauge_field[ x_p_nu ][ mu ];
-    u_nu_x      = &g_gauge_field[ x      ][ nu ];
+  sf_plaquette_slices(g_gauge_field, ss, st);
+  for(int t = 0; t < nt; t++) {
+    sum += wss[t]*ss[t] + wst[t]*st[t];
+  }
+  free(ss);
+  return(sum);
+}
 
-    _su3_times_su3( tmp1, *u_nu_x, *u_mu_x_p_nu );
-    _su3_times_su3( tmp2, *u_mu_x, *u_nu_x_p_mu );
-    _trace_su3_times_su3d( tr, tmp1, tmp2 );
+double sf_weighted_rectangle(const double * const wss, const double * const wtss, const double * const wtts) {
+  const int nt = g_nproc_t*T;
+  double * ss = (double*)malloc(3*nt*sizeof(double));
+  double * tss = ss + nt;
+  double * tts = ss + 2*nt;
+  double sum = 0.;
 
-    sum += tr;
+  sf_rectangle_slices(g_gauge_field, ss, tss, tts);
+  for(int t = 0; t < nt; t++) {
+    sum += wss[t]*ss[t] + wtss[t]*tss[t] + wtts[t]*tts[t];
   }
+  free(ss);
+  return(sum);
+}
 
-  sum /= ((double)3);
+void calc_sq_plaq_parts(double * const parts) {
+  const int nt = g_nproc_t*T;
+  double * ss = (double*)malloc(2*nt*sizeof(double));
+  double * st = ss + nt;
 
-  return sum;
+  for(int i = 0; i < 5; i++) {
+    parts[i] = 0.;
+  }
+  sf_plaquette_slices(g_gauge_field, ss, st);
+  for(int t = 0; t < nt; t++) {
+    parts[0] += ss[t] + st[t];
+    /* None of the forward plaquettes for t=T-1 contribute. */
+    /* None of the forward plaquettes for t=0 contribute. */
+    /* Also the space-time square for t=T-2 does not contribute. */
+    if(t != 0 && t != nt-1) {
+      parts[1] += ss[t];
+      if(t != nt-2) {
+        parts[1] += st[t];
+      }
+    }
+    /* We need the space-space plaquettes for t=T-1 and t=0. */
+    if(t == 0 || t == nt-1) {
+      parts[2] += ss[t];
+    }
+    /* The space-time square for t=T-2 and t=0 contributes. */
+    if(t == 0 || t == nt-2) {
+      parts[3] += st[t];
+    }
+    if(t == nt-1) {
+      parts[4] += st[t];
+    }
+  }
+  for(int i = 0; i < 5; i++) {
+    parts[i] /= ((double)3);
+  }
+  free(ss);
+  return;
 }
 
-double calc_wrapped_sq_plaq( void )
+double calc_sq_plaq( void )
 {
-  int x;
-  int x_p_mu;
-  int x_p_nu;
-  int mu;
-  int nu;
-  su3* u_mu_x;
-  su3* u_nu_x_p_mu;
-  su3* u_mu_x_p_nu;
-  su3* u_nu_x;
-  su3 tmp1;
-  su3 tmp2;
-  double tr;
-  double sum = 0;
-
-  for( x=0; x<VOLUME; x++ )
-  for( mu=0; mu<4;  mu++ )
-  for( nu=0; nu<mu; nu++ )
-  if( ( g_t[ x ] == (T-1) ) & ( ( mu == 3 ) || ( nu == 3 ) ) )
-  {
-    x_p_mu = g_iup[ x ][ mu ];
-    x_p_nu = g_iup[ x ][ nu ];
-
-    u_mu_x      = &g_gauge_field[ x      ][ mu ];
-    u_nu_x_p_mu = &g_gauge_field[ x_p_mu ][ nu ];
-    u_mu_x_p_nu = &g_gauge_field[ x_p_nu ][ mu ];
-    u_nu_x      = &g_gauge_field[ x      ][ nu ];
+  double parts[5];
+  calc_sq_plaq_parts(parts);
+  return parts[0];
+}
 
-    _su3_times_su3( tmp1, *u_nu_x, *u_mu_x_p_nu );
-    _su3_times_su3( tmp2, *u_mu_x, *u_nu_x_p_mu );
-    _trace_su3_times_su3d( tr, tmp1, tmp2 );
+double calc_bulk_sq_plaq( void )
+{
+  double parts[5];
+  calc_sq_plaq_parts(parts);
+  return parts[1];
+}
 
-    sum += tr;
-  }
+double calc_boundary_space_space_sq_plaq( void )
+{
+  double parts[5];
+  calc_sq_plaq_parts(parts);
+  return parts[2];
+}
 
-  sum /= ((double)3);
+double calc_boundary_space_time_sq_plaq( void )
+{
+  double parts[5];
+  calc_sq_plaq_parts(parts);
+  return parts[3];
+}
 
-  return sum;
+double calc_wrapped_sq_plaq( void )
+{
+  double parts[5];
+  calc_sq_plaq_parts(parts);
+  return parts[4];
 }
 
 double calc_rect_plaq( void )
 {
-  int x;
-  int x_p_mu;
-  int x_p_nu;
-  int x_p_nu_m_mu;
-  int x_m_mu;
-  int mu;
-  int nu;
-  su3* u_mu_x;
-  su3* u_nu_x_p_mu;
-  su3* u_mu_x_p_nu;
-  su3* u_mu_x_p_nu_m_mu;
-  su3* u_nu_x_m_mu;
-  su3* u_mu_x_m_mu;
-  su3 tmp1;
-  su3 tmp2;
-  su3 tmp3;
-  double tr;
+  const int nt = g_nproc_t*T;
+  double * ss = (double*)malloc(3*nt*sizeof(double));
+  double * tss = ss + nt;
+  double * tts = ss + 2*nt;
   double sum = 0;
 
-  for( x=0; x<VOLUME; x++ )
-  for( mu=0; mu<4;  mu++ )
-  for( nu=0; nu<4; nu++ )
-  if( mu != nu )
-  {
-    x_p_mu      = g_iup[ x      ][ mu ];
-    x_p_nu      = g_iup[ x      ][ nu ];
-    x_p_nu_m_mu = g_idn[ x_p_nu ][ mu ];
-    x_m_mu      = g_idn[ x      ][ mu ];
-
-    u_mu_x           = &g_gauge_field[ x           ][ mu ];
-    u_nu_x_p_mu      = &g_gauge_field[ x_p_mu      ][ nu ];
-    u_mu_x_p_nu      = &g_gauge_field[ x_p_nu      ][ mu ];
-    u_mu_x_p_nu_m_mu = &g_gauge_field[ x_p_nu_m_mu ][ mu ];
-    u_nu_x_m_mu      = &g_gauge_field[ x_m_mu      ][ nu ];
-    u_mu_x_m_mu      = &g_gauge_field[ x_m_mu      ][ mu ];
-
-    _su3_times_su3( tmp1, *u_mu_x_p_nu_m_mu, *u_mu_x_p_nu );
-    _su3_times_su3( tmp2, *u_nu_x_m_mu, tmp1 );
-
-    _su3_times_su3( tmp1, *u_mu_x, *u_nu_x_p_mu );
-    _su3_times_su3( tmp3, *u_mu_x_m_mu, tmp1 );
-
-    _trace_su3_times_su3d( tr, tmp2, tmp3 );
-
-    sum += tr;
+  sf_rectangle_slices(g_gauge_field, ss, tss, tts);
+  for(int t = 0; t < nt; t++) {
+    sum += ss[t] + tss[t] + tts[t];
   }
-
   sum /= ((double)3);
-
+  free(ss);
   return sum;
 }
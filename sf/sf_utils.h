@@ -2,6 +2,26 @@
 #ifndef _SF_UTILS_H
 #define _SF_UTILS_H
 
+#include "su3.h"
+
+/* Re tr of the plaquettes summed per global timeslice of the corner x, */
+/* separately for space-space (ss) and space-time (st) orientation; the */
+/* arrays have g_nproc_t*T entries and are summed over all processes    */
+void sf_plaquette_slices(su3 ** const gf, double * const ss, double * const st);
+
+/* the same for the 1x2 rectangles, with one step in mu and two in nu:  */
+/* space-space (ss), mu = 0 (tss) and nu = 0 (tts)                      */
+void sf_rectangle_slices(su3 ** const gf, double * const ss, double * const tss, double * const tts);
+
+/* sum of the per timeslice plaquettes (rectangles) of g_gauge_field */
+/* weighted with the tables w, one weight per global timeslice        */
+double sf_weighted_plaquette(const double * const wss, const double * const wst);
+double sf_weighted_rectangle(const double * const wss, const double * const wtss, const double * const wtts);
+
+/* total, bulk, boundary space-space, boundary space-time and wrapped */
+/* square plaquette terms below from a single sweep over the lattice  */
+void calc_sq_plaq_parts(double * const parts);
+
 /* This is the standard square plaquette term. */
 /* It calculates the sum over all squares on the lattice */
 /* and then divides by 3.  There is no coupling dependence. */
@@ -24,6 +24,9 @@
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "global.h"
 #include "su3.h"
 #include "gamma.h"
@@ -39,12 +42,167 @@
 #include "operator/Hopping_Matrix.h"
 #include "solver_field.h"
 #include "operator/D_psi.h"
+#include "xchange/xchange.h"
+#include "Msap.h"
 
 void dummy_Di(spinor * const P, spinor * const Q, const int i) {
   Block_D_psi(&block_list[i], P, Q);
   return;
 }
 
+static void (*sap_boundary_D[8])(spinor * const r, spinor * const s, su3 *u) =
+{boundary_D_0, boundary_D_1, boundary_D_2, boundary_D_3, boundary_D_4, boundary_D_5, boundary_D_6, boundary_D_7};
+
+/* site tables for the Schwarz smoothers, built on first use:                */
+/* sap_sites[blk*vol + i]    global index of block site i (block lexic order) */
+/* sap_sites_eo[blk*vol + i] the same, first the even then the odd sites      */
+/*                           in the order of copy_global_to_block_eo          */
+/* sap_face                  pairs (site, direction pm) for all sites on the  */
+/*                           faces of a block, sap_nface per block            */
+static int * sap_sites = NULL;
+static int * sap_sites_eo = NULL;
+static int * sap_face = NULL;
+static int sap_nface = 0, sap_nb_blocks = 0, sap_bvol = 0;
+
+static void init_sap_tables() {
+  const int vol = block_list[0].volume;
+  const int bl[4] = {block_list[0].BT, block_list[0].BLX, block_list[0].BLY, block_list[0].BLZ};
+  int c[4];
+
+  if(sap_sites != NULL && sap_nb_blocks == nb_blocks && sap_bvol == vol) return;
+  free(sap_sites);
+  free(sap_sites_eo);
+  free(sap_face);
+
+  sap_nface = 0;
+  for(int mu = 0; mu < 4; mu++) {
+    sap_nface += 2*vol/bl[mu];
+  }
+  sap_sites = malloc(nb_blocks*vol*sizeof(int));
+  sap_sites_eo = malloc(nb_blocks*vol*sizeof(int));
+  sap_face = malloc(2*nb_blocks*sap_nface*sizeof(int));
+  sap_nb_blocks = nb_blocks;
+  sap_bvol = vol;
+
+  for(int blk = 0; blk < nb_blocks; blk++) {
+    int * site = sap_sites + blk*vol, * site_eo = sap_sites_eo + blk*vol;
+    int * face = sap_face + 2*blk*sap_nface;
+    int i = 0, even = 0, odd = vol/2, nf = 0;
+    for(c[0] = 0; c[0] < bl[0]; c[0]++) {
+      for(c[1] = 0; c[1] < bl[1]; c[1]++) {
+        for(c[2] = 0; c[2] < bl[2]; c[2]++) {
+          for(c[3] = 0; c[3] < bl[3]; c[3]++) {
+            int ix = g_ipt[c[0] + block_list[blk].mpilocal_coordinate[0]*bl[0]]
+              [c[1] + block_list[blk].mpilocal_coordinate[1]*bl[1]]
+              [c[2] + block_list[blk].mpilocal_coordinate[2]*bl[2]]
+              [c[3] + block_list[blk].mpilocal_coordinate[3]*bl[3]];
+            site[i++] = ix;
+            if((c[0]+c[1]+c[2]+c[3])%2 == 0) site_eo[even++] = ix;
+            else site_eo[odd++] = ix;
+            for(int mu = 0; mu < 4; mu++) {
+              if(c[mu] == bl[mu] - 1) {
+                face[2*nf] = ix;
+                face[2*nf+1] = 2*mu;
+                nf++;
+              }
+              if(c[mu] == 0) {
+                face[2*nf] = ix;
+                face[2*nf+1] = 2*mu + 1;
+                nf++;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
+/* r = r - (D d) restricted to the hopping terms across the block faces */
+/* together with the block local residues this updates the global       */
+/* residue after a SAP half cycle without a full D_psi                  */
+static void sap_face_update(spinor * const r, spinor * const d) {
+#ifdef TM_USE_MPI
+  xchange_lexicfield(d);
+#endif
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int blk = 0; blk < nb_blocks; blk++) {
+    spinor ALIGN tmp;
+    spinor * s;
+    su3 * u;
+    int * face = sap_face + 2*blk*sap_nface;
+    for(int k = 0; k < sap_nface; k++) {
+      int ix = face[2*k], pm = face[2*k+1], mu = pm/2;
+      if(pm % 2 == 0) {
+        s = d + g_iup[ix][mu];
+        u = &g_gauge_field[ix][mu];
+      }
+      else {
+        s = d + g_idn[ix][mu];
+        u = &g_gauge_field[g_idn[ix][mu]][mu];
+      }
+      sap_boundary_D[pm](&tmp, s, u);
+      _vector_sub_assign(r[ix].s0, tmp.s0);
+      _vector_sub_assign(r[ix].s1, tmp.s1);
+      _vector_sub_assign(r[ix].s2, tmp.s2);
+      _vector_sub_assign(r[ix].s3, tmp.s3);
+    }
+  }
+  return;
+}
+
+static inline void sap_gather(spinor * const b, spinor * const r, const int * const site, const int n) {
+  for(int i = 0; i < n; i++) {
+    b[i] = r[site[i]];
+  }
+}
+
+static inline void sap_gather_32(spinor32 * const b, spinor * const r, const int * const site, const int n) {
+  for(int i = 0; i < n; i++) {
+    _Complex float * to = (_Complex float*) (b + i);
+    _Complex double * from = (_Complex double*) (r + site[i]);
+    for(int k = 0; k < 12; k++) {
+      to[k] = (_Complex float) from[k];
+    }
+  }
+}
+
+/* P += a, d = a and r = res (zero if res == NULL) on the given sites */
+static inline void sap_scatter(spinor * const P, spinor * const d, spinor * const r,
+                               spinor * const a, spinor * const res, const int * const site, const int n) {
+  for(int i = 0; i < n; i++) {
+    _Complex double * pp = (_Complex double*) (P + site[i]);
+    _Complex double * pd = (_Complex double*) (d + site[i]);
+    _Complex double * pr = (_Complex double*) (r + site[i]);
+    _Complex double * pa = (_Complex double*) (a + i);
+    _Complex double * pres = (res == NULL) ? NULL : (_Complex double*) (res + i);
+    for(int k = 0; k < 12; k++) {
+      pp[k] += pa[k];
+      pd[k] = pa[k];
+      pr[k] = (pres == NULL) ? 0. : pres[k];
+    }
+  }
+}
+
+static inline void sap_scatter_32(spinor * const P, spinor * const d, spinor * const r,
+                                  spinor32 * const a, spinor32 * const res, const int * const site, const int n) {
+  for(int i = 0; i < n; i++) {
+    _Complex double * pp = (_Complex double*) (P + site[i]);
+    _Complex double * pd = (_Complex double*) (d + site[i]);
+    _Complex double * pr = (_Complex double*) (r + site[i]);
+    _Complex float * pa = (_Complex float*) (a + i);
+    _Complex float * pres = (res == NULL) ? NULL : (_Complex float*) (res + i);
+    for(int k = 0; k < 12; k++) {
+      pp[k] += (_Complex double) pa[k];
+      pd[k] = (_Complex double) pa[k];
+      pr[k] = (pres == NULL) ? 0. : (_Complex double) pres[k];
+    }
+  }
+}
+
 #define _PTSWITCH(s) s
 #define _PSWITCH(s) s
 
@@ -104,54 +262,74 @@ void dummy_D1(spinor * const P, spinor * const Q) {
   return;
 }
 
+// SAP with block solves in double precision.
+// The global residue is computed once, afterwards it is updated with
+// the block local residues of mrblk and the hopping terms across the
+// block faces only. Blocks of one colour are distributed over the
+// threads, every thread has its own block work fields.
 void Msap(spinor * const P, spinor * const Q, const int Ncy, const int Niter) {
-  int blk, ncy = 0, eo, vol;
-  spinor * r, * a, * b;
+  const int vol = block_list[0].volume;
+  const int vols = vol + block_list[0].spinpad;
+  int nthreads = 1;
+  spinor * r, * d;
   double nrm;
-  spinor ** solver_field = NULL;
-  const int nr_sf = 6;
+  spinor ** solver_field = NULL, ** work = NULL;
+  const int nr_sf = 2, nr_wf = 5;
 
-  /* 
-   * here it would be probably better to get the working fields as a parameter 
-   * from the calling function
-   */
-  init_solver_field(&solver_field, VOLUME, nr_sf);
+#ifdef TM_USE_OMP
+  nthreads = omp_num_threads;
+#endif
+  init_sap_tables();
+  init_solver_field(&solver_field, VOLUMEPLUSRAND, nr_sf);
   r = solver_field[0];
-  a = solver_field[1];
-  b = solver_field[2];
-
-  for(ncy = 0; ncy < Ncy; ncy++) {
-    /* compute the global residue        */
-    /* this can be done more efficiently */
-    /* here only a naive implementation  */
-    for(eo = 0; eo < 2; eo++) {
-      D_psi(r, P);
-      diff(r, Q, r, VOLUME);
-      nrm = square_norm(r, VOLUME, 1);
-      if(g_proc_id == 0 && g_debug_level > 2 && eo == 1) {  /*  GG, was 1 */
-	printf("Msap: %d %1.3e\n", ncy, nrm);
-	fflush(stdout);
-      }
-      /* choose the even (odd) block */
+  d = solver_field[1];
+  // a, b and the three fields needed by mrblk for every thread
+  init_solver_field(&work, vols, nr_wf*nthreads);
 
-      /*blk = eolist[eo];*/
+  // make sure the block gauge fields are in the lexicographic
+  // order before the block operators are called in parallel
+  if(blk_gauge_eo) init_blocks_gaugefield();
 
-      for (blk = 0; blk < nb_blocks; blk++) {
-	if(block_list[blk].evenodd == eo) {
-	  vol = block_list[blk].volume;
+  D_psi(r, P);
+  diff(r, Q, r, VOLUME);
 
-	  /* get part of r corresponding to block blk into b */
-	  copy_global_to_block(b, r, blk);
-	  // does this work?? i.e. solver_field[3]
-	  mrblk(a, b, solver_field[3], Niter, 1.e-31, 1, vol, &dummy_Di, blk);
-
-	  /* add a up to full spinor P */
-	  add_block_to_global(P, a, blk);
-	}
+  for(int ncy = 0; ncy < Ncy; ncy++) {
+    for(int eo = 0; eo < 2; eo++) {
+      zero_spinor_field(d, VOLUME);
+#ifdef TM_USE_OMP
+#pragma omp parallel
+      {
+#endif
+      int thread = 0;
+#ifdef TM_USE_OMP
+      thread = omp_get_thread_num();
+#pragma omp for
+#endif
+      for(int blk = 0; blk < nb_blocks; blk++) {
+        if(block_list[blk].evenodd != eo) continue;
+        int * site = sap_sites + blk*vol;
+        spinor * a = work[nr_wf*thread], * b = work[nr_wf*thread + 1];
+        spinor * c = work[nr_wf*thread + 2];
+        sap_gather(b, r, site, vol);
+        mrblk(a, b, c, Niter, 1.e-31, 1, vol, &dummy_Di, blk);
+        // c holds the block local residue b - D_blk a
+        sap_scatter(P, d, r, a, c, site, vol);
+      }
+#ifdef TM_USE_OMP
+      } /* OpenMP closing brace */
+#endif
+      sap_face_update(r, d);
+      if(g_debug_level > 2 && eo == 1) {
+        nrm = square_norm(r, VOLUME, 1);
+        if(g_proc_id == 0) {
+          printf("Msap: %d %1.3e\n", ncy, nrm);
+          fflush(stdout);
+        }
       }
     }
   }
   finalize_solver(solver_field, nr_sf);
+  finalize_solver(work, nr_wf*nthreads);
   return;
 }
 
@@ -312,14 +490,16 @@ void Msap_eo_old(spinor * const P, spinor * const Q, const int Ncy, const int Ni
 
 
 void Msap_eo(spinor * const P, spinor * const Q, const int Ncy, const int Niter) {
-  int ncy = 0, vol, vols;
-  spinor * r, * a, * b;
+  int vol, vols, nthreads = 1;
+  spinor * r, * d;
   double nrm;
   double musave = g_mu;
   double kappasave = g_kappa;
   spinor ** solver_field = NULL;
-  // also get space for mrblk! 6 = 3+3
-  const int nr_sf = 6;
+  spinor32 ** work = NULL;
+  const int nr_sf = 2;
+  // even and odd parts of a and b and 3 fields for mrblk per thread
+  const int nr_wf = 7;
 
   if(kappa_Msap > 0) {
     g_kappa = kappa_Msap;
@@ -330,104 +510,104 @@ void Msap_eo(spinor * const P, spinor * const Q, const int Ncy, const int Niter)
     if(g_mu*musave < 0) g_mu *= -1.;
   }
   boundary(g_kappa);
-  /* 
-   * here it would be probably better to get the working fields as a parameter 
-   * from the calling function
-   */
+#ifdef TM_USE_OMP
+  nthreads = omp_num_threads;
+#endif
   vols = block_list[0].volume/2+block_list[0].spinpad;
   vol = block_list[0].volume/2;
 
-  init_solver_field(&solver_field, nb_blocks*2*vols, nr_sf);
+  init_sap_tables();
+  init_solver_field(&solver_field, VOLUMEPLUSRAND, nr_sf);
   r = solver_field[0];
-  a = solver_field[1];
-  b = solver_field[2];
-
-  int * blk_e_list = malloc(nb_blocks/2*sizeof(int));
-  int * blk_o_list = malloc(nb_blocks/2*sizeof(int));
-  int iblke = 0, iblko = 0;
-  for(int blk = 0; blk < nb_blocks; blk++) {
-    if (block_list[blk].evenodd == 0) {
-      blk_e_list[iblke] = blk;
-      iblke++;
-    }
-    else {
-      blk_o_list[iblko] = blk;
-      iblko++;
-    }
+  d = solver_field[1];
+  init_solver_field_32(&work, vols, nr_wf*nthreads);
+
+  // the block gauge fields must be in even/odd order
+  // before the block operators are called in parallel
+  if(blk_gauge_eo != 1) {
+    init_blocks_eo_gaugefield();
+    init_blocks_eo_gaugefield_32();
   }
 
-  for(ncy = 0; ncy < Ncy; ncy++) {
-    /* compute the global residue        */
-    /* this can be done more efficiently */
-    /* here only a naive implementation  */
+  /* the global residue is computed only once, afterwards */
+  /* it is updated block locally and on the block faces   */
+  D_psi(r, P);
+  diff(r, Q, r, VOLUME);
+
+  for(int ncy = 0; ncy < Ncy; ncy++) {
     for(int eo = 0; eo < 2; eo++) {
-      D_psi(r, P);
-      diff(r, Q, r, VOLUME);
-      nrm = square_norm(r, VOLUME, 1);
-      if(g_proc_id == 0 && g_debug_level > 2 && eo == 0) {
-	printf("Msap_eo: %d %1.3e mu = %e\n", ncy, nrm, g_mu/2./g_kappa);
-	fflush(stdout);
-      }
-      int * blk_eo_list;
-      if(eo == 0) {
-	blk_eo_list = blk_e_list;
-      }
-      else {
-	blk_eo_list = blk_o_list;
+      zero_spinor_field(d, VOLUME);
+#ifdef TM_USE_OMP
+#pragma omp parallel
+      {
+#endif
+      int thread = 0;
+#ifdef TM_USE_OMP
+      thread = omp_get_thread_num();
+#pragma omp for
+#endif
+      for(int blk = 0; blk < nb_blocks; blk++) {
+        if(block_list[blk].evenodd != eo) continue;
+        int * site_e = sap_sites_eo + blk*2*vol, * site_o = site_e + vol;
+        spinor32 * b_even = work[nr_wf*thread];
+        spinor32 * b_odd = work[nr_wf*thread + 1];
+        spinor32 * a_even = work[nr_wf*thread + 2];
+        spinor32 * a_odd = work[nr_wf*thread + 3];
+        // mrblk needs 3 consecutive solver fields
+        spinor32 * c = work[nr_wf*thread + 4];
+
+        /* get part of r corresponding to block blk into b_even and b_odd */
+        sap_gather_32(b_even, r, site_e, vol);
+        sap_gather_32(b_odd, r, site_o, vol);
+        if(g_c_sw > 0) {
+          assign_mul_one_sw_pm_imu_inv_block_32(EE, a_even, b_even, g_mu, &block_list[blk]);
+          Block_H_psi_32(&block_list[blk], a_odd, a_even, OE);
+          /* a_odd = b_odd - a_odd */
+          diff_32(a_odd, b_odd, a_odd, vol);
+
+          mrblk_32(b_odd, a_odd, c,
+                   Niter, 1.e-31, 1, vol, &Msw_plus_block_psi_32, blk);
+
+          Block_H_psi_32(&block_list[blk], b_even, b_odd, EO);
+          assign_32(a_odd, b_even, vol);
+          assign_mul_one_sw_pm_imu_inv_block_32(EE, b_even, a_odd, g_mu, &block_list[blk]);
+        }
+        else {
+          assign_mul_one_pm_imu_inv_32(a_even, b_even, +1., vol);
+          Block_H_psi_32(&block_list[blk], a_odd, a_even, OE);
+          /* a_odd = b_odd - a_odd */
+          diff_32(a_odd, b_odd, a_odd, vol);
+
+          mrblk_32(b_odd, a_odd, c,
+                   Niter, 1.e-31, 1, vol, &Mtm_plus_block_psi_32, blk);
+
+          Block_H_psi_32(&block_list[blk], b_even, b_odd, EO);
+          mul_one_pm_imu_inv_32(b_even, +1., vol);
+        }
+        /* a_even = a_even - b_even */
+        diff_32(a_even, a_even, b_even, vol);
+
+        /* add even and odd part up to full spinor P                   */
+        /* the even residue vanishes by construction, the odd residue  */
+        /* is the one of the Schur complement left in c by mrblk       */
+        sap_scatter_32(P, d, r, a_even, NULL, site_e, vol);
+        sap_scatter_32(P, d, r, b_odd, c, site_o, vol);
       }
-      /* choose the even (odd) block */
-      // rely on nested parallelism
-      // 
-      #ifdef TM_USE_OMP
-      # pragma omp parallel for 
-      #endif
-      for (int iblk = 0; iblk < nb_blocks/2; iblk++) {
-	int blk = blk_eo_list[iblk];
- 	spinor32 * b_even = (spinor32*) (b + blk*2*vols);
- 	spinor32 * b_odd = (spinor32*) (b +blk*2*vols + vols);
- 	spinor32 * a_even = (spinor32*) (a + blk*2*vols);
- 	spinor32 * a_odd = (spinor32*) (a + blk*2*vols + vols);
-        // mrblk needs 3 solver fields which we distribute according to the block number
-	spinor32 * c = (spinor32*) (solver_field[3] + blk*2*3*vols);
-
-	/* get part of r corresponding to block blk into b_even and b_odd */
-	copy_global_to_block_eo_32(b_even, b_odd, r, blk);
-	if(g_c_sw > 0) {
-	  assign_mul_one_sw_pm_imu_inv_block_32(EE, a_even, b_even, g_mu, &block_list[blk]);
-	  Block_H_psi_32(&block_list[blk], a_odd, a_even, OE);
-	  /* a_odd = b_odd - a_odd */
-	  diff_32(a_odd, b_odd, a_odd, vol);
-	  
-	  mrblk_32(b_odd, a_odd, c,
-		   Niter, 1.e-31, 1, vol, &Msw_plus_block_psi_32, blk);
-	  
-	  Block_H_psi_32(&block_list[blk], b_even, b_odd, EO);
-	  assign_32(c, b_even, vol);
-	  assign_mul_one_sw_pm_imu_inv_block_32(EE, b_even, c, g_mu, &block_list[blk]);
-	}
-	else {
-	  assign_mul_one_pm_imu_inv_32(a_even, b_even, +1., vol);
-	  Block_H_psi_32(&block_list[blk], a_odd, a_even, OE);
-	  /* a_odd = b_odd - a_odd */
-	  diff_32(a_odd, b_odd, a_odd, vol);
-	  
-	  mrblk_32(b_odd, a_odd, c, 
-		   Niter, 1.e-31, 1, vol, &Mtm_plus_block_psi_32, blk);
-	  
-	  Block_H_psi_32(&block_list[blk], b_even, b_odd, EO);
-	  mul_one_pm_imu_inv_32(b_even, +1., vol);
-	}
-	/* a_even = a_even - b_even */
-	diff_32(a_even, a_even, b_even, vol);
-	
-	/* add even and odd part up to full spinor P */
-	add_eo_block_32_to_global(P, a_even, b_odd, blk);
+#ifdef TM_USE_OMP
+      } /* OpenMP closing brace */
+#endif
+      sap_face_update(r, d);
+      if(g_debug_level > 2 && eo == 1) {
+        nrm = square_norm(r, VOLUME, 1);
+        if(g_proc_id == 0) {
+          printf("Msap_eo: %d %1.3e mu = %e\n", ncy, nrm, g_mu/2./g_kappa);
+          fflush(stdout);
+        }
       }
     }
   }
-  free(blk_e_list);
-  free(blk_o_list);
   finalize_solver(solver_field, nr_sf);
+  finalize_solver_32(work, nr_wf*nthreads);
   g_mu = musave;
   g_kappa = kappasave;
   boundary(g_kappa);
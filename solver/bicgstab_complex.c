@@ -41,8 +41,66 @@
 #include "linalg_eo.h"
 #include "start.h"
 #include "solver_field.h"
+#include "solver/orphaned_matrix_mult.h"
 #include "bicgstab_complex.h"
 
+#ifdef TM_USE_OMP
+/* the BiCGstab iteration, to be called by all threads from within one */
+/* parallel region with the orphaned operator f; the scalars are thread */
+/* local, but computed from reductions giving the same value everywhere */
+static int bicgstab_complex_orphaned(spinor * const P,spinor * const Q, const int max_iter, 
+                                     double eps_sq, const int rel_prec, 
+                                     const int N, matrix_mult f, spinor ** const solver_field) {
+  double err, squarenorm;
+  _Complex double rho0, rho1, omega, alpha, beta, nom, denom;
+  int i;
+  spinor * hatr = solver_field[0], * r = solver_field[1], * v = solver_field[2];
+  spinor * p = solver_field[3], * s = solver_field[4], * t = solver_field[5];
+
+  f(r, P);
+  diff_orphaned(p, Q, r, N);
+  assign_orphaned(r, p, N);
+  assign_orphaned(hatr, p, N);
+  rho0 = scalar_prod_orphaned(hatr, r, N, 1);
+  squarenorm = square_norm_orphaned(Q, N, 1);
+
+  for(i = 0; i < max_iter; i++){
+    err = square_norm_orphaned(r, N, 1);
+#pragma omp master
+    if(g_proc_id == g_stdio_proc && g_debug_level > 2) {
+      printf("%d %e\n", i, err);
+      fflush(stdout);
+    }
+  
+    if((((err <= eps_sq) && (rel_prec == 0)) || ((err <= eps_sq*squarenorm) && (rel_prec == 1))) && i>0) {
+      return(i);
+    }
+    f(v, p);
+    denom = scalar_prod_orphaned(hatr, v, N, 1);
+    alpha = rho0 / denom;
+    assign_orphaned(s, r, N);
+    assign_diff_mul_orphaned(s, v, alpha, N);
+    f(t, s);
+    omega = scalar_prod_orphaned(t,s, N, 1);
+    omega /= square_norm_orphaned(t, N, 1);
+    assign_add_mul_add_mul_orphaned(P, p, s, alpha, omega, N);
+    assign_orphaned(r, s, N);
+    assign_diff_mul_orphaned(r, t, omega, N);
+    rho1 = scalar_prod_orphaned(hatr, r, N, 1);
+    if(fabs(creal(rho1)) < 1.e-25 && fabs(cimag(rho1)) < 1.e-25) {
+      return(-1);
+    }
+    nom = alpha * rho1;
+    denom = omega * rho0;
+    beta = nom / denom;
+    omega = -omega;
+    assign_mul_bra_add_mul_ket_add_orphaned(p, v, r, omega, beta, N);
+    rho0 = rho1;
+  }
+  return -1;
+}
+#endif
+
 /* P inout (guess for the solving spinor)
    Q input
 */
@@ -69,6 +127,20 @@ int bicgstab_complex(spinor * const P,spinor * const Q, const int max_iter,
   s = solver_field[4];
   t = solver_field[5];
 
+#ifdef TM_USE_OMP
+  matrix_mult fo = orphaned_matrix_mult(f);
+  if(fo != NULL) {
+#pragma omp parallel
+    {
+      int it = bicgstab_complex_orphaned(P, Q, max_iter, eps_sq, rel_prec, N, fo, solver_field);
+#pragma omp master
+      i = it;
+    }
+    finalize_solver(solver_field, nr_sf);
+    return(i);
+  }
+#endif
+
   f(r, P);
   diff(p, Q, r, N);
   assign(r, p, N);
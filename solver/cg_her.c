@@ -53,12 +53,70 @@
 #include "linalg_eo.h"
 #include "start.h"
 #include "gettime.h"
+#include "profiler.h"
 #include "solver/matrix_mult_typedef.h"
 #include "sub_low_ev.h"
 #include "poly_precon.h"
 #include "solver_field.h"
+#include "solver/orphaned_matrix_mult.h"
 #include "cg_her.h"
 
+#ifdef TM_USE_OMP
+/* the CG iteration, to be called by all threads from within one parallel */
+/* region with the orphaned operator f; the scalars are thread local, but  */
+/* computed from reductions which give the same value on all threads      */
+static int cg_her_orphaned(spinor * const P, spinor * const Q, const int max_iter, 
+                           double eps_sq, const int rel_prec, const int N, matrix_mult f,
+                           spinor ** const solver_field, const double squarenorm) {
+  double normsq, pro, err, alpha_cg, beta_cg;
+  int iteration;
+  spinor * sf0 = solver_field[0], * sf1 = solver_field[1], * sf2 = solver_field[2], * stmp;
+
+  f(sf0, P);
+  diff_orphaned(sf1, Q, sf0, N);
+  assign_orphaned(sf2, sf1, N);
+  normsq = square_norm_orphaned(sf1, N, 1);
+
+  /* main loop */
+  for(iteration = 1; iteration <= max_iter; iteration++) {
+    f(sf0, sf2);
+    pro = scalar_prod_r_orphaned(sf2, sf0, N, 1);
+    alpha_cg = normsq / pro;
+    assign_add_mul_r_orphaned(P, sf2, alpha_cg, N);
+    err = assign_mul_add_r_and_square_orphaned(sf0, -alpha_cg, sf1, N, 1);
+
+#pragma omp master
+    if(g_proc_id == g_stdio_proc && g_debug_level > 2) {
+      printf("CG: iterations: %d res^2 %e\n", iteration, err);
+      fflush(stdout);
+    }
+
+    if (((err <= eps_sq) && (rel_prec == 0)) || ((err <= eps_sq*squarenorm) && (rel_prec == 1))) {
+      break;
+    }
+#ifdef _USE_HALFSPINOR
+    if(((err*err <= eps_sq) && (rel_prec == 0)) || ((err*err <= eps_sq*squarenorm) && (rel_prec == 1))) {
+#pragma omp single
+      {
+        g_sloppy_precision = 1;
+        if(g_debug_level > 2 && g_proc_id == g_stdio_proc && g_sloppy_precision_flag == 1) {
+          printf("sloppy precision on\n"); fflush( stdout);
+        }
+      }
+    }
+#endif
+
+    beta_cg = err / normsq;
+    assign_mul_add_r_orphaned(sf2, beta_cg, sf0, N);
+    stmp = sf0;
+    sf0 = sf1;
+    sf1 = stmp;
+    normsq = err;
+  }
+  return(iteration);
+}
+#endif
+
 int cg_her(spinor * const P, spinor * const Q, const int max_iter, 
            double eps_sq, const int rel_prec, const int N, matrix_mult f) {
 
@@ -70,6 +128,9 @@ int cg_her(spinor * const P, spinor * const Q, const int max_iter,
   static int cg_init = 0;
   spinor * stmp;
   const int nr_sf = 3;
+#ifdef TM_USE_OMP
+  matrix_mult fo = orphaned_matrix_mult(f);
+#endif
 
   if(N == VOLUME) {
     init_solver_field(&solver_field, VOLUMEPLUSRAND, nr_sf);
@@ -78,52 +139,67 @@ int cg_her(spinor * const P, spinor * const Q, const int max_iter,
     init_solver_field(&solver_field, VOLUMEPLUSRAND/2, nr_sf); 
   }
   /* initialize residue r and search vector p */
+  prof_begin("cg_her");
   atime = gettime();
   squarenorm = square_norm(Q, N, 1);
 
-  f(solver_field[0], P);  
+#ifdef TM_USE_OMP
+  if(fo != NULL) {
+#pragma omp parallel
+    {
+      int it = cg_her_orphaned(P, Q, max_iter, eps_sq, rel_prec, N, fo, solver_field, squarenorm);
+#pragma omp master
+      iteration = it;
+    }
+  }
+  else {
+#else
+  {
+#endif
+    f(solver_field[0], P);  
 
-  diff(solver_field[1], Q, solver_field[0], N);
-  assign(solver_field[2], solver_field[1], N);
-  normsq=square_norm(solver_field[1], N, 1);
+    diff(solver_field[1], Q, solver_field[0], N);
+    assign(solver_field[2], solver_field[1], N);
+    normsq=square_norm(solver_field[1], N, 1);
 
-  /* main loop */
-  for(iteration = 1; iteration <= max_iter; iteration++) {
-    f(solver_field[0], solver_field[2]);
-    pro = scalar_prod_r(solver_field[2], solver_field[0], N, 1);
-    alpha_cg = normsq / pro;
-    assign_add_mul_r(P, solver_field[2], alpha_cg, N);
+    /* main loop */
+    for(iteration = 1; iteration <= max_iter; iteration++) {
+      f(solver_field[0], solver_field[2]);
+      pro = scalar_prod_r(solver_field[2], solver_field[0], N, 1);
+      alpha_cg = normsq / pro;
+      assign_add_mul_r(P, solver_field[2], alpha_cg, N);
 
 #if (defined SSE2 || defined SSE3)
-    assign_mul_add_r(solver_field[0], -alpha_cg, solver_field[1], N);
-    err = square_norm(solver_field[0], N, 1);
+      assign_mul_add_r(solver_field[0], -alpha_cg, solver_field[1], N);
+      err = square_norm(solver_field[0], N, 1);
 #else
-    err = assign_mul_add_r_and_square(solver_field[0], -alpha_cg, solver_field[1], N, 1);
+      err = assign_mul_add_r_and_square(solver_field[0], -alpha_cg, solver_field[1], N, 1);
 #endif
 
-    if(g_proc_id == g_stdio_proc && g_debug_level > 2) {
-      printf("CG: iterations: %d res^2 %e\n", iteration, err);
-      fflush(stdout);
-    }
+      if(g_proc_id == g_stdio_proc && g_debug_level > 2) {
+        printf("CG: iterations: %d res^2 %e\n", iteration, err);
+        fflush(stdout);
+      }
 
-    if (((err <= eps_sq) && (rel_prec == 0)) || ((err <= eps_sq*squarenorm) && (rel_prec == 1))) {
-      break;
-    }
+      if (((err <= eps_sq) && (rel_prec == 0)) || ((err <= eps_sq*squarenorm) && (rel_prec == 1))) {
+        break;
+      }
 #ifdef _USE_HALFSPINOR
-    if(((err*err <= eps_sq) && (rel_prec == 0)) || ((err*err <= eps_sq*squarenorm) && (rel_prec == 1))) {
-      g_sloppy_precision = 1;
-      if(g_debug_level > 2 && g_proc_id == g_stdio_proc && g_sloppy_precision_flag == 1) {
-        printf("sloppy precision on\n"); fflush( stdout);
+      if(((err*err <= eps_sq) && (rel_prec == 0)) || ((err*err <= eps_sq*squarenorm) && (rel_prec == 1))) {
+        g_sloppy_precision = 1;
+        if(g_debug_level > 2 && g_proc_id == g_stdio_proc && g_sloppy_precision_flag == 1) {
+          printf("sloppy precision on\n"); fflush( stdout);
+        }
       }
-    }
 #endif
 
-    beta_cg = err / normsq;
-    assign_mul_add_r(solver_field[2], beta_cg, solver_field[0], N);
-    stmp = solver_field[0];
-    solver_field[0] = solver_field[1];
-    solver_field[1] = stmp;
-    normsq = err;
+      beta_cg = err / normsq;
+      assign_mul_add_r(solver_field[2], beta_cg, solver_field[0], N);
+      stmp = solver_field[0];
+      solver_field[0] = solver_field[1];
+      solver_field[1] = stmp;
+      normsq = err;
+    }
   }
   etime = gettime();
   g_sloppy_precision = save_sloppy;
@@ -138,6 +214,7 @@ int cg_her(spinor * const P, spinor * const Q, const int max_iter,
     }
   }
   finalize_solver(solver_field, nr_sf);
+  prof_end("cg_her", flops*1.0e6, 0.);
   if(iteration > max_iter) return(-1);
   return(iteration);
 }
@@ -45,8 +45,10 @@
 #include "linalg_eo.h"
 #include "start.h"
 #include "gettime.h"
+#include "profiler.h"
 #include "solver/solver.h"
 #include "solver_field.h"
+#include "solver/orphaned_matrix_mult.h"
 #include "cg_mms_tm.h"
 #include <io/params.h>
 
@@ -61,6 +63,84 @@ extern int index_start;
 static void init_mms_tm(const unsigned int nr, const unsigned int N);
 static void free_mms_tm();
 
+#ifdef TM_USE_OMP
+/* the multi-shift CG iteration, to be called by all threads from within one   */
+/* parallel region with the orphaned operator f; the coefficients of the shifts */
+/* are updated by a single thread, all other scalars are thread local           */
+static int cg_mms_tm_orphaned(spinor ** const P, solver_pm_t * solver_pm, matrix_mult f,
+                              spinor ** const solver_field, const double squarenorm,
+                              double * cgmms_reached_prec) {
+  double normsq, pro, err;
+  int iteration, N = solver_pm->sdim, no_shifts = solver_pm->no_shifts;
+
+  normsq = squarenorm;
+  for(iteration = 0; iteration < solver_pm->max_iter; iteration++) {
+
+    f(solver_field[2], solver_field[1]);
+    assign_add_mul_r_orphaned(solver_field[2], solver_field[1], sigma[0], N);
+    pro = scalar_prod_r_orphaned(solver_field[1], solver_field[2], N, 1);
+
+#pragma omp single
+    {
+      double alpham1 = alphas[0];
+      alphas[0] = normsq/pro;
+      for(int im = 1; im < no_shifts; im++) {
+        double gamma = zita[im]*alpham1/(alphas[0]*betas[0]*(1.-zita[im]/zitam1[im]) 
+                                         + alpham1*(1.+sigma[im]*alphas[0]));
+        zitam1[im] = zita[im];
+        zita[im] = gamma;
+        alphas[im] = alphas[0]*zita[im]/zitam1[im];
+      }
+    }
+    for(int im = 1; im < no_shifts; im++) {
+      assign_add_mul_r_orphaned(P[im], ps_mms_solver[im-1], alphas[im], N); 
+    }
+    /* shift removal as in cg_mms_tm, for the last shift only */
+    if(iteration > 0 && (iteration % 20 == 0) && no_shifts > 1) {
+      double sn = square_norm_orphaned(ps_mms_solver[no_shifts-2], N, 1);
+      if(alphas[no_shifts-1]*alphas[no_shifts-1]*sn <= solver_pm->squared_solver_prec) {
+        no_shifts--;
+#pragma omp master
+        if(g_debug_level > 2 && g_proc_id == 0) {
+          printf("# CGMMS: at iteration %d removed one shift, %d remaining\n", iteration, no_shifts);
+        }
+      }
+    }
+
+    assign_add_mul_r_orphaned(P[0], solver_field[1],  alphas[0], N);
+    assign_add_mul_r_orphaned(solver_field[0], solver_field[2], -alphas[0], N);
+    err = square_norm_orphaned(solver_field[0], N, 1);
+
+#pragma omp master
+    if(g_debug_level > 2 && g_proc_id == g_stdio_proc) {
+      printf("# CGMMS iteration: %d residue: %g\n", iteration, err); fflush( stdout );
+    }
+
+    if( ((err <= solver_pm->squared_solver_prec) && (solver_pm->rel_prec == 0)) ||
+        ((err <= solver_pm->squared_solver_prec*squarenorm) && (solver_pm->rel_prec > 0)) ||
+        (iteration == solver_pm->max_iter -1) ) {
+#pragma omp master
+      *cgmms_reached_prec = err;
+      break;
+    }
+
+#pragma omp single
+    {
+      betas[0] = err/normsq;
+      for(int im = 1; im < no_shifts; im++) {
+        betas[im] = betas[0]*zita[im]*alphas[im]/(zitam1[im]*alphas[0]);
+      }
+    }
+    assign_mul_add_r_orphaned(solver_field[1], betas[0], solver_field[0], N);
+    normsq = err;
+    for(int im = 1; im < no_shifts; im++) {
+      assign_mul_add_mul_r_orphaned(ps_mms_solver[im-1], solver_field[0], betas[im], zita[im], N);
+    }
+  }
+  return(iteration);
+}
+#endif
+
 /* P output = solution , Q input = source */
 int cg_mms_tm(spinor ** const P, spinor * const Q,
 		 solver_pm_t * solver_pm, double * cgmms_reached_prec) {
@@ -71,7 +151,11 @@ int cg_mms_tm(spinor ** const P, spinor * const Q,
   spinor ** solver_field = NULL;
   double atime, etime;
   const int nr_sf = 3;
+#ifdef TM_USE_OMP
+  matrix_mult fo = orphaned_matrix_mult(solver_pm->M_psi);
+#endif
 
+  prof_begin("cg_mms_tm");
   atime = gettime();
   if(solver_pm->sdim == VOLUME) {
     init_solver_field(&solver_field, VOLUMEPLUSRAND, nr_sf);
@@ -108,84 +192,98 @@ int cg_mms_tm(spinor ** const P, spinor * const Q,
   assign(solver_field[1], Q, N);
   normsq = squarenorm;
 
-  /* main loop */
-  for(iteration = 0; iteration < solver_pm->max_iter; iteration++) {
+#ifdef TM_USE_OMP
+  if(fo != NULL) {
+#pragma omp parallel
+    {
+      int it = cg_mms_tm_orphaned(P, solver_pm, fo, solver_field, squarenorm, cgmms_reached_prec);
+#pragma omp master
+      iteration = it;
+    }
+  }
+  else {
+#else
+  {
+#endif
+    /* main loop */
+    for(iteration = 0; iteration < solver_pm->max_iter; iteration++) {
 
-    /*   Q^2*p and then (p,Q^2*p)  */
-    solver_pm->M_psi(solver_field[2], solver_field[1]);
-    // add the zero's shift
-    assign_add_mul_r(solver_field[2], solver_field[1], sigma[0], N);
-    pro = scalar_prod_r(solver_field[1], solver_field[2], N, 1);
+      /*   Q^2*p and then (p,Q^2*p)  */
+      solver_pm->M_psi(solver_field[2], solver_field[1]);
+      // add the zero's shift
+      assign_add_mul_r(solver_field[2], solver_field[1], sigma[0], N);
+      pro = scalar_prod_r(solver_field[1], solver_field[2], N, 1);
 
-    /* For the update of the coeff. of the shifted pol. we need alphas[0](i-1) and alpha_cg(i).
-       This is the reason why we need this double definition of alpha */
-    alpham1 = alphas[0];
+      /* For the update of the coeff. of the shifted pol. we need alphas[0](i-1) and alpha_cg(i).
+         This is the reason why we need this double definition of alpha */
+      alpham1 = alphas[0];
 
-    /* Compute alphas[0](i+1) */
-    alphas[0] = normsq/pro;
-    for(int im = 1; im < no_shifts; im++) {
+      /* Compute alphas[0](i+1) */
+      alphas[0] = normsq/pro;
+      for(int im = 1; im < no_shifts; im++) {
 
-      /* Now gamma is a temp variable that corresponds to zita(i+1) */ 
-      gamma = zita[im]*alpham1/(alphas[0]*betas[0]*(1.-zita[im]/zitam1[im]) 
-				+ alpham1*(1.+sigma[im]*alphas[0]));
-
-      // Now zita(i-1) is put equal to the old zita(i)
-      zitam1[im] = zita[im];
-      // Now zita(i+1) is updated 
-      zita[im] = gamma;
-      // Update of alphas(i) = alphas[0](i)*zita(i+1)/zita(i) 
-      alphas[im] = alphas[0]*zita[im]/zitam1[im];
-
-      // Compute xs(i+1) = xs(i) + alphas(i)*ps(i) 
-      assign_add_mul_r(P[im], ps_mms_solver[im-1], alphas[im], N); 
-      // in the CG the corrections are decreasing with the iteration number increasing
-      // therefore, we can remove shifts when the norm of the correction vector
-      // falls below a threshold
-      // this is useful for computing time and needed, because otherwise
-      // zita might get smaller than DOUBLE_EPS and, hence, zero
-      if(iteration > 0 && (iteration % 20 == 0) && (im == no_shifts-1)) {
-	double sn = square_norm(ps_mms_solver[im-1], N, 1);
-	if(alphas[no_shifts-1]*alphas[no_shifts-1]*sn <= solver_pm->squared_solver_prec) {
-	  no_shifts--;
-	  if(g_debug_level > 2 && g_proc_id == 0) {
-	    printf("# CGMMS: at iteration %d removed one shift, %d remaining\n", iteration, no_shifts);
-      	  }
-	}
+        /* Now gamma is a temp variable that corresponds to zita(i+1) */ 
+        gamma = zita[im]*alpham1/(alphas[0]*betas[0]*(1.-zita[im]/zitam1[im]) 
+  				+ alpham1*(1.+sigma[im]*alphas[0]));
+
+        // Now zita(i-1) is put equal to the old zita(i)
+        zitam1[im] = zita[im];
+        // Now zita(i+1) is updated 
+        zita[im] = gamma;
+        // Update of alphas(i) = alphas[0](i)*zita(i+1)/zita(i) 
+        alphas[im] = alphas[0]*zita[im]/zitam1[im];
+
+        // Compute xs(i+1) = xs(i) + alphas(i)*ps(i) 
+        assign_add_mul_r(P[im], ps_mms_solver[im-1], alphas[im], N); 
+        // in the CG the corrections are decreasing with the iteration number increasing
+        // therefore, we can remove shifts when the norm of the correction vector
+        // falls below a threshold
+        // this is useful for computing time and needed, because otherwise
+        // zita might get smaller than DOUBLE_EPS and, hence, zero
+        if(iteration > 0 && (iteration % 20 == 0) && (im == no_shifts-1)) {
+  	double sn = square_norm(ps_mms_solver[im-1], N, 1);
+  	if(alphas[no_shifts-1]*alphas[no_shifts-1]*sn <= solver_pm->squared_solver_prec) {
+  	  no_shifts--;
+  	  if(g_debug_level > 2 && g_proc_id == 0) {
+  	    printf("# CGMMS: at iteration %d removed one shift, %d remaining\n", iteration, no_shifts);
+        	  }
+  	}
+        }
       }
-    }
     
-    /*  Compute x_(i+1) = x_i + alphas[0](i+1) p_i    */
-    assign_add_mul_r(P[0], solver_field[1],  alphas[0], N);
-    /*  Compute r_(i+1) = r_i - alphas[0](i+1) Qp_i   */
-    assign_add_mul_r(solver_field[0], solver_field[2], -alphas[0], N);
+      /*  Compute x_(i+1) = x_i + alphas[0](i+1) p_i    */
+      assign_add_mul_r(P[0], solver_field[1],  alphas[0], N);
+      /*  Compute r_(i+1) = r_i - alphas[0](i+1) Qp_i   */
+      assign_add_mul_r(solver_field[0], solver_field[2], -alphas[0], N);
 
-    /* Check whether the precision eps_sq is reached */
+      /* Check whether the precision eps_sq is reached */
 
-    err = square_norm(solver_field[0], N, 1);
+      err = square_norm(solver_field[0], N, 1);
 
-    if(g_debug_level > 2 && g_proc_id == g_stdio_proc) {
-      printf("# CGMMS iteration: %d residue: %g\n", iteration, err); fflush( stdout );
-    }
+      if(g_debug_level > 2 && g_proc_id == g_stdio_proc) {
+        printf("# CGMMS iteration: %d residue: %g\n", iteration, err); fflush( stdout );
+      }
 
-    if( ((err <= solver_pm->squared_solver_prec) && (solver_pm->rel_prec == 0)) ||
-        ((err <= solver_pm->squared_solver_prec*squarenorm) && (solver_pm->rel_prec > 0)) ||
-        (iteration == solver_pm->max_iter -1) ) {
-      /* FIXME temporary output of precision until a better solution can be found */
-      *cgmms_reached_prec = err;
-      break;
-    }
+      if( ((err <= solver_pm->squared_solver_prec) && (solver_pm->rel_prec == 0)) ||
+          ((err <= solver_pm->squared_solver_prec*squarenorm) && (solver_pm->rel_prec > 0)) ||
+          (iteration == solver_pm->max_iter -1) ) {
+        /* FIXME temporary output of precision until a better solution can be found */
+        *cgmms_reached_prec = err;
+        break;
+      }
 
-    /* Compute betas[0](i+1) = (r(i+1),r(i+1))/(r(i),r(i))
-       Compute p(i+1) = r(i+1) + beta(i+1)*p(i)  */
-    betas[0] = err/normsq;
-    assign_mul_add_r(solver_field[1], betas[0], solver_field[0], N);
-    normsq = err;
+      /* Compute betas[0](i+1) = (r(i+1),r(i+1))/(r(i),r(i))
+         Compute p(i+1) = r(i+1) + beta(i+1)*p(i)  */
+      betas[0] = err/normsq;
+      assign_mul_add_r(solver_field[1], betas[0], solver_field[0], N);
+      normsq = err;
 
-    /* Compute betas(i+1) = betas[0](i+1)*(zita(i+1)*alphas(i))/(zita(i)*alphas[0](i))
-       Compute ps(i+1) = zita(i+1)*r(i+1) + betas(i+1)*ps(i)  */
-    for(int im = 1; im < no_shifts; im++) {
-      betas[im] = betas[0]*zita[im]*alphas[im]/(zitam1[im]*alphas[0]);
-      assign_mul_add_mul_r(ps_mms_solver[im-1], solver_field[0], betas[im], zita[im], N);
+      /* Compute betas(i+1) = betas[0](i+1)*(zita(i+1)*alphas(i))/(zita(i)*alphas[0](i))
+         Compute ps(i+1) = zita(i+1)*r(i+1) + betas(i+1)*ps(i)  */
+      for(int im = 1; im < no_shifts; im++) {
+        betas[im] = betas[0]*zita[im]*alphas[im]/(zitam1[im]*alphas[0]);
+        assign_mul_add_mul_r(ps_mms_solver[im-1], solver_field[0], betas[im], zita[im], N);
+      }
     }
   }
   etime = gettime();
@@ -197,6 +295,7 @@ int cg_mms_tm(spinor ** const P, spinor * const Q,
   }
   
   finalize_solver(solver_field, nr_sf);
+  prof_end("cg_mms_tm", 0., 0.);
   return(iteration);
 }
 
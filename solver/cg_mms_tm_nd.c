@@ -45,6 +45,7 @@
 #include "linalg_eo.h"
 #include "start.h"
 #include "gettime.h"
+#include "profiler.h"
 #include "solver/solver.h"
 #include "solver_field.h"
 #include "cg_mms_tm_nd.h"
@@ -72,6 +73,7 @@ int cg_mms_tm_nd(spinor ** const Pup, spinor ** const Pdn,
   double atime, etime;
   const int nr_sf = 4;
 
+  prof_begin("cg_mms_tm_nd");
   atime = gettime();
   if(solver_pm->sdim == VOLUME) {
     init_solver_field(&solver_field, VOLUMEPLUSRAND, 2*nr_sf);
@@ -212,6 +214,7 @@ int cg_mms_tm_nd(spinor ** const Pup, spinor ** const Pdn,
   }
   
   finalize_solver(solver_field, 2*nr_sf);
+  prof_end("cg_mms_tm_nd", 0., 0.);
   return(iteration);
 }
 
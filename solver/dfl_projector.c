@@ -52,6 +52,7 @@
 #include "solver_field.h"
 #include "solver.h"
 #include "dfl_projector.h"
+#include "little_mg.h"
 
 int dfl_sloppy_prec = 1;
 int init_dfl_projector = 0;
@@ -72,6 +73,11 @@ const int dfl_work_size = 16;
 _Complex double *work[16];
 int cumiter_lgcr = 0;
 
+/* constants for the blas calls */
+static int ONE = 1;
+static _Complex double CONE = 1.0, CZERO = 0.0;
+static _Complex float CONE_32 = 1.0, CZERO_32 = 0.0;
+
 
 static void alloc_dfl_projector();
 
@@ -90,7 +96,6 @@ void project(spinor * const out, spinor * const in) {
   int gcr32 = 1;
   int little_m = little_gmres_m_parameter;
   int little_max_iter = little_solver_max_iter;
-  int vol = block_list[0].volume;
   _Complex double * v, * w;
   double prec;
   evenodd = little_evenodd;
@@ -118,11 +123,12 @@ void project(spinor * const out, spinor * const in) {
     (v[j]) = 0.0;
   }
 
+  /* all g_N_s inner products per block in one pass over psi */
+  blocks_restrict(inprod, psi);
   for (int j = 0; j < g_N_s; j++) {/*loop over block.basis */
     i_o = 0;
     i_e = 0;
     for(int i = 0; i < nb_blocks; i++) {
-      inprod[j + i*g_N_s]  = scalar_prod(block_list[i].basis[j], psi[i], vol, 0);
       inprod32[j + i*g_N_s]  = (_Complex float)inprod[j + i*g_N_s];
       if(evenodd) {
         if (block_list[i].evenodd == 0) {
@@ -190,7 +196,7 @@ void project(spinor * const out, spinor * const in) {
     else {
       if(gcr32) {
         iter = fgmres4complex_32(invvec32, inprod32, little_m, little_max_iter, prec, 1, 
-                             nb_blocks * g_N_s, 1, nb_blocks * 9 * g_N_s, 0, &little_D_32);
+                             nb_blocks * g_N_s, 1, nb_blocks * 9 * g_N_s, little_mg_threelevel, &little_D_32);
         
         for (int j = 0; j < g_N_s*nb_blocks*9; j++) {
           invvec[j] = (_Complex double) invvec32[j];
@@ -198,7 +204,7 @@ void project(spinor * const out, spinor * const in) {
       }
       else {
         iter = gcr4complex(invvec, inprod, little_m, little_max_iter, prec, 1, 
-                           nb_blocks * g_N_s, 1, nb_blocks * 9 * g_N_s, 0, &little_D);
+                           nb_blocks * g_N_s, 1, nb_blocks * 9 * g_N_s, little_mg_threelevel, &little_D);
       }
       if(g_proc_id == 0 && g_debug_level > 0) {
         printf("lgcr/lfgmres number of iterations %d (no LittleLittleD)\n", iter);
@@ -260,14 +266,7 @@ void project(spinor * const out, spinor * const in) {
   cumiter_lgcr += iter;
 
   /* sum up */
-  for(int i = 0 ; i < nb_blocks ; i++) {
-    mul(psi[i], invvec[i*g_N_s], block_list[i].basis[0], vol);
-  }
-  for(int j = 1; j < g_N_s; j++) {
-    for(int i = 0 ; i < nb_blocks ; i++) {
-      assign_add_mul(psi[i], block_list[i].basis[j], invvec[i*g_N_s + j], vol);
-    }
-  }
+  blocks_prolongate(psi, invvec);
 
   /* reconstruct global field */
   reconstruct_global_field_GEN(out, psi, nb_blocks);
@@ -329,9 +328,6 @@ void free_dfl_projector() {
 
 /* this is phi_k (phi_k, in) */
 void project2(spinor * const out, spinor * const in) {
-  int i, j; 
-  int vol = block_list[0].volume;
-
   if(init_dfl_projector == 0) {
     alloc_dfl_projector();
   }
@@ -339,16 +335,10 @@ void project2(spinor * const out, spinor * const in) {
   split_global_field_GEN(psi, in, nb_blocks);
 
   /* compute inner product */
-  for (j = 0; j < g_N_s; j++) {
-    /*loop over block.basis */
-    for(i = 0 ; i < nb_blocks ; i++)  inprod[j + i*g_N_s]  = scalar_prod(block_list[i].basis[j], psi[i], vol, 0);
-  }
+  blocks_restrict(inprod, psi);
 
   /* sum up */
-  for(i = 0 ; i < nb_blocks ; i++) mul(psi[i], inprod[i*g_N_s], block_list[i].basis[0], vol);
-  for(j = 1; j < g_N_s; j++) {
-    for(i = 0 ; i < nb_blocks ; i++) assign_add_mul(psi[i], block_list[i].basis[j], inprod[i*g_N_s + j], vol);
-  }
+  blocks_prolongate(psi, inprod);
 
   /* reconstruct global field */
   reconstruct_global_field_GEN(out, psi, nb_blocks);
@@ -410,6 +400,7 @@ void D_project_right(spinor * const out, spinor * const in) {
 /* out = |phi_k> A^{-1}_kl <phi_l|in> */
 void little_project(_Complex double * const out, _Complex double * const in, const int  N) {
   int i, j;
+  int m = nb_blocks*N, n = N, ld = nb_blocks*9*g_N_s;
   static _Complex double *phi;
   static _Complex double *psi;
 
@@ -421,9 +412,8 @@ void little_project(_Complex double * const out, _Complex double * const in, con
   psi = work[3];
 
   /* NOTE IS THIS REALLY NECESSARY/CORRECT? */
-  for(i = 0; i < N; i++) {
-    phi[i] = lscalar_prod(little_dfl_fields[i], in, nb_blocks*N, 0);
-  }
+  /* all N inner products in one pass over in */
+  _FT(zgemv)("C", &m, &n, &CONE, little_dfl_fields[0], &ld, in, &ONE, &CZERO, phi, &ONE, 1);
 
 #ifdef TM_USE_MPI
   MPI_Allreduce(phi, psi, N, MPI_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
@@ -439,10 +429,7 @@ void little_project(_Complex double * const out, _Complex double * const in, con
     }
   }
 
-  lmul(out, phi[0], little_dfl_fields[0], nb_blocks*N);
-  for(i = 1; i < N; i++) {
-    lassign_add_mul(out, little_dfl_fields[i], phi[i], nb_blocks*N);
-  }
+  _FT(zgemv)("N", &m, &n, &CONE, little_dfl_fields[0], &ld, phi, &ONE, &CZERO, out, &ONE, 1);
   return;
 }
 
@@ -450,9 +437,11 @@ void little_project(_Complex double * const out, _Complex double * const in, con
 #define _PTSWITCH(s) s
 #define _MPI_C_TYPE MPI_DOUBLE_COMPLEX
 #define _F_TYPE double
+#define _MV(x) _FT(zgemv)
 
 #include "little_project_eo_body.c"
 
+#undef _MV
 #undef _PSWITCH
 #undef _F_TYPE
 #undef _MPI_C_TYPE
@@ -462,16 +451,18 @@ void little_project(_Complex double * const out, _Complex double * const in, con
 #define _PTSWITCH(s) s ## 32
 #define _MPI_C_TYPE MPI_COMPLEX
 #define _F_TYPE float
+#define _MV(x) _FT(cgemv)
 
 #include "little_project_eo_body.c"
 
+#undef _MV
 #undef _PSWITCH
 #undef _F_TYPE
 #undef _MPI_C_TYPE
 #undef _PTSWITCH
 
 void little_project2(_Complex double * const out, _Complex double * const in, const int  N) {
-  int i;
+  int m = nb_blocks*N, n = N, ld = nb_blocks*9*g_N_s;
   static _Complex double *phi;
   static _Complex double *psi;
 
@@ -479,19 +470,14 @@ void little_project2(_Complex double * const out, _Complex double * const in, co
   phi = work[4];
   psi = work[5];
 
-  for(i = 0; i < N; i++) {
-    phi[i] = lscalar_prod(little_dfl_fields[i], in, nb_blocks*N, 0);
-  }
+  _FT(zgemv)("C", &m, &n, &CONE, little_dfl_fields[0], &ld, in, &ONE, &CZERO, phi, &ONE, 1);
 #ifdef TM_USE_MPI
   MPI_Allreduce(phi, psi, g_N_s, MPI_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
 #else
   memcpy(psi, phi, g_N_s*sizeof(_Complex double));
 #endif
 
-  lmul(out, psi[0], little_dfl_fields[0], nb_blocks*g_N_s);
-  for(i = 1; i < N; i++) {
-    lassign_add_mul(out, little_dfl_fields[i], psi[i], nb_blocks*g_N_s);
-  }
+  _FT(zgemv)("N", &m, &n, &CONE, little_dfl_fields[0], &ld, psi, &ONE, &CZERO, out, &ONE, 1);
 
   return;
 }
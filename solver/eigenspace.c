@@ -0,0 +1,470 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+ *
+ * Eigenspace service for the deflation of many inversions of the same
+ * hermitian even/odd operator f = Qtm_pm_psi or Qsw_pm_psi on a fixed
+ * gauge configuration.
+ *
+ * The lowmodes_nev lowest eigenvectors of f are computed on first use by
+ * Chebyshev filtered subspace iteration: a block of m > nev vectors is
+ * repeatedly filtered with the Chebyshev polynomial which damps the
+ * interval [a, b] of the spectrum, where b is an upper bound for the
+ * largest eigenvalue (from a power iteration) and a the largest Ritz
+ * value of the last iteration, followed by an orthonormalisation and a
+ * Rayleigh-Ritz step. The converged modes are stored in double or, to
+ * save memory, in single precision and optionally written to and read
+ * from disk.
+ *
+ * Every source b is then replaced by b - f x0 with x0 = V L^-1 V^dagger b,
+ * the solver works on the remainder only and x0 is added to its solution
+ * afterwards. Since f x0 is computed explicitly, the deflated source is
+ * exact also for single precision or not fully converged eigenvectors,
+ * such that the final residual is that of the solver.
+ *
+ * The eigenspaces are identified by the operator, the volume and the
+ * values of g_kappa, g_mu and g_c_sw and belong to the gauge field
+ * version they were computed on; spaces of an older version are dropped
+ * on the next use, eigenspace_reset frees them right away.
+ *
+ *******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include "global.h"
+#include "su3.h"
+#include "start.h"
+#include "gettime.h"
+#include "read_input.h"
+#include "linalg_eo.h"
+#include "linalg/lapack.h"
+#include "solver/solver_field.h"
+#include "solver/gram-schmidt.h"
+#include <io/eospinor.h>
+#include "eigenspace.h"
+
+#define EIGENSPACE_MAX 4
+#define EIGENSPACE_CHEB_DEGREE 20
+#define EIGENSPACE_POWER_ITER 30
+#define EIGENSPACE_MAX_ITER 100
+#define EIGENSPACE_NO_WORK 5
+
+typedef struct {
+  matrix_mult f;
+  int N, nev, m, single;
+  unsigned int gauge_version;
+  double kappa, mu, c_sw;
+  double * evals;
+  spinor ** v;
+  spinor32 ** v32;
+  char name[100];
+} eigenspace_t;
+
+static eigenspace_t spaces[EIGENSPACE_MAX];
+static int no_spaces = 0;
+static int eigenspace_nstore = 0;
+/* work[0] keeps the low mode solution between deflate and add_lowmode */
+static spinor ** work = NULL;
+static int lowmode_pending = 0;
+
+#ifdef HAVE_LAPACK
+
+static void free_eigenspace(eigenspace_t * const es) {
+  if(es->v != NULL) finalize_solver(es->v, es->m);
+  if(es->v32 != NULL) finalize_solver_32(es->v32, es->nev);
+  free(es->evals);
+  es->v = NULL;
+  es->v32 = NULL;
+  es->evals = NULL;
+  return;
+}
+
+/* returns the i-th eigenvector in double precision */
+static spinor * get_vector(eigenspace_t * const es, const int i) {
+  if(es->single) {
+    assign_to_64(work[4], es->v32[i], es->N);
+    return(work[4]);
+  }
+  return(es->v[i]);
+}
+
+/* v = T_deg((f - c)/e) v / |..| with c, e the centre and half width of [a, b] */
+static void chebyshev_filter(spinor * const v, const double a, const double b,
+                             const int N, matrix_mult f) {
+  const double c = (b + a)/2., e = (b - a)/2.;
+  spinor * y0 = work[1], * y1 = work[2], * y2 = work[3], * tmp;
+
+  assign(y0, v, N);
+  f(y1, y0);
+  assign_add_mul_r(y1, y0, -c, N);
+  mul_r(y1, 1./e, y1, N);
+  for(int k = 2; k <= EIGENSPACE_CHEB_DEGREE; k++) {
+    f(y2, y1);
+    assign_add_mul_r(y2, y1, -c, N);
+    mul_r(y2, 2./e, y2, N);
+    assign_add_mul_r(y2, y0, -1., N);
+    tmp = y0; y0 = y1; y1 = y2; y2 = tmp;
+  }
+  mul_r(v, 1./sqrt(square_norm(y1, N, 1)), y1, N);
+  return;
+}
+
+/* v_k <- sum_j v_j U_jk, site by site with a thread local buffer */
+static void rotate_basis(spinor ** const v, const _Complex double * const U, const int m, const int N) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  _Complex double * tmp = (_Complex double*)malloc(12*m*sizeof(_Complex double));
+
+#ifdef TM_USE_OMP
+#pragma omp for
+#endif
+  for(int x = 0; x < N; x++) {
+    for(int i = 0; i < 12*m; i++) {
+      tmp[i] = 0.;
+    }
+    for(int j = 0; j < m; j++) {
+      const _Complex double * const vj = (_Complex double*)(v[j] + x);
+      for(int k = 0; k < m; k++) {
+        const _Complex double u = U[j + k*m];
+        for(int c = 0; c < 12; c++) {
+          tmp[12*k + c] += u*vj[c];
+        }
+      }
+    }
+    for(int k = 0; k < m; k++) {
+      memcpy(v[k] + x, tmp + 12*k, sizeof(spinor));
+    }
+  }
+  free(tmp);
+#ifdef TM_USE_OMP
+  } /* OpenMP parallel closing brace */
+#endif
+  return;
+}
+
+static int compute_eigenspace(eigenspace_t * const es, const double prec) {
+  const int N = es->N, m = es->m;
+  int lwork = 3*m, info = 0, nconv = 0, iter;
+  double a, b, lmax = 0., nrm, atime, etime;
+  double * rwork = (double*)malloc(3*m*sizeof(double));
+  _Complex double * H = (_Complex double*)malloc(m*m*sizeof(_Complex double));
+  _Complex double * hcol = (_Complex double*)malloc(m*sizeof(_Complex double));
+  _Complex double * lwork_buf = (_Complex double*)malloc(lwork*sizeof(_Complex double));
+  char cV = 'V', cU = 'U';
+  int mm = m;
+
+  atime = gettime();
+  /* upper bound of the spectrum from a power iteration */
+  random_spinor_field_eo(work[1], reproduce_randomnumber_flag, RN_GAUSS);
+  mul_r(work[1], 1./sqrt(square_norm(work[1], N, 1)), work[1], N);
+  for(int i = 0; i < EIGENSPACE_POWER_ITER; i++) {
+    es->f(work[2], work[1]);
+    lmax = sqrt(square_norm(work[2], N, 1));
+    mul_r(work[1], 1./lmax, work[2], N);
+  }
+  b = 1.1*lmax;
+  a = 0.01*lmax;
+
+  for(int j = 0; j < m; j++) {
+    random_spinor_field_eo(es->v[j], reproduce_randomnumber_flag, RN_GAUSS);
+  }
+
+  for(iter = 0; iter < EIGENSPACE_MAX_ITER; iter++) {
+    /* filter and orthonormalise the basis */
+    for(int j = 0; j < m; j++) {
+      chebyshev_filter(es->v[j], a, b, N, es->f);
+      IteratedClassicalGS((_Complex double*)es->v[j], &nrm, 12*N, j, (_Complex double*)es->v[0],
+                          hcol, 12*(VOLUMEPLUSRAND/2));
+      mul_r(es->v[j], 1./nrm, es->v[j], N);
+    }
+
+    /* Rayleigh-Ritz, one global reduction per column of H */
+    for(int j = 0; j < m; j++) {
+      es->f(work[1], es->v[j]);
+      for(int i = 0; i <= j; i++) {
+        hcol[i] = scalar_prod(es->v[i], work[1], N, 0);
+      }
+#ifdef TM_USE_MPI
+      MPI_Allreduce(hcol, H + j*m, j+1, MPI_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
+#else
+      memcpy(H + j*m, hcol, (j+1)*sizeof(_Complex double));
+#endif
+    }
+    _FT(zheev)(&cV, &cU, &mm, H, &mm, es->evals, lwork_buf, &lwork, rwork, &info, 1, 1);
+    if(info != 0) {
+      if(g_proc_id == 0) {
+        fprintf(stderr, "Error in ZHEEV while computing the low modes, info = %d\n", info);
+      }
+      nconv = 0;
+      break;
+    }
+    rotate_basis(es->v, H, m, N);
+
+    /* residuals ||f v - lambda v|| / lambda of the wanted modes */
+    for(nconv = 0; nconv < es->nev; nconv++) {
+      es->f(work[1], es->v[nconv]);
+      assign_add_mul_r(work[1], es->v[nconv], -es->evals[nconv], N);
+      if(sqrt(square_norm(work[1], N, 1)) > prec*fabs(es->evals[nconv])) break;
+    }
+    if(g_proc_id == 0 && g_debug_level > 2) {
+      printf("# Low modes: iteration %d, %d of %d converged, lambda_min = %e, filter interval [%e, %e]\n",
+             iter, nconv, es->nev, es->evals[0], es->evals[m-1], b);
+      fflush(stdout);
+    }
+    if(nconv == es->nev) break;
+    a = es->evals[m-1];
+  }
+  etime = gettime();
+
+  if(g_proc_id == 0) {
+    if(nconv < es->nev) {
+      printf("# Low modes: only %d of %d eigenvectors converged in %d iterations\n", nconv, es->nev, iter);
+    }
+    printf("# Low modes: %d eigenvalues in [%e, %e] computed in %e sec\n",
+           nconv, es->evals[0], nconv > 0 ? es->evals[nconv-1] : 0., etime-atime);
+    fflush(stdout);
+  }
+  free(lwork_buf);
+  free(hcol);
+  free(H);
+  free(rwork);
+  return(nconv);
+}
+
+static int read_eigenspace(eigenspace_t * const es) {
+  char filename[500];
+  FILE * ifs;
+  int i, n = 0;
+
+  sprintf(filename, "%s.%.4d.evals", es->name, eigenspace_nstore);
+  if((ifs = fopen(filename, "r")) == (FILE*)NULL) {
+    return(-1);
+  }
+  while(n < es->nev && fscanf(ifs, "%d %lf\n", &i, &es->evals[n]) == 2) {
+    n++;
+  }
+  fclose(ifs);
+  if(n < es->nev) {
+    return(-1);
+  }
+  for(i = 0; i < es->nev; i++) {
+    sprintf(filename, "%s.%.4d.%.4d", es->name, eigenspace_nstore, i);
+    if(read_eospinor(es->v[i], filename) != 0) {
+      return(-1);
+    }
+  }
+  if(g_proc_id == 0) {
+    printf("# Low modes: read %d eigenvectors from %s.%.4d.*\n", es->nev, es->name, eigenspace_nstore);
+    fflush(stdout);
+  }
+  return(0);
+}
+
+static void write_eigenspace(eigenspace_t * const es, const double prec) {
+  char filename[500];
+  FILE * ofs;
+
+  for(int i = 0; i < es->nev; i++) {
+    sprintf(filename, "%s.%.4d.%.4d", es->name, eigenspace_nstore, i);
+    if(write_eospinor(es->v[i], filename, es->evals[i], prec, eigenspace_nstore) != 0) {
+      return;
+    }
+  }
+  if(g_proc_id == 0) {
+    sprintf(filename, "%s.%.4d.evals", es->name, eigenspace_nstore);
+    if((ofs = fopen(filename, "w")) != (FILE*)NULL) {
+      for(int i = 0; i < es->nev; i++) {
+        fprintf(ofs, "%d %.16e\n", i, es->evals[i]);
+      }
+      fclose(ofs);
+    }
+  }
+  return;
+}
+
+static eigenspace_t * get_eigenspace(solver_params_t * const solver_params, const int N, matrix_mult f) {
+  eigenspace_t * es;
+  int nconv, n = 0;
+
+  /* drop the spaces of previous gauge fields */
+  for(int i = 0; i < no_spaces; i++) {
+    if(spaces[i].gauge_version != g_gauge_version) {
+      free_eigenspace(&spaces[i]);
+    }
+    else {
+      spaces[n++] = spaces[i];
+    }
+  }
+  no_spaces = n;
+
+  for(int i = 0; i < no_spaces; i++) {
+    es = &spaces[i];
+    if(es->f == f && es->N == N && es->kappa == g_kappa && es->mu == g_mu && es->c_sw == g_c_sw) {
+      return(es);
+    }
+  }
+
+  if(work == NULL) {
+    init_solver_field(&work, VOLUMEPLUSRAND/2, EIGENSPACE_NO_WORK);
+  }
+  /* drop the oldest space if the cache is full */
+  if(no_spaces == EIGENSPACE_MAX) {
+    free_eigenspace(&spaces[0]);
+    memmove(spaces, spaces + 1, (EIGENSPACE_MAX-1)*sizeof(eigenspace_t));
+    no_spaces--;
+  }
+  es = &spaces[no_spaces];
+  es->f = f;
+  es->N = N;
+  es->gauge_version = g_gauge_version;
+  es->kappa = g_kappa;
+  es->mu = g_mu;
+  es->c_sw = g_c_sw;
+  es->single = solver_params->lowmodes_single;
+  es->nev = solver_params->lowmodes_nev;
+  es->m = es->nev + (es->nev/4 > 8 ? es->nev/4 : 8);
+  es->v32 = NULL;
+  es->evals = (double*)malloc(es->m*sizeof(double));
+  if(init_solver_field(&es->v, VOLUMEPLUSRAND/2, es->m) != 0) {
+    if(g_proc_id == 0) {
+      fprintf(stderr, "Not enough memory for %d low modes, no deflation\n", es->nev);
+    }
+    free(es->evals);
+    return(NULL);
+  }
+  sprintf(es->name, "lowmodes.kappa%.8f.mu%.8f.csw%.8f", g_kappa, g_mu, g_c_sw);
+
+  if(!solver_params->lowmodes_readwrite || read_eigenspace(es) != 0) {
+    nconv = compute_eigenspace(es, solver_params->lowmodes_prec);
+    es->nev = nconv;
+    if(solver_params->lowmodes_readwrite && nconv > 0) {
+      write_eigenspace(es, solver_params->lowmodes_prec);
+    }
+  }
+
+  /* keep only the converged modes in single precision */
+  if(es->single && es->nev > 0) {
+    init_solver_field_32(&es->v32, VOLUMEPLUSRAND/2, es->nev);
+    for(int i = 0; i < es->nev; i++) {
+      assign_to_32(es->v32[i], es->v[i], N);
+    }
+    finalize_solver(es->v, es->m);
+    es->v = NULL;
+  }
+  no_spaces++;
+  return(es);
+}
+
+int eigenspace_deflate_source(spinor * const b, double * const eps_sq, const int rel_prec,
+                              const int N, solver_params_t * const solver_params, matrix_mult f) {
+  eigenspace_t * es;
+  double nb, nd;
+  _Complex double * c, * cl;
+
+  lowmode_pending = 0;
+  if(solver_params->lowmodes_nev <= 0) {
+    return(0);
+  }
+  es = get_eigenspace(solver_params, N, f);
+  if(es == NULL || es->nev == 0) {
+    return(0);
+  }
+
+  c = (_Complex double*)malloc(es->nev*sizeof(_Complex double));
+  cl = (_Complex double*)malloc(es->nev*sizeof(_Complex double));
+  nb = square_norm(b, N, 1);
+  /* all projections with a single global reduction */
+  for(int i = 0; i < es->nev; i++) {
+    cl[i] = scalar_prod(get_vector(es, i), b, N, 0);
+  }
+#ifdef TM_USE_MPI
+  MPI_Allreduce(cl, c, es->nev, MPI_DOUBLE_COMPLEX, MPI_SUM, MPI_COMM_WORLD);
+#else
+  memcpy(c, cl, es->nev*sizeof(_Complex double));
+#endif
+
+  zero_spinor_field(work[0], N);
+  for(int i = 0; i < es->nev; i++) {
+    assign_add_mul(work[0], get_vector(es, i), c[i]/es->evals[i], N);
+  }
+  f(work[1], work[0]);
+  diff(b, b, work[1], N);
+  nd = square_norm(b, N, 1);
+  if(rel_prec && nd > 0.) {
+    (*eps_sq) *= nb/nd;
+  }
+  if(g_proc_id == 0 && g_debug_level > 0) {
+    printf("# Deflated %d low modes, |b|^2 reduced from %e to %e\n", es->nev, nb, nd);
+    fflush(stdout);
+  }
+  free(cl);
+  free(c);
+  lowmode_pending = 1;
+  return(1);
+}
+
+void eigenspace_add_lowmode(spinor * const x, const int N) {
+  if(lowmode_pending) {
+    assign_add_mul_r(x, work[0], 1., N);
+  }
+  return;
+}
+
+#else
+
+int eigenspace_deflate_source(spinor * const b, double * const eps_sq, const int rel_prec,
+                              const int N, solver_params_t * const solver_params, matrix_mult f) {
+  if(solver_params->lowmodes_nev > 0 && g_proc_id == 0) {
+    fprintf(stderr, "lapack not available, so no low mode deflation\n");
+  }
+  return(0);
+}
+
+void eigenspace_add_lowmode(spinor * const x, const int N) {
+  return;
+}
+
+#endif
+
+void eigenspace_reset(const int nstore) {
+#ifdef HAVE_LAPACK
+  for(int i = 0; i < no_spaces; i++) {
+    free_eigenspace(&spaces[i]);
+  }
+#endif
+  no_spaces = 0;
+  lowmode_pending = 0;
+  eigenspace_nstore = nstore;
+  return;
+}
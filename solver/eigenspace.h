@@ -0,0 +1,42 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef _EIGENSPACE_H
+#define _EIGENSPACE_H
+
+#include "su3.h"
+#include "solver/matrix_mult_typedef.h"
+#include "solver/solver_params.h"
+
+/* replaces the source b of the normal equation f x = b by its deflated  */
+/* version b - f x0 with the low mode solution x0 = V L^-1 V^dagger b,   */
+/* computing (or reading) the lowmodes_nev lowest eigenvectors of f on   */
+/* first use; for rel_prec the requested precision eps_sq is rescaled to */
+/* refer to the original source; returns 1 if b has been deflated        */
+int eigenspace_deflate_source(spinor * const b, double * const eps_sq, const int rel_prec,
+                              const int N, solver_params_t * const solver_params, matrix_mult f);
+/* adds the low mode solution x0 of the last deflated source to x, */
+/* nothing if the last eigenspace_deflate_source returned 0         */
+void eigenspace_add_lowmode(spinor * const x, const int N);
+/* frees all stored eigenspaces after a new gauge field has been read, */
+/* nstore is used to label the eigenvector files                       */
+void eigenspace_reset(const int nstore);
+
+#endif
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
+#include <string.h>
 #include "global.h"
 #include "gettime.h"
 #include "su3.h"
@@ -50,6 +51,7 @@
 #include "gcr4complex.h"
 #include "cgne4complex.h"
 #include "boundary.h"
+#include "derived_gauge_fields.h"
 #include <io/params.h>
 #include <io/gauge.h>
 #include <io/spinor.h>
@@ -58,6 +60,7 @@
 #include "solver_field.h"
 #include "dfl_projector.h"
 #include "generate_dfl_subspace.h"
+#include "little_mg.h"
 
 int init_little_dfl_subspace(const int N_s);
 void compute_little_little_D(const int N_s);
@@ -74,6 +77,30 @@ static _Complex float *_little_dfl_fields_eo_32 = NULL;
 static int init_subspace = 0;
 static int init_little_subspace = 0;
 
+/* state of the subspace kept in dfl_fields between calls of    */
+/* generate_dfl_subspace if dfl_subspace_reuse is set: the      */
+/* gauge field version and the operator parameters it was       */
+/* computed for                                                 */
+static int dfl_cache_valid = 0;
+static int dfl_cache_Ns = 0;
+static unsigned int dfl_cache_version = GAUGE_VERSION_NONE;
+static double dfl_cache_kappa = 0., dfl_cache_mu = 0., dfl_cache_c_sw = 0.;
+
+static int dfl_cache_current() {
+  return(dfl_cache_version == g_gauge_version && dfl_cache_kappa == g_kappa &&
+         dfl_cache_mu == g_mu && dfl_cache_c_sw == g_c_sw);
+}
+
+static void dfl_cache_set() {
+  dfl_cache_version = g_gauge_version;
+  dfl_cache_kappa = g_kappa;
+  dfl_cache_mu = g_mu;
+  dfl_cache_c_sw = g_c_sw;
+}
+
+static int read_dfl_subspace(const int Ns);
+static void write_dfl_subspace(const int Ns);
+
 static void random_fields(const int Ns) {
 
   for (int i = 0; i < Ns; i++) {
@@ -190,42 +217,73 @@ int generate_dfl_subspace(const int Ns, const int N, const int repro) {
     fflush(stdout);
   }
 
-  if(init_subspace == 0) p = init_dfl_subspace(Ns);
+  if(init_subspace == 1 && dfl_cache_Ns != Ns) {
+    free_dfl_subspace();
+  }
+  if(init_subspace == 0) {
+    p = init_dfl_subspace(Ns);
+    dfl_cache_valid = 0;
+    dfl_cache_Ns = Ns;
+  }
 
   if(init_little_subspace == 0) p = init_little_dfl_subspace(Ns);
 
-  if((g_proc_id == 0) && (g_debug_level > 0)) {
-    printf("# Generating random fields...");
-  }
-  double ta = gettime();
-  random_fields(Ns);
-  double tb = gettime();
-  if((g_proc_id == 0) && (g_debug_level > 0)) {
-    printf(" done in %e seconds\n", tb-ta);
-    fflush(stdout);
+  if(dfl_subspace_reuse && !dfl_cache_valid && strlen(dfl_subspace_filename) > 0) {
+    dfl_cache_valid = (read_dfl_subspace(Ns) == 0);
   }
 
-  if((g_proc_id == 0) && (p < Ns) && (g_debug_level > 0)) {
-    printf("# Compute approximate eigenvectors from scratch\n");
-    printf("# Using kappa= %e and mu = %e for the subspace generation\n", g_kappa, g_mu/g_kappa/2.);
+  if(dfl_subspace_reuse && dfl_cache_valid) {
+    /* refreshed if the gauge field or the operator have changed */
+    int nsmooth = 0;
+    if(!dfl_cache_current()) {
+      nsmooth = NsmoothMsap_dflupdate;
+    }
+    if((g_proc_id == 0) && (g_debug_level > 0)) {
+      printf("# Reusing deflation subspace with %d update steps\n", nsmooth);
+    }
+    update_dfl_subspace(Ns, N, nsmooth);
+    if(nsmooth > 0 && strlen(dfl_subspace_filename) > 0) write_dfl_subspace(Ns);
+    dfl_cache_set();
   }
+  else {
+    if((g_proc_id == 0) && (g_debug_level > 0)) {
+      printf("# Generating random fields...");
+    }
+    double ta = gettime();
+    random_fields(Ns);
+    double tb = gettime();
+    if((g_proc_id == 0) && (g_debug_level > 0)) {
+      printf(" done in %e seconds\n", tb-ta);
+      fflush(stdout);
+    }
 
-  for(int j = 0; j < loop_SAP; j++) {
-    for(int i = 0; i < Ns; i++) {
-      zero_spinor_field(g_spinor_field[0], VOLUME);  
-      g_sloppy_precision = 1;
-      Msap_eo(g_spinor_field[0], dfl_fields[i], NcycleMsap_dflgen, NiterMsap_dflgen); 
-      
-      assign(dfl_fields[i], g_spinor_field[0], VOLUME);
-      
-      g_sloppy_precision = 0;
-      ModifiedGS((_Complex double*)g_spinor_field[0], vol, i, (_Complex double*)dfl_fields[0], vpr);
-      nrm = sqrt(square_norm(g_spinor_field[0], N, 1));
-      mul_r(dfl_fields[i], 1./nrm, g_spinor_field[0], N);
+    if((g_proc_id == 0) && (p < Ns) && (g_debug_level > 0)) {
+      printf("# Compute approximate eigenvectors from scratch\n");
+      printf("# Using kappa= %e and mu = %e for the subspace generation\n", g_kappa, g_mu/g_kappa/2.);
+    }
+
+    for(int j = 0; j < loop_SAP; j++) {
+      for(int i = 0; i < Ns; i++) {
+        zero_spinor_field(g_spinor_field[0], VOLUME);  
+        g_sloppy_precision = 1;
+        Msap_eo(g_spinor_field[0], dfl_fields[i], NcycleMsap_dflgen, NiterMsap_dflgen); 
+        
+        assign(dfl_fields[i], g_spinor_field[0], VOLUME);
+        
+        g_sloppy_precision = 0;
+        ModifiedGS((_Complex double*)g_spinor_field[0], vol, i, (_Complex double*)dfl_fields[0], vpr);
+        nrm = sqrt(square_norm(g_spinor_field[0], N, 1));
+        mul_r(dfl_fields[i], 1./nrm, g_spinor_field[0], N);
+      }
     }
-  }
 
-  update_dfl_subspace(Ns, N, NsmoothMsap_dflgen-loop_SAP);
+    update_dfl_subspace(Ns, N, NsmoothMsap_dflgen-loop_SAP);
+    if(dfl_subspace_reuse) {
+      dfl_cache_valid = 1;
+      dfl_cache_set();
+      if(strlen(dfl_subspace_filename) > 0) write_dfl_subspace(Ns);
+    }
+  }
   
   compute_little_D(0);
   compute_little_little_D(Ns);
@@ -272,6 +330,10 @@ int generate_dfl_subspace(const int Ns, const int N, const int repro) {
   dfl_subspace_updated = 1;
 
   compute_little_little_D(Ns);
+
+  if(little_mg_threelevel) {
+    init_little_mg(little_mg_Nc);
+  }
   
   etime = gettime();
 
@@ -281,7 +343,8 @@ int generate_dfl_subspace(const int Ns, const int N, const int repro) {
   }
 
   finalize_solver(work_fields, nr_wf);
-  free_dfl_subspace();
+  /* keep dfl_fields alive for the next call if the subspace is reused */
+  if(!dfl_subspace_reuse) free_dfl_subspace();
   free(work);
   free(psi[0]);
   free(psi);
@@ -360,11 +423,7 @@ void compute_little_little_D(const int Ns) {
       for(int i = 0; i < Ns; i++) {
 	split_global_field_GEN(psi, dfl_fields[i], nb_blocks);
 	// now take the local scalar products
-	for(int j = 0; j < Ns; j++) {
-	  for(int blk = 0; blk < nb_blocks; blk++) {
-	    little_dfl_fields[i][j + blk*Ns] = scalar_prod(block_list[blk].basis[j], psi[blk], block_list[0].volume, 0);
-	  }
-	}
+	blocks_restrict(little_dfl_fields[i], psi);
       }
       
       // orthonormalise 
@@ -417,9 +476,7 @@ void compute_little_little_D(const int Ns) {
         i_o=0;
         for(int blk = 0; blk < nb_blocks; blk++) {
           if (block_list[blk].evenodd==1) {
-            for(int j = 0; j < Ns; j++) {
-	      little_dfl_fields_eo[i][(nb_blocks/2+i_o)*Ns + j] = scalar_prod(block_list[blk].basis[j], psi[blk], block_list[0].volume, 0);
-            }
+            block_restrict(little_dfl_fields_eo[i] + (nb_blocks/2+i_o)*Ns, &block_list[blk], psi[blk]);
             i_o++;
 	  }
 	}
@@ -554,6 +611,54 @@ int free_dfl_subspace() {
     free(dfl_fields);
     free(_dfl_fields);
     init_subspace = 0;
+    dfl_cache_valid = 0;
   }
   return 0;
 }
+
+/* reads the Ns subspace vectors from dfl_subspace_filename, */
+/* returns 0 on success                                       */
+static int read_dfl_subspace(const int Ns) {
+  FILE * ifs = fopen(dfl_subspace_filename, "r");
+  if(ifs == NULL) {
+    if(g_proc_id == 0 && g_debug_level > 0) {
+      printf("# No deflation subspace file %s found, generating from scratch\n", dfl_subspace_filename);
+    }
+    return(-1);
+  }
+  fclose(ifs);
+  for(int i = 0; i < Ns; i++) {
+    if(read_spinor(dfl_fields[i], NULL, dfl_subspace_filename, i) != 0) {
+      if(g_proc_id == 0) {
+        fprintf(stderr, "Error reading deflation subspace vector %d from file %s, generating from scratch\n",
+                i, dfl_subspace_filename);
+      }
+      return(-1);
+    }
+  }
+  /* force an update on the current gauge field */
+  dfl_cache_version = GAUGE_VERSION_NONE;
+  if(g_proc_id == 0 && g_debug_level > 0) {
+    printf("# Read %d deflation subspace vectors from file %s\n", Ns, dfl_subspace_filename);
+  }
+  return(0);
+}
+
+/* writes the Ns subspace vectors to dfl_subspace_filename */
+static void write_dfl_subspace(const int Ns) {
+  WRITER * writer = NULL;
+  paramsPropagatorFormat * propagatorFormat = NULL;
+
+  construct_writer(&writer, dfl_subspace_filename, 0);
+  propagatorFormat = construct_paramsPropagatorFormat(64, 1);
+  write_propagator_format(writer, propagatorFormat);
+  free(propagatorFormat);
+  for(int i = 0; i < Ns; i++) {
+    write_spinor(writer, &dfl_fields[i], NULL, 1, 64);
+  }
+  destruct_writer(writer);
+  if(g_proc_id == 0 && g_debug_level > 0) {
+    printf("# Wrote %d deflation subspace vectors to file %s\n", Ns, dfl_subspace_filename);
+  }
+  return;
+}
@@ -0,0 +1,362 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <complex.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
+#include "global.h"
+#include "gettime.h"
+#include "ranlxd.h"
+#include "block.h"
+#include "little_D.h"
+#include "linalg/blas.h"
+#include "xchange/little_field_gather.h"
+#include "gcr4complex.h"
+#include "little_mg.h"
+
+/* aggregates: mg_aggr_dir[mu] blocks per aggregate in direction mu */
+int mg_naggr = 0;
+static int mg_nba = 0;
+static int mg_aggr_dir[4];
+static int mg_naggr_dir[4];
+static int mg_init = 0;
+/* aggregate of every block and blocks of every aggregate */
+static int * mg_blk_agg = NULL;
+static int * mg_agg_blocks = NULL;
+/* block neighbours inside the aggregate in compact numbering, or -1 */
+static int * mg_blk_nb = NULL;
+/* neighbour aggregates and whether they live on another process */
+static int * mg_agg_nb = NULL;
+static int * mg_agg_remote = NULL;
+static int * mg_agg_color = NULL;
+
+/* near null vectors of little_D restricted to the aggregates */
+static _Complex double ** little_mg_fields = NULL;
+static _Complex float ** little_mg_fields_32 = NULL;
+/* the little little Dirac operator, 9 little_mg_Nc^2 matrices per aggregate */
+/* ordered as little_dirac_operator: local, +t, -t, +x, -x, +y, -y, +z, -z  */
+static _Complex double * little_little_dirac_operator = NULL;
+static _Complex float * little_little_dirac_operator_32 = NULL;
+
+static _Complex double * mg_work2[5], * mg_work3[4], * mg_aggr_work = NULL;
+static _Complex float * mg_work2_32[5], * mg_work3_32[4], * mg_aggr_work_32 = NULL;
+
+static int ONE = 1;
+static _Complex double CONE = 1.0, CZERO = 0.0;
+static _Complex float CONE_32 = 1.0, CZERO_32 = 0.0;
+
+#define _PSWITCH(s) s
+#define _C_TYPE _Complex double
+#define _MPI_C_TYPE MPI_DOUBLE_COMPLEX
+#define _MV(x) _FT(zgemv)
+
+#include "little_mg_body.c"
+
+#undef _MV
+#undef _MPI_C_TYPE
+#undef _C_TYPE
+#undef _PSWITCH
+
+#define _PSWITCH(s) s ## _32
+#define _C_TYPE _Complex float
+#define _MPI_C_TYPE MPI_COMPLEX
+#define _MV(x) _FT(cgemv)
+
+#include "little_mg_body.c"
+
+#undef _MV
+#undef _MPI_C_TYPE
+#undef _C_TYPE
+#undef _PSWITCH
+
+
+static int init_aggregates() {
+  int nblks[4] = {nblks_t, nblks_x, nblks_y, nblks_z};
+  int nproc_dir[4] = {g_nproc_t, g_nproc_x, g_nproc_y, g_nproc_z};
+  int c[4], ca[4], ctr[4*nb_blocks];
+
+  mg_naggr = 1;
+  for(int mu = 0; mu < 4; mu++) {
+    mg_aggr_dir[mu] = little_mg_aggregate;
+    while(nblks[mu] % mg_aggr_dir[mu] != 0) mg_aggr_dir[mu]--;
+    mg_naggr_dir[mu] = nblks[mu] / mg_aggr_dir[mu];
+    mg_naggr *= mg_naggr_dir[mu];
+  }
+  mg_nba = nb_blocks / mg_naggr;
+
+  mg_blk_agg = calloc(nb_blocks, sizeof(int));
+  mg_agg_blocks = calloc(nb_blocks, sizeof(int));
+  mg_blk_nb = calloc(8*nb_blocks, sizeof(int));
+  mg_agg_nb = calloc(8*mg_naggr, sizeof(int));
+  mg_agg_remote = calloc(8*mg_naggr, sizeof(int));
+  mg_agg_color = calloc(mg_naggr, sizeof(int));
+  if(mg_blk_agg == NULL || mg_agg_blocks == NULL || mg_blk_nb == NULL ||
+     mg_agg_nb == NULL || mg_agg_remote == NULL || mg_agg_color == NULL) {
+    return(1);
+  }
+
+  /* aggregates in lexicographic order t, x, y, z as the blocks */
+  for(int a = 0; a < mg_naggr; a++) ctr[a] = 0;
+  for(int i = 0; i < nb_blocks; i++) {
+    int a = 0;
+    for(int mu = 0; mu < 4; mu++) {
+      a = a * mg_naggr_dir[mu] + block_list[i].mpilocal_coordinate[mu] / mg_aggr_dir[mu];
+    }
+    mg_blk_agg[i] = a;
+    mg_agg_blocks[a*mg_nba + ctr[a]] = i;
+    ctr[a]++;
+  }
+
+  /* neighbours of every block, only if in the same aggregate */
+  for(int i = 0; i < nb_blocks; i++) {
+    for(int j = 0; j < 8; j++) {
+      int mu = j / 2, ib = -1;
+      for(int nu = 0; nu < 4; nu++) c[nu] = block_list[i].mpilocal_coordinate[nu];
+      c[mu] += (j % 2 == 0) ? 1 : -1;
+      mg_blk_nb[8*i + j] = -1;
+      if(c[mu] < 0 || c[mu] >= nblks[mu]) {
+        if(nproc_dir[mu] > 1) continue;
+        c[mu] = (c[mu] + nblks[mu]) % nblks[mu];
+      }
+      ib = block_index(c[0], c[1], c[2], c[3]);
+      if(mg_blk_agg[ib] != mg_blk_agg[i]) continue;
+      for(int k = 0; k < mg_nba; k++) {
+        if(mg_agg_blocks[mg_blk_agg[i]*mg_nba + k] == ib) mg_blk_nb[8*i + j] = k;
+      }
+    }
+  }
+
+  /* neighbour aggregates and colour from the global aggregate coordinate */
+  for(int a = 0; a < mg_naggr; a++) {
+    int r = a, sum = 0;
+    for(int mu = 3; mu >= 0; mu--) {
+      ca[mu] = r % mg_naggr_dir[mu];
+      r /= mg_naggr_dir[mu];
+      sum += ca[mu] + g_proc_coords[mu] * mg_naggr_dir[mu];
+    }
+    mg_agg_color[a] = sum % 2;
+    for(int j = 0; j < 8; j++) {
+      int mu = j / 2, b = 0;
+      for(int nu = 0; nu < 4; nu++) c[nu] = ca[nu];
+      c[mu] += (j % 2 == 0) ? 1 : -1;
+      mg_agg_remote[8*a + j] = 0;
+      if(c[mu] < 0 || c[mu] >= mg_naggr_dir[mu]) {
+        c[mu] = (c[mu] + mg_naggr_dir[mu]) % mg_naggr_dir[mu];
+        if(nproc_dir[mu] > 1) mg_agg_remote[8*a + j] = 1;
+      }
+      for(int nu = 0; nu < 4; nu++) b = b * mg_naggr_dir[nu] + c[nu];
+      mg_agg_nb[8*a + j] = b;
+    }
+  }
+  return(0);
+}
+
+
+/* Gram-Schmidt of the little_mg_fields on every aggregate */
+static void aggregate_orthonormalize() {
+  const int Nc = little_mg_Nc;
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int a = 0; a < mg_naggr; a++) {
+    for(int k = 0; k < Nc; k++) {
+      for(int l = 0; l < k; l++) {
+        _Complex double s = 0.;
+        for(int ib = 0; ib < mg_nba; ib++) {
+          int i = mg_agg_blocks[a*mg_nba + ib]*g_N_s;
+          for(int n = 0; n < g_N_s; n++) s += conj(little_mg_fields[l][i + n]) * little_mg_fields[k][i + n];
+        }
+        for(int ib = 0; ib < mg_nba; ib++) {
+          int i = mg_agg_blocks[a*mg_nba + ib]*g_N_s;
+          for(int n = 0; n < g_N_s; n++) little_mg_fields[k][i + n] -= s * little_mg_fields[l][i + n];
+        }
+      }
+      double nrm = 0.;
+      for(int ib = 0; ib < mg_nba; ib++) {
+        int i = mg_agg_blocks[a*mg_nba + ib]*g_N_s;
+        for(int n = 0; n < g_N_s; n++) nrm += creal(conj(little_mg_fields[k][i + n]) * little_mg_fields[k][i + n]);
+      }
+      nrm = 1./sqrt(nrm);
+      for(int ib = 0; ib < mg_nba; ib++) {
+        int i = mg_agg_blocks[a*mg_nba + ib]*g_N_s;
+        for(int n = 0; n < g_N_s; n++) little_mg_fields[k][i + n] *= nrm;
+      }
+    }
+  }
+  return;
+}
+
+
+/* A_c = V^dagger little_D V, computed from the stored block matrices */
+static void compute_little_little_D_mg() {
+  const int sq = little_mg_Nc*little_mg_Nc, bsq = g_N_s*g_N_s;
+  int ns = g_N_s, nc = little_mg_Nc, ldv = nb_blocks*g_N_s;
+  _Complex double * w = mg_work2[0];
+  _Complex double * y = mg_aggr_work;
+
+  memset(little_little_dirac_operator, 0, 9*mg_naggr*sq*sizeof(_Complex double));
+  for(int l = 0; l < little_mg_Nc; l++) {
+    memcpy(w, little_mg_fields[l], nb_blocks*g_N_s*sizeof(_Complex double));
+    little_field_gather(w);
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+    for(int a = 0; a < mg_naggr; a++) {
+      for(int ib = 0; ib < mg_nba; ib++) {
+        int i = mg_agg_blocks[a*mg_nba + ib];
+        for(int j = 0; j < 9; j++) {
+          /* neighbour block in the same aggregate contributes to the local part */
+          int d = (j == 0 || mg_blk_nb[8*i + j - 1] >= 0) ? 0 : j;
+          _FT(zgemv)("N", &ns, &ns, &CONE, block_list[i].little_dirac_operator + j*bsq,
+                     &ns, w + (nb_blocks*j + i)*g_N_s, &ONE, &CZERO, y + i*g_N_s, &ONE, 1);
+          _FT(zgemv)("C", &ns, &nc, &CONE, little_mg_fields[0] + i*g_N_s, &ldv,
+                     y + i*g_N_s, &ONE, &CONE, little_little_dirac_operator + (9*a + d)*sq + l*nc, &ONE, 1);
+        }
+      }
+    }
+  }
+  for(int i = 0; i < 9*mg_naggr*sq; i++) {
+    little_little_dirac_operator_32[i] = (_Complex float) little_little_dirac_operator[i];
+  }
+  return;
+}
+
+
+int init_little_mg(const int Nc) {
+  const int N = nb_blocks*g_N_s;
+  double atime, etime;
+  double * rnd;
+
+  if(little_evenodd || usePL) {
+    if(g_proc_id == 0) {
+      printf("# little_mg: three level multigrid requires LittleEvenOdd = no and useLittleLittleD = no, switched off\n");
+    }
+    little_mg_threelevel = 0;
+    return(1);
+  }
+  atime = gettime();
+  if(mg_init) free_little_mg();
+  if(init_aggregates() != 0) return(1);
+
+  little_mg_fields = calloc(Nc, sizeof(_Complex double*));
+  little_mg_fields_32 = calloc(Nc, sizeof(_Complex float*));
+  little_mg_fields[0] = calloc(Nc*N, sizeof(_Complex double));
+  little_mg_fields_32[0] = calloc(Nc*N, sizeof(_Complex float));
+  little_little_dirac_operator = calloc(9*mg_naggr*Nc*Nc, sizeof(_Complex double));
+  little_little_dirac_operator_32 = calloc(9*mg_naggr*Nc*Nc, sizeof(_Complex float));
+  mg_work2[0] = calloc(5*9*N, sizeof(_Complex double));
+  mg_work2_32[0] = calloc(5*9*N, sizeof(_Complex float));
+  mg_work3[0] = calloc(4*9*mg_naggr*Nc, sizeof(_Complex double));
+  mg_work3_32[0] = calloc(4*9*mg_naggr*Nc, sizeof(_Complex float));
+  mg_aggr_work = calloc(4*N, sizeof(_Complex double));
+  mg_aggr_work_32 = calloc(4*N, sizeof(_Complex float));
+  if(little_mg_fields[0] == NULL || little_mg_fields_32[0] == NULL || little_little_dirac_operator == NULL ||
+     little_little_dirac_operator_32 == NULL || mg_work2[0] == NULL || mg_work2_32[0] == NULL ||
+     mg_work3[0] == NULL || mg_work3_32[0] == NULL || mg_aggr_work == NULL || mg_aggr_work_32 == NULL) {
+    return(1);
+  }
+  for(int i = 1; i < Nc; i++) {
+    little_mg_fields[i] = little_mg_fields[i-1] + N;
+    little_mg_fields_32[i] = little_mg_fields_32[i-1] + N;
+  }
+  for(int i = 1; i < 5; i++) {
+    mg_work2[i] = mg_work2[i-1] + 9*N;
+    mg_work2_32[i] = mg_work2_32[i-1] + 9*N;
+  }
+  for(int i = 1; i < 4; i++) {
+    mg_work3[i] = mg_work3[i-1] + 9*mg_naggr*Nc;
+    mg_work3_32[i] = mg_work3_32[i-1] + 9*mg_naggr*Nc;
+  }
+  mg_init = 1;
+
+  if(dfl_subspace_updated) {
+    compute_little_D(0);
+    dfl_subspace_updated = 0;
+  }
+
+  /* random start vectors, smoothed by inverse iteration with the SAP */
+  rnd = malloc(2*N*sizeof(double));
+  for(int k = 0; k < Nc; k++) {
+    ranlxd(rnd, 2*N);
+    for(int i = 0; i < N; i++) {
+      little_mg_fields[k][i] = (2.*rnd[2*i] - 1.) + (2.*rnd[2*i+1] - 1.) * I;
+    }
+  }
+  free(rnd);
+  aggregate_orthonormalize();
+  for(int s = 0; s < little_mg_nsmooth; s++) {
+    for(int k = 0; k < Nc; k++) {
+      memcpy(mg_work2[1], little_mg_fields[k], N*sizeof(_Complex double));
+      little_mg_sap(mg_work2[2], mg_work2[1], little_mg_ncycle, little_mg_niter);
+      memcpy(little_mg_fields[k], mg_work2[2], N*sizeof(_Complex double));
+    }
+    aggregate_orthonormalize();
+  }
+  for(int i = 0; i < Nc*N; i++) {
+    little_mg_fields_32[0][i] = (_Complex float) little_mg_fields[0][i];
+  }
+
+  compute_little_little_D_mg();
+
+  etime = gettime();
+  if(g_proc_id == 0 && g_debug_level > 0) {
+    printf("# little_mg: %d aggregates of %d blocks (%d %d %d %d) per process with %d vectors each\n",
+           mg_naggr, mg_nba, mg_aggr_dir[0], mg_aggr_dir[1], mg_aggr_dir[2], mg_aggr_dir[3], Nc);
+    printf("# little_mg: time for setup of the third level %1.3e s\n", etime-atime);
+  }
+  return(0);
+}
+
+
+void free_little_mg() {
+  if(mg_init) {
+    free(little_mg_fields[0]);
+    free(little_mg_fields_32[0]);
+    free(little_mg_fields);
+    free(little_mg_fields_32);
+    free(little_little_dirac_operator);
+    free(little_little_dirac_operator_32);
+    free(mg_work2[0]);
+    free(mg_work2_32[0]);
+    free(mg_work3[0]);
+    free(mg_work3_32[0]);
+    free(mg_aggr_work);
+    free(mg_aggr_work_32);
+    free(mg_blk_agg);
+    free(mg_agg_blocks);
+    free(mg_blk_nb);
+    free(mg_agg_nb);
+    free(mg_agg_remote);
+    free(mg_agg_color);
+    mg_init = 0;
+  }
+  return;
+}
@@ -0,0 +1,55 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* third multigrid level on top of the block deflation                */
+/*                                                                    */
+/* the blocks of the little lattice are grouped into aggregates,      */
+/* little_mg_Nc near null vectors of little_D are restricted to the   */
+/* aggregates and the Galerkin operator (little little D) is built    */
+/* from them. little_mg_cycle applies one V- or K-cycle                */
+/*   SAP(little_D) -> little little D correction -> SAP(little_D)     */
+/* and is used as preconditioner for the little solver in project()   */
+
+#ifndef _LITTLE_MG_H
+#define _LITTLE_MG_H
+
+#include <complex.h>
+
+/* number of aggregates on this MPI process */
+extern int mg_naggr;
+
+int init_little_mg(const int Nc);
+void free_little_mg();
+
+void little_mg_gather(_Complex double * x);
+void little_little_D(_Complex double * v, _Complex double * w);
+void little_mg_restrict(_Complex double * const xc, _Complex double * const x);
+void little_mg_prolongate(_Complex double * const x, _Complex double * const xc);
+void little_mg_sap(_Complex double * const x, _Complex double * const b, const int ncycle, const int niter);
+void little_mg_cycle(_Complex double * const out, _Complex double * const in);
+
+void little_mg_gather_32(_Complex float * x);
+void little_little_D_32(_Complex float * v, _Complex float * w);
+void little_mg_restrict_32(_Complex float * const xc, _Complex float * const x);
+void little_mg_prolongate_32(_Complex float * const x, _Complex float * const xc);
+void little_mg_sap_32(_Complex float * const x, _Complex float * const b, const int ncycle, const int niter);
+void little_mg_cycle_32(_Complex float * const out, _Complex float * const in);
+
+#endif
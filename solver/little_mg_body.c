@@ -0,0 +1,276 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* fills the 8 neighbour slots of a little little field x         */
+/* (layout as for little_field_gather, but on the aggregates)     */
+void _PSWITCH(little_mg_gather)(_C_TYPE * x) {
+  const int nc = little_mg_Nc, na = mg_naggr;
+  _C_TYPE * buf = NULL, * src;
+#ifdef TM_USE_MPI
+  int nproc_dir[4] = {g_nproc_t, g_nproc_x, g_nproc_y, g_nproc_z};
+  int nb_up[4] = {g_nb_t_up, g_nb_x_up, g_nb_y_up, g_nb_z_up};
+  int nb_dn[4] = {g_nb_t_dn, g_nb_x_dn, g_nb_y_dn, g_nb_z_dn};
+  MPI_Request request[16];
+  MPI_Status status[16];
+  int nreq = 0;
+
+  buf = calloc(8 * na * nc, sizeof(_C_TYPE));
+  /* buf + 2*mu*na*nc from the up neighbour, buf + (2*mu+1)*na*nc from the down neighbour */
+  for(int mu = 0; mu < 4; mu++) {
+    if(nproc_dir[mu] > 1) {
+      MPI_Isend((void*)x, na * nc, _MPI_C_TYPE, nb_up[mu], 100 + 2*mu, g_cart_grid, &request[nreq++]);
+      MPI_Irecv((void*)(buf + (2*mu+1)*na*nc), na * nc, _MPI_C_TYPE, nb_dn[mu], 100 + 2*mu,
+                g_cart_grid, &request[nreq++]);
+      MPI_Isend((void*)x, na * nc, _MPI_C_TYPE, nb_dn[mu], 101 + 2*mu, g_cart_grid, &request[nreq++]);
+      MPI_Irecv((void*)(buf + 2*mu*na*nc), na * nc, _MPI_C_TYPE, nb_up[mu], 101 + 2*mu,
+                g_cart_grid, &request[nreq++]);
+    }
+  }
+  MPI_Waitall(nreq, request, status);
+#endif
+
+  for(int j = 0; j < 8; j++) {
+    for(int a = 0; a < na; a++) {
+      if(mg_agg_remote[8*a + j]) src = buf + j*na*nc;
+      else src = x;
+      memcpy(x + (na*(j+1) + a)*nc, src + mg_agg_nb[8*a + j]*nc, nc*sizeof(_C_TYPE));
+    }
+  }
+  free(buf);
+  return;
+}
+
+
+/* v = A_c w with the Galerkin operator A_c on the aggregates */
+void _PSWITCH(little_little_D)(_C_TYPE * v, _C_TYPE * w) {
+  const int sq = little_mg_Nc*little_mg_Nc;
+  int nc = little_mg_Nc;
+
+  _PSWITCH(little_mg_gather)(w);
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int a = 0; a < mg_naggr; a++) {
+    _MV(zgemv)("N", &nc, &nc, &_PSWITCH(CONE), _PSWITCH(little_little_dirac_operator) + 9*a*sq,
+               &nc, w + a*nc, &ONE, &_PSWITCH(CZERO), v + a*nc, &ONE, 1);
+    for(int j = 1; j < 9; j++) {
+      _MV(zgemv)("N", &nc, &nc, &_PSWITCH(CONE), _PSWITCH(little_little_dirac_operator) + (9*a + j)*sq,
+                 &nc, w + (mg_naggr*j + a)*nc, &ONE, &_PSWITCH(CONE), v + a*nc, &ONE, 1);
+    }
+  }
+  return;
+}
+
+
+/* xc_a = sum_{i in a} V_i^dagger x_i */
+void _PSWITCH(little_mg_restrict)(_C_TYPE * const xc, _C_TYPE * const x) {
+  int ns = g_N_s, nc = little_mg_Nc, ldv = nb_blocks*g_N_s;
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int a = 0; a < mg_naggr; a++) {
+    memset(xc + a*nc, 0, nc*sizeof(_C_TYPE));
+    for(int ib = 0; ib < mg_nba; ib++) {
+      int i = mg_agg_blocks[a*mg_nba + ib];
+      _MV(zgemv)("C", &ns, &nc, &_PSWITCH(CONE), _PSWITCH(little_mg_fields)[0] + i*ns, &ldv,
+                 x + i*ns, &ONE, &_PSWITCH(CONE), xc + a*nc, &ONE, 1);
+    }
+  }
+  return;
+}
+
+
+/* x_i = V_i xc_{a(i)} */
+void _PSWITCH(little_mg_prolongate)(_C_TYPE * const x, _C_TYPE * const xc) {
+  int ns = g_N_s, nc = little_mg_Nc, ldv = nb_blocks*g_N_s;
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int i = 0; i < nb_blocks; i++) {
+    _MV(zgemv)("N", &ns, &nc, &_PSWITCH(CONE), _PSWITCH(little_mg_fields)[0] + i*ns, &ldv,
+               xc + mg_blk_agg[i]*nc, &ONE, &_PSWITCH(CZERO), x + i*ns, &ONE, 1);
+  }
+  return;
+}
+
+
+/* little_D restricted to aggregate a, v and w in compact aggregate ordering */
+static void _PSWITCH(aggr_D)(const int a, _C_TYPE * const v, _C_TYPE * const w) {
+  const int sq = g_N_s*g_N_s;
+  int ns = g_N_s;
+
+  for(int ib = 0; ib < mg_nba; ib++) {
+    int i = mg_agg_blocks[a*mg_nba + ib];
+    _MV(zgemv)("N", &ns, &ns, &_PSWITCH(CONE), _PSWITCH(block_list[i].little_dirac_operator),
+               &ns, w + ib*ns, &ONE, &_PSWITCH(CZERO), v + ib*ns, &ONE, 1);
+    for(int j = 1; j < 9; j++) {
+      int k = mg_blk_nb[8*i + j - 1];
+      if(k < 0) continue;
+      _MV(zgemv)("N", &ns, &ns, &_PSWITCH(CONE), _PSWITCH(block_list[i].little_dirac_operator) + j*sq,
+                 &ns, w + k*ns, &ONE, &_PSWITCH(CONE), v + ib*ns, &ONE, 1);
+    }
+  }
+  return;
+}
+
+
+/* niter minimal residual steps for A_aa x = b on aggregate a, x0 = 0 */
+static void _PSWITCH(aggr_mr)(const int a, _C_TYPE * const x, _C_TYPE * const b, const int niter) {
+  const int N = mg_nba*g_N_s;
+  _C_TYPE * r = _PSWITCH(mg_aggr_work) + (4*a + 2)*N;
+  _C_TYPE * p = _PSWITCH(mg_aggr_work) + (4*a + 3)*N;
+  _Complex double alpha;
+  double nrm;
+
+  for(int i = 0; i < N; i++) {
+    x[i] = 0.;
+    r[i] = b[i];
+  }
+  for(int it = 0; it < niter; it++) {
+    _PSWITCH(aggr_D)(a, p, r);
+    alpha = 0.;
+    nrm = 0.;
+    for(int i = 0; i < N; i++) {
+      alpha += conj(p[i]) * r[i];
+      nrm += creal(conj(p[i]) * p[i]);
+    }
+    if(nrm == 0.) break;
+    alpha /= nrm;
+    for(int i = 0; i < N; i++) {
+      x[i] += (_C_TYPE)alpha * r[i];
+      r[i] -= (_C_TYPE)alpha * p[i];
+    }
+  }
+  return;
+}
+
+
+/* Schwarz alternating procedure on the aggregates for little_D x = b */
+/* x must provide space for the 8 neighbour slots (9*nb_blocks*g_N_s) */
+void _PSWITCH(little_mg_sap)(_C_TYPE * const x, _C_TYPE * const b, const int ncycle, const int niter) {
+  const int N = nb_blocks*g_N_s;
+  const int Na = mg_nba*g_N_s;
+  _C_TYPE * r = _PSWITCH(mg_work2)[0];
+
+  memset(x, 0, N*sizeof(_C_TYPE));
+  for(int ncy = 0; ncy < ncycle; ncy++) {
+    for(int eo = 0; eo < 2; eo++) {
+      /* r = b - little_D x */
+      memset(r, 0, N*sizeof(_C_TYPE));
+      _PSWITCH(little_D)(r, x);
+      _PSWITCH(ldiff)(r, b, r, N);
+
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+      for(int a = 0; a < mg_naggr; a++) {
+        if(mg_agg_color[a] != eo) continue;
+        _C_TYPE * ra = _PSWITCH(mg_aggr_work) + 4*a*Na;
+        _C_TYPE * ea = _PSWITCH(mg_aggr_work) + (4*a + 1)*Na;
+        for(int ib = 0; ib < mg_nba; ib++) {
+          memcpy(ra + ib*g_N_s, r + mg_agg_blocks[a*mg_nba + ib]*g_N_s, g_N_s*sizeof(_C_TYPE));
+        }
+        _PSWITCH(aggr_mr)(a, ea, ra, niter);
+        for(int ib = 0; ib < mg_nba; ib++) {
+          _C_TYPE * xb = x + mg_agg_blocks[a*mg_nba + ib]*g_N_s;
+          for(int s = 0; s < g_N_s; s++) {
+            xb[s] += ea[ib*g_N_s + s];
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
+
+/* minimal residual solver for the little little D, x0 = 0 */
+static int _PSWITCH(little_mg_coarse_mr)(_C_TYPE * const x, _C_TYPE * const b,
+                                         const int max_iter, const double eps_sq) {
+  const int N = mg_naggr*little_mg_Nc;
+  _C_TYPE * r = _PSWITCH(mg_work3)[2];
+  _C_TYPE * p = _PSWITCH(mg_work3)[3];
+  _C_TYPE alpha;
+  double nrm, norm_sq, err;
+  int i = 0;
+
+  memset(x, 0, N*sizeof(_C_TYPE));
+  memcpy(r, b, N*sizeof(_C_TYPE));
+  norm_sq = _PSWITCH(lsquare_norm)(b, N, 1);
+  err = norm_sq;
+  while((err > eps_sq*norm_sq) && (i < max_iter)) {
+    i++;
+    _PSWITCH(little_little_D)(p, r);
+    alpha = _PSWITCH(lscalar_prod)(p, r, N, 1);
+    nrm = _PSWITCH(lsquare_norm)(p, N, 1);
+    if(nrm == 0.) break;
+    alpha /= nrm;
+    _PSWITCH(lassign_add_mul)(x, r, alpha, N);
+    _PSWITCH(lassign_diff_mul)(r, p, alpha, N);
+    err = _PSWITCH(lsquare_norm)(r, N, 1);
+  }
+  if(g_proc_id == g_stdio_proc && g_debug_level > 3) {
+    printf("# little_mg: coarse MR %d iterations, |r|^2/|b|^2 = %e\n", i, err/norm_sq);
+  }
+  return(i);
+}
+
+
+/* one V (little_mg_cycle_type = 0) or K (= 1) cycle for little_D out = in */
+/* in K-cycle mode the coarse grid correction is rescaled with the        */
+/* minimal residual factor, i.e. one Krylov step on the middle level       */
+void _PSWITCH(little_mg_cycle)(_C_TYPE * const out, _C_TYPE * const in) {
+  const int N = nb_blocks*g_N_s;
+  _C_TYPE * r = _PSWITCH(mg_work2)[1];
+  _C_TYPE * e = _PSWITCH(mg_work2)[2];
+  _C_TYPE * t = _PSWITCH(mg_work2)[3];
+  _C_TYPE * x = _PSWITCH(mg_work2)[4];
+  _C_TYPE * rc = _PSWITCH(mg_work3)[0];
+  _C_TYPE * ec = _PSWITCH(mg_work3)[1];
+  _C_TYPE alpha = 1.0;
+  double nrm;
+
+  /* pre-smoothing */
+  _PSWITCH(little_mg_sap)(x, in, little_mg_ncycle, little_mg_niter);
+  memset(t, 0, N*sizeof(_C_TYPE));
+  _PSWITCH(little_D)(t, x);
+  _PSWITCH(ldiff)(r, in, t, N);
+
+  /* coarse grid correction */
+  _PSWITCH(little_mg_restrict)(rc, r);
+  _PSWITCH(little_mg_coarse_mr)(ec, rc, little_mg_coarse_max_iter, little_mg_coarse_prec);
+  _PSWITCH(little_mg_prolongate)(e, ec);
+  memset(t, 0, N*sizeof(_C_TYPE));
+  _PSWITCH(little_D)(t, e);
+  if(little_mg_cycle_type == 1) {
+    nrm = _PSWITCH(lsquare_norm)(t, N, 1);
+    if(nrm > 0.) alpha = _PSWITCH(lscalar_prod)(t, r, N, 1) / nrm;
+  }
+  _PSWITCH(lassign_add_mul)(x, e, alpha, N);
+  _PSWITCH(lassign_diff_mul)(r, t, alpha, N);
+
+  /* post-smoothing */
+  _PSWITCH(little_mg_sap)(e, r, little_mg_ncycle, little_mg_niter);
+  _PSWITCH(ladd)(out, x, e, N);
+  return;
+}
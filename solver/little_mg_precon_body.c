@@ -18,6 +18,11 @@
  ***********************************************************************/
 
 void _PSWITCH(little_mg_precon)(_Complex _F_TYPE * const out, _Complex _F_TYPE * const in) {
+  if(little_mg_threelevel) {
+    // one cycle of the three level multigrid on little_D
+    _PSWITCH(little_mg_cycle)(out, in);
+    return;
+  }
   // phi = PD_c^{-1} P^dagger in
   _PSWITCH(little_project_eo)(out, in, g_N_s);
   // in - D*phi
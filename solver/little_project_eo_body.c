@@ -22,6 +22,7 @@
 void _PSWITCH(little_project_eo)(_Complex _F_TYPE * const out, _Complex _F_TYPE * const in, const int  N) {
   static _Complex _F_TYPE * phi;
   static _Complex _F_TYPE * psi;
+  int m = nb_blocks*N, n = N, ld = nb_blocks*9*g_N_s;
 
   if(init_dfl_projector == 0) {
     alloc_dfl_projector();
@@ -31,9 +32,9 @@ void _PSWITCH(little_project_eo)(_Complex _F_TYPE * const out, _Complex _F_TYPE
   psi = (_Complex _F_TYPE *)work[3];
 
   /* NOTE IS THIS REALLY NECESSARY/CORRECT? */
-  for(int i = 0; i < N; i++) {
-    phi[i] = _PSWITCH(lscalar_prod)(_PSWITCH(little_dfl_fields_eo)[i], in, nb_blocks*N, 0);
-  }
+  /* all N inner products in one pass over in */
+  _MV(zgemv)("C", &m, &n, &_PSWITCH(CONE), _PSWITCH(little_dfl_fields_eo)[0], &ld, in, &ONE,
+             &_PSWITCH(CZERO), phi, &ONE, 1);
 
 #ifdef TM_USE_MPI
   MPI_Allreduce(phi, psi, N, _MPI_C_TYPE, MPI_SUM, MPI_COMM_WORLD);
@@ -48,10 +49,8 @@ void _PSWITCH(little_project_eo)(_Complex _F_TYPE * const out, _Complex _F_TYPE
       (phi[i]) += (_PSWITCH(little_A_eo)[j*N + i]) * (psi[j]);
     }
   }
-  _PSWITCH(lmul)(out, phi[0], _PSWITCH(little_dfl_fields_eo)[0], nb_blocks*N);
-  for(int i = 1; i < N; i++) {
-    _PSWITCH(lassign_add_mul)(out, _PSWITCH(little_dfl_fields_eo)[i], phi[i], nb_blocks*N);
-  }
+  _MV(zgemv)("N", &m, &n, &_PSWITCH(CONE), _PSWITCH(little_dfl_fields_eo)[0], &ld, phi, &ONE,
+             &_PSWITCH(CZERO), out, &ONE, 1);
 
   return;
 }
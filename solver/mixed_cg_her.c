@@ -57,6 +57,7 @@
 #include "solver_field.h"
 #include "solver/mixed_cg_her.h"
 #include "gettime.h"
+#include "profiler.h"
 
 
 
@@ -107,6 +108,7 @@ int mixed_cg_her(spinor * const P, spinor * const Q, solver_params_t solver_para
   //set solution to zero
   zero_spinor_field(P, N);
   
+  prof_begin("mixed_cg_her");
   atime = gettime();
   for(i = 0; i < N_outer; i++) {
 
@@ -191,12 +193,14 @@ int mixed_cg_her(spinor * const P, spinor * const Q, solver_params_t solver_para
       
       finalize_solver(solver_field, nr_sf);
       finalize_solver_32(solver_field32, nr_sf32); 
+      prof_end("mixed_cg_her", 0., 0.);
       return(iter+i);
     }
     iter++;
   }
   finalize_solver(solver_field, nr_sf);
   finalize_solver_32(solver_field32, nr_sf32); 
+  prof_end("mixed_cg_her", 0., 0.);
   return(-1);
 }
 
@@ -46,6 +46,7 @@
 #include "linalg_eo.h"
 #include "start.h"
 #include "gettime.h"
+#include "profiler.h"
 #include "solver/solver.h"
 #include "solver_field.h"
 #include "cg_mms_tm_nd.h"
@@ -111,6 +112,7 @@ int mixed_cg_mms_tm_nd(spinor ** const Pup, spinor ** const Pdn,
     if( (g_cart_id == 0 && g_debug_level > 2)) printf("# CGMMSND_mixed: norm of source too low: falling back to double mms solver %.6e\n", rr);
     return(cg_mms_tm_nd(Pup, Pdn, Qup, Qdn, solver_pm));
   }
+  prof_begin("mixed_cg_mms_tm_nd");
   
   r0r0   = rr;	// for relative precision 
   rr_old = rr;	// for the first iteration
@@ -499,7 +501,7 @@ int mixed_cg_mms_tm_nd(spinor ** const Pup, spinor ** const Pdn,
   
   //free reliable update stuff
   free(res); free(res0); free(maxres);
-
+  prof_end("mixed_cg_mms_tm_nd", 0., 0.);
 
   //if not converged -> return(-1)
   if(j<max_iter){
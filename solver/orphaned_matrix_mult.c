@@ -0,0 +1,55 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+/*******************************************************************************
+ *
+ * The solvers which run their whole iteration in a single parallel region
+ * (cg_her, rg_mixed_cg_her, cg_mms_tm, bicgstab_complex) need the orphaned
+ * version of the operator they are called with. For operators without one
+ * NULL is returned and the solvers use the operator as it is, each call
+ * opening its own parallel region.
+ *
+ *******************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include "global.h"
+#include "su3.h"
+#include "operator/tm_operators.h"
+#include "operator/tm_operators_32.h"
+#include "operator/clovertm_operators_32.h"
+#include "solver/orphaned_matrix_mult.h"
+
+matrix_mult orphaned_matrix_mult(matrix_mult f) {
+#ifdef TM_USE_OMP
+  if(f == &Qtm_pm_psi) return(&Qtm_pm_psi_orphaned);
+  if(f == &Mtm_plus_sym_psi) return(&Mtm_plus_sym_psi_orphaned);
+#endif
+  return(NULL);
+}
+
+matrix_mult32 orphaned_matrix_mult32(matrix_mult32 f32) {
+#ifdef TM_USE_OMP
+  if(f32 == &Qtm_pm_psi_32) return(&Qtm_pm_psi_32_orphaned);
+  if(f32 == &Qsw_pm_psi_32) return(&Qsw_pm_psi_32_orphaned);
+#endif
+  return(NULL);
+}
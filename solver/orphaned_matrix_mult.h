@@ -0,0 +1,31 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifndef _ORPHANED_MATRIX_MULT_H
+#define _ORPHANED_MATRIX_MULT_H
+
+#include "solver/matrix_mult_typedef.h"
+
+/* the version of f which is to be called by all threads from within a */
+/* parallel region, NULL if there is none or without OpenMP             */
+matrix_mult orphaned_matrix_mult(matrix_mult f);
+matrix_mult32 orphaned_matrix_mult32(matrix_mult32 f32);
+
+#endif
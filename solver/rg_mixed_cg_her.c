@@ -63,20 +63,117 @@
 #include "operator/clovertm_operators_32.h"
 #include "solver/matrix_mult_typedef.h"
 #include "solver/solver_params.h"
+#include "solver/orphaned_matrix_mult.h"
 #include "read_input.h"
 
 #include "solver_field.h"
 #include "solver/rg_mixed_cg_her.h"
 #include "gettime.h"
+#include "profiler.h"
 
 static void output_flops(const double seconds, const unsigned int N, const unsigned int iter_out, const unsigned int iter_in_sp, const unsigned int iter_in_dp, const double eps_sq);
 
+#ifdef TM_USE_OMP
+/* the inner loops below, to be called by all threads from within one parallel  */
+/* region with the orphaned operator; the scalars are thread local, but computed */
+/* from reductions which give the same value on all threads                      */
+static unsigned int inner_loop_high_orphaned(spinor * const x, spinor * const p, spinor * const q, spinor * const r, double * const rho1, const double delta,
+                                             matrix_mult f, const double eps_sq, const unsigned int N, const unsigned int iter, const unsigned int max_iter ){
+
+  double alpha, beta, rho, rhomax, rhoold;
+  unsigned int j = 0;
+
+  rho = *rho1;
+  rhomax = *rho1;
+  rhoold = *rho1;
+
+  while( rho > delta*rhomax && j+iter <= max_iter ){
+    ++j;
+    f(q,p);
+    alpha = rho/scalar_prod_r_orphaned(p,q,N,1);
+    assign_add_mul_r_orphaned(x, p, alpha, N);
+    assign_add_mul_r_orphaned(r, q, -alpha, N);
+    rho = square_norm_orphaned(r,N,1);
+    beta = rho / rhoold;
+    rhoold = rho;
+    assign_mul_add_r_orphaned(p, beta, r, N);
+    
+    if( 1.3*rho < eps_sq ) break;
+    if( rho > rhomax ) rhomax = rho;
+    
+#pragma omp master
+    if(g_debug_level > 2 && g_proc_id == 0) {
+      printf("DP_inner CG: %d res^2 %g\t\n", j+iter, rho);
+    }
+  }
+  /* all threads have read *rho1 */
+#pragma omp barrier
+#pragma omp master
+  *rho1 = rhoold;
+
+  return j;
+}
+
+static unsigned int inner_loop_orphaned(spinor32 * const x, spinor32 * const p, spinor32 * const q, spinor32 * const r, float * const rho1, const float delta,
+                                        matrix_mult32 f32, const float eps_sq, const unsigned int N, const unsigned int iter, const unsigned max_iter,
+                                        MCG_PR_TYPE pr ){
+
+  float alpha, beta, rho, rhomax, rhoold, pro;
+  unsigned int j = 0;
+
+  rho = *rho1;
+  rhomax = *rho1;
+  rhoold = *rho1;
+
+  while( rho > delta*rhomax && j+iter <= max_iter ){
+    ++j;
+    f32(q,p);
+    pro = scalar_prod_r_32_orphaned(p,q,N,1);
+    alpha = rho/pro;
+    assign_add_mul_r_32_orphaned(x, p, alpha, N);
+    assign_add_mul_r_32_orphaned(r, q, -alpha, N);
+    rho = square_norm_32_orphaned(r,N,1);
+    if(pr==MCG_PR){
+      beta = alpha*(alpha*square_norm_32_orphaned(q,N,1)-pro) / rhoold;
+    }else{
+      beta = rho / rhoold;
+    }
+    rhoold = rho;
+    assign_mul_add_r_32_orphaned(p, beta, r, N);
+#pragma omp master
+    if(g_debug_level > 2 && g_proc_id == 0) {
+      printf("SP_inner CG: %d res^2 %g\t\n", j+iter, rho);
+    }
+    if( 1.3*rho < eps_sq ) break;
+    if( rho > rhomax ) rhomax = rho;
+  }
+#pragma omp barrier
+#pragma omp master
+  *rho1 = rhoold;
+
+  return j;
+}
+#endif
+
 static inline unsigned int inner_loop_high(spinor * const x, spinor * const p, spinor * const q, spinor * const r, double * const rho1, const double delta,
                                            matrix_mult f, const double eps_sq, const unsigned int N, const unsigned int iter, const unsigned int max_iter ){
 
   static double alpha, beta, rho, rhomax;
   unsigned int j = 0;
 
+#ifdef TM_USE_OMP
+  matrix_mult fo = orphaned_matrix_mult(f);
+  if(fo != NULL) {
+#pragma omp parallel
+    {
+      unsigned int jl = inner_loop_high_orphaned(x, p, q, r, rho1, delta, fo, eps_sq, N, iter, max_iter);
+#pragma omp master
+      j = jl;
+    }
+    return j;
+  }
+#endif
+
   rho = *rho1;
   rhomax = *rho1;
 
@@ -113,6 +210,19 @@ static inline unsigned int inner_loop(spinor32 * const x, spinor32 * const p, sp
   static float rho, rhomax, pro;
   unsigned int j = 0;
 
+#ifdef TM_USE_OMP
+  matrix_mult32 f32o = orphaned_matrix_mult32(f32);
+  if(f32o != NULL && pipelined==MCG_NO_PIPELINED) {
+#pragma omp parallel
+    {
+      unsigned int jl = inner_loop_orphaned(x, p, q, r, rho1, delta, f32o, eps_sq, N, iter, max_iter, pr);
+#pragma omp master
+      j = jl;
+    }
+    return j;
+  }
+#endif
+
   rho = *rho1;
   rhomax = *rho1;
 
@@ -207,6 +317,7 @@ int rg_mixed_cg_her(spinor * const P, spinor * const Q, solver_params_t solver_p
     init_solver_field_32(&solver_field32, VOLUMEPLUSRAND/2, nr_sf32);    
   }
 
+  prof_begin("rg_mixed_cg_her");
   atime = gettime();
 
   // we could get away with using fewer fields, of course
@@ -299,6 +410,7 @@ int rg_mixed_cg_her(spinor * const P, spinor * const Q, solver_params_t solver_p
       g_sloppy_precision_flag = save_sloppy;
       finalize_solver(solver_field, nr_sf);
       finalize_solver_32(solver_field32, nr_sf32);
+      prof_end("rg_mixed_cg_her", 0., 0.);
       if( (iter_in_sp+iter_in_dp+iter_out) >= max_iter ){
         return(-1);
       } else {
@@ -327,6 +439,7 @@ int rg_mixed_cg_her(spinor * const P, spinor * const Q, solver_params_t solver_p
   g_sloppy_precision_flag = save_sloppy;
   finalize_solver(solver_field, nr_sf);
   finalize_solver_32(solver_field32, nr_sf32);
+  prof_end("rg_mixed_cg_her", 0., 0.);
   return -1; 
 }
 
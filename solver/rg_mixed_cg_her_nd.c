@@ -68,6 +68,7 @@
 #include "solver_field.h"
 #include "solver/rg_mixed_cg_her.h"
 #include "gettime.h"
+#include "profiler.h"
 
 static void output_flops(const double seconds, const unsigned int N, const unsigned int iter_out, 
                   const unsigned int iter_in_sp, const unsigned int iter_in_dp, const double eps_sq);
@@ -216,6 +217,7 @@ int rg_mixed_cg_her_nd(spinor * const P_up, spinor * const P_dn, spinor * const
     init_solver_field_32(&solver_field32, VOLUMEPLUSRAND/2, nr_sf32);    
   }
 
+  prof_begin("rg_mixed_cg_her_nd");
   atime = gettime();
 
   // we could get away with using fewer fields, of course
@@ -309,6 +311,7 @@ int rg_mixed_cg_her_nd(spinor * const P_up, spinor * const P_dn, spinor * const
       g_sloppy_precision_flag = save_sloppy;
       finalize_solver(solver_field, nr_sf);
       finalize_solver_32(solver_field32, nr_sf32); 
+      prof_end("rg_mixed_cg_her_nd", 0., 0.);
       if( (iter_in_sp+iter_in_dp+iter_out) >= max_iter ){
         return(-1);
       } else {
@@ -337,6 +340,7 @@ int rg_mixed_cg_her_nd(spinor * const P_up, spinor * const P_dn, spinor * const
   g_sloppy_precision_flag = save_sloppy;
   finalize_solver(solver_field, nr_sf);
   finalize_solver_32(solver_field32, nr_sf32);
+  prof_end("rg_mixed_cg_her_nd", 0., 0.);
   return -1; 
 }
 
@@ -56,6 +56,15 @@ typedef struct {
      where the maximum is over the iterated residuals since the last update */  
   float mcg_delta; 
 
+  /********************************
+   * low mode deflation parameters
+   ********************************/
+
+  int lowmodes_nev;        /* number of low modes of the squared operator used for deflation, 0 for none */
+  int lowmodes_single;     /* store the low modes in single precision */
+  int lowmodes_readwrite;  /* read the low modes from disk if available and write them otherwise */
+  double lowmodes_prec;    /* relative residual |Q^2 v - lambda v|/lambda of the low modes */
+
 } solver_params_t;
 
 #endif
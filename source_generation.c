@@ -23,10 +23,16 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <stdint.h>
+#include <complex.h>
+#ifdef TM_USE_OMP
+# include <omp.h>
+#endif
 #include "global.h"
 #include "start.h"
 #include "ranlxd.h"
 #include "su3spinor.h"
+#include "counter_random.h"
 #include "source_generation.h"
 
 #ifndef M_PI
@@ -72,53 +78,139 @@ void rnormal(double * r, const int n)
   return;
 }
 
-/* Generates a volume source with gaussian noise */
-/* in all real and imaginary elements            */
-/*                                               */
-/* i.e. xi*.xi = 2                               */
-/* is the normalisation                          */
-/* this is corrected for in the contraction      */
-/* codes                                         */
-void gaussian_volume_source(spinor * const P, spinor * const Q,
-			    const int sample, const int nstore, const int f) 
-{
-  int x, y, z, t, i, reset = 0, seed; 
-  int rlxd_state[105];
-  spinor * p;
+/* The stochastic sources below are generated site by site from the  */
+/* counter based random numbers of counter_random.h: the noise of a   */
+/* site only depends on the key of the source and the global site     */
+/* index. Every process and thread hence generates only its own sites */
+/* and the sources are independent of the process grid and of the    */
+/* number of threads.                                                 */
+
+/* tags to separate the keys of the different kinds of sources */
+#define SRC_KEY_VOLUME 1
+#define SRC_KEY_TSLICE 2
+#define SRC_KEY_ZSLICE 3
+#define SRC_KEY_NUCLEON 4
+
+static uint64_t source_key(const int tag, const int sample, const int nstore, const int t, const int f) {
+  uint64_t key = cr_mix((uint64_t)nstore + 0x9e3779b97f4a7c15ULL);
+  key = cr_mix(key ^ (uint64_t)sample);
+  key = cr_mix(key ^ (((uint64_t)tag << 48) | ((uint64_t)(t + 1) << 16) | (uint64_t)f));
+  return(key);
+}
 
-  /* save the ranlxd_state if neccessary */
-  if(ranlxd_init == 1) {
-    rlxd_get(rlxd_state);
-    reset = 1;
+/* one noise value */
+static inline _Complex double noise_value(const int noise, uint64_t * const state) {
+  const double sqr2 = 1./sqrt(2.);
+  double u[2], s, l;
+  int r;
+
+  switch(noise) {
+  case SRC_NOISE_Z2:
+    return(cr_random(state) > 0.5 ? 1. : -1.);
+  case SRC_NOISE_Z3:
+    r = (int)floor(3.*cr_random(state));
+    return(cexp(2.*M_PI*(r > 2 ? 2 : r)/3. * I));
+  case SRC_NOISE_Z4:
+    r = (int)floor(4.*cr_random(state));
+    /* co + si I as in the original pion sources */
+    if(r == 0) return(sqr2 + sqr2 * I);
+    else if(r == 1) return(sqr2 - sqr2 * I);
+    else if(r == 2) return(-sqr2 + sqr2 * I);
+    return(-sqr2 - sqr2 * I);
+  default:
+    /* gaussian, polar form of box-muller as in rnormal */
+    do {
+      u[0] = 2.*cr_random(state) - 1.;
+      u[1] = 2.*cr_random(state) - 1.;
+      s = u[0]*u[0] + u[1]*u[1];
+    } while(s == 0. || s > 1.);
+    l = sqrt(-2.*log(s)/s);
+    return(u[0]*l + u[1]*l * I);
   }
+}
 
-  /* Compute the seed */
-  seed =(int) abs(1 + sample + f*10*97 + nstore*100*53 + g_cart_id*13);
+static inline spinor * eo_site(spinor * const P, spinor * const Q, const int ix) {
+  if((g_coord[ix][0] + g_coord[ix][1] + g_coord[ix][2] + g_coord[ix][3])%2 == 0) {
+    return(P + g_lexic2eosub[ix]);
+  }
+  return(Q + g_lexic2eosub[ix]);
+}
 
-  rlxd_init(2, seed);
+/* is spin colour component j set in source k of the dilution scheme */
+static inline int in_dilution(const int dilution, const int k, const int j) {
+  switch(dilution) {
+  case SRC_DILUTION_SPIN:
+    return(j/3 == k);
+  case SRC_DILUTION_COLOUR:
+    return(j%3 == k);
+  case SRC_DILUTION_SPINCOLOUR:
+    return(j == k);
+  default:
+    return(1);
+  }
+}
 
-  for(t = 0; t < T; t++) {
-    for(x = 0; x < LX; x++) {
-      for(y =0; y < LY; y++) {
-	for(z = 0; z < LZ; z++) {
-	  i = g_lexic2eosub[ g_ipt[t][x][y][z] ];
-	  if((t+x+y+z+g_proc_coords[3]*LZ+g_proc_coords[2]*LY 
-	      + g_proc_coords[0]*T+g_proc_coords[1]*LX)%2 == 0) {
-	    p = P + i;
-	  }
-	  else {
-	    p = Q + i;
-	  }
-	  rnormal((double*)p, 24);
-	}
+/* sources on the sites with global coordinate x_mu = slice, all */
+/* sites for mu < 0                                              */
+static int noise_sources(spinor ** const P, spinor ** const Q, const int noise, const int dilution,
+                         const int mu, const int slice, const uint64_t key) {
+  const int n = source_dilution_size(dilution);
+
+  for(int k = 0; k < n; k++) {
+    zero_spinor_field(P[k], VOLUME/2);
+    zero_spinor_field(Q[k], VOLUME/2);
+  }
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int ix = 0; ix < VOLUME; ix++) {
+    if(mu >= 0 && g_coord[ix][mu] != slice) continue;
+    uint64_t state = cr_state(key, cr_global_site(ix));
+    _Complex double eta[12];
+    for(int j = 0; j < 12; j++) {
+      eta[j] = noise_value(noise, &state);
+    }
+    for(int k = 0; k < n; k++) {
+      _Complex double * const c = (_Complex double*) eo_site(P[k], Q[k], ix);
+      for(int j = 0; j < 12; j++) {
+        if(in_dilution(dilution, k, j)) c[j] = eta[j];
       }
     }
   }
+  return(n);
+}
 
-  /* reset the ranlxd if neccessary */
-  if(reset) {
-    rlxd_reset(rlxd_state);
+int source_dilution_size(const int dilution) {
+  switch(dilution) {
+  case SRC_DILUTION_SPIN:
+    return(4);
+  case SRC_DILUTION_COLOUR:
+    return(3);
+  case SRC_DILUTION_SPINCOLOUR:
+    return(12);
+  default:
+    return(1);
   }
+}
+
+int stochastic_sources(spinor ** const P, spinor ** const Q, const int noise, const int dilution,
+                       const int t, const int sample, const int nstore, const int f) {
+  const uint64_t key = source_key(t < 0 ? SRC_KEY_VOLUME : SRC_KEY_TSLICE, sample, nstore, t, f);
+  return(noise_sources(P, Q, noise, dilution, (t < 0 ? -1 : 0), t, key));
+}
+
+/* Generates a volume source with gaussian noise */
+/* in all real and imaginary elements            */
+/*                                               */
+/* i.e. xi*.xi = 2                               */
+/* is the normalisation                          */
+/* this is corrected for in the contraction      */
+/* codes                                         */
+void gaussian_volume_source(spinor * const P, spinor * const Q,
+			    const int sample, const int nstore, const int f) 
+{
+  spinor * p[1] = {P}, * q[1] = {Q};
+  stochastic_sources(p, q, SRC_NOISE_GAUSS, SRC_DILUTION_NONE, -1, sample, nstore, f);
   return;
 }
 
@@ -126,47 +218,22 @@ void extended_pion_source(spinor * const P, spinor * const Q,
 			  spinor * const R, spinor * const S,
 			  const int t0,
 			  const double px, const double py, const double pz) {
-  int lt, lx, ly, lz, i, x, y, z, id=0, t;
-  int coords[4];
-  spinor * p, * q, r;
-  _Complex double efac;
+  const int t = ((g_nproc_t*T)/2+t0)%(g_nproc_t*T);
 
   zero_spinor_field(P,VOLUME/2);
   zero_spinor_field(Q,VOLUME/2);
-  
-  t=((g_nproc_t*T)/2+t0)%(g_nproc_t*T);
-  lt = t - g_proc_coords[0]*T;
-  coords[0] = t / T;
-  for(x = 0; x < LX*g_nproc_x; x++) {
-    lx = x - g_proc_coords[1]*LX;
-    coords[1] = x / LX;
-    for(y = 0; y < LY*g_nproc_y; y++) {
-      ly = y - g_proc_coords[2]*LY;
-      coords[2] = y / LY;
-      for(z = 0; z < LZ*g_nproc_z; z++) {
-	lz = z - g_proc_coords[3]*LZ;
-	coords[3] = z / LZ;
-#ifdef TM_USE_MPI
-	MPI_Cart_rank(g_cart_grid, coords, &id);
-#endif
-	if(g_cart_id == id) {
-	  efac = cexp(-(px * x + py * y + pz * z) * I);
 
-	  i = g_lexic2eosub[ g_ipt[lt][lx][ly][lz] ];
-	  if((lt+lx+ly+lz+g_proc_coords[3]*LZ+g_proc_coords[2]*LY 
-	      + g_proc_coords[0]*T+g_proc_coords[1]*LX)%2 == 0) {
-	    p = P + i;
-	    q = R + i;
-	  }
-	  else {
-	    p = Q + i;
-	    q = S + i;
-	  }
-	  _gamma5(r, (*q));
-	  _spinor_mul_complex((*p),efac,r);
-	}
-      }
-    }
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int ix = 0; ix < VOLUME; ix++) {
+    if(g_coord[ix][0] != t) continue;
+    const _Complex double efac = cexp(-(px * g_coord[ix][1] + py * g_coord[ix][2] + pz * g_coord[ix][3]) * I);
+    spinor * const p = eo_site(P, Q, ix);
+    spinor * const q = eo_site(R, S, ix);
+    spinor r;
+    _gamma5(r, (*q));
+    _spinor_mul_complex((*p),efac,r);
   }
   return;
 }
@@ -174,86 +241,8 @@ void extended_pion_source(spinor * const P, spinor * const Q,
 void source_generation_pion_only(spinor * const P, spinor * const Q,
 				 const int t,
 				 const int sample, const int nstore) {
-
-  int reset = 0, i, x, y, z, is, ic, lt, lx, ly, lz, id=0;
-  int coords[4], seed, r;
-  double rnumber, si=0., co=0.;
-  int rlxd_state[105];
-  const double sqr2 = 1./sqrt(2.);
-  _Complex double * p = NULL;
-  
-  zero_spinor_field(P,VOLUME/2);
-  zero_spinor_field(Q,VOLUME/2);
-
-  /* save the ranlxd_state if neccessary */
-  if(ranlxd_init == 1) {
-    rlxd_get(rlxd_state);
-    reset = 1;
-  }
-
-  /* Compute the seed */
-  seed =(int) abs(1 + sample + t*10*97 + nstore*100*53);
-
-  rlxd_init(2, seed);
-
-  lt = t - g_proc_coords[0]*T;
-  coords[0] = t / T;
-  for(x = 0; x < LX*g_nproc_x; x++) {
-    lx = x - g_proc_coords[1]*LX;
-    coords[1] = x / LX;
-    for(y = 0; y < LY*g_nproc_y; y++) {
-      ly = y - g_proc_coords[2]*LY;
-      coords[2] = y / LY;
-      for(z = 0; z < LZ*g_nproc_z; z++) {
-	lz = z - g_proc_coords[3]*LZ;
-	coords[3] = z / LZ;
-#ifdef TM_USE_MPI
-	MPI_Cart_rank(g_cart_grid, coords, &id);
-#endif
-	for(is = 0; is < 4; is++) {
-	  for(ic = 0; ic < 3; ic++) {
-	    ranlxd(&rnumber, 1);
-	    if(g_cart_id  == id) {
-	      r = (int)floor(4.*rnumber);
-	      if(r == 0)
-	      {
-		si = sqr2;
-		co = sqr2;
-	      }
-	      else if(r == 1) {
-		si = -sqr2;
-		co = sqr2;
-	      }
-	      else if(r==2) {
-		si = sqr2;
-		co = -sqr2;
-	      }
-	      else {
-		si = -sqr2;
-		co = -sqr2;
-	      }
-	    
-	      i = g_lexic2eosub[ g_ipt[lt][lx][ly][lz] ];
-	      if((lt+lx+ly+lz+g_proc_coords[3]*LZ+g_proc_coords[2]*LY 
-		  + g_proc_coords[0]*T+g_proc_coords[1]*LX)%2 == 0) {
-		p = (_Complex double*)(P + i);
-	      }
-	      else {
-		p = (_Complex double*)(Q + i);
-	      }
-	      
-	      (*(p+3*is+ic)) = co + si * I;
-	    }
-	  }
-	}
-      }
-    }
-  }
-	    
-  /* reset the ranlxd if neccessary */
-  if(reset) {
-    rlxd_reset(rlxd_state);
-  }
+  spinor * p[1] = {P}, * q[1] = {Q};
+  stochastic_sources(p, q, SRC_NOISE_Z4, SRC_DILUTION_NONE, t, sample, nstore, 0);
   return;
 }
 
@@ -261,198 +250,36 @@ void source_generation_pion_only(spinor * const P, spinor * const Q,
 void source_generation_pion_zdir(spinor * const P, spinor * const Q,
                                  const int z,
                                  const int sample, const int nstore) {
-
-  int reset = 0, i, x, y, t, is, ic, lt, lx, ly, lz, id=0;
-  int coords[4], seed, r;
-  double rnumber, si=0., co=0.;
-  int rlxd_state[105];
-  const double sqr2 = 1./sqrt(2.);
-  _Complex double * p = NULL;
-  
-  zero_spinor_field(P,VOLUME/2);
-  zero_spinor_field(Q,VOLUME/2);
-
-  /* save the ranlxd_state if neccessary */
-  if(ranlxd_init == 1) {
-    rlxd_get(rlxd_state);
-    reset = 1;
-  }
-
-  /* Compute the seed */
-  seed =(int) abs(1 + sample + z*10*97 + nstore*100*53);
-
-  rlxd_init(2, seed);
-  lz = z - g_proc_coords[3]*LZ;
-  coords[3] = z / LZ;
- for(t = 0; t < T*g_nproc_t; t++) {
-   lt = t - g_proc_coords[0]*T;
-   coords[0] = t / T;  
-   for(x = 0; x < LX*g_nproc_x; x++) {
-    lx = x - g_proc_coords[1]*LX;
-    coords[1] = x / LX;
-    for(y = 0; y < LY*g_nproc_y; y++) {
-      ly = y - g_proc_coords[2]*LY;
-      coords[2] = y / LY;
-
-#ifdef TM_USE_MPI
-        MPI_Cart_rank(g_cart_grid, coords, &id);
-#endif
-        for(is = 0; is < 4; is++) {
-          for(ic = 0; ic < 3; ic++) {
-            ranlxd(&rnumber, 1);
-            if(g_cart_id  == id) {
-              r = (int)floor(4.*rnumber);
-              if(r == 0) {
-                si = sqr2;
-                co = sqr2;
-              }
-              else if(r == 1) {
-                si = -sqr2;
-                co = sqr2;
-              }
-              else if(r==2) {
-                si = sqr2;
-                co = -sqr2;
-              }
-              else {
-                si = -sqr2;
-                co = -sqr2;
-              }
-            
-              i = g_lexic2eosub[ g_ipt[lt][lx][ly][lz] ];
-              if((lt+lx+ly+lz+g_proc_coords[3]*LZ+g_proc_coords[2]*LY 
-                  + g_proc_coords[0]*T+g_proc_coords[1]*LX)%2 == 0) {
-                p = (_Complex double*)(P + i);
-              }
-              else {
-                p = (_Complex double*)(Q + i);
-              }
-              
-	      (*(p+3*is+ic)) = co + si * I;
-            }
-          }
-        }
-      }
-    }
-  }
-            
-  /* reset the ranlxd if neccessary */
-  if(reset) {
-    rlxd_reset(rlxd_state);
-  }
+  spinor * p[1] = {P}, * q[1] = {Q};
+  noise_sources(p, q, SRC_NOISE_Z4, SRC_DILUTION_NONE, 3, z,
+                source_key(SRC_KEY_ZSLICE, sample, nstore, z, 0));
   return;
 }
 
 /* end Florian Burger 4.11.2009 */
 
-
-
-
-
 void source_generation_nucleon(spinor * const P, spinor * const Q, 
 			       const int is, const int ic,
 			       const int t, const int nt, const int nx, 
 			       const int sample, const int nstore, 
 			       const int meson) {
-
-  double rnumber, si=0., co=0., sqr2;
-  int rlxd_state[105];
-  int reset = 0, seed, r, tt, lt, xx, lx, yy, ly, zz, lz;
-  int coords[4], id=0, i;
-  _Complex double * p = NULL;
-  const double s0=0.;
-  const double c0=1.;
-  const double s1=sin(2.*M_PI/3.);
-  const double c1=cos(2.*M_PI/3.);
-  const double s2=sin(4.*M_PI/3.);
-  const double c2=cos(4.*M_PI/3.);
+  const uint64_t key = source_key(SRC_KEY_NUCLEON, sample, nstore, t, 0);
+  const int noise = meson ? SRC_NOISE_Z4 : SRC_NOISE_Z3;
 
   zero_spinor_field(P,VOLUME/2);
   zero_spinor_field(Q,VOLUME/2);
 
-  sqr2 = 1./sqrt(2.);
-  /* save the ranlxd_state if neccessary */
-  if(ranlxd_init == 1) {
-    rlxd_get(rlxd_state);
-    reset = 1;
-  }
-
-  /* Compute the seed */
-  seed =(int) abs(1 + sample + t*10*97 + nstore*100*53);
-
-  rlxd_init(2, seed);
-
-  for(tt = t; tt < T*g_nproc_t; tt+=nt) {
-    lt = tt - g_proc_coords[0]*T;
-    coords[0] = tt / T;
-    for(xx = 0; xx < LX*g_nproc_x; xx+=nx) {
-      lx = xx - g_proc_coords[1]*LX;
-      coords[1] = xx / LX;
-      for(yy = 0; yy < LY*g_nproc_y; yy+=nx) {
-	ly = yy - g_proc_coords[2]*LY;
-	coords[2] = yy / LY;
-	for(zz = 0; zz < LZ*g_nproc_z; zz+=nx) {
-	  lz = zz - g_proc_coords[3]*LZ;
-	  coords[3] = zz / LZ;
-#ifdef TM_USE_MPI
-	  MPI_Cart_rank(g_cart_grid, coords, &id);
+  /* every nt-th timeslice from t on and every nx-th site in space, */
+  /* the noise of a site does not depend on is and ic               */
+#ifdef TM_USE_OMP
+#pragma omp parallel for
 #endif
-	  ranlxd(&rnumber, 1);
-	  if(g_cart_id  == id) {
-	    if(meson) {
-	      r = (int)floor(4.*rnumber);
-	      if(r == 0) {
-		si = sqr2;
-		co = sqr2;
-	      }
-	      else if(r == 1) {
-		si = -sqr2;
-		co = sqr2;
-	      }
-	      else if(r==2) {
-		si = sqr2;
-		co = -sqr2;
-	      }
-	      else {
-		si = -sqr2;
-		co = -sqr2;
-	      }
-	    }
-	    else {
-	      r = (int)floor(3.*rnumber);
-	      if(r == 0) {
-		si = s0;
-		co = c0;
-	      }
-	      else if(r == 1) {
-		si = s1;
-		co = c1;
-	      }
-	      else {
-		si = s2;
-		co = c2;
-	      }
-	    }
-	    
-	    i = g_lexic2eosub[ g_ipt[lt][lx][ly][lz] ];
-	    if((lt+lx+ly+lz+g_proc_coords[3]*LZ+g_proc_coords[2]*LY 
-		+ g_proc_coords[0]*T+g_proc_coords[1]*LX)%2 == 0) {
-	      p = (_Complex double*)(P + i);
-	    }
-	    else {
-	      p = (_Complex double*)(Q + i);
-	    }
-
-	    (*(p+3*is+ic)) = co + si * I;
-	  }
-	}
-      }
-    }
-  }
-
-  /* reset the ranlxd if neccessary */
-  if(reset) {
-    rlxd_reset(rlxd_state);
+  for(int ix = 0; ix < VOLUME; ix++) {
+    if(g_coord[ix][0] < t || (g_coord[ix][0] - t)%nt != 0 || g_coord[ix][1]%nx != 0 ||
+       g_coord[ix][2]%nx != 0 || g_coord[ix][3]%nx != 0) continue;
+    uint64_t state = cr_state(key, cr_global_site(ix));
+    _Complex double * const p = (_Complex double*) eo_site(P, Q, ix);
+    p[3*is+ic] = noise_value(noise, &state);
   }
   return;
 }
@@ -19,6 +19,26 @@
 #ifndef _SOURCE_GENERATION_H
 #define _SOURCE_GENERATION_H
 
+/* noise of the stochastic sources */
+#define SRC_NOISE_GAUSS 0
+#define SRC_NOISE_Z2 1
+#define SRC_NOISE_Z3 2
+#define SRC_NOISE_Z4 3
+
+/* dilution of the stochastic sources, giving 1, 4, 3 or 12 sources */
+#define SRC_DILUTION_NONE 0
+#define SRC_DILUTION_SPIN 1
+#define SRC_DILUTION_COLOUR 2
+#define SRC_DILUTION_SPINCOLOUR 3
+
+int source_dilution_size(const int dilution);
+
+/* generates the source_dilution_size(dilution) diluted sources of one   */
+/* noise vector at once into the even/odd fields P[k], Q[k]; timeslice t */
+/* or volume source for t < 0, f labels independent noise vectors        */
+int stochastic_sources(spinor ** const P, spinor ** const Q, const int noise, const int dilution,
+                       const int t, const int sample, const int nstore, const int f);
+
 void gaussian_volume_source(spinor * const P, spinor * const Q,
 			    const int sample, const int nstore, const int f);
 
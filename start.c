@@ -77,6 +77,7 @@
 #include "ranlxd.h"
 #include "ranlxs.h"
 #include "start.h"
+#include "derived_gauge_fields.h"
 
 static void gauss_vector(double v[],int n)
 {
@@ -435,7 +436,7 @@ void unit_g_gauge_field(void)
       g_gauge_field[ix][mu]=unit_su3();
     }
   }
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
   return;
 }
 
@@ -503,7 +504,7 @@ void random_gauge_field(const int repro, su3 ** const gf) {
     }
   }
 
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
   return;
 }
 
@@ -699,7 +700,7 @@ void set_gauge_field(const double c)
       g_gauge_field[ix][mu]=set_su3(c);
     }
   }
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
   return;
 }
 
@@ -11,6 +11,7 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "linalg_eo.h"
+#include "derived_gauge_fields.h"
 #ifdef TM_USE_MPI
   #include<mpi.h>
   #include "mpi_init.h"
@@ -519,7 +520,7 @@ void apply_gtrafo2 (su3 ** gfield, su3 * trafofield) {
   }
   
   // update gauge copy fields in the next call to HoppingMatrix
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
 }
 
 */
@@ -593,7 +594,7 @@ void apply_gtrafo (su3 ** gfield, su3 * trafofield) {
   }
   
   /* update gauge copy fields in the next call to HoppingMatrix */
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
  
 }//apply_gtrafo()
 
@@ -647,7 +648,7 @@ void apply_inv_gtrafo (su3 ** gfield, su3 * trafofield) {
   }
   
   /* update gauge copy fields in the next call to HoppingMatrix */
-  g_update_gauge_copy = 1;
+  gauge_field_changed();
   
 }
 
@@ -1018,7 +1019,7 @@ void gtrafo_eo_nd(spinor * const Even_s, spinor * const Odd_s, spinor * const Ev
     /* copy back the saved original field located in g_tempgauge_field -> update necessary*/
     plaquette1 = measure_plaquette(g_gauge_field);
     copy_gauge_field(g_gauge_field, g_tempgauge_field);
-    g_update_gauge_copy = 1;
+    gauge_field_changed();
     plaquette2 = measure_plaquette(g_gauge_field);
     if (g_proc_id == 0) printf("\tPlaquette before inverse gauge fixing: %.16e\n", plaquette1/6./VOLUME);
     if (g_proc_id == 0) printf("\tPlaquette after inverse gauge fixing:  %.16e\n", plaquette2/6./VOLUME);
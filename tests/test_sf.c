@@ -0,0 +1,57 @@
+#include <config.h>
+#include <global.h>
+
+#ifdef TM_USE_MPI
+#include <mpi.h>
+#endif
+
+#include "../mpi_init.h"
+#include "../init/init_openmp.h"
+#include "../geometry_eo.h"
+#include "../start.h"
+#include "../init/init_gauge_field.h"
+#include "../init/init_geometry_indices.h"
+#include "../xchange/xchange_gauge.h"
+#include "test_sf_plaquette.h"
+
+TEST_SUITES {
+  TEST_SUITE_ADD(SF_PLAQUETTE),
+  TEST_SUITES_CLOSURE
+};
+
+int main(int argc,char *argv[]){
+#ifdef TM_USE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+  /* a random gauge field on a 4^4 lattice */
+  T_global = 4;
+#ifndef FIXEDVOLUME
+  L = LX = LY = LZ = 4;
+  N_PROC_X = N_PROC_Y = N_PROC_Z = 1;
+#endif
+  tmlqcd_mpi_init(argc, argv);
+#ifdef TM_USE_OMP
+  /* more than one thread to check the reduction over the threads */
+  omp_num_threads = 2;
+#endif
+  init_openmp();
+  init_gauge_field(VOLUMEPLUSRAND + g_dbw2rand, 0);
+  init_geometry_indices(VOLUMEPLUSRAND + g_dbw2rand);
+  geometry();
+  start_ranlux(1, 123456);
+  random_gauge_field(0, g_gauge_field);
+#ifdef TM_USE_MPI
+  xchange_gauge(g_gauge_field);
+#endif
+
+  CU_SET_OUT_PREFIX("regressions/");
+  CU_RUN(argc,argv);
+
+  free_gauge_field();
+  free_geometry_indices();
+#ifdef TM_USE_MPI
+  MPI_Finalize();
+#endif
+
+  return 0;
+}
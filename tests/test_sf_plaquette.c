@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <config.h>
+#include <cu/cu.h>
+#include "../global.h"
+#include "../su3.h"
+#include "../measure_gauge_action.h"
+#include "../measure_rectangles.h"
+#include "../sf/sf_utils.h"
+#include "../sf/sf_calc_action.h"
+
+#define EPS 1e-12
+
+/* the per timeslice plaquettes must agree with measure_gauge_observables */
+TEST(sf_plaquette_timeslices) {
+  const int nt = g_nproc_t*T;
+  const double VS = (double)VOLUME*g_nproc/nt;
+  double * ss = malloc(2*nt*sizeof(double));
+  double * st = ss + nt;
+  double * tslice = malloc(3*nt*sizeof(double));
+  double sst = 0.;
+  int test = 0;
+  gauge_obs_t obs;
+
+  sf_plaquette_slices(g_gauge_field, ss, st);
+  measure_gauge_observables((const su3**)g_gauge_field, GAUGE_OBS_PLAQ, &obs, tslice);
+
+  for(int t = 0; t < nt; t++) {
+    const double ref = 3.*6.*VS*tslice[3*t];
+    if(fabs(ss[t] + st[t] - ref) > EPS*ref) {
+      printf("t = %d: %e %e\n", t, ss[t] + st[t], ref);
+      test = 1;
+    }
+    sst += st[t];
+  }
+  assertFalseM(test, "The SF plaquettes per timeslice differ from measure_gauge_observables!\n");
+
+  /* the space-time plaquettes are the planes 01, 02 and 03 */
+  const double ref = 3.*(obs.plaq_plane[0] + obs.plaq_plane[1] + obs.plaq_plane[2])*g_nproc*VOLUME;
+  assertFalseM(fabs(sst - ref) > EPS*ref, "The SF space-time plaquettes differ from measure_gauge_observables!\n");
+
+  free(tslice);
+  free(ss);
+}
+
+/* bulk, boundary and wrapped plaquettes must add up to measure_plaquette */
+TEST(sf_plaquette_parts) {
+  double parts[5];
+  const double plaq = measure_plaquette((const su3**)g_gauge_field);
+
+  calc_sq_plaq_parts(parts);
+  assertFalseM(fabs(parts[0] - plaq) > EPS*plaq, "calc_sq_plaq differs from measure_plaquette!\n");
+  assertFalseM(fabs(parts[1] + parts[2] + parts[3] + parts[4] - parts[0]) > EPS*plaq,
+               "The SF plaquette parts do not add up to the total!\n");
+  assertFalseM(fabs(calc_bulk_sq_plaq() - parts[1]) > EPS*plaq, "calc_bulk_sq_plaq differs from calc_sq_plaq_parts!\n");
+  assertFalseM(fabs(calc_wrapped_sq_plaq() - parts[4]) > EPS*plaq, "calc_wrapped_sq_plaq differs from calc_sq_plaq_parts!\n");
+}
+
+TEST(sf_rectangles) {
+  const double rect = measure_rectangles((const su3**)g_gauge_field);
+  const double sfrect = calc_rect_plaq();
+
+  assertFalseM(fabs(sfrect - rect) > EPS*rect, "calc_rect_plaq differs from measure_rectangles!\n");
+  assertFalseM(fabs(sf_measure_rectangle() - 6.*rect) > EPS*rect, "sf_measure_rectangle differs from measure_rectangles!\n");
+}
+
+/* with periodic weights the SF Wilson action is the usual one */
+TEST(sf_wilson_action) {
+  const double beta = 6.;
+  const double plaq = measure_plaquette((const su3**)g_gauge_field);
+
+  assertFalseM(fabs(sf_measure_plaquette() - 6.*plaq) > EPS*plaq, "sf_measure_plaquette differs from measure_plaquette!\n");
+  assertFalseM(fabs(measure_wilson_action(beta) + beta*plaq) > EPS*beta*plaq,
+               "measure_wilson_action differs from measure_plaquette!\n");
+}
@@ -0,0 +1,19 @@
+#ifndef _TEST_SF_PLAQUETTE_H
+#define _TEST_SF_PLAQUETTE_H
+
+#include <cu/cu.h>
+
+TEST(sf_plaquette_timeslices);
+TEST(sf_plaquette_parts);
+TEST(sf_rectangles);
+TEST(sf_wilson_action);
+
+TEST_SUITE(SF_PLAQUETTE){
+  TEST_ADD(sf_plaquette_timeslices),
+  TEST_ADD(sf_plaquette_parts),
+  TEST_ADD(sf_rectangles),
+  TEST_ADD(sf_wilson_action),
+  TEST_SUITE_CLOSURE
+};
+
+#endif /* _TEST_SF_PLAQUETTE_H */
@@ -0,0 +1,51 @@
+#include <config.h>
+#include <global.h>
+
+#ifdef TM_USE_MPI
+#include <mpi.h>
+#endif
+
+#include "../mpi_init.h"
+#include "../init/init_openmp.h"
+#include "../geometry_eo.h"
+#include "../init/init_geometry_indices.h"
+#include "../init/init_spinor_field.h"
+#include "test_sources_dilution.h"
+
+TEST_SUITES {
+  TEST_SUITE_ADD(SOURCES_DILUTION),
+  TEST_SUITES_CLOSURE
+};
+
+int main(int argc,char *argv[]){
+#ifdef TM_USE_MPI
+  MPI_Init(&argc, &argv);
+#endif
+  /* a 4^4 lattice */
+  T_global = 4;
+#ifndef FIXEDVOLUME
+  L = LX = LY = LZ = 4;
+  N_PROC_X = N_PROC_Y = N_PROC_Z = 1;
+#endif
+  tmlqcd_mpi_init(argc, argv);
+#ifdef TM_USE_OMP
+  /* more than one thread, the sources must not depend on it */
+  omp_num_threads = 2;
+#endif
+  init_openmp();
+  init_geometry_indices(VOLUMEPLUSRAND + g_dbw2rand);
+  geometry();
+  /* one undiluted and up to 12 diluted sources, even and odd parts */
+  init_spinor_field(VOLUMEPLUSRAND/2, 26);
+
+  CU_SET_OUT_PREFIX("regressions/");
+  CU_RUN(argc,argv);
+
+  free_spinor_field();
+  free_geometry_indices();
+#ifdef TM_USE_MPI
+  MPI_Finalize();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <complex.h>
+#include <config.h>
+#include <cu/cu.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#include "../global.h"
+#include "../su3.h"
+#include "../source_generation.h"
+
+/* number of spin colour components of the local field which differ */
+/* between the diluted sources and the undiluted noise vector,       */
+/* summed over all processes                                         */
+static int check_dilution(const int noise, const int dilution, const int t) {
+  spinor ** P = g_spinor_field + 2;
+  spinor ** Q = g_spinor_field + 14;
+  const int n = source_dilution_size(dilution);
+  int err = 0, gerr = 0;
+
+  stochastic_sources(g_spinor_field, g_spinor_field + 1, noise, SRC_DILUTION_NONE, t, 3, 1000, 0);
+  if(stochastic_sources(P, Q, noise, dilution, t, 3, 1000, 0) != n) {
+    err++;
+  }
+
+  for(int ix = 0; ix < VOLUME; ix++) {
+    const int even = (g_coord[ix][0] + g_coord[ix][1] + g_coord[ix][2] + g_coord[ix][3])%2 == 0;
+    const int i = g_lexic2eosub[ix];
+    const _Complex double * const eta = (_Complex double*)((even ? g_spinor_field[0] : g_spinor_field[1]) + i);
+    for(int j = 0; j < 12; j++) {
+      /* the undiluted noise only lives on the requested timeslice */
+      if(t >= 0 && g_coord[ix][0] != t && eta[j] != 0.) err++;
+      if(eta[j] == 0. && (t < 0 || g_coord[ix][0] == t)) err++;
+      /* component j is set in exactly one source, with the undiluted noise */
+      int found = 0;
+      for(int k = 0; k < n; k++) {
+        const _Complex double c = ((_Complex double*)((even ? P[k] : Q[k]) + i))[j];
+        int set;
+        switch(dilution) {
+        case SRC_DILUTION_SPIN:
+          set = (j/3 == k);
+          break;
+        case SRC_DILUTION_COLOUR:
+          set = (j%3 == k);
+          break;
+        case SRC_DILUTION_SPINCOLOUR:
+          set = (j == k);
+          break;
+        default:
+          set = 1;
+        }
+        if(set) {
+          found++;
+          if(c != eta[j]) err++;
+        }
+        else if(c != 0.) err++;
+      }
+      if(found != 1) err++;
+    }
+  }
+#ifdef TM_USE_MPI
+  MPI_Allreduce(&err, &gerr, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#else
+  gerr = err;
+#endif
+  return(gerr);
+}
+
+TEST(sources_dilution_volume) {
+  int test = 0;
+
+  for(int noise = SRC_NOISE_GAUSS; noise <= SRC_NOISE_Z4; noise++) {
+    for(int dilution = SRC_DILUTION_NONE; dilution <= SRC_DILUTION_SPINCOLOUR; dilution++) {
+      const int err = check_dilution(noise, dilution, -1);
+      if(err != 0) {
+        if(g_proc_id == 0) printf("noise %d, dilution %d: %d wrong components\n", noise, dilution, err);
+        test = 1;
+      }
+    }
+  }
+  assertFalseM(test, "The diluted volume sources do not match the undiluted noise vector!\n");
+}
+
+TEST(sources_dilution_timeslice) {
+  int test = 0;
+
+  for(int noise = SRC_NOISE_GAUSS; noise <= SRC_NOISE_Z4; noise++) {
+    for(int dilution = SRC_DILUTION_NONE; dilution <= SRC_DILUTION_SPINCOLOUR; dilution++) {
+      for(int t = 0; t < g_nproc_t*T; t += g_nproc_t*T-1) {
+        const int err = check_dilution(noise, dilution, t);
+        if(err != 0) {
+          if(g_proc_id == 0) printf("noise %d, dilution %d, t = %d: %d wrong components\n", noise, dilution, t, err);
+          test = 1;
+        }
+      }
+    }
+  }
+  assertFalseM(test, "The diluted timeslice sources do not match the undiluted noise vector!\n");
+}
+
+/* the single source routines are the undiluted batched sources */
+TEST(sources_dilution_wrappers) {
+  spinor * P[1] = {g_spinor_field[2]}, * Q[1] = {g_spinor_field[3]};
+  int err = 0, gerr = 0;
+
+  gaussian_volume_source(g_spinor_field[0], g_spinor_field[1], 5, 1000, 1);
+  stochastic_sources(P, Q, SRC_NOISE_GAUSS, SRC_DILUTION_NONE, -1, 5, 1000, 1);
+  for(int i = 0; i < VOLUME/2; i++) {
+    for(int k = 0; k < 2; k++) {
+      const _Complex double * const a = (_Complex double*)(g_spinor_field[k] + i);
+      const _Complex double * const b = (_Complex double*)(g_spinor_field[2+k] + i);
+      for(int j = 0; j < 12; j++) {
+        if(a[j] != b[j]) err++;
+      }
+    }
+  }
+
+  source_generation_pion_only(g_spinor_field[0], g_spinor_field[1], 1, 5, 1000);
+  stochastic_sources(P, Q, SRC_NOISE_Z4, SRC_DILUTION_NONE, 1, 5, 1000, 0);
+  for(int i = 0; i < VOLUME/2; i++) {
+    for(int k = 0; k < 2; k++) {
+      const _Complex double * const a = (_Complex double*)(g_spinor_field[k] + i);
+      const _Complex double * const b = (_Complex double*)(g_spinor_field[2+k] + i);
+      for(int j = 0; j < 12; j++) {
+        if(a[j] != b[j]) err++;
+      }
+    }
+  }
+#ifdef TM_USE_MPI
+  MPI_Allreduce(&err, &gerr, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#else
+  gerr = err;
+#endif
+  assertFalseM(gerr != 0, "The single source routines differ from stochastic_sources!\n");
+}
@@ -0,0 +1,17 @@
+#ifndef _TEST_SOURCES_DILUTION_H
+#define _TEST_SOURCES_DILUTION_H
+
+#include <cu/cu.h>
+
+TEST(sources_dilution_volume);
+TEST(sources_dilution_timeslice);
+TEST(sources_dilution_wrappers);
+
+TEST_SUITE(SOURCES_DILUTION){
+  TEST_ADD(sources_dilution_volume),
+  TEST_ADD(sources_dilution_timeslice),
+  TEST_ADD(sources_dilution_wrappers),
+  TEST_SUITE_CLOSURE
+};
+
+#endif /* _TEST_SOURCES_DILUTION_H */
@@ -0,0 +1,295 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include<config.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#ifdef TM_USE_MPI
+# include <mpi.h>
+#endif
+#include "global.h"
+#include "monomial/monomial.h"
+#include "integrator.h"
+#include "tune_integrator.h"
+
+/* largest number of steps per timescale considered */
+#define TUNE_NMAX 32
+
+static int tune_ntraj = 0;
+static double tune_dh2 = 0.;
+static int tune_nforce[max_no_monomials];
+static double tune_force[max_no_monomials];
+static int tune_ncall[max_no_monomials];
+static double tune_time[max_no_monomials];
+
+/* state of the search for a single assignment */
+static int tune_T, tune_M;
+static int tune_ids[max_no_monomials];
+static double tune_F2[10], tune_C[10], tune_K, tune_vtarget;
+static double tune_best;
+static int tune_n[10], tune_best_n[10];
+/* overall best assignment */
+static double tune_opt;
+static int tune_opt_n[10], tune_opt_ts[max_no_monomials];
+
+void tune_integrator_force(const int id, const double f2) {
+  if(!Integrator.tune) return;
+  tune_force[id] += f2;
+  tune_nforce[id]++;
+  return;
+}
+
+void tune_integrator_cost(const int id, const double t) {
+  if(!Integrator.tune) return;
+  tune_time[id] += t;
+  tune_ncall[id]++;
+  return;
+}
+
+void tune_integrator_dh(const double dh) {
+  if(!Integrator.tune) return;
+  tune_dh2 += dh*dh;
+  tune_ntraj++;
+  return;
+}
+
+/* order of the integration error per unit time */
+static int tune_order(const int type) {
+  if(type == OMF4 || type == FG) return(4);
+  return(2);
+}
+
+/* force evaluations per step after merging neighbouring kicks */
+static int tune_kicks(const int type) {
+  if(type == LEAPFROG) return(1);
+  if(type == OMF4) return(4);
+  if(type == FG) return(3);
+  return(2);
+}
+
+/* variance of dH needed for acceptance rate acc, using              */
+/* <dH> = <dH^2>/2 and P_acc = erfc(sqrt(<dH>)/2)                    */
+static double tune_target_variance(const double acc) {
+  double lo = 0., hi = 100.;
+  for(int i = 0; i < 100; i++) {
+    double mid = 0.5*(lo + hi);
+    if(erfc(sqrt(mid/8.)) > acc) lo = mid;
+    else hi = mid;
+  }
+  return(lo);
+}
+
+/* predicted <dH^2>/K and cost for the timescale sums and steps n */
+static double tune_variance(const double * const F2, const int * const n) {
+  double N = 1., v = 0.;
+  for(int t = tune_T-1; t > -1; t--) {
+    N *= n[t];
+    v += pow(pow(Integrator.tau/N, tune_order(Integrator.type[t]))*F2[t], 2);
+  }
+  return(v);
+}
+
+static double tune_cost(const double * const C, const int * const n) {
+  double N = 1., c = 0.;
+  for(int t = tune_T-1; t > -1; t--) {
+    N *= n[t];
+    c += N*tune_kicks(Integrator.type[t])*C[t];
+  }
+  return(c);
+}
+
+/* depth first search over the steps, outermost timescale first     */
+/* the cost grows and the variance decreases monotonically with n   */
+static void tune_search(const int t, const double N, const double cost, const double var) {
+  if(t < 0) {
+    if(var <= tune_vtarget && cost < tune_best) {
+      tune_best = cost;
+      for(int i = 0; i < tune_T; i++) tune_best_n[i] = tune_n[i];
+    }
+    return;
+  }
+  for(int n = 1; n <= TUNE_NMAX; n++) {
+    double Nt = N*n;
+    double c = cost + Nt*tune_kicks(Integrator.type[t])*tune_C[t];
+    if(c >= tune_best) break;
+    double v = var + tune_K*pow(pow(Integrator.tau/Nt, tune_order(Integrator.type[t]))*tune_F2[t], 2);
+    if(v > tune_vtarget) continue;
+    tune_n[t] = n;
+    tune_search(t-1, Nt, c, v);
+  }
+  return;
+}
+
+static void tune_sums(const int * const ts, double * const F2, double * const C) {
+  for(int t = 0; t < tune_T; t++) {
+    F2[t] = 0.;
+    C[t] = 0.;
+  }
+  for(int m = 0; m < tune_M; m++) {
+    int id = tune_ids[m];
+    F2[ts[id]] += tune_force[id]/tune_nforce[id];
+    C[ts[id]] += tune_time[id]/tune_ncall[id];
+  }
+  return;
+}
+
+static void tune_evaluate(const int * const ts) {
+  int count[10] = {0};
+  /* Integrator.mnls_per_ts holds at most 10 monomials per timescale */
+  for(int i = 0; i < no_monomials; i++) {
+    if(ts[i] > -1 && ts[i] < tune_T && ++count[ts[i]] > 10) return;
+  }
+  tune_sums(ts, tune_F2, tune_C);
+  tune_best = HUGE_VAL;
+  tune_search(tune_T-1, 1., 0., 0.);
+  if(tune_best < tune_opt) {
+    tune_opt = tune_best;
+    for(int t = 0; t < tune_T; t++) tune_opt_n[t] = tune_best_n[t];
+    for(int i = 0; i < no_monomials; i++) tune_opt_ts[i] = ts[i];
+  }
+  return;
+}
+
+/* all splittings of the monomials ordered by cost into contiguous */
+/* non-empty groups, the cheapest going to the finest timescale    */
+static void tune_partitions(int * const ts, const int start, const int t) {
+  if(t == tune_T-1) {
+    for(int m = start; m < tune_M; m++) ts[tune_ids[m]] = t;
+    tune_evaluate(ts);
+    return;
+  }
+  for(int end = start+1; end <= tune_M-(tune_T-1-t); end++) {
+    for(int m = start; m < end; m++) ts[tune_ids[m]] = t;
+    tune_partitions(ts, end, t+1);
+  }
+  return;
+}
+
+static int tune_propose() {
+  int ts[max_no_monomials];
+  double F2[10], C[10];
+
+  tune_T = Integrator.no_timescales;
+  tune_M = 0;
+  for(int i = 0; i < no_monomials; i++) {
+    ts[i] = monomial_list[i].timescale;
+    if(monomial_list[i].derivativefunction != NULL && tune_nforce[i] > 0 && tune_ncall[i] > 0
+       && ts[i] > -1 && ts[i] < tune_T) {
+      tune_ids[tune_M] = i;
+      tune_M++;
+    }
+  }
+  /* order by cost per force, insertion sort is sufficient here */
+  for(int m = 1; m < tune_M; m++) {
+    int id = tune_ids[m], k = m;
+    while(k > 0 && tune_time[tune_ids[k-1]]/tune_ncall[tune_ids[k-1]] > tune_time[id]/tune_ncall[id]) {
+      tune_ids[k] = tune_ids[k-1];
+      k--;
+    }
+    tune_ids[k] = id;
+  }
+
+  printf("# Integrator tuning after %d trajectories: <dH^2> = %e\n", tune_ntraj, tune_dh2/tune_ntraj);
+  for(int m = 0; m < tune_M; m++) {
+    int id = tune_ids[m];
+    printf("# monomial %s on timescale %d: <F^2> = %e, time per force = %e s\n",
+           monomial_list[id].name, ts[id], tune_force[id]/tune_nforce[id], tune_time[id]/tune_ncall[id]);
+  }
+
+  tune_sums(ts, F2, C);
+  double v = tune_variance(F2, Integrator.n_int);
+  if(tune_dh2 <= 0. || v <= 0.) {
+    printf("# Integrator tuning: no dH or force signal, keeping the current setup\n");
+    return(0);
+  }
+  tune_K = (tune_dh2/tune_ntraj)/v;
+  tune_vtarget = tune_target_variance(Integrator.tune_acceptance);
+  printf("# current setup: predicted acceptance %f, force time per trajectory %e s\n",
+         erfc(sqrt(tune_dh2/tune_ntraj/8.)), tune_cost(C, Integrator.n_int));
+
+  /* the current assignment is always a candidate, even if it is not ordered by cost */
+  tune_opt = HUGE_VAL;
+  tune_evaluate(ts);
+  if(tune_M >= tune_T) {
+    tune_partitions(ts, 0, 0);
+  }
+  if(tune_opt == HUGE_VAL) {
+    printf("# Integrator tuning: no setup with at most %d steps per timescale reaches acceptance %f\n",
+           TUNE_NMAX, Integrator.tune_acceptance);
+    return(0);
+  }
+
+  tune_sums(tune_opt_ts, F2, C);
+  printf("# proposed setup: predicted acceptance %f, force time per trajectory %e s\n",
+         erfc(sqrt(tune_K*tune_variance(F2, tune_opt_n)/8.)), tune_opt);
+  for(int t = 0; t < tune_T; t++) {
+    printf("#   IntegrationSteps%d = %d\n", t, tune_opt_n[t]);
+  }
+  for(int m = 0; m < tune_M; m++) {
+    printf("#   monomial %s: Timescale = %d\n", monomial_list[tune_ids[m]].name, tune_opt_ts[tune_ids[m]]);
+  }
+  fflush(stdout);
+  return(1);
+}
+
+int tune_integrator() {
+  int found = 0, applied = 0;
+
+  if(!Integrator.tune || tune_ntraj < Integrator.tune_trajectories) return(0);
+
+  if(g_proc_id == 0) found = tune_propose();
+#ifdef TM_USE_MPI
+  /* the costs are those of process 0, all processes follow its choice */
+  MPI_Bcast(&found, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if(found) {
+    MPI_Bcast(tune_opt_n, 10, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(tune_opt_ts, no_monomials, MPI_INT, 0, MPI_COMM_WORLD);
+  }
+#endif
+  if(found && Integrator.tune == 2) {
+    for(int t = 0; t < Integrator.no_timescales; t++) {
+      Integrator.n_int[t] = tune_opt_n[t];
+    }
+    for(int i = 0; i < no_monomials; i++) {
+      monomial_list[i].timescale = tune_opt_ts[i];
+    }
+    integrator_set_timescales();
+    if(g_proc_id == 0) {
+      printf("# Integrator tuning: proposed setup applied\n");
+      fflush(stdout);
+    }
+    applied = 1;
+  }
+
+  /* tuning is done once */
+  Integrator.tune = 0;
+  tune_ntraj = 0;
+  tune_dh2 = 0.;
+  for(int i = 0; i < max_no_monomials; i++) {
+    tune_nforce[i] = 0;
+    tune_force[i] = 0.;
+    tune_ncall[i] = 0;
+    tune_time[i] = 0.;
+  }
+  return(applied);
+}
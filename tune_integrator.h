@@ -0,0 +1,45 @@
+/***********************************************************************
+ *
+ * Copyright (C) 2016
+ *
+ * This file is part of tmLQCD.
+ *
+ * tmLQCD is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tmLQCD is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tmLQCD.  If not, see <http://www.gnu.org/licenses/>.
+ ***********************************************************************/
+
+/* automatic tuning of the timescale assignment and the integration   */
+/* steps from measured force norms, costs per force and <dH^2>        */
+/*                                                                    */
+/* during Integrator.tune_trajectories trajectories the squared force */
+/* of every monomial (from monitor_forces), the wall time per         */
+/* derivative call (from update_momenta) and dH are recorded. Then    */
+/*   <dH^2> = K sum_ts (h_ts^p_ts F2_ts)^2                            */
+/* is calibrated on the current setup, with h_ts the step size, p_ts  */
+/* the order of the integrator and F2_ts the sum of the squared       */
+/* forces on timescale ts, and the cheapest assignment of monomials   */
+/* (ordered by cost per force) and steps per timescale reaching       */
+/* Integrator.tune_acceptance is proposed and, if requested, applied  */
+/* the measurements are not part of the checkpoints (checkpoint.h),   */
+/* after a restart they are accumulated anew                          */
+
+#ifndef _TUNE_INTEGRATOR_H
+#define _TUNE_INTEGRATOR_H
+
+void tune_integrator_force(const int id, const double f2);
+void tune_integrator_cost(const int id, const double t);
+void tune_integrator_dh(const double dh);
+/* returns 1 if a new setup was applied, 0 otherwise */
+int tune_integrator();
+
+#endif
@@ -27,12 +27,7 @@
 
 
 #if defined _USE_HALFSPINOR
-void update_backward_gauge(su3 ** const gf) {
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
-
+void update_backward_gauge_orphaned(su3 ** const gf) {
   int ix=0, kb=0, iy=0;
 
 #ifdef TM_USE_OMP
@@ -59,11 +54,27 @@ void update_backward_gauge(su3 ** const gf) {
     _su3_assign(g_gauge_field_copy[1][ix][3], gf[kb][3]);
   }
 
+// we use the implicit barrier at the end of the single section to catch all
+// threads, in the meantime, one of them modifies the global flag
 #ifdef TM_USE_OMP
-  } /* OpenMP closing brace */
+#pragma omp single
+  {
 #endif
-
   g_update_gauge_copy = 0;
+#ifdef TM_USE_OMP
+  }
+#endif
+}
+
+void update_backward_gauge(su3 ** const gf) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  update_backward_gauge_orphaned(gf);
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
   return;
 }
 
@@ -121,12 +132,7 @@ void update_backward_gauge_32(su3_32 ** const gf) {
 
 #elif _USE_TSPLITPAR 
 
-void update_backward_gauge(su3 ** const gf) {
-#ifdef TM_USE_OMP
-#pragma omp parallel
-  {
-#endif
-
+void update_backward_gauge_orphaned(su3 ** const gf) {
   int ix=0, kb=0, kb2=0;
 
 #ifdef TM_USE_OMP
@@ -172,22 +178,33 @@ void update_backward_gauge(su3 ** const gf) {
     _su3_assign(g_gauge_field_copys[ix][5],gf[kb][3]);
   }
 
+// we use the implicit barrier at the end of the single section to catch all
+// threads, in the meantime, one of them modifies the global flag
 #ifdef TM_USE_OMP
-  } /* OpenMP closing brace */
+#pragma omp single
+  {
 #endif
-
   g_update_gauge_copy = 0;
-  return;
+#ifdef TM_USE_OMP
+  }
+#endif
 }
 
-#else
-
 void update_backward_gauge(su3 ** const gf) {
 #ifdef TM_USE_OMP
 #pragma omp parallel
   {
 #endif
+  update_backward_gauge_orphaned(gf);
+#ifdef TM_USE_OMP
+  } /* OpenMP closing brace */
+#endif
+  return;
+}
 
+#else
+
+void update_backward_gauge_orphaned(su3 ** const gf) {
   int ix=0, kb=0, kb2=0;
 
 #ifdef TM_USE_OMP
@@ -233,11 +250,27 @@ void update_backward_gauge(su3 ** const gf) {
     _su3_assign(g_gauge_field_copy[ix][7],gf[kb][3]);
   }
 
+// we use the implicit barrier at the end of the single section to catch all
+// threads, in the meantime, one of them modifies the global flag
+#ifdef TM_USE_OMP
+#pragma omp single
+  {
+#endif
+  g_update_gauge_copy = 0;
+#ifdef TM_USE_OMP
+  }
+#endif
+}
+
+void update_backward_gauge(su3 ** const gf) {
+#ifdef TM_USE_OMP
+#pragma omp parallel
+  {
+#endif
+  update_backward_gauge_orphaned(gf);
 #ifdef TM_USE_OMP
   } /* OpenMP closing brace */
 #endif
-
-  g_update_gauge_copy = 0;
   return;
 }
 
@@ -39,6 +39,8 @@
 #include "hamiltonian_field.h"
 #include "update_gauge.h"
 #include "init/init_gauge_field.h"
+#include "derived_gauge_fields.h"
+#include "profiler.h"
 
 
 /*******************************************************
@@ -51,6 +53,7 @@
 void update_gauge(const double step, hamiltonian_field_t * const hf) {
   double atime, etime;
   atime = gettime();
+  prof_begin("update_gauge");
 #ifdef TM_USE_OMP
 #define static
 #pragma omp parallel
@@ -89,26 +92,28 @@ void update_gauge(const double step, hamiltonian_field_t * const hf) {
   } /* OpenMP parallel closing brace */
 #endif
   
-#ifdef TM_USE_MPI
-  /* for parallelization */
-  xchange_gauge(hf->gaugefield);
-#endif
-  
-  /*Convert to a 32 bit gauge field, after xchange*/
-  convert_32_gauge_field(g_gauge_field_32, hf->gaugefield, VOLUMEPLUSRAND + g_dbw2rand);
-  
   /*
-   * The backward copy of the gauge field
-   * is not updated here!
+   * The boundary, the 32 bit field and the backward
+   * copies are not updated here, but on first use
+   * (see derived_gauge_fields.c)
    */
   hf->update_gauge_copy = 1;
-  g_update_gauge_copy = 1;
-  g_update_gauge_copy_32 = 1;
+  if(hf->gaugefield == g_gauge_field) {
+    gauge_field_changed();
+  }
+  else {
+#ifdef TM_USE_MPI
+    xchange_gauge(hf->gaugefield);
+#endif
+    g_update_gauge_copy = 1;
+    g_update_gauge_copy_32 = 1;
+  }
 
   etime = gettime();
   if(g_debug_level > 1 && g_proc_id == 0) {
     printf("# Time gauge update: %e s\n", etime-atime); 
   } 
+  prof_end("update_gauge", 0., (double)VOLUME*4*(2*sizeof(su3) + sizeof(su3adj)));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(updategauge)
@@ -37,6 +37,10 @@
 #include "hamiltonian_field.h"
 #include "update_momenta.h"
 #include "gettime.h"
+#include "derived_gauge_fields.h"
+#include "integrator.h"
+#include "tune_integrator.h"
+#include "profiler.h"
 
 /* Updates the momenta: equation 16 of Gottlieb */
 void update_momenta(int * mnllist, double step, const int no, 
@@ -53,7 +57,14 @@ void update_momenta(int * mnllist, double step, const int no,
   
   for(int k = 0; k < no; k++) {
     if(monomial_list[ mnllist[k] ].derivativefunction != NULL) {
+      double atime = Integrator.tune ? gettime() : 0.;
+      prof_begin("derivative");
+      prof_begin(monomial_list[ mnllist[k] ].name);
+      update_gauge_fields_for_monomial(mnllist[k]);
       monomial_list[ mnllist[k] ].derivativefunction(mnllist[k], hf);
+      prof_end(monomial_list[ mnllist[k] ].name, 0., 0.);
+      prof_end("derivative", 0., 0.);
+      if(Integrator.tune) tune_integrator_cost(mnllist[k], gettime() - atime);
     }
   }
   
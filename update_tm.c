@@ -60,6 +60,9 @@
 #include "hamiltonian_field.h"
 #include "update_tm.h"
 #include "gettime.h"
+#include "derived_gauge_fields.h"
+#include "tune_integrator.h"
+#include "profiler.h"
 
 extern su3 ** g_gauge_field_saved;
 
@@ -97,6 +100,7 @@ int update_tm(double *plaquette_energy, double *rectangle_energy,
 
   sprintf(tmp_filename, ".conf.t%05d.tmp",traj_counter);
   atime = gettime();
+  prof_begin("update_tm");
 
   /*
    *  here the momentum and spinor fields are initialized 
@@ -117,37 +121,55 @@ int update_tm(double *plaquette_energy, double *rectangle_energy,
     }
   }
 
+  /* refit adaptive rational approximations, only during thermalisation */
+  prof_begin("adapt_rational");
+  adapt_rational(&hf, acctest);
+  prof_end("adapt_rational", 0., 0.);
+
   /* heatbath for all monomials */
+  prof_begin("heatbath");
   for(i = 0; i < Integrator.no_timescales; i++) {
     for(j = 0; j < Integrator.no_mnls_per_ts[i]; j++) {
+      prof_begin(monomial_list[ Integrator.mnls_per_ts[i][j] ].name);
+      update_gauge_fields_for_monomial(Integrator.mnls_per_ts[i][j]);
       monomial_list[ Integrator.mnls_per_ts[i][j] ].hbfunction(Integrator.mnls_per_ts[i][j], &hf);
+      prof_end(monomial_list[ Integrator.mnls_per_ts[i][j] ].name, 0., 0.);
     }
   }
+  prof_end("heatbath", 0., 0.);
 
-  if(Integrator.monitor_forces) monitor_forces(&hf);
+  if(Integrator.monitor_forces || Integrator.tune) monitor_forces(&hf);
   /* initialize the momenta  */
   enep = random_su3adj_field(reproduce_randomnumber_flag, hf.momenta);
 
   g_sloppy_precision = 1;
 
   /* run the trajectory */
+  prof_begin("integrate");
   if(Integrator.n_int[Integrator.no_timescales-1] > 0) {
     Integrator.integrate[Integrator.no_timescales-1](Integrator.tau, 
                  Integrator.no_timescales-1, 1);
   }
+  prof_end("integrate", 0., 0.);
 
   g_sloppy_precision = 0;
 
   /* compute the final energy contributions for all monomials */
   dh = 0.;
+  prof_begin("acc");
   for(i = 0; i < Integrator.no_timescales; i++) {
     for(j = 0; j < Integrator.no_mnls_per_ts[i]; j++) {
+      prof_begin(monomial_list[ Integrator.mnls_per_ts[i][j] ].name);
+      update_gauge_fields_for_monomial(Integrator.mnls_per_ts[i][j]);
       dh += monomial_list[ Integrator.mnls_per_ts[i][j] ].accfunction(Integrator.mnls_per_ts[i][j], &hf);
+      prof_end(monomial_list[ Integrator.mnls_per_ts[i][j] ].name, 0., 0.);
     }
   }
+  prof_end("acc", 0., 0.);
 
   enepx = moment_energy(hf.momenta);
 
+  update_gauge_halo();
   if (!bc_flag) { /* if PBC */
     new_plaquette_energy = measure_plaquette( (const su3**) hf.gaugefield);
     if(g_rgi_C1 > 0. || g_rgi_C1 < 0.) {
@@ -160,6 +182,7 @@ int update_tm(double *plaquette_energy, double *rectangle_energy,
   if(g_proc_id == 0 && g_debug_level > 3) {
     printf("called momenta_acc dH = %e\n", (enepx - enep));
   }
+  tune_integrator_dh(dh);
   expmdh = exp(-dh);
   /* the random number is only taken at node zero and then distributed to 
      the other sites */
@@ -209,6 +232,7 @@ int update_tm(double *plaquette_energy, double *rectangle_energy,
     ret_dh = 0.;
     for(i = 0; i < Integrator.no_timescales; i++) {
       for(j = 0; j < Integrator.no_mnls_per_ts[i]; j++) {
+        update_gauge_fields_for_monomial(Integrator.mnls_per_ts[i][j]);
         ret_dh += monomial_list[ Integrator.mnls_per_ts[i][j] ].accfunction(Integrator.mnls_per_ts[i][j], &hf);
       }
     }
@@ -328,16 +352,13 @@ int update_tm(double *plaquette_energy, double *rectangle_energy,
     }
   }
   hf.update_gauge_copy = 1;
-  g_update_gauge_copy = 1;
-  g_update_gauge_copy_32 = 1;  
-#ifdef TM_USE_MPI
-  xchange_gauge(hf.gaugefield);
-#endif
-  
-  /*Convert to a 32 bit gauge field, after xchange*/
-  convert_32_gauge_field(g_gauge_field_32, hf.gaugefield, VOLUMEPLUSRAND + g_dbw2rand); 
+  gauge_field_changed();
+  /* code outside the trajectory does not know about the lazy */
+  /* update, so the boundary and the 32 bit field are set here */
+  update_gauge_field_32();
   
   etime=gettime();
+  prof_end("update_tm", 0., 0.);
 
   /* printing data in the .data file */
   if(g_proc_id==0) {
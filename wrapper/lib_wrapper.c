@@ -55,7 +55,11 @@
 #include "start.h"
 #include "operator.h"
 #include "measure_gauge_action.h"
+#include "derived_gauge_fields.h"
 #include "linalg/convert_eo_to_lexic.h"
+#include "solver/eigenspace.h"
+#include "solver/solver_field.h"
+#include "aligned_malloc.h"
 #include "include/tmLQCD.h"
 #include "fatal_error.h"
 
@@ -73,6 +77,21 @@ extern void finalize_gpu_fields();
 
 
 static int tmLQCD_invert_initialised = 0;
+/* even/odd source and propagator fields of tmLQCD_invert_batch and */
+/* tmLQCD_invert_eo_32, kept between calls such that repeated calls  */
+/* do not allocate again                                             */
+static spinor ** batch_field = NULL;
+#define NO_BATCH_FIELDS 4
+
+static int init_batch_field() {
+  if(batch_field == NULL) {
+    if(init_solver_field(&batch_field, VOLUMEPLUSRAND/2, NO_BATCH_FIELDS) != 0) {
+      batch_field = NULL;
+      return(-1);
+    }
+  }
+  return(0);
+}
 
 int tmLQCD_invert_init(int argc, char *argv[], const int _verbose, const int external_id) {
 
@@ -222,6 +241,7 @@ int tmLQCD_read_gauge(const int nconfig) {
   if(!lowmem_flag){
     convert_32_gauge_field(g_gauge_field_32, g_gauge_field, VOLUMEPLUSRAND);
   }
+  eigenspace_reset(nconfig);
 
   double plaquette = measure_plaquette( (const su3** const) g_gauge_field)/(6.*VOLUME*g_nproc);
   if (g_cart_id == 0) {
@@ -271,8 +291,157 @@ int tmLQCD_invert(double * const propagator, double * const source,
 }
 
 
+/* inverts op_id on the even/odd fields sr0, sr1 into prop0, prop1 */
+/* without copying them                                           */
+static void invert_eo_fields(spinor * const prop0, spinor * const prop1,
+                             spinor * const sr0, spinor * const sr1, const int op_id) {
+  operator * optr = &operator_list[op_id];
+  spinor * const save[4] = {optr->sr0, optr->sr1, optr->prop0, optr->prop1};
+  unsigned int index_start = 0;
+
+  optr->sr0 = sr0;
+  optr->sr1 = sr1;
+  optr->prop0 = prop0;
+  optr->prop1 = prop1;
+  zero_spinor_field(optr->prop0, VOLUME / 2);
+  zero_spinor_field(optr->prop1, VOLUME / 2);
+
+  optr->inverter(op_id, index_start, 0);
+
+  optr->sr0 = save[0];
+  optr->sr1 = save[1];
+  optr->prop0 = save[2];
+  optr->prop1 = save[3];
+  return;
+}
+
+static int check_invert_args(const char * const caller, const int op_id) {
+  if(!tmLQCD_invert_initialised) {
+    fprintf(stderr, "%s: tmLQCD_inver_init must be called first. Aborting...\n", caller);
+    return(-1);
+  }
+  if(op_id < 0 || op_id >= no_operators) {
+    fprintf(stderr, "%s: op_id=%d not in valid range. Aborting...\n", caller, op_id);
+    return(-1);
+  }
+  return(0);
+}
+
+int tmLQCD_invert_batch(double ** const propagators, double ** const sources,
+                        const int nrhs, const int op_id) {
+  g_mu = 0.;
+
+  if(check_invert_args("tmLQCD_invert_batch", op_id) != 0) {
+    return(-1);
+  }
+  if(init_batch_field() != 0) {
+    fprintf(stderr, "tmLQCD_invert_batch: not enough memory for the even/odd fields. Aborting...\n");
+    return(-1);
+  }
+
+  /* the operator works on the private fields for the whole batch, the  */
+  /* clover term and the low modes for deflation are only set up on the */
+  /* first right hand side and reused for the following ones            */
+  for(int j = 0; j < nrhs; j++) {
+    convert_lexic_to_eo(batch_field[0], batch_field[1], (spinor*) sources[j]);
+    invert_eo_fields(batch_field[2], batch_field[3], batch_field[0], batch_field[1], op_id);
+    convert_eo_to_lexic((spinor*) propagators[j], batch_field[2], batch_field[3]);
+
+    if(g_proc_id == 0 && g_debug_level > 0) {
+      printf("# tmLQCD_invert_batch: right hand side %d of %d done in %d iterations\n",
+             j+1, nrhs, operator_list[op_id].iterations);
+      fflush(stdout);
+    }
+  }
+  return(0);
+}
+
+
+int tmLQCD_get_eo_layout(tmLQCD_eo_layout * layout) {
+  if(!tmLQCD_invert_initialised) {
+    fprintf(stderr, "tmLQCD_get_eo_layout: tmLQCD_invert_init must be called first. Aborting...\n");
+    return(-1);
+  }
+  layout->sites = VOLUME/2;
+  layout->field_sites = VOLUMEPLUSRAND/2;
+  layout->site_reals = sizeof(spinor)/sizeof(double);
+  return(0);
+}
+
+int tmLQCD_get_eo_index_map(int * const parity, int * const index) {
+  if(!tmLQCD_invert_initialised) {
+    fprintf(stderr, "tmLQCD_get_eo_index_map: tmLQCD_invert_init must be called first. Aborting...\n");
+    return(-1);
+  }
+#ifdef TM_USE_OMP
+#pragma omp parallel for
+#endif
+  for(int t = 0; t < T; t++) {
+    for(int x = 0; x < LX; x++) {
+      for(int y = 0; y < LY; y++) {
+        for(int z = 0; z < LZ; z++) {
+          const int ix = g_ipt[t][x][y][z];
+          /* same parity convention as convert_lexic_to_eo */
+          parity[ix] = (t + x + y + z + g_proc_coords[3]*LZ + g_proc_coords[2]*LY
+                        + g_proc_coords[0]*T + g_proc_coords[1]*LX)%2;
+          index[ix] = g_lexic2eosub[ix];
+        }
+      }
+    }
+  }
+  return(0);
+}
+
+double * tmLQCD_alloc_eo_field() {
+  return((double*)aligned_malloc_zero((VOLUMEPLUSRAND/2)*sizeof(spinor)));
+}
+
+float * tmLQCD_alloc_eo_field_32() {
+  return((float*)aligned_malloc_zero((VOLUMEPLUSRAND/2)*sizeof(spinor32)));
+}
+
+void tmLQCD_free_eo_field(void * field) {
+  if(field != NULL) aligned_free(field);
+}
+
+int tmLQCD_invert_eo(double * const prop_even, double * const prop_odd,
+                     double * const source_even, double * const source_odd, const int op_id) {
+  g_mu = 0.;
+  if(check_invert_args("tmLQCD_invert_eo", op_id) != 0) {
+    return(-1);
+  }
+  invert_eo_fields((spinor*) prop_even, (spinor*) prop_odd,
+                   (spinor*) source_even, (spinor*) source_odd, op_id);
+  return(0);
+}
+
+int tmLQCD_invert_eo_32(float * const prop_even, float * const prop_odd,
+                        float * const source_even, float * const source_odd, const int op_id) {
+  g_mu = 0.;
+  if(check_invert_args("tmLQCD_invert_eo_32", op_id) != 0) {
+    return(-1);
+  }
+  if(init_batch_field() != 0) {
+    fprintf(stderr, "tmLQCD_invert_eo_32: not enough memory for the even/odd fields. Aborting...\n");
+    return(-1);
+  }
+  /* same order of the sites, only the precision changes */
+  assign_to_64(batch_field[0], (spinor32*) source_even, VOLUME/2);
+  assign_to_64(batch_field[1], (spinor32*) source_odd, VOLUME/2);
+  invert_eo_fields(batch_field[2], batch_field[3], batch_field[0], batch_field[1], op_id);
+  assign_to_32((spinor32*) prop_even, batch_field[2], VOLUME/2);
+  assign_to_32((spinor32*) prop_odd, batch_field[3], VOLUME/2);
+  return(0);
+}
+
+
 int tmLQCD_finalise() {
 
+  if(batch_field != NULL) {
+    finalize_solver(batch_field, NO_BATCH_FIELDS);
+    batch_field = NULL;
+  }
+
 #ifdef TM_USE_OMP
   free_omp_accumulators();
 #endif
@@ -349,6 +518,9 @@ int tmLQCD_get_gauge_field_pointer(double ** gf) {
     fprintf(stderr, "tmLQCD_get_gauge_field_pointer: tmLQCD_invert_init must be called first. Aborting...\n");
     return(-1);
   }
+  /* the caller may have changed the field through the pointer before */
+  /* and may change it afterwards, fields derived from it are invalid  */
+  gauge_field_changed();
 #ifdef TM_USE_MPI
   xchange_gauge(g_gauge_field);
 #endif
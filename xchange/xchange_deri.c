@@ -37,6 +37,7 @@
 #include "su3.h"
 #include "su3adj.h"
 #include "xchange_deri.h"
+#include "profiler.h"
 
 inline void addup_ddummy(su3adj** const df, const int ix, const int iy) {
   for(int mu = 0; mu < 4; mu++) {
@@ -57,6 +58,7 @@ inline void addup_ddummy(su3adj** const df, const int ix, const int iy) {
 
 void xchange_deri(su3adj ** const df)
 {
+  prof_begin("xchange_deri");
 #  ifdef TM_USE_MPI
   int ix,mu, t, y, z, x;
   MPI_Status status;
@@ -179,6 +181,7 @@ void xchange_deri(su3adj ** const df)
   /* clover case, so this needs fixing here! */
 #    endif /* (defined PARALLELXYZT || defined PARALLELXYZ ) */
 #  endif /* MPI */
+  prof_end("xchange_deri", 0., (double)RAND*4*sizeof(su3adj));
   return;
 }
 
@@ -186,6 +189,7 @@ void xchange_deri(su3adj ** const df)
 
 void xchange_deri(su3adj ** const df)
 {
+  prof_begin("xchange_deri");
 #  ifdef TM_USE_MPI
   int ix,iy, t, y, z, x;
   MPI_Status status;
@@ -612,6 +616,7 @@ void xchange_deri(su3adj ** const df)
 
 #    endif /* PARALLELXYZT */
 #  endif /* MPI */
+  prof_end("xchange_deri", 0., (double)RAND*4*sizeof(su3adj));
   return;
 }
 
@@ -46,6 +46,7 @@
 #include "mpi_init.h"
 #include "su3.h"
 #include "xchange_field.h"
+#include "profiler.h"
 
 #if (defined XLC && defined PARALLELXYZT)
 #pragma disjoint(*field_buffer_z2, *field_buffer_z)
@@ -79,6 +80,7 @@ void xchange_field(spinor * const l, const int ieo) {
 #ifdef _KOJAK_INST
 #pragma pomp inst begin(xchangefield)
 #endif
+  prof_begin("xchange_field");
 #  if (defined BGL && defined XLC)
   __alignx(16, l);
 #  endif
@@ -257,6 +259,7 @@ void xchange_field(spinor * const l, const int ieo) {
 
 
 #  endif /* MPI */
+  prof_end("xchange_field", 0., (double)RAND/2*sizeof(spinor));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(xchangefield)
@@ -286,6 +289,7 @@ void xchange_field(spinor * const l, const int ieo) {
 #ifdef _KOJAK_INST
 #pragma pomp inst begin(xchangefield)
 #endif
+  prof_begin("xchange_field");
 #  if (defined BGL && defined XLC)
 #    ifdef PARALLELXYZT
   __alignx(16, field_buffer_z);
@@ -459,6 +463,7 @@ void xchange_field(spinor * const l, const int ieo) {
 #  endif
 
 
+  prof_end("xchange_field", 0., (double)RAND/2*sizeof(spinor));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(xchangefield)
@@ -479,6 +484,7 @@ void xchange_field(spinor * const l, const int ieo) {
 #ifdef _KOJAK_INST
 #pragma pomp inst begin(xchangefield)
 #endif
+  prof_begin("xchange_field");
 
   shmem_barrier_all();
 
@@ -564,6 +570,7 @@ void xchange_field(spinor * const l, const int ieo) {
 
   shmem_barrier_all();
 #  endif // MPI
+  prof_end("xchange_field", 0., (double)RAND/2*sizeof(spinor));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(xchangefield)
@@ -588,6 +595,7 @@ void xchange_field(spinor * const l, const int ieo) {
 #ifdef _KOJAK_INST
 #pragma pomp inst begin(xchangefield)
 #endif
+  prof_begin("xchange_field");
 
 #  ifdef TM_USE_MPI
     
@@ -664,6 +672,7 @@ void xchange_field(spinor * const l, const int ieo) {
 
 #    endif
 #  endif // MPI
+  prof_end("xchange_field", 0., (double)RAND/2*sizeof(spinor));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(xchangefield)
@@ -682,6 +691,7 @@ void xchange_field(spinor * const l, const int ieo) {
 #ifdef _KOJAK_INST
 #pragma pomp inst begin(xchangefield)
 #endif
+  prof_begin("xchange_field");
 
 #  ifdef TM_USE_MPI
     
@@ -770,6 +780,7 @@ void xchange_field(spinor * const l, const int ieo) {
     
 #    endif
 #  endif // MPI
+  prof_end("xchange_field", 0., (double)RAND/2*sizeof(spinor));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(xchangefield)
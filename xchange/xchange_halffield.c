@@ -43,6 +43,7 @@
 #include "su3.h"
 #include "init/init_dirac_halfspinor.h"
 #include "xchange_halffield.h"
+#include "profiler.h"
 
 #if (defined _USE_HALFSPINOR)
 
@@ -145,6 +146,7 @@ void init_xchange_halffield() {
 
 /* 3. */
 void xchange_halffield() {
+  prof_begin("xchange_halffield");
 #  ifdef TM_USE_MPI
 
   MPI_Status status[16];
@@ -165,6 +167,7 @@ void xchange_halffield() {
 
   MPI_Waitall(reqcount, prequests, status); 
 #  endif /* MPI */
+  prof_end("xchange_halffield", 0., (double)RAND*sizeof(halfspinor));
   return;
 }
 
@@ -174,6 +177,7 @@ void xchange_halffield() {
 
 /* 4. -IIG */
 void xchange_halffield() {
+  prof_begin("xchange_halffield");
 
 #  ifdef TM_USE_MPI
 
@@ -255,6 +259,7 @@ void xchange_halffield() {
 
   MPI_Waitall(reqcount, requests, status); 
 #  endif /* MPI */
+  prof_end("xchange_halffield", 0., (double)RAND*sizeof(halfspinor));
   return;
 
 #ifdef _KOJAK_INST
@@ -266,6 +271,7 @@ void xchange_halffield() {
 
 /* 4. */
 void xchange_halffield() {
+  prof_begin("xchange_halffield");
 
 #  ifdef TM_USE_MPI
 
@@ -352,6 +358,7 @@ void xchange_halffield() {
   
   MPI_Waitall(reqcount, requests, status); 
 #  endif /* MPI */
+  prof_end("xchange_halffield", 0., (double)RAND*sizeof(halfspinor));
   return;
   
 #ifdef _KOJAK_INST
@@ -369,6 +376,7 @@ void xchange_halffield() {
 # else // defined _INDEX_INDEP_GEOM
 /* 32-2. */
 void xchange_halffield32() {
+  prof_begin("xchange_halffield32");
 
 #  ifdef TM_USE_MPI
 
@@ -455,6 +463,7 @@ void xchange_halffield32() {
 
   MPI_Waitall(reqcount, requests, status); 
 #  endif /* MPI */
+  prof_end("xchange_halffield32", 0., (double)RAND*sizeof(halfspinor32));
   return;
 #ifdef _KOJAK_INST
 #pragma pomp inst end(xchangehalf32)